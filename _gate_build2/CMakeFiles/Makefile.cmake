@@ -0,0 +1,84 @@
+# CMAKE generated file: DO NOT EDIT!
+# Generated by "Unix Makefiles" Generator, CMake Version 3.25
+
+# The generator used is:
+set(CMAKE_DEPENDS_GENERATOR "Unix Makefiles")
+
+# The top level Makefile was generated from the following files:
+set(CMAKE_MAKEFILE_DEPENDS
+  "CMakeCache.txt"
+  "/root/repo/CMakeLists.txt"
+  "CMakeFiles/3.25.1/CMakeCCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeCXXCompiler.cmake"
+  "CMakeFiles/3.25.1/CMakeSystem.cmake"
+  "/root/repo/cmake/FindFFTW.cmake"
+  "/root/repo/cmake/FindLevelDB.cmake"
+  "/root/repo/cmake/FindR.cmake"
+  "/root/repo/cmake/FindRocksDB.cmake"
+  "/root/repo/cmake/FindSZ.cmake"
+  "/root/repo/examples/CMakeLists.txt"
+  "/root/repo/zc/CMakeLists.txt"
+  "/root/repo/zc/include/CMakeLists.txt"
+  "/root/repo/zc/src/CMakeLists.txt"
+  "/usr/share/cmake-3.25/Modules/CMakeCInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCXXInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeCommonLanguageInclude.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeGenericSystem.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeInitializeConfigs.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeLanguageInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInformation.cmake"
+  "/usr/share/cmake-3.25/Modules/CMakeSystemSpecificInitialize.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckCSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckIncludeFile.cmake"
+  "/usr/share/cmake-3.25/Modules/CheckLibraryExists.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/CMakeCommonCompilerMacros.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-C.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Compiler/GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/FindMPI.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageHandleStandardArgs.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPackageMessage.cmake"
+  "/usr/share/cmake-3.25/Modules/FindPkgConfig.cmake"
+  "/usr/share/cmake-3.25/Modules/FindThreads.cmake"
+  "/usr/share/cmake-3.25/Modules/FindZLIB.cmake"
+  "/usr/share/cmake-3.25/Modules/Internal/CheckSourceCompiles.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-C.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU-CXX.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux-GNU.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/Linux.cmake"
+  "/usr/share/cmake-3.25/Modules/Platform/UnixPaths.cmake"
+  "/usr/share/cmake-3.25/Modules/SelectLibraryConfigurations.cmake"
+  )
+
+# The corresponding makefile is:
+set(CMAKE_MAKEFILE_OUTPUTS
+  "Makefile"
+  "CMakeFiles/cmake.check_cache"
+  )
+
+# Byproducts of CMake generate step:
+set(CMAKE_MAKEFILE_PRODUCTS
+  "CMakeFiles/CMakeDirectoryInformation.cmake"
+  "zc/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "zc/include/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "zc/src/CMakeFiles/CMakeDirectoryInformation.cmake"
+  "examples/CMakeFiles/CMakeDirectoryInformation.cmake"
+  )
+
+# Dependency information for all targets:
+set(CMAKE_DEPEND_INFO_FILES
+  "zc/src/CMakeFiles/zc.dir/DependInfo.cmake"
+  "examples/CMakeFiles/analyzeDataProperty.dir/DependInfo.cmake"
+  "examples/CMakeFiles/analyzeDataProperty_multivars.dir/DependInfo.cmake"
+  "examples/CMakeFiles/compareDataSets.dir/DependInfo.cmake"
+  "examples/CMakeFiles/generateGNUPlot.dir/DependInfo.cmake"
+  "examples/CMakeFiles/generateReport.dir/DependInfo.cmake"
+  "examples/CMakeFiles/modifyZCConfig.dir/DependInfo.cmake"
+  "examples/CMakeFiles/runOfflineCase.dir/DependInfo.cmake"
+  "examples/CMakeFiles/verifyErrorBound.dir/DependInfo.cmake"
+  "examples/CMakeFiles/testRscript_double.dir/DependInfo.cmake"
+  "examples/CMakeFiles/testRscript_float.dir/DependInfo.cmake"
+  "examples/CMakeFiles/testRscript_readBinFloat.dir/DependInfo.cmake"
+  "examples/CMakeFiles/analyzeDataProperty_online.dir/DependInfo.cmake"
+  "examples/CMakeFiles/compareDataSets_online.dir/DependInfo.cmake"
+  )
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../bin/analyzeDataProperty"
+  "../bin/analyzeDataProperty.pdb"
+  "CMakeFiles/analyzeDataProperty.dir/analyzeDataProperty.c.o"
+  "CMakeFiles/analyzeDataProperty.dir/analyzeDataProperty.c.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/analyzeDataProperty.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../bin/analyzeDataProperty_multivars"
+  "../bin/analyzeDataProperty_multivars.pdb"
+  "CMakeFiles/analyzeDataProperty_multivars.dir/analyzeDataProperty_multivars.c.o"
+  "CMakeFiles/analyzeDataProperty_multivars.dir/analyzeDataProperty_multivars.c.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/analyzeDataProperty_multivars.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../bin/analyzeDataProperty_online"
+  "../bin/analyzeDataProperty_online.pdb"
+  "CMakeFiles/analyzeDataProperty_online.dir/analyzeDataProperty_online.c.o"
+  "CMakeFiles/analyzeDataProperty_online.dir/analyzeDataProperty_online.c.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/analyzeDataProperty_online.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
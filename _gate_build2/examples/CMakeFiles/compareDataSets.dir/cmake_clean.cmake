@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../bin/compareDataSets"
+  "../bin/compareDataSets.pdb"
+  "CMakeFiles/compareDataSets.dir/compareDataSets.c.o"
+  "CMakeFiles/compareDataSets.dir/compareDataSets.c.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/compareDataSets.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
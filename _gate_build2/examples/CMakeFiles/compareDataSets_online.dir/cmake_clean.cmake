@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../bin/compareDataSets_online"
+  "../bin/compareDataSets_online.pdb"
+  "CMakeFiles/compareDataSets_online.dir/compareDataSets_online.c.o"
+  "CMakeFiles/compareDataSets_online.dir/compareDataSets_online.c.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/compareDataSets_online.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
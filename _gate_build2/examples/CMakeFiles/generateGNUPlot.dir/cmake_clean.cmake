@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../bin/generateGNUPlot"
+  "../bin/generateGNUPlot.pdb"
+  "CMakeFiles/generateGNUPlot.dir/generateGNUPlot.c.o"
+  "CMakeFiles/generateGNUPlot.dir/generateGNUPlot.c.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/generateGNUPlot.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../bin/generateReport"
+  "../bin/generateReport.pdb"
+  "CMakeFiles/generateReport.dir/generateReport.c.o"
+  "CMakeFiles/generateReport.dir/generateReport.c.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/generateReport.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
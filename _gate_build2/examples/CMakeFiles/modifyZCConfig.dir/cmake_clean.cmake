@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../bin/modifyZCConfig"
+  "../bin/modifyZCConfig.pdb"
+  "CMakeFiles/modifyZCConfig.dir/modifyZCConfig.c.o"
+  "CMakeFiles/modifyZCConfig.dir/modifyZCConfig.c.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/modifyZCConfig.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
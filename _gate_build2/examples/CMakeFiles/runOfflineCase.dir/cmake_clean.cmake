@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../bin/runOfflineCase"
+  "../bin/runOfflineCase.pdb"
+  "CMakeFiles/runOfflineCase.dir/runOfflineCase.c.o"
+  "CMakeFiles/runOfflineCase.dir/runOfflineCase.c.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/runOfflineCase.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../bin/testRscript_double"
+  "../bin/testRscript_double.pdb"
+  "CMakeFiles/testRscript_double.dir/testRscript_double.c.o"
+  "CMakeFiles/testRscript_double.dir/testRscript_double.c.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/testRscript_double.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../bin/testRscript_float"
+  "../bin/testRscript_float.pdb"
+  "CMakeFiles/testRscript_float.dir/testRscript_float.c.o"
+  "CMakeFiles/testRscript_float.dir/testRscript_float.c.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/testRscript_float.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
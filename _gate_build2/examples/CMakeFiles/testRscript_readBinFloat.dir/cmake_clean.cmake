@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../bin/testRscript_readBinFloat"
+  "../bin/testRscript_readBinFloat.pdb"
+  "CMakeFiles/testRscript_readBinFloat.dir/testRscript_readBinFloat.c.o"
+  "CMakeFiles/testRscript_readBinFloat.dir/testRscript_readBinFloat.c.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/testRscript_readBinFloat.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
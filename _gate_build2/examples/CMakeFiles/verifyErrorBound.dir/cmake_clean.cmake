@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "../bin/verifyErrorBound"
+  "../bin/verifyErrorBound.pdb"
+  "CMakeFiles/verifyErrorBound.dir/verifyErrorBound.c.o"
+  "CMakeFiles/verifyErrorBound.dir/verifyErrorBound.c.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/verifyErrorBound.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
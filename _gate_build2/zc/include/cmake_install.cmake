@@ -0,0 +1,78 @@
+# Install script for directory: /root/repo/zc/include
+
+# Set the install prefix
+if(NOT DEFINED CMAKE_INSTALL_PREFIX)
+  set(CMAKE_INSTALL_PREFIX "/usr/local")
+endif()
+string(REGEX REPLACE "/$" "" CMAKE_INSTALL_PREFIX "${CMAKE_INSTALL_PREFIX}")
+
+# Set the install configuration name.
+if(NOT DEFINED CMAKE_INSTALL_CONFIG_NAME)
+  if(BUILD_TYPE)
+    string(REGEX REPLACE "^[^A-Za-z0-9_]+" ""
+           CMAKE_INSTALL_CONFIG_NAME "${BUILD_TYPE}")
+  else()
+    set(CMAKE_INSTALL_CONFIG_NAME "")
+  endif()
+  message(STATUS "Install configuration: \"${CMAKE_INSTALL_CONFIG_NAME}\"")
+endif()
+
+# Set the component getting installed.
+if(NOT CMAKE_INSTALL_COMPONENT)
+  if(COMPONENT)
+    message(STATUS "Install component: \"${COMPONENT}\"")
+    set(CMAKE_INSTALL_COMPONENT "${COMPONENT}")
+  else()
+    set(CMAKE_INSTALL_COMPONENT)
+  endif()
+endif()
+
+# Install shared libraries without execute permission?
+if(NOT DEFINED CMAKE_INSTALL_SO_NO_EXE)
+  set(CMAKE_INSTALL_SO_NO_EXE "1")
+endif()
+
+# Is this installation the result of a crosscompile?
+if(NOT DEFINED CMAKE_CROSSCOMPILING)
+  set(CMAKE_CROSSCOMPILING "FALSE")
+endif()
+
+# Set default install directory permissions.
+if(NOT DEFINED CMAKE_OBJDUMP)
+  set(CMAKE_OBJDUMP "/usr/bin/objdump")
+endif()
+
+if(CMAKE_INSTALL_COMPONENT STREQUAL "Unspecified" OR NOT CMAKE_INSTALL_COMPONENT)
+  file(INSTALL DESTINATION "${CMAKE_INSTALL_PREFIX}/include" TYPE FILE FILES
+    "/root/repo/zc/include/DynamicByteArray.h"
+    "/root/repo/zc/include/ZC_ByteToolkit.h"
+    "/root/repo/zc/include/ZC_Hashtable.h"
+    "/root/repo/zc/include/ZC_latex.h"
+    "/root/repo/zc/include/dictionary.h"
+    "/root/repo/zc/include/ZC_ssim.h"
+    "/root/repo/zc/include/DynamicDoubleArray.h"
+    "/root/repo/zc/include/ZC_CompareData.h"
+    "/root/repo/zc/include/ZC_ReportGenerator.h"
+    "/root/repo/zc/include/ZC_quicksort.h"
+    "/root/repo/zc/include/iniparser.h"
+    "/root/repo/zc/include/DynamicFloatArray.h"
+    "/root/repo/zc/include/ZC_DataProperty.h"
+    "/root/repo/zc/include/ZC_conf.h"
+    "/root/repo/zc/include/ZC_rw.h"
+    "/root/repo/zc/include/zc.h"
+    "/root/repo/zc/include/DynamicIntArray.h"
+    "/root/repo/zc/include/ZC_DataSetHandler.h"
+    "/root/repo/zc/include/ZC_gnuplot.h"
+    "/root/repo/zc/include/ZC_util.h"
+    "/root/repo/zc/include/ZC_thread.h"
+    "/root/repo/zc/include/ZC_simd.h"
+    "/root/repo/zc/include/ZC_autocorr.h"
+    "/root/repo/zc/include/ZC_sample.h"
+    "/root/repo/zc/include/ZC_ErrMap.h"
+    "/root/repo/zc/include/ZC_verify.h"
+    "/root/repo/zc/include/ZC_fft.h"
+    "/root/repo/zc/include/ZC_PropertyAccumulator.h"
+    "/root/repo/zc/include/ZC_QuantileSketch.h"
+    )
+endif()
+
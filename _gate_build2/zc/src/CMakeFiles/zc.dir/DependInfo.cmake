@@ -0,0 +1,55 @@
+
+# Consider dependencies only in project.
+set(CMAKE_DEPENDS_IN_PROJECT_ONLY OFF)
+
+# The set of languages for which implicit dependencies are needed:
+set(CMAKE_DEPENDS_LANGUAGES
+  )
+
+# The set of dependency files which are needed:
+set(CMAKE_DEPENDS_DEPENDENCY_FILES
+  "/root/repo/zc/src/DynamicByteArray.c" "zc/src/CMakeFiles/zc.dir/DynamicByteArray.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/DynamicByteArray.c.o.d"
+  "/root/repo/zc/src/DynamicDoubleArray.c" "zc/src/CMakeFiles/zc.dir/DynamicDoubleArray.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/DynamicDoubleArray.c.o.d"
+  "/root/repo/zc/src/DynamicFloatArray.c" "zc/src/CMakeFiles/zc.dir/DynamicFloatArray.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/DynamicFloatArray.c.o.d"
+  "/root/repo/zc/src/DynamicIntArray.c" "zc/src/CMakeFiles/zc.dir/DynamicIntArray.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/DynamicIntArray.c.o.d"
+  "/root/repo/zc/src/ZC_ByteToolkit.c" "zc/src/CMakeFiles/zc.dir/ZC_ByteToolkit.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/ZC_ByteToolkit.c.o.d"
+  "/root/repo/zc/src/ZC_CompareData.c" "zc/src/CMakeFiles/zc.dir/ZC_CompareData.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/ZC_CompareData.c.o.d"
+  "/root/repo/zc/src/ZC_CompareData_double.c" "zc/src/CMakeFiles/zc.dir/ZC_CompareData_double.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/ZC_CompareData_double.c.o.d"
+  "/root/repo/zc/src/ZC_CompareData_float.c" "zc/src/CMakeFiles/zc.dir/ZC_CompareData_float.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/ZC_CompareData_float.c.o.d"
+  "/root/repo/zc/src/ZC_DataProperty.c" "zc/src/CMakeFiles/zc.dir/ZC_DataProperty.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/ZC_DataProperty.c.o.d"
+  "/root/repo/zc/src/ZC_DataProperty_double.c" "zc/src/CMakeFiles/zc.dir/ZC_DataProperty_double.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/ZC_DataProperty_double.c.o.d"
+  "/root/repo/zc/src/ZC_DataProperty_float.c" "zc/src/CMakeFiles/zc.dir/ZC_DataProperty_float.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/ZC_DataProperty_float.c.o.d"
+  "/root/repo/zc/src/ZC_DataSetHandler.c" "zc/src/CMakeFiles/zc.dir/ZC_DataSetHandler.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/ZC_DataSetHandler.c.o.d"
+  "/root/repo/zc/src/ZC_ErrMap.c" "zc/src/CMakeFiles/zc.dir/ZC_ErrMap.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/ZC_ErrMap.c.o.d"
+  "/root/repo/zc/src/ZC_Hashtable.c" "zc/src/CMakeFiles/zc.dir/ZC_Hashtable.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/ZC_Hashtable.c.o.d"
+  "/root/repo/zc/src/ZC_PropertyAccumulator.c" "zc/src/CMakeFiles/zc.dir/ZC_PropertyAccumulator.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/ZC_PropertyAccumulator.c.o.d"
+  "/root/repo/zc/src/ZC_PropertyAccumulator_double.c" "zc/src/CMakeFiles/zc.dir/ZC_PropertyAccumulator_double.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/ZC_PropertyAccumulator_double.c.o.d"
+  "/root/repo/zc/src/ZC_PropertyAccumulator_float.c" "zc/src/CMakeFiles/zc.dir/ZC_PropertyAccumulator_float.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/ZC_PropertyAccumulator_float.c.o.d"
+  "/root/repo/zc/src/ZC_QuantileSketch.c" "zc/src/CMakeFiles/zc.dir/ZC_QuantileSketch.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/ZC_QuantileSketch.c.o.d"
+  "/root/repo/zc/src/ZC_ReportGenerator.c" "zc/src/CMakeFiles/zc.dir/ZC_ReportGenerator.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/ZC_ReportGenerator.c.o.d"
+  "/root/repo/zc/src/ZC_autocorr.c" "zc/src/CMakeFiles/zc.dir/ZC_autocorr.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/ZC_autocorr.c.o.d"
+  "/root/repo/zc/src/ZC_conf.c" "zc/src/CMakeFiles/zc.dir/ZC_conf.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/ZC_conf.c.o.d"
+  "/root/repo/zc/src/ZC_fft.c" "zc/src/CMakeFiles/zc.dir/ZC_fft.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/ZC_fft.c.o.d"
+  "/root/repo/zc/src/ZC_gnuplot.c" "zc/src/CMakeFiles/zc.dir/ZC_gnuplot.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/ZC_gnuplot.c.o.d"
+  "/root/repo/zc/src/ZC_latex.c" "zc/src/CMakeFiles/zc.dir/ZC_latex.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/ZC_latex.c.o.d"
+  "/root/repo/zc/src/ZC_quicksort.c" "zc/src/CMakeFiles/zc.dir/ZC_quicksort.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/ZC_quicksort.c.o.d"
+  "/root/repo/zc/src/ZC_rw.c" "zc/src/CMakeFiles/zc.dir/ZC_rw.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/ZC_rw.c.o.d"
+  "/root/repo/zc/src/ZC_sample.c" "zc/src/CMakeFiles/zc.dir/ZC_sample.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/ZC_sample.c.o.d"
+  "/root/repo/zc/src/ZC_simd.c" "zc/src/CMakeFiles/zc.dir/ZC_simd.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/ZC_simd.c.o.d"
+  "/root/repo/zc/src/ZC_simd_neon.c" "zc/src/CMakeFiles/zc.dir/ZC_simd_neon.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/ZC_simd_neon.c.o.d"
+  "/root/repo/zc/src/ZC_simd_x86.c" "zc/src/CMakeFiles/zc.dir/ZC_simd_x86.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/ZC_simd_x86.c.o.d"
+  "/root/repo/zc/src/ZC_ssim.c" "zc/src/CMakeFiles/zc.dir/ZC_ssim.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/ZC_ssim.c.o.d"
+  "/root/repo/zc/src/ZC_thread.c" "zc/src/CMakeFiles/zc.dir/ZC_thread.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/ZC_thread.c.o.d"
+  "/root/repo/zc/src/ZC_util.c" "zc/src/CMakeFiles/zc.dir/ZC_util.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/ZC_util.c.o.d"
+  "/root/repo/zc/src/ZC_verify.c" "zc/src/CMakeFiles/zc.dir/ZC_verify.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/ZC_verify.c.o.d"
+  "/root/repo/zc/src/dictionary.c" "zc/src/CMakeFiles/zc.dir/dictionary.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/dictionary.c.o.d"
+  "/root/repo/zc/src/iniparser.c" "zc/src/CMakeFiles/zc.dir/iniparser.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/iniparser.c.o.d"
+  "/root/repo/zc/src/zc.c" "zc/src/CMakeFiles/zc.dir/zc.c.o" "gcc" "zc/src/CMakeFiles/zc.dir/zc.c.o.d"
+  )
+
+# Targets to which this target links.
+set(CMAKE_TARGET_LINKED_INFO_FILES
+  )
+
+# Fortran module output directory.
+set(CMAKE_Fortran_TARGET_MODULE_DIR "")
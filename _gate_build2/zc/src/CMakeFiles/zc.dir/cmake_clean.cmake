@@ -0,0 +1,83 @@
+file(REMOVE_RECURSE
+  "../../lib/libzc.pdb"
+  "../../lib/libzc.so"
+  "CMakeFiles/zc.dir/DynamicByteArray.c.o"
+  "CMakeFiles/zc.dir/DynamicByteArray.c.o.d"
+  "CMakeFiles/zc.dir/DynamicDoubleArray.c.o"
+  "CMakeFiles/zc.dir/DynamicDoubleArray.c.o.d"
+  "CMakeFiles/zc.dir/DynamicFloatArray.c.o"
+  "CMakeFiles/zc.dir/DynamicFloatArray.c.o.d"
+  "CMakeFiles/zc.dir/DynamicIntArray.c.o"
+  "CMakeFiles/zc.dir/DynamicIntArray.c.o.d"
+  "CMakeFiles/zc.dir/ZC_ByteToolkit.c.o"
+  "CMakeFiles/zc.dir/ZC_ByteToolkit.c.o.d"
+  "CMakeFiles/zc.dir/ZC_CompareData.c.o"
+  "CMakeFiles/zc.dir/ZC_CompareData.c.o.d"
+  "CMakeFiles/zc.dir/ZC_CompareData_double.c.o"
+  "CMakeFiles/zc.dir/ZC_CompareData_double.c.o.d"
+  "CMakeFiles/zc.dir/ZC_CompareData_float.c.o"
+  "CMakeFiles/zc.dir/ZC_CompareData_float.c.o.d"
+  "CMakeFiles/zc.dir/ZC_DataProperty.c.o"
+  "CMakeFiles/zc.dir/ZC_DataProperty.c.o.d"
+  "CMakeFiles/zc.dir/ZC_DataProperty_double.c.o"
+  "CMakeFiles/zc.dir/ZC_DataProperty_double.c.o.d"
+  "CMakeFiles/zc.dir/ZC_DataProperty_float.c.o"
+  "CMakeFiles/zc.dir/ZC_DataProperty_float.c.o.d"
+  "CMakeFiles/zc.dir/ZC_DataSetHandler.c.o"
+  "CMakeFiles/zc.dir/ZC_DataSetHandler.c.o.d"
+  "CMakeFiles/zc.dir/ZC_ErrMap.c.o"
+  "CMakeFiles/zc.dir/ZC_ErrMap.c.o.d"
+  "CMakeFiles/zc.dir/ZC_Hashtable.c.o"
+  "CMakeFiles/zc.dir/ZC_Hashtable.c.o.d"
+  "CMakeFiles/zc.dir/ZC_PropertyAccumulator.c.o"
+  "CMakeFiles/zc.dir/ZC_PropertyAccumulator.c.o.d"
+  "CMakeFiles/zc.dir/ZC_PropertyAccumulator_double.c.o"
+  "CMakeFiles/zc.dir/ZC_PropertyAccumulator_double.c.o.d"
+  "CMakeFiles/zc.dir/ZC_PropertyAccumulator_float.c.o"
+  "CMakeFiles/zc.dir/ZC_PropertyAccumulator_float.c.o.d"
+  "CMakeFiles/zc.dir/ZC_QuantileSketch.c.o"
+  "CMakeFiles/zc.dir/ZC_QuantileSketch.c.o.d"
+  "CMakeFiles/zc.dir/ZC_ReportGenerator.c.o"
+  "CMakeFiles/zc.dir/ZC_ReportGenerator.c.o.d"
+  "CMakeFiles/zc.dir/ZC_autocorr.c.o"
+  "CMakeFiles/zc.dir/ZC_autocorr.c.o.d"
+  "CMakeFiles/zc.dir/ZC_conf.c.o"
+  "CMakeFiles/zc.dir/ZC_conf.c.o.d"
+  "CMakeFiles/zc.dir/ZC_fft.c.o"
+  "CMakeFiles/zc.dir/ZC_fft.c.o.d"
+  "CMakeFiles/zc.dir/ZC_gnuplot.c.o"
+  "CMakeFiles/zc.dir/ZC_gnuplot.c.o.d"
+  "CMakeFiles/zc.dir/ZC_latex.c.o"
+  "CMakeFiles/zc.dir/ZC_latex.c.o.d"
+  "CMakeFiles/zc.dir/ZC_quicksort.c.o"
+  "CMakeFiles/zc.dir/ZC_quicksort.c.o.d"
+  "CMakeFiles/zc.dir/ZC_rw.c.o"
+  "CMakeFiles/zc.dir/ZC_rw.c.o.d"
+  "CMakeFiles/zc.dir/ZC_sample.c.o"
+  "CMakeFiles/zc.dir/ZC_sample.c.o.d"
+  "CMakeFiles/zc.dir/ZC_simd.c.o"
+  "CMakeFiles/zc.dir/ZC_simd.c.o.d"
+  "CMakeFiles/zc.dir/ZC_simd_neon.c.o"
+  "CMakeFiles/zc.dir/ZC_simd_neon.c.o.d"
+  "CMakeFiles/zc.dir/ZC_simd_x86.c.o"
+  "CMakeFiles/zc.dir/ZC_simd_x86.c.o.d"
+  "CMakeFiles/zc.dir/ZC_ssim.c.o"
+  "CMakeFiles/zc.dir/ZC_ssim.c.o.d"
+  "CMakeFiles/zc.dir/ZC_thread.c.o"
+  "CMakeFiles/zc.dir/ZC_thread.c.o.d"
+  "CMakeFiles/zc.dir/ZC_util.c.o"
+  "CMakeFiles/zc.dir/ZC_util.c.o.d"
+  "CMakeFiles/zc.dir/ZC_verify.c.o"
+  "CMakeFiles/zc.dir/ZC_verify.c.o.d"
+  "CMakeFiles/zc.dir/dictionary.c.o"
+  "CMakeFiles/zc.dir/dictionary.c.o.d"
+  "CMakeFiles/zc.dir/iniparser.c.o"
+  "CMakeFiles/zc.dir/iniparser.c.o.d"
+  "CMakeFiles/zc.dir/zc.c.o"
+  "CMakeFiles/zc.dir/zc.c.o.d"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang C)
+  include(CMakeFiles/zc.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
@@ -4,6 +4,9 @@
 #  FFTW_INCLUDES    - where to find fftw3.h
 #  FFTW_LIBRARIES   - List of libraries when using FFTW.
 #  FFTW_FOUND       - True if FFTW found.
+#  FFTW_FLOAT_FOUND   - True if the single-precision library (fftw3f) is found too.
+#  FFTW_THREADS_FOUND - True if the threaded libraries (fftw3_threads, and fftw3f_threads
+#                       with fftw3f) are found too.
 
 if (FFTW_INCLUDES)
   # Already in cache, be silent
@@ -13,10 +16,26 @@ endif (FFTW_INCLUDES)
 find_path (FFTW_INCLUDES fftw3.h)
 
 find_library (FFTW_LIBRARIES NAMES fftw3)
+find_library (FFTW_FLOAT_LIBRARY NAMES fftw3f)
+find_library (FFTW_THREADS_LIBRARY NAMES fftw3_threads)
+find_library (FFTW_FLOAT_THREADS_LIBRARY NAMES fftw3f_threads)
 
 # handle the QUIETLY and REQUIRED arguments and set FFTW_FOUND to TRUE if
 # all listed variables are TRUE
 include (FindPackageHandleStandardArgs)
 find_package_handle_standard_args (FFTW DEFAULT_MSG FFTW_LIBRARIES FFTW_INCLUDES)
 
-mark_as_advanced (FFTW_LIBRARIES FFTW_INCLUDES)
+if (FFTW_FOUND AND FFTW_FLOAT_LIBRARY)
+  set (FFTW_FLOAT_FOUND TRUE)
+  list (APPEND FFTW_LIBRARIES ${FFTW_FLOAT_LIBRARY})
+endif ()
+if (FFTW_FOUND AND FFTW_THREADS_LIBRARY AND (NOT FFTW_FLOAT_FOUND OR FFTW_FLOAT_THREADS_LIBRARY))
+  set (FFTW_THREADS_FOUND TRUE)
+  if (FFTW_FLOAT_FOUND)
+    list (INSERT FFTW_LIBRARIES 0 ${FFTW_THREADS_LIBRARY} ${FFTW_FLOAT_THREADS_LIBRARY})
+  else ()
+    list (INSERT FFTW_LIBRARIES 0 ${FFTW_THREADS_LIBRARY})
+  endif ()
+endif ()
+
+mark_as_advanced (FFTW_LIBRARIES FFTW_INCLUDES FFTW_FLOAT_LIBRARY FFTW_THREADS_LIBRARY FFTW_FLOAT_THREADS_LIBRARY)
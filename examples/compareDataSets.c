@@ -8,11 +8,30 @@ int main(int argc, char * argv[])
     size_t r5=0,r4=0,r3=0,r2=0,r1=0;
     char oriFilePath[640], decFilePath[640];
     char *cfgFile, *compressionCase, *varName;
+    size_t chunkSize = 0; //0 means loading both data sets in memory
+    double sampleRatio_ = 0; //0 means the sampleRatio of the config file
+
+    while(argc >= 3 && strncmp(argv[1], "--", 2) == 0)
+    {
+        if(strcmp(argv[1], "--chunk-size") == 0)
+            chunkSize = strtoul(argv[2], NULL, 10);
+        else if(strcmp(argv[1], "--sample-ratio") == 0)
+            sampleRatio_ = atof(argv[2]);
+        else
+        {
+            printf("Unknown option: %s\n", argv[1]);
+            exit(0);
+        }
+        argc -= 2;
+        argv += 2;
+    }
 
     if(argc < 8)
     {
-        printf("Usage: compareDataSets [dataType -f or -d] [config_file] [compressionCase] [varName] [oriDataFilePath] [decDataFilePath] [dimension sizes...]\n");
+        printf("Usage: compareDataSets [--chunk-size nbEle] [--sample-ratio ratio] [dataType -f or -d] [config_file] [compressionCase] [varName] [oriDataFilePath] [decDataFilePath] [dimension sizes...]\n");
         printf("Example: compareDataSets -f zc.config SZ 8_8_128 testfloat_8_8_128.dat testfloat_8_8_128.dat.out 8 8 128\n");
+        printf("--chunk-size: compare the files chunk by chunk, holding only nbEle data points of each file in memory\n");
+        printf("--sample-ratio: approximate comparison of a random sample of blocks (e.g., 0.01), with 95%% confidence intervals\n");
         exit(0);
     }
 
@@ -44,28 +63,23 @@ int main(int argc, char * argv[])
     printf("decFilePath=%s\n", decFilePath);
     ZC_Init(cfgFile);
     executionMode = ZC_OFFLINE;
-
-
-    size_t nbEle1, nbEle2;
-    float *data1 = ZC_readFloatData(oriFilePath, &nbEle1);
-    float *data2 = ZC_readFloatData(decFilePath, &nbEle2);
-
-    if(nbEle1!=nbEle2)
+    if(sampleRatio_ > 0)
     {
-        printf("Error: nbEle1(%d)!=nbEle2(%d)\n",nbEle1, nbEle2);
-        exit(0);
-    }	
+        if(sampleRatio_ > 1)
+        {
+            printf("Error: the sample ratio must be in (0,1]\n");
+            exit(0);
+        }
+        sampleRatio = sampleRatio_;
+    }
 
 	ZC_CompareData* compareResult;
+	int dataType;
 
 	if (argv[1][1] == 'f')
-	{
-		compareResult = ZC_compareData(varName, ZC_FLOAT, data1, data2, r5, r4, r3, r2, r1);
-	}
+		dataType = ZC_FLOAT;
 	else if (argv[1][1] == 'd')
-	{
-		compareResult = ZC_compareData(varName, ZC_DOUBLE, data1, data2, r5, r4, r3, r2, r1);
-	}
+		dataType = ZC_DOUBLE;
 	else
 	{
 		printf ("Wrong data type.\n");
@@ -73,6 +87,29 @@ int main(int argc, char * argv[])
 		exit(0);
 	}
 
+    if(chunkSize > 0)
+    {
+        compareResult = ZC_compareDataFiles(varName, dataType, oriFilePath, decFilePath, chunkSize, r5, r4, r3, r2, r1);
+        ZC_printCompressionResult(compareResult);
+        ZC_writeCompressionResult(compareResult, compressionCase, varName, "compressionResults");
+        freeDataProperty(compareResult->property);
+        freeCompareResult(compareResult);
+        printf("done\n");
+        return 0;
+    }
+
+    size_t nbEle1, nbEle2;
+    float *data1 = ZC_readFloatData(oriFilePath, &nbEle1);
+    float *data2 = ZC_readFloatData(decFilePath, &nbEle2);
+
+    if(nbEle1!=nbEle2)
+    {
+        printf("Error: nbEle1(%d)!=nbEle2(%d)\n",nbEle1, nbEle2);
+        exit(0);
+    }	
+
+	compareResult = ZC_compareData(varName, dataType, data1, data2, r5, r4, r3, r2, r1);
+
     ZC_printCompressionResult(compareResult);
     
     ZC_writeCompressionResult(compareResult, compressionCase, varName, "compressionResults");
@@ -158,6 +158,8 @@ int main(int argc, char *argv[])
 	char propName[128], cmprCaseName[128];
 	memset(propName, 0, 128);
 	memset(cmprCaseName, 0, 128);
+	//statistics of the properties over the time steps, accumulated incrementally (one pass per step)
+	ZC_PropertyAccumulator* propAcc = ZC_initPropertyAccumulator(varName, ZC_DOUBLE, 0, 0, 0, nbLines, M);
 	
 	for (i = 0; i < ITER_TIMES; i++) {
 		localerror = doWork(nbProcs, rank, M, nbLines, g, h);
@@ -177,14 +179,15 @@ int main(int argc, char *argv[])
 
 			freeDataProperty(basicDataProperty); //free the basic data property generated at current time step
 			//Bsic data property includes only basic properties such as min, max, value_range of the data, which are necessary for assessing compression quality.
-			//generate the full data property analysis results, which are optional to users. It includes more information such as entropy and autocorrelation.
-			ZC_DataProperty* fullDataProperty = ZC_genProperties(propName, ZC_DOUBLE, g, 0, 0, 0, nbLines, M);
+			//the other properties of the step (entropy, autocorrelation) are computed by the accumulator, in its single pass over the data
+			ZC_updatePropertyAccumulator(propAcc, g);
+			ZC_DataProperty* stepDataProperty = ZC_getAccumulatorStepProperty(propAcc, propName);
 			if(rank==0) {
-				ZC_writeDataProperty(fullDataProperty, "dataProperties");
-        zserver_commit(i, fullDataProperty, compareResult);
+				ZC_writeDataProperty(stepDataProperty, "dataProperties");
+        zserver_commit(i, stepDataProperty, compareResult);
       }
 
-			freeDataProperty(fullDataProperty); //free data property generated at current time step
+			freeDataProperty_internal(stepDataProperty); //free data property generated at current time step
 			free(cmprBytes);
 			free(decData);
 		}
@@ -217,7 +220,9 @@ int main(int argc, char *argv[])
 
 	}
 
-
+	if(rank==0) //the properties of the steps are global, the same on all the ranks
+		ZC_writePropertyAccumulator(propAcc, "dataProperties");
+	ZC_freePropertyAccumulator(propAcc);
 
 	free(h);
 	free(g);
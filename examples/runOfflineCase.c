@@ -81,6 +81,8 @@ void usage()
 	printf("    -C <information file> : the file containing the data information\n");
 	printf("* analysis options:\n");
 	printf("    -A : perform the full analysis of the compression results\n");
+	printf("    -B : same as -A, but compare all the decompressed data of a variable in one pass\n");
+	printf("         over its original data (all of them are loaded in memory)\n");
 	printf("    -a <metric> : perform quick analysis for specific metric\n");
 	printf("        *metric options: (including all variables)\n");
 	printf("          cr  : compression ratio (min, avg, max)\n");
@@ -95,6 +97,7 @@ void usage()
 	printf("    runOfflineCase -C varCmpr.inf -l\n");
 	printf("    runOfflineCase -C varCmpr.inf -m\n");
 	printf("    runOfflineCase -C varCmpr.inf -A\n");
+	printf("    runOfflineCase -C varCmpr.inf -B\n");
 	printf("    runOfflineCase -C varCmpr.inf -a err\n");
 	printf("    runOfflineCase -C varCmpr.inf -a cr\n");
 }
@@ -265,6 +268,7 @@ VarItem* ZC_readInfo(char* filePath, int *varCount)
 				newCItem = (ComprItem*)malloc(sizeof(ComprItem));
 				memset(newCItem, 0, sizeof(ComprItem));
 				comprPreItem->next = newCItem;
+				tail->nbCmprCases++;
 				strcpy(newCItem->precStr, valueBuf);
 				newCItem->precision = atof(valueBuf);
 				comprPreItem = newCItem;
@@ -290,6 +294,80 @@ VarItem* ZC_readInfo(char* filePath, int *varCount)
 	return header;
 }
 
+/**
+ * set the compression information of one compression case and write its results
+ * */
+void finishCompareResult(ZC_CompareData* compareResult, ComprItem* ci, size_t oriDataSize, int datatype, char* compressorName, char* varName)
+{
+	char compressionCase[128];
+	compareResult->compressSize = ZC_checkFileSize(ci->cmprDataFile);
+	compareResult->compressRatio = (oriDataSize*1.0/compareResult->compressSize);
+	compareResult->rate = datatype*8.0/compareResult->compressRatio;
+	compareResult->compressTime = ci->cmprTime;
+	compareResult->decompressTime = ci->decoTime;
+	if(compareResult->compressTime!=0)
+		compareResult->compressRate = oriDataSize*1.0/compareResult->compressTime;
+	else
+		compareResult->compressRate = 0;
+	if(compareResult->decompressTime!=0)
+		compareResult->decompressRate = oriDataSize*1.0/compareResult->decompressTime;					
+	else
+		compareResult->decompressRate = 0;
+	ZC_printCompressionResult(compareResult);
+
+	sprintf(compressionCase, "%s(%s)", compressorName, ci->precStr);
+	ZC_writeCompressionResult(compareResult, compressionCase, varName, "compressionResults");
+}
+
+/**
+ * compare all the decompressed data sets of one variable in a single pass over the original data, 
+ * with the property already generated on it (see ZC_startCmpr_reuse())
+ * */
+void compareBatch(VarItem* p, void* oriData_v, size_t len, size_t oriDataSize, int datatype, char* compressorName)
+{
+	int k = 0, j;
+	size_t nbEle = 0;
+	ComprItem* q;
+	ComprItem** items = (ComprItem**)malloc(sizeof(ComprItem*)*p->nbCmprCases);
+	void** decData = (void**)malloc(sizeof(void*)*p->nbCmprCases);
+	
+	for(q = p->comprHeader->next;q!=NULL;q = q->next)
+	{
+		printf("- data distortion analysis: %s with precision = %f ....\n", p->varName, q->precision);
+		if(!ZC_check_file_exists(q->decoDataFile))
+		{
+			printf("\t\t Precision=%f, ERROR: missing decompressed file (%s)\n", q->precision, q->cmprDataFile);
+			continue;
+		}
+		if(p->dataType == ZC_FLOAT)
+			decData[k] = ZC_readFloatData(q->decoDataFile, &nbEle);
+		else
+			decData[k] = ZC_readDoubleData(q->decoDataFile, &nbEle);
+		if(nbEle!=len)
+		{
+			printf("Error: inconsistent number of elements between the info file and decompressed data file. \n");
+			printf("data size %ld x %ld x %ld x %ld x %ld doesn't match file size (%zu elements).\n", p->dim5, p->dim4, p->dim3, p->dim2, p->dim1, nbEle); 
+			exit(0);
+		}
+		items[k++] = q;
+	}
+	
+	if(k > 0)
+	{
+		ZC_DataProperty* property = ZC_startCmpr_reuse(p->varName, p->dataType, oriData_v, p->dim5, p->dim4, p->dim3, p->dim2, p->dim1);
+		ZC_CompareData** compareResults = ZC_compareData_batch(property, decData, NULL, k);
+		for(j=0;j<k;j++)
+		{
+			finishCompareResult(compareResults[j], items[j], oriDataSize, datatype, compressorName, p->varName);
+			freeCompareResult_internal(compareResults[j]);
+			free(decData[j]);
+		}
+		free(compareResults);
+	}
+	free(items);
+	free(decData);
+}
+
 int main(int argc, char* argv[])
 {
 	int printNbVars = 0;
@@ -297,6 +375,7 @@ int main(int argc, char* argv[])
 	int listAllVarInfo = 0;
 	int printPrecisions = 0;
 	int fullAnalysis = 0;
+	int batchMode = 0;
 
 	char* inPath = NULL;
 	char* compressorName = "user_compressor";
@@ -337,6 +416,10 @@ int main(int argc, char* argv[])
 		case 'A': 
 			fullAnalysis = 1;
 			break;
+		case 'B': 
+			fullAnalysis = 1;
+			batchMode = 1;
+			break;
 		case 'C':
 			if (++i == argc)
 				usage();
@@ -784,7 +867,6 @@ int main(int argc, char* argv[])
 		p = varItemHeader->next;
 		void *oriData_v;
 		size_t nbEle = 0;
-		char compressionCase[128];
 		while(p!=NULL)
 		{	
 			if(p->dataType==ZC_FLOAT)
@@ -823,6 +905,15 @@ int main(int argc, char* argv[])
 
 			ZC_writeDataProperty(property, "dataProperties");
 			
+			if(batchMode)
+			{
+				compareBatch(p, oriData_v, len, oriDataSize, datatype, compressorName);
+				free(oriData_v);
+				p = p->next;
+				i++;
+				continue;
+			}
+			
 			ZC_CompareData* compareResult;
 			//processing compression results
 			q = p->comprHeader;
@@ -836,53 +927,29 @@ int main(int argc, char* argv[])
 				int decoFileExists = ZC_check_file_exists(ci->decoDataFile);
 				if(decoFileExists)
 				{
+					void* decData;
 					if(p->dataType == ZC_FLOAT)
+						decData = ZC_readFloatData(ci->decoDataFile, &nbEle);
+					else
+						decData = ZC_readDoubleData(ci->decoDataFile, &nbEle);	
+					if(nbEle!=len)
 					{
-						float* decData = ZC_readFloatData(ci->decoDataFile, &nbEle);
-						if(nbEle!=len)
-						{
-							free(oriData_v);
-							free(decData);
-							printf("Error: inconsistent number of elements between the info file and decompressed data file. \n");
-							printf("data size %ld x %ld x %ld x %ld x %ld doesn't match file size (%zu elements).\n", p->dim5, p->dim4, p->dim3, p->dim2, p->dim1, nbEle); 
-							exit(0);
-						}
-						
-						compareResult = ZC_compareData(p->varName, ZC_FLOAT, (float*)oriData_v, decData, p->dim5, p->dim4, p->dim3, p->dim2, p->dim1);	
+						free(oriData_v);
+						free(decData);
+						printf("Error: inconsistent number of elements between the info file and decompressed data file. \n");
+						printf("data size %ld x %ld x %ld x %ld x %ld doesn't match file size (%zu elements).\n", p->dim5, p->dim4, p->dim3, p->dim2, p->dim1, nbEle); 
+						exit(0);
 					}
-					else if(p->dataType == ZC_DOUBLE)
-					{
-						double* decData = ZC_readDoubleData(ci->decoDataFile, &nbEle);	
-						if(nbEle!=len)
-						{
-							free(oriData_v);
-							free(decData);
-							printf("Error: inconsistent number of elements between the info file and decompressed data file. \n");
-							printf("data size %ld x %ld x %ld x %ld x %ld doesn't match file size (%zu elements).\n", p->dim5, p->dim4, p->dim3, p->dim2, p->dim1, nbEle); 
-							exit(0);
-						}
-						
-						compareResult = ZC_compareData(p->varName, ZC_DOUBLE, (double*)oriData_v, decData, p->dim5, p->dim4, p->dim3, p->dim2, p->dim1);			
-					}
-
-					compareResult->compressSize = ZC_checkFileSize(ci->cmprDataFile);
-					compareResult->compressRatio = (oriDataSize*1.0/compareResult->compressSize);
-					compareResult->rate = datatype*8.0/compareResult->compressRatio;
-					compareResult->compressTime = ci->cmprTime;
-					compareResult->decompressTime = ci->decoTime;
-					if(compareResult->compressTime!=0)
-						compareResult->compressRate = oriDataSize*1.0/compareResult->compressTime;
-					else
-						compareResult->compressRate = 0;
-					if(compareResult->decompressTime!=0)
-						compareResult->decompressRate = oriDataSize*1.0/compareResult->decompressTime;					
-					else
-						compareResult->decompressRate = 0;
-					ZC_printCompressionResult(compareResult);
-
-					sprintf(compressionCase, "%s(%s)", compressorName, ci->precStr);
-					ZC_writeCompressionResult(compareResult, compressionCase, p->varName, "compressionResults");
-
+					
+					//all the precisions are compared with the property of the original data generated above
+					ZC_DataProperty* oriProperty = ZC_startCmpr_reuse(p->varName, p->dataType, oriData_v, p->dim5, p->dim4, p->dim3, p->dim2, p->dim1);
+					ZC_CompareData** compareResults = ZC_compareData_batch(oriProperty, &decData, NULL, 1);
+					compareResult = compareResults[0];
+					free(compareResults);
+
+					finishCompareResult(compareResult, ci, oriDataSize, datatype, compressorName, p->varName);
+					freeCompareResult_internal(compareResult);
+					free(decData);
 				}
 				else
 					printf("\t\t Precision=%f, ERROR: missing decompressed file (%s)\n", prec, ci->cmprDataFile);				
@@ -0,0 +1,115 @@
+#include <stdio.h>
+#include <string.h>
+#include <ZC_rw.h>
+#include <zc.h>
+
+int main(int argc, char * argv[])
+{
+	size_t r5=0,r4=0,r3=0,r2=0,r1=0;
+	char oriFilePath[640], decFilePath[640];
+	char *cfgFile, *mode = NULL;
+	double absBound = -1, relRatio = -1, pwrRatio = -1; //-1 means the bound of the config file
+	long maxViolations = -1;
+
+	while(argc >= 3 && strncmp(argv[1], "--", 2) == 0)
+	{
+		if(strcmp(argv[1], "--mode") == 0)
+			mode = argv[2];
+		else if(strcmp(argv[1], "--abs") == 0)
+			absBound = atof(argv[2]);
+		else if(strcmp(argv[1], "--rel") == 0)
+			relRatio = atof(argv[2]);
+		else if(strcmp(argv[1], "--pwr") == 0)
+			pwrRatio = atof(argv[2]);
+		else if(strcmp(argv[1], "--max-violations") == 0)
+			maxViolations = atol(argv[2]);
+		else
+		{
+			printf("Unknown option: %s\n", argv[1]);
+			exit(0);
+		}
+		argc -= 2;
+		argv += 2;
+	}
+
+	if(argc < 6)
+	{
+		printf("Usage: verifyErrorBound [--mode errorBoundMode] [--abs absErrBound] [--rel relBoundRatio] [--pwr pw_relBoundRatio] [--max-violations K] [dataType -f or -d] [config_file] [oriDataFilePath] [decDataFilePath] [dimension sizes...]\n");
+		printf("Example: verifyErrorBound --mode ABS --abs 1E-4 -f zc.config testfloat_8_8_128.dat testfloat_8_8_128.dat.out 8 8 128\n");
+		printf("The options override the error bound of the [COMPARE] section of the config file.\n");
+		printf("--max-violations: report the first K violating points and stop (0: check all the points and count the violations)\n");
+		printf("The exit status is 0 if the error bound holds at every point, and 1 otherwise.\n");
+		exit(0);
+	}
+
+	cfgFile=argv[2];
+	sprintf(oriFilePath, "%s", argv[3]);
+	sprintf(decFilePath, "%s", argv[4]);
+	if(argc>=6)
+		r1 = atoi(argv[5]);
+	if(argc>=7)
+		r2 = atoi(argv[6]);
+	if(argc>=8)
+		r3 = atoi(argv[7]);
+	if(argc>=9)
+		r4 = atoi(argv[8]);
+	if(argc>=10)
+		r5 = atoi(argv[9]);
+
+	ZC_Init(cfgFile);
+	if(mode != NULL)
+	{
+		errorBoundMode = ZC_parseErrorBoundMode(mode);
+		if(errorBoundMode < 0)
+		{
+			printf("Error: wrong error bound mode: %s\n", mode);
+			exit(0);
+		}
+	}
+	if(absBound >= 0)
+		absErrBound = absBound;
+	if(relRatio >= 0)
+		relBoundRatio = relRatio;
+	if(pwrRatio >= 0)
+		pwrBoundRatio = pwrRatio;
+	if(maxViolations >= 0)
+		verifyMaxViolations = maxViolations;
+
+	int dataType;
+	void *data1, *data2;
+	size_t nbEle1, nbEle2;
+	if (argv[1][1] == 'f')
+	{
+		dataType = ZC_FLOAT;
+		data1 = ZC_readFloatData(oriFilePath, &nbEle1);
+		data2 = ZC_readFloatData(decFilePath, &nbEle2);
+	}
+	else if (argv[1][1] == 'd')
+	{
+		dataType = ZC_DOUBLE;
+		data1 = ZC_readDoubleData(oriFilePath, &nbEle1);
+		data2 = ZC_readDoubleData(decFilePath, &nbEle2);
+	}
+	else
+	{
+		printf ("Wrong data type.\n");
+		printf ("Please use -f or -d to specify single or double data type.\n");
+		exit(0);
+	}
+
+	if(nbEle1!=nbEle2 || nbEle1!=ZC_computeDataLength(r5, r4, r3, r2, r1))
+	{
+		printf("Error: nbEle1(%zu), nbEle2(%zu) and the dimension sizes do not match\n", nbEle1, nbEle2);
+		exit(0);
+	}
+
+	ZC_VerifyResult* result = ZC_verifyErrorBound(dataType, data1, data2, r5, r4, r3, r2, r1);
+	ZC_printVerifyResult(result, data1, data2, dataType);
+	int pass = result->pass;
+
+	ZC_freeVerifyResult(result);
+	free(data1);
+	free(data2);
+	ZC_Finalize();
+	return pass ? 0 : 1;
+}
@@ -0,0 +1,190 @@
+#include "CUnit/CUnit.h"
+#include "CUnit/Basic.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>  // for printf
+#include <string.h>
+#include "zc.h"
+#include "ZC_PropertyAccumulator.h"
+
+#define R2 300
+#define R1 1000
+#define STEPS 6
+
+/* Test Suite setup and cleanup functions: */
+
+int init_suite(void) { return 0; }
+int clean_suite(void) { return 0; }
+
+/************* Test case functions ****************/
+
+static void genStep(float* data, int step)
+{
+	size_t i;
+	srand(7+step);
+	for(i=0;i<R2*R1;i++)
+		data[i] = 300 + 10*sin(i*0.01) + 0.5*step + (float)rand()/RAND_MAX;
+}
+
+void test_ZC_TemporalStat(void)
+{
+	int t;
+	ZC_TemporalStat a, b, all;
+	ZC_initTemporalStat(&a);
+	ZC_initTemporalStat(&b);
+	ZC_initTemporalStat(&all);
+	for(t=0;t<10;t++)
+	{
+		double v = 2 + 0.25*t + (t%3);
+		ZC_updateTemporalStat(t<4 ? &a : &b, v);
+		ZC_updateTemporalStat(&all, v);
+	}
+	ZC_mergeTemporalStat(&a, &b);
+	CU_ASSERT_EQUAL(a.nbSteps, 10);
+	CU_ASSERT_DOUBLE_EQUAL(a.mean, all.mean, 1E-12);
+	CU_ASSERT_DOUBLE_EQUAL(ZC_getTemporalVariance(&a), ZC_getTemporalVariance(&all), 1E-12);
+	CU_ASSERT_DOUBLE_EQUAL(ZC_getTemporalDrift(&a), ZC_getTemporalDrift(&all), 1E-12);
+	CU_ASSERT_EQUAL(a.first, all.first);
+	CU_ASSERT_EQUAL(a.last, all.last);
+	CU_ASSERT_EQUAL(a.max, all.max);
+
+	//a linear series drifts by its slope
+	ZC_initTemporalStat(&a);
+	for(t=0;t<5;t++)
+		ZC_updateTemporalStat(&a, 1 - 0.5*t);
+	CU_ASSERT_DOUBLE_EQUAL(ZC_getTemporalDrift(&a), -0.5, 1E-12);
+}
+
+void test_ZC_updatePropertyAccumulator(void)
+{
+	size_t i, n = R2*R1;
+	int t, delta;
+	float* data[STEPS];
+	fftFlag = 0;
+	autocorr3DFlag = 0;
+	lapFlag = 0;
+	ZC_setNbThreads(4);
+	ZC_PropertyAccumulator* acc = ZC_initPropertyAccumulator("temperature", ZC_FLOAT, 0, 0, 0, R2, R1);
+	ZC_PropertyAccumulator* first = ZC_initPropertyAccumulator("temperature", ZC_FLOAT, 0, 0, 0, R2, R1);
+	ZC_PropertyAccumulator* second = ZC_initPropertyAccumulator("temperature", ZC_FLOAT, 0, 0, 0, R2, R1);
+	CU_ASSERT_EQUAL(acc->maxLag, AUTOCORR_SIZE);
+	for(t=0;t<STEPS;t++)
+	{
+		data[t] = (float*)malloc(sizeof(float)*n);
+		genStep(data[t], t);
+		ZC_updatePropertyAccumulator(acc, data[t]);
+		ZC_updatePropertyAccumulator(t<STEPS/2 ? first : second, data[t]);
+
+		//the properties of the step are those of ZC_genProperties()
+		ZC_DataProperty* property = ZC_genProperties_float("temperature", data[t], n, 0, 0, 0, R2, R1);
+		CU_ASSERT_EQUAL(acc->property->minValue, property->minValue);
+		CU_ASSERT_EQUAL(acc->property->maxValue, property->maxValue);
+		CU_ASSERT_DOUBLE_EQUAL(acc->property->avgValue, property->avgValue, 1E-9);
+		CU_ASSERT_DOUBLE_EQUAL(acc->property->zeromean_variance, property->zeromean_variance, 1E-8);
+		CU_ASSERT_DOUBLE_EQUAL(acc->property->entropy, property->entropy, 1E-12);
+		for(delta=1;delta<=AUTOCORR_SIZE;delta++)
+			CU_ASSERT_DOUBLE_EQUAL(acc->property->autocorr[delta], property->autocorr[delta], 1E-9);
+		freeDataProperty_internal(property);
+
+		//a copy, named after the step
+		ZC_DataProperty* step = ZC_getAccumulatorStepProperty(acc, "temperature_0001.dat");
+		CU_ASSERT_STRING_EQUAL(step->varName, "temperature_0001");
+		CU_ASSERT_PTR_NULL(step->data);
+		CU_ASSERT_EQUAL(step->entropy, acc->property->entropy);
+		CU_ASSERT(step->autocorr != acc->property->autocorr);
+		CU_ASSERT_EQUAL(step->autocorr[AUTOCORR_SIZE], acc->property->autocorr[AUTOCORR_SIZE]);
+		freeDataProperty_internal(step);
+	}
+	CU_ASSERT_EQUAL(acc->nbSteps, STEPS);
+	CU_ASSERT_DOUBLE_EQUAL(ZC_getTemporalDrift(&acc->avgValue), 0.5, 1E-3);
+
+	//per-point statistics against a direct computation
+	int errors = 0;
+	for(i=0;i<n;i+=997)
+	{
+		double mean = 0, var = 0, min = data[0][i], max = data[0][i];
+		for(t=0;t<STEPS;t++)
+		{
+			mean += data[t][i];
+			if(min>data[t][i]) min = data[t][i];
+			if(max<data[t][i]) max = data[t][i];
+		}
+		mean /= STEPS;
+		for(t=0;t<STEPS;t++)
+			var += (data[t][i]-mean)*(data[t][i]-mean);
+		var /= STEPS;
+		if(fabs(acc->mean[i]-mean) > 1E-10 || fabs(acc->m2[i]/STEPS-var) > 1E-9
+		|| acc->minEnvelope[i] != min || acc->maxEnvelope[i] != max)
+			errors++;
+	}
+	CU_ASSERT_EQUAL(errors, 0);
+
+	//two halves of the steps merged
+	ZC_mergePropertyAccumulator(first, second);
+	CU_ASSERT_EQUAL(first->nbSteps, STEPS);
+	CU_ASSERT_DOUBLE_EQUAL(first->entropy.mean, acc->entropy.mean, 1E-12);
+	CU_ASSERT_DOUBLE_EQUAL(ZC_getTemporalDrift(&first->avgValue), ZC_getTemporalDrift(&acc->avgValue), 1E-9);
+	CU_ASSERT_DOUBLE_EQUAL(first->autocorr[1].mean, acc->autocorr[1].mean, 1E-9);
+	CU_ASSERT_DOUBLE_EQUAL(first->m2[12345], acc->m2[12345], 1E-9);
+	CU_ASSERT_EQUAL(first->minEnvelope[12345], acc->minEnvelope[12345]);
+
+	//the results do not depend on the number of threads
+	ZC_PropertyAccumulator* serial = ZC_initPropertyAccumulator("temperature", ZC_FLOAT, 0, 0, 0, R2, R1);
+	ZC_setNbThreads(1);
+	for(t=0;t<STEPS;t++)
+		ZC_updatePropertyAccumulator(serial, data[t]);
+	CU_ASSERT_EQUAL(serial->property->avgValue, acc->property->avgValue);
+	CU_ASSERT_EQUAL(serial->property->autocorr[7], acc->property->autocorr[7]);
+	CU_ASSERT_EQUAL(serial->entropy.mean, acc->entropy.mean);
+
+	ZC_DataProperty* summary = ZC_finalizePropertyAccumulator(acc);
+	CU_ASSERT_EQUAL(summary->minValue, acc->minValue.min);
+	CU_ASSERT_EQUAL(summary->maxValue, acc->maxValue.max);
+	CU_ASSERT_DOUBLE_EQUAL(summary->autocorr[1], acc->autocorr[1].mean, 1E-15);
+	freeDataProperty_internal(summary);
+
+	ZC_freePropertyAccumulator(serial);
+	ZC_freePropertyAccumulator(first);
+	ZC_freePropertyAccumulator(second);
+	ZC_freePropertyAccumulator(acc);
+	for(t=0;t<STEPS;t++)
+		free(data[t]);
+}
+
+/************* Test Runner Code goes here **************/
+
+int main ( void )
+{
+   CU_pSuite pSuite = NULL;
+
+   /* initialize the CUnit test registry */
+   if ( CUE_SUCCESS != CU_initialize_registry() )
+      return CU_get_error();
+
+   /* add a suite to the registry */
+   pSuite = CU_add_suite( "test_PropertyAccumulator_suite", init_suite, clean_suite );
+   if ( NULL == pSuite ) {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   /* add the tests to the suite */
+   if ((NULL == CU_add_test(pSuite, "test_ZC_TemporalStat", test_ZC_TemporalStat)) ||
+       (NULL == CU_add_test(pSuite, "test_ZC_updatePropertyAccumulator", test_ZC_updatePropertyAccumulator)))
+   {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   // Run all tests using the basic interface
+   CU_basic_set_mode(CU_BRM_VERBOSE);
+   CU_basic_run_tests();
+   printf("\n");
+   CU_basic_show_failures(CU_get_failure_list());
+   printf("\n\n");
+
+   /* Clean up registry and return */
+   CU_cleanup_registry();
+   return CU_get_error();
+}
@@ -0,0 +1,114 @@
+#include "CUnit/CUnit.h"
+#include "CUnit/Basic.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>  // for printf
+#include <string.h>
+#include "zc.h"
+#include "ZC_autocorr.h"
+
+#define TEST_SIZE 100003
+#define TEST_LAG 100
+
+/* Test Suite setup and cleanup functions: */
+
+int init_suite(void) { return 0; }
+int clean_suite(void) { return 0; }
+
+/************* Test case functions ****************/
+
+void test_ZC_computeCenteredLagSums(void)
+{
+	size_t i, offset, len;
+	int delta;
+	double mean = 0;
+	double* data = (double*)malloc(sizeof(double)*TEST_SIZE);
+	for(i=0;i<TEST_SIZE;i++)
+	{
+		data[i] = 1e3 + sin(i*0.01) + cos(i*0.37)*1e-2;
+		mean += data[i];
+	}
+	mean /= TEST_SIZE;
+	
+	//stream the data in chunks of irregular sizes, some shorter than the lag
+	ZC_LagAccumulator acc;
+	double lagSums[TEST_LAG+1];
+	ZC_initLagAccumulator(&acc, TEST_LAG, data[0]);
+	for(offset=0, len=7;offset<TEST_SIZE;offset+=len, len=len*3+11)
+	{
+		if(len>TEST_SIZE-offset)
+			len = TEST_SIZE-offset;
+		ZC_updateLagAccumulator(&acc, data+offset, len);
+	}
+	CU_ASSERT_EQUAL(acc.n, TEST_SIZE);
+	ZC_computeCenteredLagSums(&acc, mean, lagSums);
+	ZC_freeLagAccumulator(&acc);
+	
+	for(delta=0;delta<=TEST_LAG;delta+=7)
+	{
+		double sum = 0;
+		for(i=0;i<TEST_SIZE-delta;i++)
+			sum += (data[i]-mean)*(data[i+delta]-mean);
+		CU_ASSERT_DOUBLE_EQUAL(lagSums[delta], sum, 1E-9*fabs(sum)+1E-9);
+	}
+	free(data);
+}
+
+void test_ZC_accumulateLagProducts(void)
+{
+	size_t i, n = 3*ZC_LAG_TILE_SIZE+17;
+	int delta;
+	double prod[TEST_LAG+1];
+	double* y = (double*)malloc(sizeof(double)*n);
+	for(i=0;i<n;i++)
+		y[i] = sin(i*0.05) + cos(i*0.7)*0.1;
+	
+	memset(prod, 0, sizeof(prod));
+	ZC_accumulateLagProducts(y, n, 0, TEST_LAG, prod);
+	for(delta=0;delta<=TEST_LAG;delta++)
+	{
+		double sum = 0;
+		for(i=0;i+delta<n;i++)
+			sum += y[i]*y[i+delta];
+		CU_ASSERT_DOUBLE_EQUAL(prod[delta], sum, 1E-10*n);
+	}
+	free(y);
+}
+
+/************* Test Runner Code goes here **************/
+
+int main ( void )
+{
+   CU_pSuite pSuite = NULL;
+
+   /* initialize the CUnit test registry */
+   if ( CUE_SUCCESS != CU_initialize_registry() )
+      return CU_get_error();
+
+   /* add a suite to the registry */
+   pSuite = CU_add_suite( "test_autocorr_suite", init_suite, clean_suite );
+   if ( NULL == pSuite ) {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   /* add the tests to the suite */
+   if ((NULL == CU_add_test(pSuite, "test_ZC_accumulateLagProducts", test_ZC_accumulateLagProducts)) ||
+       (NULL == CU_add_test(pSuite, "test_ZC_computeCenteredLagSums", test_ZC_computeCenteredLagSums)))
+   {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   // Run all tests using the basic interface
+   CU_basic_set_mode(CU_BRM_VERBOSE);
+   CU_basic_run_tests();
+   printf("\n");
+   CU_basic_show_failures(CU_get_failure_list());
+   printf("\n\n");
+
+   /* Clean up registry and return */
+   CU_cleanup_registry();
+   return CU_get_error();
+}
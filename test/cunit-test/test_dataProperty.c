@@ -0,0 +1,247 @@
+#include "CUnit/CUnit.h"
+#include "CUnit/Basic.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>  // for printf
+#include <string.h>
+#include <unistd.h>
+#include "zc.h"
+
+#define R2 200
+#define R1 500
+
+/* Test Suite setup and cleanup functions: */
+
+int init_suite(void) { return 0; }
+int clean_suite(void) { return 0; }
+
+/************* Test case functions ****************/
+
+void test_ZC_createDataProperty(void)
+{
+	size_t i, n = R2*R1;
+	double* data = (double*)malloc(sizeof(double)*n);
+	for(i=0;i<n;i++)
+		data[i] = 20*sin(i*0.003) + 0.1*(i%17);
+	entropyFlag = 1;
+	quantEntropyFlag = 1;
+	autocorrFlag = 1;
+	autocorr3DFlag = 0;
+	fftFlag = 0;
+	lapFlag = 1;
+	ZC_DataProperty* eager = ZC_genProperties_double("var.dat", data, n, 0, 0, 0, R2, R1);
+	ZC_DataProperty* lazy = ZC_createDataProperty("var.dat", ZC_DOUBLE, data, 0, 0, 0, R2, R1);
+	CU_ASSERT_STRING_EQUAL(lazy->varName, "var");
+	CU_ASSERT_EQUAL(lazy->numOfElem, n);
+	CU_ASSERT_EQUAL(lazy->pendingMask, ZC_PROP_ALL);
+
+	//the autocorrelation needs the average, but nothing else
+	double* autocorr = ZC_getAutocorr(lazy);
+	CU_ASSERT_EQUAL(lazy->pendingMask, ZC_PROP_ALL & ~(ZC_PROP_AUTOCORR|ZC_PROP_BASIC));
+	CU_ASSERT_EQUAL(memcmp(autocorr, eager->autocorr, sizeof(double)*(AUTOCORR_SIZE+1)), 0);
+	CU_ASSERT_EQUAL(ZC_getValueRange(lazy), eager->valueRange);
+	CU_ASSERT_EQUAL(ZC_getAvgValue(lazy), eager->avgValue);
+	CU_ASSERT_EQUAL(ZC_getZeromeanVariance(lazy), eager->zeromean_variance);
+	CU_ASSERT_EQUAL(lazy->entropy, 0);
+
+	//each property is computed once
+	CU_ASSERT_PTR_EQUAL(ZC_getAutocorr(lazy), autocorr);
+	CU_ASSERT_EQUAL(ZC_getEntropy(lazy), eager->entropy);
+	CU_ASSERT_EQUAL(ZC_getQuantEntropy(lazy), eager->quantEntropy);
+	double* lap = ZC_getLaplacian(lazy);
+	CU_ASSERT_EQUAL(memcmp(lap, eager->lap, sizeof(double)*n), 0);
+	CU_ASSERT_PTR_EQUAL(ZC_getLaplacian(lazy), lap);
+	CU_ASSERT_EQUAL(lazy->pendingMask, ZC_PROP_ALL & ~ZC_getFlaggedProperties());
+
+	//the eager properties are all computed, the others stay pending
+	CU_ASSERT_EQUAL(eager->pendingMask, ZC_PROP_ALL & ~ZC_getFlaggedProperties());
+	CU_ASSERT_PTR_NULL(eager->fftCoeff);
+	CU_ASSERT_PTR_NOT_NULL(ZC_getFFTCoeff(eager));
+	CU_ASSERT_EQUAL(eager->pendingMask & ZC_PROP_FFT, 0);
+
+	freeDataProperty_internal(eager);
+	freeDataProperty_internal(lazy);
+	free(data);
+}
+
+void test_ZC_mergePropertyStat(void)
+{
+	size_t i, n = R2*R1, cuts[4] = {0, 7, n/3, n};
+	float* data = (float*)malloc(sizeof(float)*n);
+	for(i=0;i<n;i++)
+		data[i] = 20*sin(i*0.003) + 0.1*(i%17) + 5;
+	ZC_DataProperty* eager = ZC_genProperties_float("var.dat", data, n, 0, 0, 0, R2, R1);
+
+	//the statistics of the parts (e.g., of the ranks) merged in order give those of the whole data
+	ZC_OnlineStat stat, part;
+	ZC_initOnlineStat(&stat, ZC_REDUCE_PROPERTY);
+	for(i=0;i<3;i++)
+	{
+		ZC_initOnlineStat(&part, ZC_REDUCE_PROPERTY);
+		ZC_computePropertyStat_float(&part.property, data+cuts[i], cuts[i+1]-cuts[i]);
+		part.compare.n = 1; //not reduced
+		ZC_mergeOnlineStat(&stat, &part);
+	}
+	CU_ASSERT_EQUAL(stat.compare.n, 0);
+
+	ZC_DataProperty* merged = ZC_createDataProperty("var.dat", ZC_FLOAT, data, 0, 0, 0, R2, R1);
+	ZC_applyPropertyStat(merged, &stat.property);
+	CU_ASSERT_EQUAL(merged->numOfElem, n);
+	CU_ASSERT_EQUAL(merged->minValue, eager->minValue);
+	CU_ASSERT_EQUAL(merged->maxValue, eager->maxValue);
+	CU_ASSERT_DOUBLE_EQUAL(merged->avgValue, eager->avgValue, 1E-12*fabs(eager->avgValue));
+	CU_ASSERT_DOUBLE_EQUAL(merged->zeromean_variance, eager->zeromean_variance, 1E-12*eager->zeromean_variance);
+	CU_ASSERT_EQUAL(merged->pendingMask, ZC_PROP_ALL & ~ZC_PROP_BASIC);
+	CU_ASSERT_EQUAL(merged->sumSqrDevReady, 1);
+
+	freeDataProperty_internal(eager);
+	freeDataProperty_internal(merged);
+	free(data);
+}
+
+void test_ZC_compareData_refill(void)
+{
+	size_t i, n = R2*R1;
+	float* data1 = (float*)malloc(sizeof(float)*n);
+	float* data2 = (float*)malloc(sizeof(float)*n);
+	ZC_Init_NULL();
+	executionMode = ZC_OFFLINE;
+	psnrFlag = 1;
+	for(i=0;i<n;i++)
+	{
+		data1[i] = (float)(i%100);
+		data2[i] = data1[i] + 0.01f;
+	}
+	ZC_CompareData* first = ZC_compareData("var.dat", ZC_FLOAT, data1, data2, 0, 0, 0, R2, R1);
+	CU_ASSERT_EQUAL(first->property->valueRange, 99);
+	freeCompareResult_internal(first);
+
+	//new data in the same buffer: the property of the original data is not reused
+	for(i=0;i<n;i++)
+	{
+		data1[i] = (float)(i%100)*1000;
+		data2[i] = data1[i] + 0.01f;
+	}
+	ZC_CompareData* second = ZC_compareData("var.dat", ZC_FLOAT, data1, data2, 0, 0, 0, R2, R1);
+	CU_ASSERT_EQUAL(second->property->valueRange, 99000);
+	CU_ASSERT_EQUAL(second->property->maxValue, 99000);
+	CU_ASSERT_DOUBLE_EQUAL(second->psnr, -20.0*log10(second->rmse/99000), 1E-9);
+	freeCompareResult_internal(second);
+	free(data1);
+	free(data2);
+}
+
+void test_ZC_compareData_metricFlags(void)
+{
+	size_t i, n = R2*R1;
+	float* data1 = (float*)malloc(sizeof(float)*n);
+	float* data2 = (float*)malloc(sizeof(float)*n);
+	ZC_Init_NULL();
+	executionMode = ZC_OFFLINE;
+	pwrErrFlag = pwrErrPDFFlag = 0;
+	pearsonCorrFlag = valErrCorrFlag = errAutoCorrFlag = 0;
+	ZC_resolveMetricPlan(&metricPlan); //as resolved by ZC_ReadConf()
+	CU_ASSERT_EQUAL(metricPlan.statMask, 0);
+	for(i=0;i<n;i++)
+	{
+		data1[i] = 20*sin(i*0.003);
+		data2[i] = data1[i] + 0.01f*(i%3);
+	}
+	
+	//enabled by the program after the initialization
+	pearsonCorrFlag = 1;
+	ZC_CompareData* result = ZC_compareData("var.dat", ZC_FLOAT, data1, data2, 0, 0, 0, R2, R1);
+	CU_ASSERT_EQUAL(metricPlan.statMask, ZC_STAT_MOMENTS);
+	CU_ASSERT(result->pearsonCorr > 0.99 && result->pearsonCorr <= 1);
+	freeCompareResult_internal(result);
+	free(data1);
+	free(data2);
+}
+
+void test_ZC_compareDataFiles_writeProperty(void)
+{
+	size_t i, n = R2*R1;
+	float* data1 = (float*)malloc(sizeof(float)*n);
+	float* data2 = (float*)malloc(sizeof(float)*n);
+	char path1[] = "/tmp/test_dataProperty_ori.f32", path2[] = "/tmp/test_dataProperty_dec.f32";
+	char dir[] = "/tmp/test_dataProperty_ws", propPath[] = "/tmp/test_dataProperty_ws/var.prop";
+	ZC_Init_NULL();
+	executionMode = ZC_OFFLINE;
+	entropyFlag = 1;
+	autocorrFlag = 1;
+	for(i=0;i<n;i++)
+	{
+		data1[i] = 20*sin(i*0.003);
+		data2[i] = data1[i] + 0.01f*(i%3);
+	}
+	ZC_writeFloatData_inBytes(data1, n, path1);
+	ZC_writeFloatData_inBytes(data2, n, path2);
+	ZC_DataProperty* ref = ZC_genProperties_float("var.dat", data1, n, 0, 0, 0, R2, R1);
+	
+	//loaded in one chunk: the flagged properties are computed before the data are freed
+	ZC_CompareData* result = ZC_compareDataFiles("var.dat", ZC_FLOAT, path1, path2, n, 0, 0, 0, R2, R1);
+	CU_ASSERT_PTR_NULL(result->property->data);
+	CU_ASSERT_EQUAL(result->property->pendingMask, 0);
+	CU_ASSERT_EQUAL(result->property->entropy, ref->entropy);
+	CU_ASSERT_PTR_NOT_NULL(result->property->autocorr);
+	unlink(propPath);
+	ZC_writeDataProperty(result->property, dir);
+	CU_ASSERT_EQUAL(access(propPath, F_OK), 0);
+	ZC_requireProperties(result->property, ZC_PROP_ALL); //no data: nothing to compute
+	freeCompareResult_internal(result);
+	
+	//read by chunks
+	result = ZC_compareDataFiles("var.dat", ZC_FLOAT, path1, path2, n/2, 0, 0, 0, R2, R1);
+	CU_ASSERT_EQUAL(result->property->pendingMask, 0);
+	unlink(propPath);
+	ZC_writeDataProperty(result->property, dir);
+	CU_ASSERT_EQUAL(access(propPath, F_OK), 0);
+	freeCompareResult_internal(result);
+	
+	freeDataProperty_internal(ref);
+	unlink(path1);
+	unlink(path2);
+	free(data1);
+	free(data2);
+}
+
+/************* Test Runner Code goes here **************/
+
+int main ( void )
+{
+   CU_pSuite pSuite = NULL;
+
+   /* initialize the CUnit test registry */
+   if ( CUE_SUCCESS != CU_initialize_registry() )
+      return CU_get_error();
+
+   /* add a suite to the registry */
+   pSuite = CU_add_suite( "test_dataProperty_suite", init_suite, clean_suite );
+   if ( NULL == pSuite ) {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   /* add the tests to the suite */
+   if ((NULL == CU_add_test(pSuite, "test_ZC_createDataProperty", test_ZC_createDataProperty)) ||
+       (NULL == CU_add_test(pSuite, "test_ZC_mergePropertyStat", test_ZC_mergePropertyStat)) ||
+       (NULL == CU_add_test(pSuite, "test_ZC_compareData_refill", test_ZC_compareData_refill)) ||
+       (NULL == CU_add_test(pSuite, "test_ZC_compareData_metricFlags", test_ZC_compareData_metricFlags)) ||
+       (NULL == CU_add_test(pSuite, "test_ZC_compareDataFiles_writeProperty", test_ZC_compareDataFiles_writeProperty)))
+   {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   // Run all tests using the basic interface
+   CU_basic_set_mode(CU_BRM_VERBOSE);
+   CU_basic_run_tests();
+   printf("\n");
+   CU_basic_show_failures(CU_get_failure_list());
+   printf("\n\n");
+
+   /* Clean up registry and return */
+   CU_cleanup_registry();
+   return CU_get_error();
+}
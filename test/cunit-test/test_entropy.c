@@ -0,0 +1,147 @@
+#include "CUnit/CUnit.h"
+#include "CUnit/Basic.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>  // for printf
+#include <string.h>
+#include "zc.h"
+
+#define N 1000000
+
+/* Test Suite setup and cleanup functions: */
+
+int init_suite(void) { return 0; }
+int clean_suite(void) { return 0; }
+
+/************* Test case functions ****************/
+
+void test_hash_put(void)
+{
+	HashTable table;
+	unsigned long key;
+	int errors = 0;
+	hash_init(&table, 4);
+	CU_ASSERT_EQUAL(table.size, 16);
+	for(key=0;key<100000;key++)
+		hash_put(&table, key*key, key%7+1);
+	hash_put(&table, 25, 10);
+	CU_ASSERT_EQUAL(table.count, 100000);
+	CU_ASSERT(2*table.count <= table.size);
+	for(key=0;key<100000;key++)
+		if(hash_get(&table, key*key) != (long)(key%7+1) + (key==5 ? 10 : 0))
+			errors++;
+	CU_ASSERT_EQUAL(errors, 0);
+	CU_ASSERT_EQUAL(hash_get(&table, 3), 0);
+	hash_free(&table);
+}
+
+void test_ZC_countBytes(void)
+{
+	unsigned char bytes[1003];
+	long tables[ZC_BYTE_SUBTABLES*256];
+	size_t i;
+	int b, errors = 0;
+	for(i=0;i<sizeof(bytes);i++)
+		bytes[i] = (unsigned char)(i*i%251);
+	memset(tables, 0, sizeof(tables));
+	ZC_countBytes(bytes, sizeof(bytes), tables);
+	for(b=0;b<256;b++)
+	{
+		long count = 0, expected = 0;
+		for(i=0;i<ZC_BYTE_SUBTABLES;i++)
+			count += tables[i*256+b];
+		for(i=0;i<sizeof(bytes);i++)
+			expected += bytes[i]==b;
+		if(count != expected)
+			errors++;
+	}
+	CU_ASSERT_EQUAL(errors, 0);
+}
+
+static double bruteForceEntropy(float* data, size_t n, double min, double errBound)
+{
+	size_t i, j;
+	double entVal = 0, scale = 1/(2*errBound);
+	unsigned long* keys = (unsigned long*)malloc(sizeof(unsigned long)*n);
+	for(i=0;i<n;i++)
+		keys[i] = (unsigned long)((data[i]-min)*scale+0.5);
+	unsigned long maxKey = 0;
+	for(i=0;i<n;i++)
+		if(maxKey<keys[i]) maxKey = keys[i];
+	long* counts = (long*)calloc(maxKey+1, sizeof(long));
+	for(i=0;i<n;i++)
+		counts[keys[i]]++;
+	for(j=0;j<=maxKey;j++)
+		if(counts[j] != 0)
+		{
+			double prob = (double)counts[j]/n;
+			entVal -= prob*log(prob)/log(2);
+		}
+	free(counts);
+	free(keys);
+	return entVal;
+}
+
+void test_ZC_computeQuantEntropy(void)
+{
+	size_t i;
+	float* data = (float*)malloc(sizeof(float)*N);
+	double min = 0, max = 0;
+	for(i=0;i<N;i++)
+	{
+		data[i] = 100*sin(i*1E-4) + 0.01*(i%13);
+		if(min>data[i]) min = data[i];
+		if(max<data[i]) max = data[i];
+	}
+	ZC_setNbThreads(4);
+	//direct bins
+	double e1 = ZC_computeQuantEntropy_float(data, N, min, max-min, 1E-2);
+	CU_ASSERT_DOUBLE_EQUAL(e1, bruteForceEntropy(data, N, min, 1E-2), 1E-10);
+	//hash table (more than ZC_QUANT_DIRECT_BINS possible keys)
+	double e2 = ZC_computeQuantEntropy_float(data, N, min, max-min, 1E-5);
+	CU_ASSERT_DOUBLE_EQUAL(e2, bruteForceEntropy(data, N, min, 1E-5), 1E-10);
+	//the same result with one thread
+	ZC_setNbThreads(1);
+	CU_ASSERT_EQUAL(ZC_computeQuantEntropy_float(data, N, min, max-min, 1E-5), e2);
+	CU_ASSERT_EQUAL(ZC_computeQuantEntropy_float(data, N, min, 0, 1E-5), 0);
+	free(data);
+}
+
+/************* Test Runner Code goes here **************/
+
+int main ( void )
+{
+   CU_pSuite pSuite = NULL;
+
+   /* initialize the CUnit test registry */
+   if ( CUE_SUCCESS != CU_initialize_registry() )
+      return CU_get_error();
+
+   /* add a suite to the registry */
+   pSuite = CU_add_suite( "test_entropy_suite", init_suite, clean_suite );
+   if ( NULL == pSuite ) {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   /* add the tests to the suite */
+   if ((NULL == CU_add_test(pSuite, "test_hash_put", test_hash_put)) ||
+       (NULL == CU_add_test(pSuite, "test_ZC_countBytes", test_ZC_countBytes)) ||
+       (NULL == CU_add_test(pSuite, "test_ZC_computeQuantEntropy", test_ZC_computeQuantEntropy)))
+   {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   // Run all tests using the basic interface
+   CU_basic_set_mode(CU_BRM_VERBOSE);
+   CU_basic_run_tests();
+   printf("\n");
+   CU_basic_show_failures(CU_get_failure_list());
+   printf("\n\n");
+
+   /* Clean up registry and return */
+   CU_cleanup_registry();
+   return CU_get_error();
+}
@@ -0,0 +1,118 @@
+#include "CUnit/CUnit.h"
+#include "CUnit/Basic.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>  // for printf
+#include <string.h>
+#include "zc.h"
+#include "ZC_ErrMap.h"
+
+#define R3 37
+#define R2 21
+#define R1 45
+
+/* Test Suite setup and cleanup functions: */
+
+int init_suite(void) { return 0; }
+int clean_suite(void) { return 0; }
+
+/************* Test case functions ****************/
+
+void test_ZC_computeErrMap(void)
+{
+	size_t i, j, k, n = R3*R2*R1, offset, len;
+	float* data1 = (float*)malloc(sizeof(float)*n);
+	float* data2 = (float*)malloc(sizeof(float)*n);
+	for(i=0;i<n;i++)
+	{
+		data1[i] = (float)(100 + sin(i*0.01));
+		data2[i] = data1[i] + (float)(cos(i*0.37)*1e-3*(1+i%R1));
+	}
+
+	size_t tile[5];
+	ZC_parseErrMapTile("8 5 16", tile);
+	memcpy(errMapTile, tile, sizeof(tile));
+	ZC_ErrMap* map = ZC_computeErrMap_float(data1, data2, 2, 0, 0, R3, R2, R1);
+	CU_ASSERT_EQUAL(map->dims[0], 6);
+	CU_ASSERT_EQUAL(map->dims[1], 5);
+	CU_ASSERT_EQUAL(map->dims[2], 3);
+	CU_ASSERT_EQUAL(map->nbTiles, 90);
+
+	//the last tile of every dimension is cut by the data
+	size_t t = map->nbTiles-1;
+	double maxErr = 0, sum = 0, sum2 = 0, count = 0;
+	for(k=32;k<R3;k++)
+		for(j=20;j<R2;j++)
+			for(i=40;i<R1;i++)
+			{
+				double diff = data2[(k*R2+j)*R1+i]-data1[(k*R2+j)*R1+i];
+				if(maxErr<fabs(diff))
+					maxErr = fabs(diff);
+				sum += diff;
+				sum2 += diff*diff;
+				count++;
+			}
+	CU_ASSERT_DOUBLE_EQUAL(map->maxAbsErr[t], maxErr, 1E-12);
+	CU_ASSERT_DOUBLE_EQUAL(map->bias[t], sum/count, 1E-12);
+	CU_ASSERT_DOUBLE_EQUAL(map->rmse[t], sqrt(sum2/count), 1E-12);
+	CU_ASSERT_DOUBLE_EQUAL(map->psnr[t], 20*log10(2/sqrt(sum2/count)), 1E-9);
+
+	//streaming the data in chunks that cut the rows and the tiles gives the same map
+	ZC_ErrMap* map2 = ZC_constructErrMap(0, 0, R3, R2, R1);
+	for(offset=0, len=13;offset<n;offset+=len, len=len*2+7)
+	{
+		if(len>n-offset)
+			len = n-offset;
+		ZC_updateErrMap_float(map2, data1+offset, data2+offset, offset, len);
+	}
+	ZC_finalizeErrMap(map2, 2);
+	for(i=0;i<map->nbTiles;i++)
+	{
+		CU_ASSERT_EQUAL(map2->maxAbsErr[i], map->maxAbsErr[i]);
+		CU_ASSERT_DOUBLE_EQUAL(map2->rmse[i], map->rmse[i], 1E-12);
+		CU_ASSERT_DOUBLE_EQUAL(map2->ssim[i], map->ssim[i], 1E-12);
+	}
+
+	memset(errMapTile, 0, sizeof(errMapTile));
+	ZC_freeErrMap(map);
+	ZC_freeErrMap(map2);
+	free(data1);
+	free(data2);
+}
+
+/************* Test Runner Code goes here **************/
+
+int main ( void )
+{
+   CU_pSuite pSuite = NULL;
+
+   /* initialize the CUnit test registry */
+   if ( CUE_SUCCESS != CU_initialize_registry() )
+      return CU_get_error();
+
+   /* add a suite to the registry */
+   pSuite = CU_add_suite( "test_errmap_suite", init_suite, clean_suite );
+   if ( NULL == pSuite ) {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   /* add the tests to the suite */
+   if (NULL == CU_add_test(pSuite, "test_ZC_computeErrMap", test_ZC_computeErrMap))
+   {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   // Run all tests using the basic interface
+   CU_basic_set_mode(CU_BRM_VERBOSE);
+   CU_basic_run_tests();
+   printf("\n");
+   CU_basic_show_failures(CU_get_failure_list());
+   printf("\n\n");
+
+   /* Clean up registry and return */
+   CU_cleanup_registry();
+   return CU_get_error();
+}
@@ -0,0 +1,158 @@
+#include "CUnit/CUnit.h"
+#include "CUnit/Basic.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>  // for printf
+#include <string.h>
+#include "zc.h"
+#include "ZC_fft.h"
+
+#define TEST_SIZE 512
+
+/* Test Suite setup and cleanup functions: */
+
+int init_suite(void) { return 0; }
+int clean_suite(void) { return 0; }
+
+/************* Test case functions ****************/
+
+void test_ZC_fftReal(void)
+{
+	size_t i, k, n;
+	float data[TEST_SIZE];
+	double re[TEST_SIZE/2+1], im[TEST_SIZE/2+1];
+	for(i=0;i<TEST_SIZE;i++)
+		data[i] = (float)(sin(i*0.05) + (i%5)*0.1);
+
+	for(n=1;n<=TEST_SIZE;n*=2)
+	{
+		ZC_fftReal(data, ZC_FLOAT, n, re, im);
+		for(k=0;k<=n/2;k++) //against the DFT
+		{
+			double sr = 0, si = 0;
+			for(i=0;i<n;i++)
+			{
+				sr += data[i]*cos(2*PI*i*k/n);
+				si -= data[i]*sin(2*PI*i*k/n);
+			}
+			CU_ASSERT_DOUBLE_EQUAL(re[k], sr, 1E-9);
+			CU_ASSERT_DOUBLE_EQUAL(im[k], si, 1E-9);
+		}
+	}
+
+	//the coefficients do not depend on the number of threads
+	size_t N = 1<<21;
+	float* big = (float*)malloc(sizeof(float)*N);
+	double* re1 = (double*)malloc(sizeof(double)*(N/2+1));
+	double* im1 = (double*)malloc(sizeof(double)*(N/2+1));
+	double* re4 = (double*)malloc(sizeof(double)*(N/2+1));
+	double* im4 = (double*)malloc(sizeof(double)*(N/2+1));
+	for(i=0;i<N;i++)
+		big[i] = (float)cos(i*1e-3);
+	ZC_fftReal(big, ZC_FLOAT, N, re1, im1);
+	ZC_setNbThreads(4);
+	ZC_fftReal(big, ZC_FLOAT, N, re4, im4);
+	ZC_setNbThreads(1);
+	CU_ASSERT(memcmp(re1, re4, sizeof(double)*(N/2+1))==0);
+	CU_ASSERT(memcmp(im1, im4, sizeof(double)*(N/2+1))==0);
+	free(big);
+	free(re1);
+	free(im1);
+	free(re4);
+	free(im4);
+	ZC_freeFFTTwiddles();
+}
+
+void test_ZC_fftRealLowBins(void)
+{
+	size_t i, k, n;
+	size_t N = 1<<16, K = 128;
+	double* data = (double*)malloc(sizeof(double)*N);
+	double* re = (double*)malloc(sizeof(double)*(N/2+1));
+	double* im = (double*)malloc(sizeof(double)*(N/2+1));
+	double lre[128], lim[128];
+	for(i=0;i<N;i++)
+		data[i] = sin(i*0.01) + (i%13)*0.01;
+
+	for(n=16;n<=N;n*=64) //n < K: periodic extension of the whole spectrum
+	{
+		ZC_fftReal(data, ZC_DOUBLE, n, re, im);
+		ZC_fftRealLowBins(data, ZC_DOUBLE, n, K, lre, lim);
+		for(k=0;k<K;k++)
+		{
+			size_t j = k%n;
+			CU_ASSERT_DOUBLE_EQUAL(lre[k], j<=n/2 ? re[j] : re[n-j], 1E-9);
+			CU_ASSERT_DOUBLE_EQUAL(lim[k], j<=n/2 ? im[j] : -im[n-j], 1E-9);
+		}
+	}
+	free(data);
+	free(re);
+	free(im);
+}
+
+void test_fft_ifft(void)
+{
+	size_t i;
+	complex v[TEST_SIZE], tmp[TEST_SIZE];
+	for(i=0;i<TEST_SIZE;i++)
+	{
+		v[i].Re = sin(i*0.3);
+		v[i].Im = cos(i*0.7);
+	}
+	fft(v, TEST_SIZE, tmp);
+	double sr = 0, si = 0; //X[3]
+	for(i=0;i<TEST_SIZE;i++)
+	{
+		double c = cos(2*PI*i*3/TEST_SIZE), s = sin(2*PI*i*3/TEST_SIZE);
+		sr += sin(i*0.3)*c + cos(i*0.7)*s;
+		si += cos(i*0.7)*c - sin(i*0.3)*s;
+	}
+	CU_ASSERT_DOUBLE_EQUAL(v[3].Re, sr, 1E-9);
+	CU_ASSERT_DOUBLE_EQUAL(v[3].Im, si, 1E-9);
+
+	ifft(v, TEST_SIZE, tmp); //not normalized
+	for(i=0;i<TEST_SIZE;i++)
+	{
+		CU_ASSERT_DOUBLE_EQUAL(v[i].Re/TEST_SIZE, sin(i*0.3), 1E-12);
+		CU_ASSERT_DOUBLE_EQUAL(v[i].Im/TEST_SIZE, cos(i*0.7), 1E-12);
+	}
+}
+
+/************* Test Runner Code goes here **************/
+
+int main ( void )
+{
+   CU_pSuite pSuite = NULL;
+
+   /* initialize the CUnit test registry */
+   if ( CUE_SUCCESS != CU_initialize_registry() )
+      return CU_get_error();
+
+   /* add a suite to the registry */
+   pSuite = CU_add_suite( "test_fft_suite", init_suite, clean_suite );
+   if ( NULL == pSuite ) {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   /* add the tests to the suite */
+   if ((NULL == CU_add_test(pSuite, "test_ZC_fftReal", test_ZC_fftReal)) ||
+       (NULL == CU_add_test(pSuite, "test_ZC_fftRealLowBins", test_ZC_fftRealLowBins)) ||
+       (NULL == CU_add_test(pSuite, "test_fft_ifft", test_fft_ifft)))
+   {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   // Run all tests using the basic interface
+   CU_basic_set_mode(CU_BRM_VERBOSE);
+   CU_basic_run_tests();
+   printf("\n");
+   CU_basic_show_failures(CU_get_failure_list());
+   printf("\n\n");
+
+   /* Clean up registry and return */
+   CU_cleanup_registry();
+   return CU_get_error();
+}
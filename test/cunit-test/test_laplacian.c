@@ -0,0 +1,146 @@
+#include "CUnit/CUnit.h"
+#include "CUnit/Basic.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>  // for printf
+#include <string.h>
+#include "zc.h"
+
+/* Test Suite setup and cleanup functions: */
+
+int init_suite(void) { return 0; }
+int clean_suite(void) { return 0; }
+
+/************* Test case functions ****************/
+
+static size_t clampIndex(size_t i, size_t n)
+{
+	if(n < 3)
+		return i;
+	return i < 1 ? 1 : (i > n-2 ? n-2 : i);
+}
+
+/*point by point: the sum over the dimensions (of size >= 3) of f[i-1]-2f[i]+f[i+1] at the clamped point*/
+static void referenceLaplacian(float* data, double* lap, size_t* n)
+{
+	size_t idx, total = n[0]*n[1]*n[2]*n[3]*n[4];
+	int d;
+	for(idx=0;idx<total;idx++)
+	{
+		size_t c[5], q = idx, center = 0, stride = 1;
+		size_t strides[5];
+		for(d=0;d<5;d++)
+		{
+			c[d] = clampIndex(q%n[d], n[d]);
+			q /= n[d];
+			strides[d] = stride;
+			center += c[d]*stride;
+			stride *= n[d];
+		}
+		double v = n[0] >= 3 ? (double)data[center-1] - 2*(double)data[center] + (double)data[center+1] : 0;
+		for(d=1;d<5;d++)
+			if(n[d] >= 3)
+				v += (double)data[center-strides[d]] - 2*(double)data[center] + (double)data[center+strides[d]];
+		lap[idx] = v;
+	}
+}
+
+static int checkLaplacian(size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
+{
+	size_t n[5] = {r1, r2 ? r2 : 1, r3 ? r3 : 1, r4 ? r4 : 1, r5 ? r5 : 1};
+	size_t i, total = n[0]*n[1]*n[2]*n[3]*n[4];
+	int errors = 0;
+	float* data = (float*)malloc(sizeof(float)*total);
+	double* lap = (double*)malloc(sizeof(double)*total);
+	double* ref = (double*)malloc(sizeof(double)*total);
+	for(i=0;i<total;i++)
+		data[i] = sin(i*0.37) + (i%17)*0.25;
+	ZC_computeLaplacian_float(data, lap, r5, r4, r3, r2, r1);
+	referenceLaplacian(data, ref, n);
+	for(i=0;i<total;i++)
+		if(lap[i] != ref[i])
+			errors++;
+	free(data);
+	free(lap);
+	free(ref);
+	return errors;
+}
+
+void test_ZC_computeLaplacian(void)
+{
+	ZC_setNbThreads(4);
+	CU_ASSERT_EQUAL(checkLaplacian(0, 0, 0, 0, 1000), 0);
+	CU_ASSERT_EQUAL(checkLaplacian(0, 0, 0, 0, 600000), 0); //several blocks of columns
+	CU_ASSERT_EQUAL(checkLaplacian(0, 0, 0, 700, 1025), 0); //several blocks of rows and tiles
+	CU_ASSERT_EQUAL(checkLaplacian(0, 0, 0, 2, 50), 0);
+	CU_ASSERT_EQUAL(checkLaplacian(0, 0, 13, 20, 30), 0);
+	CU_ASSERT_EQUAL(checkLaplacian(0, 5, 6, 7, 8), 0);
+	CU_ASSERT_EQUAL(checkLaplacian(4, 3, 5, 6, 7), 0);
+	CU_ASSERT_EQUAL(checkLaplacian(3, 1, 5, 6, 7), 0);
+	ZC_setNbThreads(1);
+	CU_ASSERT_EQUAL(checkLaplacian(4, 3, 5, 6, 7), 0);
+}
+
+void test_computeLap(void)
+{
+	//the double interface gives the same results as the float one on the same values
+	size_t i, n = 20*30*40;
+	float* data = (float*)malloc(sizeof(float)*n);
+	double* ddata = (double*)malloc(sizeof(double)*n);
+	double* lap1 = (double*)malloc(sizeof(double)*n);
+	double* lap2 = (double*)malloc(sizeof(double)*n);
+	int errors = 0;
+	for(i=0;i<n;i++)
+	{
+		data[i] = cos(i*0.01)*100;
+		ddata[i] = data[i];
+	}
+	ZC_computeLaplacian_float(data, lap1, 0, 0, 20, 30, 40);
+	computeLap(ddata, lap2, 0, 0, 20, 30, 40);
+	for(i=0;i<n;i++)
+		if(lap1[i] != lap2[i])
+			errors++;
+	CU_ASSERT_EQUAL(errors, 0);
+	free(data);
+	free(ddata);
+	free(lap1);
+	free(lap2);
+}
+
+/************* Test Runner Code goes here **************/
+
+int main ( void )
+{
+   CU_pSuite pSuite = NULL;
+
+   /* initialize the CUnit test registry */
+   if ( CUE_SUCCESS != CU_initialize_registry() )
+      return CU_get_error();
+
+   /* add a suite to the registry */
+   pSuite = CU_add_suite( "test_laplacian_suite", init_suite, clean_suite );
+   if ( NULL == pSuite ) {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   /* add the tests to the suite */
+   if ((NULL == CU_add_test(pSuite, "test_ZC_computeLaplacian", test_ZC_computeLaplacian)) ||
+       (NULL == CU_add_test(pSuite, "test_computeLap", test_computeLap)))
+   {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   // Run all tests using the basic interface
+   CU_basic_set_mode(CU_BRM_VERBOSE);
+   CU_basic_run_tests();
+   printf("\n");
+   CU_basic_show_failures(CU_get_failure_list());
+   printf("\n\n");
+
+   /* Clean up registry and return */
+   CU_cleanup_registry();
+   return CU_get_error();
+}
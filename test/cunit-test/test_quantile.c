@@ -0,0 +1,157 @@
+#include "CUnit/CUnit.h"
+#include "CUnit/Basic.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>  // for printf
+#include <string.h>
+#include "zc.h"
+
+#define N 1000000
+
+/* Test Suite setup and cleanup functions: */
+
+int init_suite(void) { return 0; }
+int clean_suite(void) { return 0; }
+
+/************* Test case functions ****************/
+
+static int compareDouble(const void* a, const void* b)
+{
+	double x = *(const double*)a, y = *(const double*)b;
+	return x < y ? -1 : (x > y ? 1 : 0);
+}
+
+/*number of quantiles of the sketch farther than 1/64 from the exact ones*/
+static int countQuantileErrors(ZC_QuantileSketch* sketch, double* sorted, size_t n, double* q, int count)
+{
+	int i, errors = 0;
+	for(i=0;i<count;i++)
+	{
+		double exact = sorted[(size_t)(q[i]*(n-1))];
+		if(fabs(ZC_getSketchQuantile(sketch, q[i]) - exact) > fabs(exact)/64)
+			errors++;
+	}
+	return errors;
+}
+
+void test_ZC_QuantileSketch(void)
+{
+	size_t i;
+	double* values = (double*)malloc(sizeof(double)*N);
+	ZC_QuantileSketch* sketch = ZC_createQuantileSketch();
+	ZC_QuantileSketch* parts = ZC_createQuantileSketches(3);
+	srand(11);
+	for(i=0;i<N;i++)
+	{
+		//heavy-tailed values of both signs, with some zeros
+		double u = (double)rand()/RAND_MAX;
+		values[i] = i%50==0 ? 0 : (u-0.3)*exp(8*(double)rand()/RAND_MAX);
+		ZC_addSketchValue(sketch, values[i]);
+		ZC_addSketchValue(&parts[i%3], values[i]);
+	}
+	qsort(values, N, sizeof(double), compareDouble);
+
+	CU_ASSERT_EQUAL(sketch->n, N);
+	CU_ASSERT_EQUAL(sketch->zeroCount, N/50);
+	CU_ASSERT_EQUAL(ZC_getSketchQuantile(sketch, 0), values[0]);
+	CU_ASSERT_EQUAL(ZC_getSketchQuantile(sketch, 1), values[N-1]);
+	CU_ASSERT_EQUAL(countQuantileErrors(sketch, values, N, ZC_valueQuantiles, ZC_VALUE_QUANTILE_COUNT), 0);
+	CU_ASSERT_EQUAL(countQuantileErrors(sketch, values, N, ZC_errQuantiles, ZC_ERR_QUANTILE_COUNT), 0);
+
+	//the merge is exact, in any order
+	ZC_mergeQuantileSketch(&parts[2], &parts[0]);
+	ZC_mergeQuantileSketch(&parts[2], &parts[1]);
+	CU_ASSERT_EQUAL(memcmp(&parts[2], sketch, sizeof(ZC_QuantileSketch)), 0);
+
+	//magnitudes far below the largest one are merged into the lowest bin
+	ZC_QuantileSketch* wide = ZC_createQuantileSketch();
+	for(i=0;i<1000;i++)
+		ZC_addSketchValue(wide, ldexp(1.5, -(int)(i%100)));
+	CU_ASSERT_EQUAL(wide->positive.maxIndex, ZC_getSketchIndex(1.5));
+	CU_ASSERT_EQUAL(wide->positive.counts[0], 10*(100-ZC_SKETCH_BINS/ZC_SKETCH_BINS_PER_OCTAVE));
+	CU_ASSERT_DOUBLE_EQUAL(ZC_getSketchQuantile(wide, 0.999), 1.5, 1.5/64);
+
+	ZC_freeQuantileSketch(wide);
+	free(parts);
+	ZC_freeQuantileSketch(sketch);
+	free(values);
+}
+
+void test_ZC_addErrSketches(void)
+{
+	size_t i, n_rel = 0;
+	float* data1 = (float*)malloc(sizeof(float)*N);
+	float* data2 = (float*)malloc(sizeof(float)*N);
+	double* absErr = (double*)malloc(sizeof(double)*N);
+	double* pwrErr = (double*)malloc(sizeof(double)*N);
+	srand(5);
+	for(i=0;i<N;i++)
+	{
+		data1[i] = i%1000==0 ? 0 : 100*sin(i*0.001);
+		data2[i] = data1[i] + 0.01*((double)rand()/RAND_MAX-0.5)*(i%997==0 ? 100 : 1);
+		absErr[i] = fabs((double)data2[i]-data1[i]);
+		if(data1[i]!=0)
+			pwrErr[n_rel++] = absErr[i]/fabs(data1[i]);
+	}
+	qsort(absErr, N, sizeof(double), compareDouble);
+	qsort(pwrErr, n_rel, sizeof(double), compareDouble);
+
+	ZC_QuantileSketch* sketches = ZC_createQuantileSketches(4);
+	ZC_setNbThreads(4);
+	ZC_addErrSketches_float(&sketches[0], &sketches[1], data1, data2, N);
+	ZC_setNbThreads(1);
+	ZC_addErrSketches_float(&sketches[2], &sketches[3], data1, data2, N);
+
+	CU_ASSERT_EQUAL(sketches[0].n, N);
+	CU_ASSERT_EQUAL(sketches[1].n, n_rel);
+	CU_ASSERT_EQUAL(countQuantileErrors(&sketches[0], absErr, N, ZC_errQuantiles, ZC_ERR_QUANTILE_COUNT), 0);
+	CU_ASSERT_EQUAL(countQuantileErrors(&sketches[1], pwrErr, n_rel, ZC_errQuantiles, ZC_ERR_QUANTILE_COUNT), 0);
+	CU_ASSERT_EQUAL(ZC_getSketchQuantile(&sketches[0], 1), absErr[N-1]);
+
+	//the results do not depend on the number of threads
+	CU_ASSERT_EQUAL(memcmp(&sketches[0], &sketches[2], 2*sizeof(ZC_QuantileSketch)), 0);
+
+	free(sketches);
+	free(data1);
+	free(data2);
+	free(absErr);
+	free(pwrErr);
+}
+
+/************* Test Runner Code goes here **************/
+
+int main ( void )
+{
+   CU_pSuite pSuite = NULL;
+
+   /* initialize the CUnit test registry */
+   if ( CUE_SUCCESS != CU_initialize_registry() )
+      return CU_get_error();
+
+   /* add a suite to the registry */
+   pSuite = CU_add_suite( "test_quantile_suite", init_suite, clean_suite );
+   if ( NULL == pSuite ) {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   /* add the tests to the suite */
+   if ((NULL == CU_add_test(pSuite, "test_ZC_QuantileSketch", test_ZC_QuantileSketch)) ||
+       (NULL == CU_add_test(pSuite, "test_ZC_addErrSketches", test_ZC_addErrSketches)))
+   {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   // Run all tests using the basic interface
+   CU_basic_set_mode(CU_BRM_VERBOSE);
+   CU_basic_run_tests();
+   printf("\n");
+   CU_basic_show_failures(CU_get_failure_list());
+   printf("\n\n");
+
+   /* Clean up registry and return */
+   CU_cleanup_registry();
+   return CU_get_error();
+}
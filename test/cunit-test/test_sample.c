@@ -0,0 +1,123 @@
+#include "CUnit/CUnit.h"
+#include "CUnit/Basic.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>  // for printf
+#include <string.h>
+#include "zc.h"
+#include "ZC_sample.h"
+
+#define TEST_SIZE (1000*ZC_SAMPLE_BLOCK_SIZE+123)
+
+/* Test Suite setup and cleanup functions: */
+
+int init_suite(void) { return 0; }
+int clean_suite(void) { return 0; }
+
+/************* Test case functions ****************/
+
+void test_ZC_selectSampleBlocks(void)
+{
+	size_t j, nbSampled, nbSampled2;
+	size_t nbBlocks = ZC_computeSampleBlockCount(TEST_SIZE);
+	CU_ASSERT_EQUAL(nbBlocks, 1001);
+	CU_ASSERT_EQUAL(ZC_getSampleBlockLength(TEST_SIZE, nbBlocks-1), 123);
+
+	size_t* blocks = ZC_selectSampleBlocks(TEST_SIZE, 0.05, 7, &nbSampled);
+	CU_ASSERT_PTR_NOT_NULL(blocks);
+	if(blocks==NULL)
+		return;
+	CU_ASSERT_EQUAL(nbSampled, 51);
+	for(j=0;j<nbSampled;j++) //one block in each stratum
+	{
+		CU_ASSERT(blocks[j] >= j*nbBlocks/nbSampled);
+		CU_ASSERT(blocks[j] < (j+1)*nbBlocks/nbSampled);
+	}
+
+	//the same seed gives the same sample
+	size_t* blocks2 = ZC_selectSampleBlocks(TEST_SIZE, 0.05, 7, &nbSampled2);
+	CU_ASSERT_EQUAL(nbSampled2, nbSampled);
+	CU_ASSERT(memcmp(blocks, blocks2, sizeof(size_t)*nbSampled)==0);
+	free(blocks);
+	free(blocks2);
+
+	//no sampling for the exact mode or tiny data
+	CU_ASSERT_PTR_NULL(ZC_selectSampleBlocks(TEST_SIZE, 1, 7, &nbSampled));
+	CU_ASSERT_EQUAL(nbSampled, nbBlocks);
+	CU_ASSERT_PTR_NULL(ZC_selectSampleBlocks(2*ZC_SAMPLE_BLOCK_SIZE, 0.1, 7, &nbSampled));
+}
+
+void test_ZC_estimateRatio(void)
+{
+	size_t j, nbSampled, i;
+	double halfWidth, sum = 0;
+	float* data = (float*)malloc(sizeof(float)*TEST_SIZE);
+	for(i=0;i<TEST_SIZE;i++)
+	{
+		data[i] = (float)(fabs(sin(i*1e-4))*1e-3 + (i%17)*1e-5);
+		sum += data[i];
+	}
+
+	size_t* blocks = ZC_selectSampleBlocks(TEST_SIZE, 0.1, 3, &nbSampled);
+	size_t* lengths = (size_t*)malloc(sizeof(size_t)*nbSampled);
+	float** pointers = (float**)ZC_getSampleBlockPointers(data, sizeof(float), TEST_SIZE, blocks, nbSampled, lengths);
+	ZC_RatioSums s;
+	ZC_initRatioSums(&s);
+	for(j=0;j<nbSampled;j++)
+	{
+		double blockSum = 0;
+		for(i=0;i<lengths[j];i++)
+			blockSum += pointers[j][i];
+		ZC_addRatioSample(&s, blockSum, lengths[j]);
+	}
+	double mean = ZC_estimateRatio(&s, nbSampled, ZC_computeSampleBlockCount(TEST_SIZE), &halfWidth);
+	CU_ASSERT(halfWidth > 0);
+	CU_ASSERT(fabs(mean - sum/TEST_SIZE) <= halfWidth);
+
+	//the whole data: exact, no interval
+	ZC_estimateRatio(&s, nbSampled, nbSampled, &halfWidth);
+	CU_ASSERT_EQUAL(halfWidth, 0);
+
+	free(pointers);
+	free(lengths);
+	free(blocks);
+	free(data);
+}
+
+/************* Test Runner Code goes here **************/
+
+int main ( void )
+{
+   CU_pSuite pSuite = NULL;
+
+   /* initialize the CUnit test registry */
+   if ( CUE_SUCCESS != CU_initialize_registry() )
+      return CU_get_error();
+
+   /* add a suite to the registry */
+   pSuite = CU_add_suite( "test_sample_suite", init_suite, clean_suite );
+   if ( NULL == pSuite ) {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   /* add the tests to the suite */
+   if ((NULL == CU_add_test(pSuite, "test_ZC_selectSampleBlocks", test_ZC_selectSampleBlocks)) ||
+       (NULL == CU_add_test(pSuite, "test_ZC_estimateRatio", test_ZC_estimateRatio)))
+   {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   // Run all tests using the basic interface
+   CU_basic_set_mode(CU_BRM_VERBOSE);
+   CU_basic_run_tests();
+   printf("\n");
+   CU_basic_show_failures(CU_get_failure_list());
+   printf("\n\n");
+
+   /* Clean up registry and return */
+   CU_cleanup_registry();
+   return CU_get_error();
+}
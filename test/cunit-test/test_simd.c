@@ -0,0 +1,106 @@
+#include "CUnit/CUnit.h"
+#include "CUnit/Basic.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>  // for printf
+#include "zc.h"
+
+#define TEST_SIZE 4099
+
+/* Test Suite setup and cleanup functions: */
+
+int init_suite(void) { return 0; }
+int clean_suite(void) { return 0; }
+
+/************* Test case functions ****************/
+
+void test_ZC_selectKernels(void)
+{
+	ZC_selectKernels(ZC_SIMD_SCALAR, 0);
+	CU_ASSERT_EQUAL(ZC_getKernels()->type, ZC_SIMD_SCALAR);
+	ZC_selectKernels(ZC_SIMD_AUTO, 0);
+	CU_ASSERT_EQUAL(ZC_getKernels()->type, ZC_detectSimdKernelType());
+	CU_ASSERT_EQUAL(ZC_parseSimdKernelType("AVX2"), ZC_SIMD_AVX2);
+}
+
+void test_ZC_kernels_validation(void)
+{
+	size_t i;
+	float* data1 = (float*)malloc(sizeof(float)*TEST_SIZE);
+	float* data2 = (float*)malloc(sizeof(float)*TEST_SIZE);
+	for(i=0;i<TEST_SIZE;i++)
+	{
+		data1[i] = i%5==0 ? 0 : sin(i*0.01)*100;
+		data2[i] = data1[i] + cos(i*0.37)*1e-2;
+	}
+	
+	//every kernel call of the best instruction set is checked against the scalar reference
+	ZC_selectKernels(ZC_SIMD_AUTO, 1);
+	ZC_Kernels* kernels = ZC_getKernels();
+	ZC_DiffSums ds;
+	ZC_RelSums rs;
+	ZC_CoMoments cm;
+	double min, max, sum, maxErr;
+	kernels->diffSums_float(data1, data2, TEST_SIZE, &ds);
+	kernels->relSums_float(data1, data2, TEST_SIZE, &rs);
+	kernels->coMoments_float(data1, data2, TEST_SIZE, ds.sum1/TEST_SIZE, ds.sum2/TEST_SIZE, ds.sumDiff/TEST_SIZE, &cm);
+	kernels->valueSums_float(data1, TEST_SIZE, &min, &max, &sum);
+	kernels->sqDevSum_float(data1, TEST_SIZE, sum/TEST_SIZE);
+	size_t nbAnd = kernels->boundViolations_float(data1, data2, TEST_SIZE, 5E-3, 1E-4, 1, &maxErr);
+	size_t nbOr = kernels->boundViolations_float(data1, data2, TEST_SIZE, 5E-3, 1E-4, 0, &maxErr);
+	CU_ASSERT_EQUAL(simdValidationErrors, 0);
+	CU_ASSERT(nbOr > 0 && nbOr < nbAnd);
+	CU_ASSERT_EQUAL(maxErr, ds.maxErr);
+	CU_ASSERT_EQUAL(rs.n_rel, TEST_SIZE - (TEST_SIZE+4)/5);
+	CU_ASSERT_DOUBLE_EQUAL(ds.sum1, sum, 1E-9);
+	
+	//the kernels are also checked in the worker threads of the compare
+	ZC_CompareStat stat;
+	ZC_setNbThreads(4);
+	ZC_computeCompareStat_float(&stat, data1, data2, TEST_SIZE);
+	ZC_setNbThreads(1);
+	CU_ASSERT_EQUAL(simdValidationErrors, 0);
+	CU_ASSERT_EQUAL(stat.maxErr, ds.maxErr);
+	ZC_selectKernels(ZC_SIMD_AUTO, 0);
+	
+	free(data1);
+	free(data2);
+}
+
+/************* Test Runner Code goes here **************/
+
+int main ( void )
+{
+   CU_pSuite pSuite = NULL;
+
+   /* initialize the CUnit test registry */
+   if ( CUE_SUCCESS != CU_initialize_registry() )
+      return CU_get_error();
+
+   /* add a suite to the registry */
+   pSuite = CU_add_suite( "test_simd_suite", init_suite, clean_suite );
+   if ( NULL == pSuite ) {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   /* add the tests to the suite */
+   if ((NULL == CU_add_test(pSuite, "test_ZC_selectKernels", test_ZC_selectKernels)) ||
+       (NULL == CU_add_test(pSuite, "test_ZC_kernels_validation", test_ZC_kernels_validation)))
+   {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   // Run all tests using the basic interface
+   CU_basic_set_mode(CU_BRM_VERBOSE);
+   CU_basic_run_tests();
+   printf("\n");
+   CU_basic_show_failures(CU_get_failure_list());
+   printf("\n\n");
+
+   /* Clean up registry and return */
+   CU_cleanup_registry();
+   return CU_get_error();
+}
@@ -0,0 +1,340 @@
+#include "CUnit/CUnit.h"
+#include "CUnit/Basic.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>  // for printf
+#include <string.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "zc.h"
+#include "ZC_ssim.h"
+
+/* Test Suite setup and cleanup functions: */
+
+int init_suite(void) { return 0; }
+int clean_suite(void) { return 0; }
+
+/************* Test case functions ****************/
+
+/*mean of the per-pixel windows (zc_get_ssim_double())*/
+static double computeReferenceSsim(double* org, double* rec, size_t H, size_t W)
+{
+	size_t i, x, y;
+	double min = org[0], max = org[0], sum = 0;
+	for(i=0;i<H*W;i++)
+	{
+		if(min>org[i]) min = org[i];
+		if(max<org[i]) max = org[i];
+	}
+	for(y=0;y<H;y++)
+		for(x=0;x<W;x++)
+			sum += zc_get_ssim_double(org, rec, x, y, W, H, max-min);
+	return sum/(H*W);
+}
+
+static void genImage(double* org, double* rec, float* orgf, float* recf, size_t H, size_t W, double noise)
+{
+	size_t x, y;
+	srand(3);
+	for(y=0;y<H;y++)
+		for(x=0;x<W;x++)
+		{
+			size_t i = y*W+x;
+			org[i] = 100 + 50*sin(x*0.05)*cos(y*0.03) + 5*((double)rand()/RAND_MAX);
+			rec[i] = org[i] + noise*((double)rand()/RAND_MAX-0.5);
+			orgf[i] = org[i];
+			recf[i] = rec[i];
+		}
+}
+
+void test_zc_calc_ssim_2d(void)
+{
+	size_t sizes[5][2] = {{300, 257}, {64, 64}, {5, 40}, {130, 3}, {1, 9}};
+	int k;
+	for(k=0;k<5;k++)
+	{
+		size_t H = sizes[k][0], W = sizes[k][1];
+		double* org = (double*)malloc(sizeof(double)*H*W);
+		double* rec = (double*)malloc(sizeof(double)*H*W);
+		float* orgf = (float*)malloc(sizeof(float)*H*W);
+		float* recf = (float*)malloc(sizeof(float)*H*W);
+		genImage(org, rec, orgf, recf, H, W, 2);
+
+		double ref = computeReferenceSsim(org, rec, H, W);
+		ZC_setNbThreads(1);
+		double ssim = zc_calc_ssim_2d_double(org, rec, H, W);
+		ZC_setNbThreads(4);
+		double ssim4 = zc_calc_ssim_2d_double(org, rec, H, W);
+		CU_ASSERT_DOUBLE_EQUAL(ssim, ref, 1E-12);
+		CU_ASSERT_EQUAL(ssim, ssim4);
+		CU_ASSERT(ssim < 1 && ssim > 0.5);
+
+		//the float data are filtered in double precision too
+		genImage(org, rec, orgf, recf, H, W, 2);
+		for(size_t i=0;i<H*W;i++)
+		{
+			org[i] = orgf[i];
+			rec[i] = recf[i];
+		}
+		CU_ASSERT_EQUAL(zc_calc_ssim_2d_float(orgf, recf, H, W), zc_calc_ssim_2d_double(org, rec, H, W));
+		ZC_setNbThreads(1);
+
+		free(org);
+		free(rec);
+		free(orgf);
+		free(recf);
+	}
+}
+
+void test_zc_calc_ssim_2d_identical(void)
+{
+	size_t i, n = 100*100;
+	double* org = (double*)malloc(sizeof(double)*n);
+	for(i=0;i<n;i++)
+		org[i] = cos(i*0.01)*1000;
+	CU_ASSERT_DOUBLE_EQUAL(zc_calc_ssim_2d_double(org, org, 100, 100), 1, 1E-12);
+	free(org);
+}
+
+/*mean of the 7x7x7 windows of the r4 volumes, clipped at their borders*/
+static double computeReferenceSsimVolume(double* org, double* rec, size_t r4, size_t r3, size_t r2, size_t r1, double valueRange)
+{
+	static const int K[7] = {1, 4, 11, 16, 11, 4, 1};
+	size_t v, z, y, x, n = r3*r2*r1;
+	int i, j, k;
+	double C1 = 1E-4*valueRange*valueRange, C2 = 9E-4*valueRange*valueRange, C3 = C2/4, sum = 0;
+	for(v=0;v<r4;v++)
+	for(z=0;z<r3;z++)
+	for(y=0;y<r2;y++)
+	for(x=0;x<r1;x++)
+	{
+		double w = 0, xm = 0, ym = 0, xxm = 0, xym = 0, yym = 0;
+		for(k=-3;k<=3;k++)
+		for(j=-3;j<=3;j++)
+		for(i=-3;i<=3;i++)
+		{
+			long zz = (long)z+k, yy = (long)y+j, xx = (long)x+i;
+			if(zz<0 || zz>=(long)r3 || yy<0 || yy>=(long)r2 || xx<0 || xx>=(long)r1)
+				continue;
+			double wt = K[k+3]*K[j+3]*K[i+3], a = org[v*n+(zz*r2+yy)*r1+xx], b = rec[v*n+(zz*r2+yy)*r1+xx];
+			w += wt; xm += wt*a; ym += wt*b; xxm += wt*a*a; xym += wt*a*b; yym += wt*b*b;
+		}
+		double mx = xm/w, my = ym/w, sxx = xxm/w-mx*mx, syy = yym/w-my*my, sxy = xym/w-mx*my;
+		if(sxx < 0) sxx = 0;
+		if(syy < 0) syy = 0;
+		double sxsy = sqrt(sxx*syy);
+		sum += (2*mx*my+C1)/(mx*mx+my*my+C1) * (2*sxsy+C2)/(sxx+syy+C2) * (sxy+C3)/(sxsy+C3);
+	}
+	return sum/(r4*n);
+}
+
+static int writeTmpFile(char* path, void* data, size_t size)
+{
+	int fd = mkstemp(path);
+	if(fd>=0 && write(fd, data, size)!=(ssize_t)size)
+	{
+		close(fd);
+		return -1;
+	}
+	return fd;
+}
+
+void test_zc_calc_ssim_2d_file(void)
+{
+	size_t H = 300, W = 257, n = H*W;
+	double* org = (double*)malloc(sizeof(double)*n);
+	double* rec = (double*)malloc(sizeof(double)*n);
+	float* orgf = (float*)malloc(sizeof(float)*n);
+	float* recf = (float*)malloc(sizeof(float)*n);
+	genImage(org, rec, orgf, recf, H, W, 2);
+	
+	//read by bands of rows from the files
+	char path1[] = "/tmp/test_ssim_XXXXXX", path2[] = "/tmp/test_ssim_XXXXXX";
+	int fd1 = writeTmpFile(path1, orgf, sizeof(float)*n), fd2 = writeTmpFile(path2, recf, sizeof(float)*n);
+	CU_ASSERT(fd1>=0 && fd2>=0);
+	double ssim = zc_calc_ssim_2d_float(orgf, recf, H, W);
+	CU_ASSERT_EQUAL(zc_calc_ssim_2d_file(fd1, fd2, ZC_FLOAT, H, W, ZC_computeValueRange_float(orgf, n)), ssim);
+	ZC_setNbThreads(4);
+	CU_ASSERT_EQUAL(zc_calc_ssim_2d_file(fd1, fd2, ZC_FLOAT, H, W, ZC_computeValueRange_float(orgf, n)), ssim);
+	ZC_setNbThreads(1);
+	close(fd1);
+	close(fd2);
+	unlink(path1);
+	unlink(path2);
+
+	free(org);
+	free(rec);
+	free(orgf);
+	free(recf);
+}
+
+void test_zc_calc_ssim_volume(void)
+{
+	size_t r4 = 2, r3 = 13, r2 = 70, r1 = 11, n = r4*r3*r2*r1;
+	double* org = (double*)malloc(sizeof(double)*n);
+	double* rec = (double*)malloc(sizeof(double)*n);
+	float* orgf = (float*)malloc(sizeof(float)*n);
+	float* recf = (float*)malloc(sizeof(float)*n);
+	genImage(org, rec, orgf, recf, r4*r3*r2, r1, 20);
+	double valueRange = ZC_computeValueRange_double(org, n);
+
+	double ref = computeReferenceSsimVolume(org, rec, r4, r3, r2, r1, valueRange);
+	double ssim = zc_calc_ssim_volume_double(org, rec, r4, r3, r2, r1, valueRange);
+	ZC_setNbThreads(4);
+	CU_ASSERT_EQUAL(zc_calc_ssim_volume_double(org, rec, r4, r3, r2, r1, valueRange), ssim);
+	ZC_setNbThreads(1);
+	CU_ASSERT_DOUBLE_EQUAL(ssim, ref, 1E-12);
+	CU_ASSERT(ssim < 1 && ssim > 0.5);
+	CU_ASSERT_DOUBLE_EQUAL(zc_calc_ssim_volume_double(org, org, r4, r3, r2, r1, valueRange), 1, 1E-12);
+
+	//read by bands of rows from the files
+	char path1[] = "/tmp/test_ssim_XXXXXX", path2[] = "/tmp/test_ssim_XXXXXX";
+	int fd1 = writeTmpFile(path1, orgf, sizeof(float)*n), fd2 = writeTmpFile(path2, recf, sizeof(float)*n);
+	CU_ASSERT(fd1>=0 && fd2>=0);
+	valueRange = ZC_computeValueRange_float(orgf, n);
+	CU_ASSERT_EQUAL(zc_calc_ssim_volume_file(fd1, fd2, ZC_FLOAT, r4, r3, r2, r1, valueRange), 
+	zc_calc_ssim_volume_float(orgf, recf, r4, r3, r2, r1, valueRange));
+	close(fd1);
+	close(fd2);
+	unlink(path1);
+	unlink(path2);
+
+	free(org);
+	free(rec);
+	free(orgf);
+	free(recf);
+}
+
+void test_zc_calc_ssim_3d(void)
+{
+	size_t r3 = 45, r2 = 100, r1 = 30, i, n = r3*r2*r1, nbEle = r2*r1;
+	double minSsim, avgSsim, maxSsim, min4, avg4, max4, min = 1, max = 0, sum = 0;
+	double* org = (double*)malloc(sizeof(double)*n);
+	double* rec = (double*)malloc(sizeof(double)*n);
+	float* orgf = (float*)malloc(sizeof(float)*n);
+	float* recf = (float*)malloc(sizeof(float)*n);
+	genImage(org, rec, orgf, recf, r3*r2, r1, 20);
+	for(i=0;i<nbEle;i++) //a constant slice, skipped
+		org[5*nbEle+i] = orgf[5*nbEle+i] = 1;
+
+	//all the slices: the 2D SSIM of each slice
+	ssimImage2DSlices = 0;
+	for(i=0;i<r3;i++)
+	{
+		if(i==5)
+			continue;
+		double ssim = zc_calc_ssim_2d_double(org+i*nbEle, rec+i*nbEle, r2, r1);
+		if(min>ssim) min = ssim;
+		if(max<ssim) max = ssim;
+		sum += ssim;
+	}
+	zc_calc_ssim_3d_double(org, rec, r3, r2, r1, &minSsim, &avgSsim, &maxSsim);
+	CU_ASSERT_EQUAL(minSsim, min);
+	CU_ASSERT_EQUAL(maxSsim, max);
+	CU_ASSERT_EQUAL(avgSsim, sum/(r3-1));
+	ZC_setNbThreads(4);
+	zc_calc_ssim_3d_double(org, rec, r3, r2, r1, &min4, &avg4, &max4);
+	ZC_setNbThreads(1);
+	CU_ASSERT(min4==minSsim && avg4==avgSsim && max4==maxSsim);
+
+	//sampled slices: 0, 2, 4, ..., 44
+	ssimImage2DSlices = 20;
+	zc_calc_ssim_3d_double(org, rec, r3, r2, r1, &minSsim, &avgSsim, &maxSsim);
+	for(i=0, sum=0;i<r3;i+=2)
+		sum += zc_calc_ssim_2d_double(org+i*nbEle, rec+i*nbEle, r2, r1);
+	CU_ASSERT_EQUAL(avgSsim, sum/23);
+
+	//read slice by slice from the files
+	char path1[] = "/tmp/test_ssim_XXXXXX", path2[] = "/tmp/test_ssim_XXXXXX";
+	int fd1 = writeTmpFile(path1, orgf, sizeof(float)*n), fd2 = writeTmpFile(path2, recf, sizeof(float)*n);
+	ssimImage2DSlices = 0;
+	zc_calc_ssim_3d_float(orgf, recf, r3, r2, r1, &minSsim, &avgSsim, &maxSsim);
+	zc_calc_ssim_3d_file(fd1, fd2, ZC_FLOAT, r3, r2, r1, &min4, &avg4, &max4);
+	CU_ASSERT(min4==minSsim && avg4==avgSsim && max4==maxSsim);
+	ssimImage2DSlices = 20;
+	close(fd1);
+	close(fd2);
+	unlink(path1);
+	unlink(path2);
+
+	free(org);
+	free(rec);
+	free(orgf);
+	free(recf);
+}
+
+void test_zc_calc_ssim_1d(void)
+{
+	size_t n = 150001;
+	double* org = (double*)malloc(sizeof(double)*n);
+	double* rec = (double*)malloc(sizeof(double)*n);
+	float* orgf = (float*)malloc(sizeof(float)*n);
+	float* recf = (float*)malloc(sizeof(float)*n);
+	genImage(org, rec, orgf, recf, 1, n, 2);
+
+	//the windows of 7 points are those of an image of one row
+	double ssim = zc_calc_ssim_1d_double(org, rec, n);
+	CU_ASSERT_DOUBLE_EQUAL(ssim, computeReferenceSsim(org, rec, 1, n), 1E-12);
+	CU_ASSERT(ssim < 1 && ssim > 0.5);
+	ZC_setNbThreads(4);
+	CU_ASSERT_EQUAL(zc_calc_ssim_1d_double(org, rec, n), ssim);
+	ZC_setNbThreads(1);
+	CU_ASSERT_DOUBLE_EQUAL(zc_calc_ssim_1d_double(org, rec, 5), computeReferenceSsim(org, rec, 1, 5), 1E-12);
+	CU_ASSERT_DOUBLE_EQUAL(zc_calc_ssim_1d_double(org, org, n), 1, 1E-12);
+
+	char path1[] = "/tmp/test_ssim_XXXXXX", path2[] = "/tmp/test_ssim_XXXXXX";
+	int fd1 = writeTmpFile(path1, orgf, sizeof(float)*n), fd2 = writeTmpFile(path2, recf, sizeof(float)*n);
+	CU_ASSERT_EQUAL(zc_calc_ssim_1d_file(fd1, fd2, ZC_FLOAT, n, ZC_computeValueRange_float(orgf, n)), 
+	zc_calc_ssim_1d_float(orgf, recf, n));
+	close(fd1);
+	close(fd2);
+	unlink(path1);
+	unlink(path2);
+
+	free(org);
+	free(rec);
+	free(orgf);
+	free(recf);
+}
+
+/************* Test Runner Code goes here **************/
+
+int main ( void )
+{
+   CU_pSuite pSuite = NULL;
+
+   /* initialize the CUnit test registry */
+   if ( CUE_SUCCESS != CU_initialize_registry() )
+      return CU_get_error();
+
+   /* add a suite to the registry */
+   pSuite = CU_add_suite( "test_ssim_suite", init_suite, clean_suite );
+   if ( NULL == pSuite ) {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   /* add the tests to the suite */
+   if ((NULL == CU_add_test(pSuite, "test_zc_calc_ssim_2d", test_zc_calc_ssim_2d)) ||
+       (NULL == CU_add_test(pSuite, "test_zc_calc_ssim_2d_identical", test_zc_calc_ssim_2d_identical)) ||
+       (NULL == CU_add_test(pSuite, "test_zc_calc_ssim_2d_file", test_zc_calc_ssim_2d_file)) ||
+       (NULL == CU_add_test(pSuite, "test_zc_calc_ssim_3d", test_zc_calc_ssim_3d)) ||
+       (NULL == CU_add_test(pSuite, "test_zc_calc_ssim_volume", test_zc_calc_ssim_volume)) ||
+       (NULL == CU_add_test(pSuite, "test_zc_calc_ssim_1d", test_zc_calc_ssim_1d)))
+   {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   // Run all tests using the basic interface
+   CU_basic_set_mode(CU_BRM_VERBOSE);
+   CU_basic_run_tests();
+   printf("\n");
+   CU_basic_show_failures(CU_get_failure_list());
+   printf("\n\n");
+
+   /* Clean up registry and return */
+   CU_cleanup_registry();
+   return CU_get_error();
+}
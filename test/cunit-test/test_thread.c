@@ -0,0 +1,195 @@
+#include "CUnit/CUnit.h"
+#include "CUnit/Basic.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>  // for printf
+#include <string.h>
+#include "zc.h"
+
+#define TEST_SIZE 1000003
+
+/* Test Suite setup and cleanup functions: */
+
+int init_suite(void) { return 0; }
+int clean_suite(void) { return 0; }
+
+/************* Test case functions ****************/
+
+void test_ZC_reduceSumTree(void)
+{
+	double partials[10] = {1, 10, 2, 20, 3, 30, 4, 40, 5, 50};
+	ZC_reduceSumTree(partials, 5, 2);
+	CU_ASSERT_EQUAL(partials[0], 15);
+	CU_ASSERT_EQUAL(partials[1], 150);
+}
+
+void test_ZC_computeCompareStat_threads(void)
+{
+	size_t i;
+	double* data1 = (double*)malloc(sizeof(double)*TEST_SIZE);
+	double* data2 = (double*)malloc(sizeof(double)*TEST_SIZE);
+	for(i=0;i<TEST_SIZE;i++)
+	{
+		data1[i] = sin(i*0.001)*100 + (i%7==0 ? 0 : 1e3);
+		data2[i] = data1[i] + cos(i*0.37)*1e-3;
+	}
+	
+	ZC_CompareStat stat1, stat4;
+	ZC_setNbThreads(1);
+	ZC_computeCompareStat_double(&stat1, data1, data2, TEST_SIZE);
+	ZC_setNbThreads(4);
+	ZC_computeCompareStat_double(&stat4, data1, data2, TEST_SIZE);
+	ZC_setNbThreads(1);
+	
+	//the results must be bit-identical whatever the number of threads
+	CU_ASSERT_EQUAL(stat1.n, TEST_SIZE);
+	CU_ASSERT_EQUAL(stat1.n_rel, stat4.n_rel);
+	CU_ASSERT_EQUAL(stat1.mean1, stat4.mean1);
+	CU_ASSERT_EQUAL(stat1.m2_1, stat4.m2_1);
+	CU_ASSERT_EQUAL(stat1.c12, stat4.c12);
+	CU_ASSERT_EQUAL(stat1.c1d, stat4.c1d);
+	CU_ASSERT_EQUAL(stat1.sumErrSqr, stat4.sumErrSqr);
+	CU_ASSERT_EQUAL(stat1.maxErr, stat4.maxErr);
+	CU_ASSERT_EQUAL(stat1.minDiff_rel, stat4.minDiff_rel);
+	
+	double sum = 0;
+	for(i=0;i<TEST_SIZE;i++)
+		sum += data1[i];
+	CU_ASSERT_DOUBLE_EQUAL(stat1.mean1, sum/TEST_SIZE, 1E-9);
+	
+	free(data1);
+	free(data2);
+}
+
+void test_ZC_computeCompareStatBatch(void)
+{
+	size_t i;
+	int j;
+	double* data1 = (double*)malloc(sizeof(double)*TEST_SIZE);
+	double* data2[3];
+	for(j=0;j<3;j++)
+		data2[j] = (double*)malloc(sizeof(double)*TEST_SIZE);
+	for(i=0;i<TEST_SIZE;i++)
+	{
+		data1[i] = sin(i*0.001)*100 + (i%7==0 ? 0 : 1e3);
+		for(j=0;j<3;j++)
+			data2[j][i] = data1[i] + cos(i*0.37*(j+1))*pow(10, -j-1);
+	}
+	
+	ZC_CompareStat stats[3], stat;
+	ZC_setNbThreads(4);
+	ZC_computeCompareStatBatch_double(stats, data1, data2, 3, TEST_SIZE, ZC_STAT_ALL);
+	for(j=0;j<3;j++)
+	{
+		//each candidate must get exactly the statistics of a separate comparison
+		ZC_computeCompareStatMask_double(&stat, data1, data2[j], TEST_SIZE, ZC_STAT_ALL);
+		CU_ASSERT_EQUAL(memcmp(&stat, &stats[j], sizeof(ZC_CompareStat)), 0);
+	}
+	ZC_setNbThreads(1);
+	
+	free(data1);
+	for(j=0;j<3;j++)
+		free(data2[j]);
+}
+
+typedef struct TestTasks
+{
+	int* owner; /*threadID that ran each task*/
+	int* count; /*number of runs of each task*/
+	int nested;
+} TestTasks;
+
+static void testTask(void* arg, int threadID, size_t taskID)
+{
+	TestTasks* t = (TestTasks*)arg;
+	t->owner[taskID] = threadID;
+	__sync_fetch_and_add(&t->count[taskID], 1);
+	if(t->nested && taskID == 0)
+	{
+		//a task running ZC_runTasks again must not wait for the busy workers
+		int owner[3], count[3] = {0, 0, 0};
+		TestTasks in = {owner, count, 0};
+		ZC_runTasks(testTask, &in, 3);
+		t->nested = count[0] + count[1] + count[2];
+	}
+}
+
+void test_ZC_runTasks(void)
+{
+	int owner[10], count[10];
+	int k, n, ok;
+	size_t i;
+	TestTasks t = {owner, count, 0};
+	int threads[5] = {4, 2, 3, 4, 1};
+	for(k=0;k<5;k++)
+	{
+		//the workers are reused by the next calls, with more or fewer threads
+		ZC_setNbThreads(threads[k]);
+		memset(count, 0, sizeof(count));
+		ZC_runTasks(testTask, &t, 10);
+		ok = 1;
+		for(i=0;i<10;i++)
+			ok = ok && count[i] == 1 && owner[i] == (int)(i % threads[k]);
+		CU_ASSERT(ok);
+	}
+	
+	ZC_setNbThreads(4);
+	memset(count, 0, sizeof(count));
+	t.nested = 1;
+	ZC_runTasks(testTask, &t, 10);
+	CU_ASSERT_EQUAL(t.nested, 3);
+	for(n=0,i=0;i<10;i++)
+		n += count[i];
+	CU_ASSERT_EQUAL(n, 10);
+	
+	//the workers are started again after ZC_freeThreadPool
+	ZC_freeThreadPool();
+	t.nested = 0;
+	memset(count, 0, sizeof(count));
+	ZC_runTasks(testTask, &t, 10);
+	for(n=0,i=0;i<10;i++)
+		n += count[i] == 1 && owner[i] == (int)(i % 4);
+	CU_ASSERT_EQUAL(n, 10);
+	ZC_freeThreadPool();
+	ZC_setNbThreads(1);
+}
+
+/************* Test Runner Code goes here **************/
+
+int main ( void )
+{
+   CU_pSuite pSuite = NULL;
+
+   /* initialize the CUnit test registry */
+   if ( CUE_SUCCESS != CU_initialize_registry() )
+      return CU_get_error();
+
+   /* add a suite to the registry */
+   pSuite = CU_add_suite( "test_thread_suite", init_suite, clean_suite );
+   if ( NULL == pSuite ) {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   /* add the tests to the suite */
+   if ((NULL == CU_add_test(pSuite, "test_ZC_reduceSumTree", test_ZC_reduceSumTree)) ||
+       (NULL == CU_add_test(pSuite, "test_ZC_computeCompareStat_threads", test_ZC_computeCompareStat_threads)) ||
+       (NULL == CU_add_test(pSuite, "test_ZC_computeCompareStatBatch", test_ZC_computeCompareStatBatch)) ||
+       (NULL == CU_add_test(pSuite, "test_ZC_runTasks", test_ZC_runTasks)))
+   {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   // Run all tests using the basic interface
+   CU_basic_set_mode(CU_BRM_VERBOSE);
+   CU_basic_run_tests();
+   printf("\n");
+   CU_basic_show_failures(CU_get_failure_list());
+   printf("\n\n");
+
+   /* Clean up registry and return */
+   CU_cleanup_registry();
+   return CU_get_error();
+}
@@ -0,0 +1,133 @@
+#include "CUnit/CUnit.h"
+#include "CUnit/Basic.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <stdio.h>  // for printf
+#include <string.h>
+#include "zc.h"
+#include "ZC_verify.h"
+
+#define R2 1500
+#define R1 1000
+
+/* Test Suite setup and cleanup functions: */
+
+int init_suite(void) { return 0; }
+int clean_suite(void) { return 0; }
+
+/************* Test case functions ****************/
+
+void test_ZC_resolveErrorBound(void)
+{
+	ZC_VerifyResult b;
+	CU_ASSERT_EQUAL(ZC_parseErrorBoundMode("ABS_OR_PW_REL"), ABS_OR_PW_REL);
+	CU_ASSERT_EQUAL(ZC_parseErrorBoundMode("abs"), -1);
+
+	ZC_resolveErrorBound(&b, ABS_AND_REL, 1E-3, 1E-4, 0, 100);
+	CU_ASSERT_DOUBLE_EQUAL(b.absBound, 1E-3, 1E-15);
+	CU_ASSERT_EQUAL(b.pwrBound, 0);
+	ZC_resolveErrorBound(&b, ABS_OR_REL, 1E-3, 1E-4, 0, 100);
+	CU_ASSERT_DOUBLE_EQUAL(b.absBound, 1E-2, 1E-15);
+	ZC_resolveErrorBound(&b, REL_AND_PW_REL, 1E-3, 1E-4, 1E-2, 100);
+	CU_ASSERT_DOUBLE_EQUAL(b.absBound, 1E-2, 1E-15);
+	CU_ASSERT_EQUAL(b.pwrBound, 1E-2);
+	CU_ASSERT_EQUAL(b.andMode, 1);
+
+	size_t coords[5];
+	ZC_computeCoordinates((7*20+3)*30+11, 0, 0, 10, 20, 30, coords);
+	CU_ASSERT_EQUAL(coords[2], 7);
+	CU_ASSERT_EQUAL(coords[3], 3);
+	CU_ASSERT_EQUAL(coords[4], 11);
+}
+
+void test_ZC_verifyErrorBound(void)
+{
+	size_t i, n = R2*R1;
+	size_t bad[4] = {5, 700001, 700002, n-1}; //in 3 of the 6 chunks
+	float* data1 = (float*)malloc(sizeof(float)*n);
+	float* data2 = (float*)malloc(sizeof(float)*n);
+	for(i=0;i<n;i++)
+	{
+		data1[i] = (float)(10*sin(i*1e-4));
+		data2[i] = data1[i] + (float)(cos(i*0.37)*1E-4);
+	}
+
+	ZC_VerifyResult* r = ZC_verifyErrorBound_float(data1, data2, ABS, 2E-4, 0, 0, 1, 0, 0, 0, R2, R1);
+	CU_ASSERT_EQUAL(r->pass, 1);
+	CU_ASSERT_EQUAL(r->nbChecked, n);
+	CU_ASSERT(r->maxAbsErr > 0.9E-4 && r->maxAbsErr <= 2E-4);
+	ZC_freeVerifyResult(r);
+
+	for(i=0;i<4;i++)
+		data2[bad[i]] = data1[bad[i]] + 1E-3;
+	data2[bad[2]] = NAN; //NaN errors are violations
+
+	int t;
+	for(t=1;t<=4;t+=3) //the same result with any number of threads
+	{
+		ZC_setNbThreads(t);
+		r = ZC_verifyErrorBound_float(data1, data2, ABS, 2E-4, 0, 0, 1, 0, 0, 0, R2, R1);
+		CU_ASSERT_EQUAL(r->pass, 0);
+		CU_ASSERT_EQUAL(r->nbViolations, 1);
+		CU_ASSERT_EQUAL(r->violations[0], bad[0]);
+		CU_ASSERT(r->nbChecked < n); //early exit
+		ZC_freeVerifyResult(r);
+
+		r = ZC_verifyErrorBound_float(data1, data2, ABS, 2E-4, 0, 0, 3, 0, 0, 0, R2, R1);
+		CU_ASSERT_EQUAL(r->nbViolations, 3);
+		CU_ASSERT(memcmp(r->violations, bad, 3*sizeof(size_t))==0);
+		ZC_freeVerifyResult(r);
+
+		r = ZC_verifyErrorBound_float(data1, data2, ABS, 2E-4, 0, 0, 0, 0, 0, 0, R2, R1);
+		CU_ASSERT_EQUAL(r->nbViolations, 4);
+		CU_ASSERT_EQUAL(r->nbChecked, n);
+		ZC_freeVerifyResult(r);
+	}
+	ZC_setNbThreads(1);
+
+	//the point-wise relative bound: the errors of the points near 0 are too large
+	r = ZC_verifyErrorBound_float(data1, data2, PW_REL, 0, 0, 1E-3, 0, 0, 0, 0, R2, R1);
+	CU_ASSERT(r->nbViolations > 4);
+	ZC_freeVerifyResult(r);
+
+	free(data1);
+	free(data2);
+}
+
+/************* Test Runner Code goes here **************/
+
+int main ( void )
+{
+   CU_pSuite pSuite = NULL;
+
+   /* initialize the CUnit test registry */
+   if ( CUE_SUCCESS != CU_initialize_registry() )
+      return CU_get_error();
+
+   /* add a suite to the registry */
+   pSuite = CU_add_suite( "test_verify_suite", init_suite, clean_suite );
+   if ( NULL == pSuite ) {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   /* add the tests to the suite */
+   if ((NULL == CU_add_test(pSuite, "test_ZC_resolveErrorBound", test_ZC_resolveErrorBound)) ||
+       (NULL == CU_add_test(pSuite, "test_ZC_verifyErrorBound", test_ZC_verifyErrorBound)))
+   {
+      CU_cleanup_registry();
+      return CU_get_error();
+   }
+
+   // Run all tests using the basic interface
+   CU_basic_set_mode(CU_BRM_VERBOSE);
+   CU_basic_run_tests();
+   printf("\n");
+   CU_basic_show_failures(CU_get_failure_list());
+   printf("\n\n");
+
+   /* Clean up registry and return */
+   CU_cleanup_registry();
+   return CU_get_error();
+}
@@ -11,11 +11,76 @@
 #define _ZC_CompareData_H
 
 #include "ZC_DataProperty.h"
+#include "ZC_ErrMap.h"
+#include "ZC_verify.h"
 
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+#define ZC_STAT_BLOCK_SIZE 4096
+
+/*number of lines of the .cmp files (see constructCompareDataString())*/
+#define ZC_CMP_STRING_COUNT 33
+#define ZC_CMP_SAMPLE_STRING_COUNT 8
+#define ZC_CMP_ERRMAP_STRING_COUNT 2
+#define ZC_CMP_QUANTILE_STRING_COUNT (2*ZC_ERR_QUANTILE_COUNT)
+#define ZC_CMP_SSIM3D_STRING_COUNT 1
+
+/**
+ * Mergeable moment-style statistics of (data1, data2, diff=data2-data1).
+ * Each block of ZC_STAT_BLOCK_SIZE points is reduced in cache to means and
+ * centered (co-)moments, then blocks are combined with the pairwise update
+ * of Chan et al., so that no per-point scratch array is needed.
+ * */
+typedef struct ZC_CompareStat
+{
+	size_t n;
+	double mean1, mean2, meanDiff;
+	double m2_1, m2_2, m2_diff; /*sums of squared deviations*/
+	double c12, c1d; /*co-moments of (data1,data2) and (data1,diff)*/
+	double minDiff, maxDiff, minErr, maxErr;
+	double sumErr, sumErrSqr;
+	
+	size_t n_rel; /*number of points with data1!=0*/
+	double minDiff_rel, maxDiff_rel, minErr_rel, maxErr_rel;
+	double sumErr_rel, sumErrSqr_rel;
+} ZC_CompareStat;
+
+/*optional parts of ZC_CompareStat; the errors (minDiff ... sumErrSqr) and the means are always computed*/
+#define ZC_STAT_REL 1 /*point-wise relative errors (n_rel ... sumErrSqr_rel)*/
+#define ZC_STAT_MOMENTS 2 /*centered (co-)moments (m2_1 ... c1d)*/
+#define ZC_STAT_ALL 3
+
+/**
+ * The statistics of one phase of the online analysis, reduced over all the ranks at once 
+ * by ZC_reduceOnlineStat_online(); mask tells which of them are reduced (ZC_REDUCE_* bits), 
+ * so that the basic properties of the original data are reduced together with the first 
+ * comparison when both are needed in the same step.
+ * */
+typedef struct ZC_OnlineStat
+{
+	int mask;
+	ZC_PropertyStat property;
+	ZC_CompareStat compare;
+} ZC_OnlineStat;
+
+#define ZC_REDUCE_PROPERTY 1
+#define ZC_REDUCE_COMPARE 2
+
+/**
+ * The work needed by the metrics enabled in the [COMPARE] section, resolved from 
+ * the flags by ZC_ReadConf() and again at the start of each comparison (the flags 
+ * may be set by the program). statMask selects the specialized kernel of the first pass.
+ * */
+typedef struct ZC_MetricPlan
+{
+	int statMask;
+	int errPDF; /*the second pass over the data is needed*/
+} ZC_MetricPlan;
+
+extern ZC_MetricPlan metricPlan;
+
 typedef struct ZC_CompareData
 {	
 	char* solution; //the key string of the ZC_CompareData
@@ -72,7 +137,24 @@ typedef struct ZC_CompareData
 	double ssimImage2D_avg;
 	double ssimImage2D_max;
 	
+	double ssimVolume3D; /*mean SSIM of the 7x7x7 windows (ssimVolume3D in the [COMPARE] section)*/
+	int ssimVolume3DComputed; /*1: ssimVolume3D is set*/
+	
 	complex *fftCoeff;	
+	
+	/*approximate mode (see ZC_compareDataSample_float()): the metrics are estimated on a sample*/
+	double sampleRatio; /*fraction of the data points compared (0 or 1: exact results)*/
+	int maxAbsErrExact; /*1: maxAbsErr is the maximal error; 0: the maximum of the sample, i.e., a lower bound*/
+	double avgAbsErr_low, avgAbsErr_high; /*95% confidence intervals*/
+	double rmse_low, rmse_high;
+	double psnr_low, psnr_high; /*on the value range of the property: the sample's in the file mode, the data's otherwise; psnr_high is HUGE_VAL (unbounded) if rmse_low is 0*/
+	double* absErrPDF_ci; /*half-widths of the 95% confidence intervals of the absErrPDF bins*/
+	
+	ZC_ErrMap* errMap; /*per-tile metrics (errMap in the [COMPARE] section), written in the .emap files*/
+	
+	/*distributions of |data2-data1| and of |data2-data1|/|data1| (data1!=0), if errQuantilesFlag is set*/
+	ZC_QuantileSketch* absErrSketch;
+	ZC_QuantileSketch* pwrErrSketch;
 } ZC_CompareData;
 
 typedef struct ZC_CompareData_Overall
@@ -130,17 +212,71 @@ size_t compressSize, double decompressTime, double decompressRate, double minAbs
 double minRelErr, double avgRelErr, double maxRelErr, double rmse, double nrmse, double psnr, double snr, double valErrCorr, double pearsonCorr,
 double* autoCorrAbsErr, double* absErrPDF);
 
+void ZC_resolveMetricPlan(ZC_MetricPlan* plan);
+void ZC_initCompareStat(ZC_CompareStat* stat);
+void ZC_mergeCompareStat(ZC_CompareStat* stat, ZC_CompareStat* other);
+void ZC_reduceCompareStat(ZC_CompareStat* stats, size_t count);
+void ZC_applyCompareStat(ZC_CompareData* compareResult, ZC_CompareStat* stat);
+void ZC_computeErrPDFRange(ZC_CompareStat* stat, double* minDiff, double* interval, double* minDiff_rel, double* maxDiff_rel, double* interval_rel);
+void ZC_allocErrPDFCounts(ZC_CompareStat* stat, double** absCounts, double** relCounts);
+void ZC_finalizeErrPDF(ZC_CompareData* compareResult, ZC_CompareStat* stat, double* absCounts, double* relCounts);
+void ZC_initOnlineStat(ZC_OnlineStat* stat, int mask);
+void ZC_mergeOnlineStat(ZC_OnlineStat* stat, ZC_OnlineStat* other);
+
+void ZC_computeCompareStatBlock_float(ZC_CompareStat* stat, float* data1, float* data2, size_t n);
+void ZC_computeCompareStatBlock_double(ZC_CompareStat* stat, double* data1, double* data2, size_t n);
+void ZC_computeCompareStat_float(ZC_CompareStat* stat, float* data1, float* data2, size_t n);
+void ZC_computeCompareStat_double(ZC_CompareStat* stat, double* data1, double* data2, size_t n);
+void ZC_computeCompareStatMask_float(ZC_CompareStat* stat, float* data1, float* data2, size_t n, int statMask);
+void ZC_computeCompareStatMask_double(ZC_CompareStat* stat, double* data1, double* data2, size_t n, int statMask);
+void ZC_computeCompareStatBatch_float(ZC_CompareStat* stats, float* data1, float** data2, int k, size_t n, int statMask);
+void ZC_computeCompareStatBatch_double(ZC_CompareStat* stats, double* data1, double** data2, int k, size_t n, int statMask);
+void ZC_countErrPDF_float(ZC_CompareStat* stat, float* data1, float* data2, size_t n, double* absCounts, double* relCounts);
+void ZC_countErrPDF_double(ZC_CompareStat* stat, double* data1, double* data2, size_t n, double* absCounts, double* relCounts);
+void ZC_computeErrPDF_float(ZC_CompareData* compareResult, ZC_CompareStat* stat, float* data1, float* data2, size_t n);
+void ZC_computeErrPDF_double(ZC_CompareData* compareResult, ZC_CompareStat* stat, double* data1, double* data2, size_t n);
+double* ZC_computeErrAutoCorr_float(float* data1, float* data2, size_t n, double avgDiff, double varDiff);
+double* ZC_computeErrAutoCorr_double(double* data1, double* data2, size_t n, double avgDiff, double varDiff);
+void ZC_addErrSketches_float(ZC_QuantileSketch* absSketch, ZC_QuantileSketch* pwrSketch, float* data1, float* data2, size_t n);
+void ZC_addErrSketches_double(ZC_QuantileSketch* absSketch, ZC_QuantileSketch* pwrSketch, double* data1, double* data2, size_t n);
+void ZC_updateErrMap_float(ZC_ErrMap* map, float* data1, float* data2, size_t offset, size_t len);
+void ZC_updateErrMap_double(ZC_ErrMap* map, double* data1, double* data2, size_t offset, size_t len);
+ZC_ErrMap* ZC_computeErrMap_float(float* data1, float* data2, double valueRange, 
+size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
+ZC_ErrMap* ZC_computeErrMap_double(double* data1, double* data2, double valueRange, 
+size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
+ZC_VerifyResult* ZC_verifyErrorBound_float(float* data1, float* data2, int errBoundMode, double absErrBound, double relBoundRatio, 
+double pwrBoundRatio, size_t maxViolations, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
+ZC_VerifyResult* ZC_verifyErrorBound_double(double* data1, double* data2, int errBoundMode, double absErrBound, double relBoundRatio, 
+double pwrBoundRatio, size_t maxViolations, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
+
 void ZC_compareData_float(ZC_CompareData* compareResult, float* data1, float* data2, 
 size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
 void ZC_compareData_double(ZC_CompareData* compareResult, double* data1, double* data2,
 size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
 
+void ZC_compareDataSample_float(ZC_CompareData* compareResult, float* data1, float* data2, size_t* blocks, size_t nbSampled);
+void ZC_compareDataSample_double(ZC_CompareData* compareResult, double* data1, double* data2, size_t* blocks, size_t nbSampled);
+void ZC_compareData_batch_float(ZC_CompareData** compareResults, float* data1, float** data2, int k, 
+size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
+void ZC_compareData_batch_double(ZC_CompareData** compareResults, double* data1, double** data2, int k, 
+size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
+void ZC_compareDataFile_float(ZC_CompareData* compareResult, int fd1, int fd2, size_t chunkSize, 
+size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
+void ZC_compareDataFile_double(ZC_CompareData* compareResult, int fd1, int fd2, size_t chunkSize, 
+size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
+
 void ZC_computeFFT_float_offline(ZC_CompareData* compareResult, float* data1, float* data2, size_t numOfElem);
 void ZC_computeFFT_double_offline(ZC_CompareData* compareResult, double* data1, double* data2, size_t numOfElem);
 
 void ZC_compareData_dec(ZC_CompareData* compareResult, void *decData);
 ZC_CompareData* ZC_compareData(char* varName, int dataType, void *oriData, void *decData, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
+ZC_CompareData** ZC_compareData_batch(ZC_DataProperty* property, void** decData, char** solutions, int k);
+ZC_CompareData* ZC_compareDataFiles(char* varName, int dataType, char* oriFilePath, char* decFilePath, size_t chunkSize, 
+size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
 void ZC_printCompressionResult(ZC_CompareData* compareResult);
+int ZC_isSampledResult(ZC_CompareData* compareResult);
+int ZC_getCompareDataStringCount(ZC_CompareData* compareResult);
 char** constructCompareDataString(ZC_CompareData* compareResult);
 void ZC_writeCompressionResult(ZC_CompareData* compareResult, char* solution, char* varName, char* tgtWorkspaceDir);
 ZC_CompareData* ZC_loadCompressionResult(char* cmpResultFile);
@@ -148,6 +284,8 @@ ZC_CompareData* ZC_loadCompressionResult(char* cmpResultFile);
 ZC_CompareData_Overall* ZC_compareData_overall();
 
 //mpi interfaces
+void ZC_reduceOnlineStat_online(ZC_OnlineStat* stat);
+void ZC_freeOnlineStatOp();
 void ZC_compareData_float_online(ZC_CompareData* compareResult, float* data1, float* data2, 
 size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
 void ZC_compareData_double_online(ZC_CompareData* compareResult, double* data1, double* data2, 
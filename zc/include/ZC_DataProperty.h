@@ -10,21 +10,75 @@
 #ifndef _ZC_DataProperty_H
 #define _ZC_DataProperty_H
 
+#include "ZC_QuantileSketch.h"
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
+/*the byte histograms are counted in this many interleaved sub-histograms, so that
+ *consecutive bytes with the same value do not wait for each other's increments*/
+#define ZC_BYTE_SUBTABLES 4
+
+/*quantized values: direct bins up to this number of bins, an open-addressing hash table beyond*/
+#define ZC_QUANT_DIRECT_BINS 1048576
+#define ZC_QUANT_MAX_KEYS 4.6E18
+
+/*the Laplacian is computed by tiles of this many columns (the rows of the tile and their neighbors stay in L1)*/
+#define ZC_LAP_TILE_SIZE 1024
+
 struct HashEntry_s{
-	int flag;
-    unsigned long key;
-	int num;
+	unsigned long key;
+	long num; /*0: empty entry*/
 };
 
 typedef struct HashEntry_s HashEntry;
 
+/*open-addressing (linear probing) counts of the keys, doubled when half full*/
+typedef struct HashTable_s
+{
+	HashEntry* entries;
+	size_t size; /*power of 2*/
+	size_t count; /*number of keys*/
+	int shift; /*64 - log2(size), for the multiplicative hash*/
+} HashTable;
+
+/*counts of the values quantized by bins of width 2*errBound from min*/
+typedef struct ZC_QuantCounts
+{
+	double min;
+	double scale; /*1/(2*errBound)*/
+	size_t nbBins; /*number of possible keys*/
+	long* bins; /*direct bins, or NULL if the counts are in table*/
+	HashTable table;
+} ZC_QuantCounts;
+
+/**
+ * Mergeable basic statistics of a set of values (see ZC_mergePropertyStat()), 
+ * from which the basic properties (ZC_PROP_BASIC) of the whole data are derived.
+ * */
+typedef struct ZC_PropertyStat
+{
+	size_t n;
+	double min, max;
+	double mean, m2; /*m2: sum of the squared deviations from mean*/
+} ZC_PropertyStat;
+
 typedef double real;
 typedef struct{real Re; real Im; real Amp;} complex;
 
+/*properties computed on demand by ZC_requireProperties() (bits of pendingMask)*/
+#define ZC_PROP_BASIC 0x01 /*minValue, maxValue, valueRange, avgValue and zeromean_variance*/
+#define ZC_PROP_ENTROPY 0x02
+#define ZC_PROP_QUANT_ENTROPY 0x04 /*needs ZC_PROP_BASIC*/
+#define ZC_PROP_QUANTILES 0x08 /*valueSketch*/
+#define ZC_PROP_AUTOCORR 0x10 /*needs ZC_PROP_BASIC*/
+#define ZC_PROP_AUTOCORR3D 0x20
+#define ZC_PROP_FFT 0x40 /*fftCoeff*/
+#define ZC_PROP_LAP 0x80
+#define ZC_PROP_COUNT 8
+#define ZC_PROP_ALL 0xFF
+
 typedef struct ZC_DataProperty
 {
 	char* varName;
@@ -43,16 +97,32 @@ typedef struct ZC_DataProperty
 	double valueRange;
 	double avgValue;
 	double entropy;
+	double quantEntropy; /*entropy of the values quantized with the bound quantEntropyBoundRatio*valueRange*/
+	ZC_QuantileSketch* valueSketch; /*distribution of the values (valueQuantilesFlag), or NULL*/
 	double zeromean_variance;
 	double* autocorr; /*array of autocorrelation coefficients*/
 	void* autocorr3D; //double* or float*, depending on the floating type of the data
-	complex* fftCoeff; /*array of fft coefficients*/
+	complex* fftCoeff; /*array of fft coefficients (computed on first use by ZC_getFFTCoeff())*/
 	double* lap;
+	double sampleRatio; /*approximate mode: the basic properties are computed on this fraction of the data (0 or 1: exact)*/
+	int pendingMask; /*ZC_PROP_* properties not computed yet, computed from data on first use (0 unless made by ZC_createDataProperty(); see ZC_releasePropertyData())*/
+	
+	/*cached for the comparisons against the same original data*/
+	int sumSqrDevReady;
+	double sumSqrDev; /*sum of the squared deviations from avgValue (global in the online mode)*/
 } ZC_DataProperty;
 
-void hash_init(HashEntry *table, size_t table_size);
-size_t hash_get(HashEntry *table, unsigned long key, size_t table_size);
-void hash_put(HashEntry *table, unsigned long key, size_t table_size);
+void hash_init(HashTable *table, size_t capacity);
+long hash_get(HashTable *table, unsigned long key);
+void hash_put(HashTable *table, unsigned long key, long num);
+void hash_free(HashTable *table);
+
+void ZC_countBytes(const unsigned char* bytes, size_t n, long* tables);
+void ZC_initQuantCounts(ZC_QuantCounts* counts, double min, double valueRange, double errBound);
+void ZC_initEmptyQuantCounts(ZC_QuantCounts* counts, ZC_QuantCounts* model);
+void ZC_mergeQuantCounts(ZC_QuantCounts* a, ZC_QuantCounts* b);
+double ZC_computeQuantEntropy(ZC_QuantCounts* counts, double total);
+void ZC_freeQuantCounts(ZC_QuantCounts* counts);
 
 int ZC_computeDimension(size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
 void ZC_constructDimString(size_t r5, size_t r4, size_t r3, size_t r2, size_t r1, char* output);
@@ -60,6 +130,8 @@ void fft(complex *v, size_t n, complex *tmp);
 void ifft(complex *v, size_t n, complex *tmp);
 
 void computeLap(double *data, double *lap, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
+void ZC_computeLaplacian_float(float* data, double* lap, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
+void ZC_computeLaplacian_double(double* data, double* lap, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
 
 void freeDataProperty_internal(ZC_DataProperty* dataProperty);
 int freeDataProperty(ZC_DataProperty* dataProperty);
@@ -69,9 +141,44 @@ size_t numOfElem, double minValue, double maxValue, double valueRange, double av
 double entropy, double* autocorr, complex* fftCoeff);
 
 complex* ZC_computeFFT(void* data, size_t n, int dataType);
+size_t ZC_getFFTCoeffCount(size_t numOfElem);
+complex* ZC_computeFFTCoeff(void* data, size_t numOfElem, int dataType);
+complex* ZC_getFFTCoeff(ZC_DataProperty* property);
+ZC_DataProperty* ZC_createDataProperty(char* varName, int dataType, void* data, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
+int ZC_getFlaggedProperties();
+void ZC_requireProperties(ZC_DataProperty* property, int mask);
+void ZC_releasePropertyData(ZC_DataProperty* property);
+void ZC_computeProperty_float(ZC_DataProperty* property, int id);
+void ZC_computeProperty_double(ZC_DataProperty* property, int id);
+double ZC_getMinValue(ZC_DataProperty* property);
+double ZC_getMaxValue(ZC_DataProperty* property);
+double ZC_getValueRange(ZC_DataProperty* property);
+double ZC_getAvgValue(ZC_DataProperty* property);
+double ZC_getZeromeanVariance(ZC_DataProperty* property);
+double ZC_getEntropy(ZC_DataProperty* property);
+double ZC_getQuantEntropy(ZC_DataProperty* property);
+ZC_QuantileSketch* ZC_getValueSketch(ZC_DataProperty* property);
+double* ZC_getAutocorr(ZC_DataProperty* property);
+void* ZC_getAutocorr3D(ZC_DataProperty* property);
+double* ZC_getLaplacian(ZC_DataProperty* property);
 ZC_DataProperty* ZC_genProperties_float(char* varName, float *data, size_t numOfElem, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
 ZC_DataProperty* ZC_genProperties_double(char* varName, double *data, size_t numOfElem, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
 ZC_DataProperty* ZC_genProperties(char* varName, int dataType, void *oriData, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
+size_t ZC_computeSampleValueStat_float(float** blocks, size_t* lengths, size_t nbSampled, double* min, double* max, double* avg, double* zeromean_variance);
+size_t ZC_computeSampleValueStat_double(double** blocks, size_t* lengths, size_t nbSampled, double* min, double* max, double* avg, double* zeromean_variance);
+double ZC_computeValueRange_float(float* data, size_t numOfElem);
+double ZC_computeValueRange_double(double* data, size_t numOfElem);
+void ZC_countQuantValues_float(float* data, size_t numOfElem, ZC_QuantCounts* counts);
+void ZC_countQuantValues_double(double* data, size_t numOfElem, ZC_QuantCounts* counts);
+double ZC_computeQuantEntropy_float(float* data, size_t numOfElem, double min, double valueRange, double errBound);
+double ZC_computeQuantEntropy_double(double* data, size_t numOfElem, double min, double valueRange, double errBound);
+void ZC_addValueSketch_float(ZC_QuantileSketch* sketch, float* data, size_t numOfElem);
+void ZC_addValueSketch_double(ZC_QuantileSketch* sketch, double* data, size_t numOfElem);
+void ZC_initPropertyStat(ZC_PropertyStat* stat);
+void ZC_mergePropertyStat(ZC_PropertyStat* stat, ZC_PropertyStat* other);
+void ZC_applyPropertyStat(ZC_DataProperty* property, ZC_PropertyStat* stat);
+void ZC_computePropertyStat_float(ZC_PropertyStat* stat, float* data, size_t numOfElem);
+void ZC_computePropertyStat_double(ZC_PropertyStat* stat, double* data, size_t numOfElem);
 
 int ZC_moveDataProperty(ZC_DataProperty* target, ZC_DataProperty* source);
 
@@ -87,6 +194,7 @@ void ZC_genBasicProperties_float_online(float* data, size_t numOfElem, ZC_DataPr
 void ZC_genBasicProperties_double_online(double* data, size_t numOfElem, ZC_DataProperty* property);
 ZC_DataProperty* ZC_genProperties_float_online(char* varName, float *data, size_t numOfElem, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
 ZC_DataProperty* ZC_genProperties_double_online(char* varName, double *data, size_t numOfElem, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
+double ZC_reduceQuantEntropy_online(ZC_QuantCounts* counts, double total);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,72 @@
+/**
+ *  @file ZC_ErrMap.h
+ *  @brief Header file for the ZC_ErrMap.c.
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#ifndef _ZC_ErrMap_H
+#define _ZC_ErrMap_H
+
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*fields of the error maps, written in this order in the .emap files*/
+#define ZC_ERRMAP_FIELD_COUNT 5
+
+/*per-tile sums accumulated by ZC_updateErrMap_float() and ZC_updateErrMap_double();
+ *the values are shifted by the first original value of the tile (pilot)*/
+#define ZC_ERRMAP_COUNT 0
+#define ZC_ERRMAP_MAX 1
+#define ZC_ERRMAP_SUM_DIFF 2
+#define ZC_ERRMAP_SUM_DIFF2 3
+#define ZC_ERRMAP_PILOT 4
+#define ZC_ERRMAP_SUM1 5
+#define ZC_ERRMAP_SUM2 6
+#define ZC_ERRMAP_SUM11 7
+#define ZC_ERRMAP_SUM22 8
+#define ZC_ERRMAP_SUM12 9
+#define ZC_ERRMAP_ACC_COUNT 10
+
+extern int errMapFlag;
+extern size_t errMapTile[5]; /*tile shape along r1..r5 (0: default shape)*/
+
+/**
+ * Blockwise error map: the data are split into tiles of tile[0]x...xtile[4] points
+ * (along r1..r5) and each tile gets its own metrics, so the maps are reduced-resolution
+ * fields showing where the errors are located.
+ * */
+typedef struct ZC_ErrMap
+{
+	int dim;
+	size_t r[5]; /*data sizes along r1..r5 (1 for the missing dimensions)*/
+	size_t tile[5]; /*tile shape*/
+	size_t dims[5]; /*number of tiles along r1..r5*/
+	size_t nbTiles;
+
+	double* acc; /*ZC_ERRMAP_ACC_COUNT sums per tile (freed by ZC_finalizeErrMap())*/
+
+	double* maxAbsErr;
+	double* rmse;
+	double* psnr; /*with the value range of the whole data*/
+	double* bias; /*mean of data2-data1*/
+	double* ssim; /*SSIM with the tile as the window*/
+} ZC_ErrMap;
+
+void ZC_parseErrMapTile(char* s, size_t* tile);
+ZC_ErrMap* ZC_constructErrMap(size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
+size_t ZC_getErrMapLayerSize(ZC_ErrMap* map, size_t* nbLayers);
+double* ZC_getErrMapRowTiles(ZC_ErrMap* map, size_t row);
+void ZC_finalizeErrMap(ZC_ErrMap* map, double valueRange);
+void ZC_constructErrMapDimString(ZC_ErrMap* map, size_t* sizes, char* output);
+void ZC_writeErrMap(ZC_ErrMap* map, char* tgtFilePath);
+void ZC_freeErrMap(ZC_ErrMap* map);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ----- #ifndef _ZC_ErrMap_H  ----- */
@@ -14,8 +14,17 @@
 extern "C" {
 #endif
 
+/*number of shapes whose plans are kept (see ZC_getFFTWPlan())*/
+#define ZC_FFTW_PLAN_CACHE_SIZE 16
+
+/*thickness of the z-slabs of the bounded-lag 3D autocorrelation (autocorr3DMaxLag>0), in max lags*/
+#define ZC_AUTOCORR3D_SLAB_LAGS 4
+
 double* autocorr_3d_double(double* input, size_t nx, size_t ny, size_t nz);
 float* autocorr_3d_float(float* input, size_t nx, size_t ny, size_t nz);
+void autocorr_1d_lagSums(double* input, size_t n, int maxLag, double* lagSums);
+void fft_r2c_1d(double* input, size_t n, double* re, double* im);
+void ZC_freeFFTWPlans();
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,108 @@
+/**
+ *  @file ZC_PropertyAccumulator.h
+ *  @brief Header file for the ZC_PropertyAccumulator.c.
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#ifndef _ZC_PropertyAccumulator_H
+#define _ZC_PropertyAccumulator_H
+
+#include <stdlib.h>
+#include "ZC_DataProperty.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/**
+ * Statistics over the time steps of one property of the field (e.g., its entropy):
+ * running mean and variance (Welford), envelope, and the least-squares drift per step.
+ * */
+typedef struct ZC_TemporalStat
+{
+	size_t nbSteps;
+	double mean;
+	double m2; /*sum of the squared deviations from mean*/
+	double min;
+	double max;
+	double first;
+	double last;
+	double sumT; /*sums over the steps t=0,1,... for the drift*/
+	double sumTT;
+	double sumTY;
+} ZC_TemporalStat;
+
+/**
+ * Properties of a time-stepped field, accumulated step by step in one pass over the data:
+ * the properties of each step (in the layout of ZC_DataProperty, without FFT and Laplacian),
+ * their statistics over the steps, and the temporal mean, variance and envelope of each point.
+ * In the online mode, the properties of a step are those of the global field (reduced over
+ * the ranks), while the per-point arrays cover the local points of the rank.
+ * */
+typedef struct ZC_PropertyAccumulator
+{
+	int dataType;
+	size_t numOfElem; /*local number of points*/
+	int maxLag; /*autocorrelation lags (AUTOCORR_SIZE, or 0 if autocorrFlag is off)*/
+	size_t nbSteps;
+
+	/*per point, over the steps*/
+	double* mean;
+	double* m2; /*sum of the squared deviations from mean (temporal variance = m2/nbSteps)*/
+	double* minEnvelope;
+	double* maxEnvelope;
+
+	ZC_DataProperty* property; /*properties of the last step (property->data is NULL)*/
+
+	/*statistics of the properties of the steps*/
+	ZC_TemporalStat minValue;
+	ZC_TemporalStat maxValue;
+	ZC_TemporalStat avgValue;
+	ZC_TemporalStat variance;
+	ZC_TemporalStat entropy;
+	ZC_TemporalStat* autocorr; /*lags 1..maxLag (autocorr[0] is not used)*/
+
+	/*work space, reused by all the steps*/
+	void* data; /*data of the step being accumulated*/
+	double pilot; /*shift of the values for the sums of the step (average of the previous step)*/
+	size_t nbChunks;
+	double* partials; /*per chunk: sum and lag products 0..maxLag of the shifted values*/
+	double* extrema; /*per chunk: min and max*/
+	double* sums; /*step sums, reduced over the ranks in the online mode*/
+	long* tables; /*one byte histogram (ZC_BYTE_SUBTABLES sub-histograms) per thread*/
+	double* tiles; /*one tile of shifted values per thread*/
+	int nbTables;
+} ZC_PropertyAccumulator;
+
+/*layout of the step sums: count, parts, sum, lag products 0..maxLag, sums of the lagged parts 0..maxLag, byte histogram*/
+#define ZC_ACC_COUNT 0
+#define ZC_ACC_PARTS 1
+#define ZC_ACC_SUM 2
+#define ZC_ACC_PROD 3
+#define ZC_ACC_SUMS_SIZE(maxLag) (ZC_ACC_PROD+2*((maxLag)+1)+256)
+
+void ZC_initTemporalStat(ZC_TemporalStat* stat);
+void ZC_updateTemporalStat(ZC_TemporalStat* stat, double value);
+void ZC_mergeTemporalStat(ZC_TemporalStat* a, ZC_TemporalStat* b);
+double ZC_getTemporalVariance(ZC_TemporalStat* stat);
+double ZC_getTemporalDrift(ZC_TemporalStat* stat);
+
+ZC_PropertyAccumulator* ZC_initPropertyAccumulator(char* varName, int dataType, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
+void ZC_prepareAccumulatorStep(ZC_PropertyAccumulator* acc, void* data);
+void ZC_finishAccumulatorStep(ZC_PropertyAccumulator* acc);
+void ZC_updatePropertyAccumulator_float(ZC_PropertyAccumulator* acc, float* data);
+void ZC_updatePropertyAccumulator_double(ZC_PropertyAccumulator* acc, double* data);
+void ZC_updatePropertyAccumulator(ZC_PropertyAccumulator* acc, void* data);
+void ZC_mergePropertyAccumulator(ZC_PropertyAccumulator* a, ZC_PropertyAccumulator* b);
+ZC_DataProperty* ZC_getAccumulatorStepProperty(ZC_PropertyAccumulator* acc, char* stepName);
+ZC_DataProperty* ZC_finalizePropertyAccumulator(ZC_PropertyAccumulator* acc);
+void ZC_writePropertyAccumulator(ZC_PropertyAccumulator* acc, char* tgtWorkspaceDir);
+void ZC_writeTemporalPointStat(ZC_PropertyAccumulator* acc, char* tgtWorkspaceDir);
+void ZC_freePropertyAccumulator(ZC_PropertyAccumulator* acc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ----- #ifndef _ZC_PropertyAccumulator_H  ----- */
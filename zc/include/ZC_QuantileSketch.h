@@ -0,0 +1,109 @@
+/**
+ *  @file ZC_QuantileSketch.h
+ *  @brief Header file for the ZC_QuantileSketch.c.
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#ifndef _ZC_QuantileSketch_H
+#define _ZC_QuantileSketch_H
+
+#include <stdlib.h>
+#include <limits.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*bins of each sign (8 KB); they cover 2^(ZC_SKETCH_BINS/ZC_SKETCH_BINS_PER_OCTAVE) below the largest magnitude*/
+#define ZC_SKETCH_BINS 1024
+/*each octave [2^e, 2^(e+1)) is split into ZC_SKETCH_BINS_PER_OCTAVE bins of equal width (the first
+ *bits of the mantissa), so the quantiles (middles of the bins) are within 1/64 (1.6%) of the exact ones*/
+#define ZC_SKETCH_MANTISSA_BITS 5
+#define ZC_SKETCH_BINS_PER_OCTAVE (1<<ZC_SKETCH_MANTISSA_BITS)
+
+/*quantiles written in the .prop files (valueQuantiles) and in the .cmp files (errQuantiles)*/
+#define ZC_VALUE_QUANTILE_COUNT 9
+#define ZC_ERR_QUANTILE_COUNT 5
+
+extern int valueQuantilesFlag;
+extern int errQuantilesFlag;
+extern double ZC_valueQuantiles[ZC_VALUE_QUANTILE_COUNT];
+extern double ZC_errQuantiles[ZC_ERR_QUANTILE_COUNT];
+
+/**
+ * Counts of the magnitudes of one sign in logarithmic bins; the window of ZC_SKETCH_BINS
+ * bins ends at the largest magnitude seen so far, and the lowest bin also counts all the
+ * smaller magnitudes.
+ * */
+typedef struct ZC_SketchStore
+{
+	long maxIndex; /*index of the last bin (LONG_MIN: empty)*/
+	long counts[ZC_SKETCH_BINS]; /*counts[i]: bin maxIndex-ZC_SKETCH_BINS+1+i*/
+} ZC_SketchStore;
+
+/**
+ * Mergeable quantile sketch with relative value accuracy (log-bucketed, as in DDSketch).
+ * It is updated in one pass with a few operations per value, its size does not depend
+ * on the number of values, and the merge of two sketches (threads, ranks or chunks of a
+ * file) is exact, so the result does not depend on the order of the updates.
+ * */
+typedef struct ZC_QuantileSketch
+{
+	size_t n;
+	double min;
+	double max;
+	long zeroCount;
+	ZC_SketchStore positive;
+	ZC_SketchStore negative; /*magnitudes of the negative values*/
+} ZC_QuantileSketch;
+
+/*bin of the magnitude x>0: the exponent and the first bits of the mantissa of x, i.e., 
+ *the bin [2^e*(1+j/ZC_SKETCH_BINS_PER_OCTAVE), 2^e*(1+(j+1)/ZC_SKETCH_BINS_PER_OCTAVE)) has the index e*ZC_SKETCH_BINS_PER_OCTAVE+j*/
+static inline long ZC_getSketchIndex(double x)
+{
+	union {double d; unsigned long long u;} b;
+	b.d = x;
+	return (long)(b.u>>(52-ZC_SKETCH_MANTISSA_BITS)) - 1023L*ZC_SKETCH_BINS_PER_OCTAVE;
+}
+
+void ZC_shiftSketchStore(ZC_SketchStore* store, long maxIndex);
+
+static inline void ZC_addSketchIndex(ZC_SketchStore* store, long index)
+{
+	if(index > store->maxIndex)
+		ZC_shiftSketchStore(store, index);
+	long k = index - (store->maxIndex - (ZC_SKETCH_BINS-1));
+	store->counts[k < 0 ? 0 : k]++;
+}
+
+static inline void ZC_addSketchValue(ZC_QuantileSketch* sketch, double x)
+{
+	sketch->n++;
+	if(sketch->min > x) sketch->min = x;
+	if(sketch->max < x) sketch->max = x;
+	if(x > 0)
+		ZC_addSketchIndex(&sketch->positive, ZC_getSketchIndex(x));
+	else if(x < 0)
+		ZC_addSketchIndex(&sketch->negative, ZC_getSketchIndex(-x));
+	else
+		sketch->zeroCount++;
+}
+
+void ZC_initQuantileSketch(ZC_QuantileSketch* sketch);
+ZC_QuantileSketch* ZC_createQuantileSketch();
+ZC_QuantileSketch* ZC_createQuantileSketches(int count);
+void ZC_mergeQuantileSketch(ZC_QuantileSketch* a, ZC_QuantileSketch* b);
+double ZC_getSketchQuantile(ZC_QuantileSketch* sketch, double q);
+void ZC_getQuantileName(double q, char* output);
+char* ZC_constructQuantileString(char* prefix, ZC_QuantileSketch* sketch, double q);
+void ZC_freeQuantileSketch(ZC_QuantileSketch* sketch);
+#ifdef HAVE_MPI
+void ZC_reduceQuantileSketch_online(ZC_QuantileSketch* sketch);
+#endif
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ----- #ifndef _ZC_QuantileSketch_H  ----- */
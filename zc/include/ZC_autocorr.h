@@ -0,0 +1,58 @@
+/**
+ *  @file ZC_autocorr.h
+ *  @brief Header file for the ZC_autocorr.c.
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#ifndef _ZC_Autocorr_H
+#define _ZC_Autocorr_H
+
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*number of positions whose lag products are accumulated together (the tile 
+ *and the maxLag values preceding it stay in L1)*/
+#define ZC_LAG_TILE_SIZE 2048
+
+/*the FFT-based lag sums (with FFTW3) are used from this number of lags and values*/
+#define ZC_AUTOCORR_FFT_MIN_LAG 512
+#define ZC_AUTOCORR_FFT_MIN_SIZE 1048576
+
+/**
+ * Lagged products of a series that is streamed chunk by chunk.
+ * The values are shifted by a pilot estimate of their mean, so the centered
+ * lag sums can be recovered once the exact mean is known, without a second pass.
+ * */
+typedef struct ZC_LagAccumulator
+{
+	int maxLag;
+	size_t n; /*number of values seen so far*/
+	double pilot; /*shift applied to the values*/
+	double sum; /*sum of the shifted values*/
+	double* prod; /*prod[delta] = sum of y[i]*y[i+delta], delta=0..maxLag*/
+	double* head; /*first maxLag shifted values*/
+	double* tail; /*last maxLag shifted values, carried to the next chunk*/
+	double* buffer;
+	size_t bufferSize;
+} ZC_LagAccumulator;
+
+void ZC_accumulateLagProducts(const double* y, size_t m, size_t first, int maxLag, double* prod);
+void ZC_computeLagCorrelations(const double* y, size_t n, int maxLag, double zeroValue, double* autocorr);
+int ZC_useLagSumsFFT(size_t n, int maxLag);
+void ZC_computeLagSumsFFT(double* y, size_t n, int maxLag, double* lagSums);
+size_t ZC_getAutocorr3DLength(size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
+
+void ZC_initLagAccumulator(ZC_LagAccumulator* acc, int maxLag, double pilot);
+void ZC_updateLagAccumulator(ZC_LagAccumulator* acc, double* data, size_t m);
+void ZC_computeCenteredLagSums(ZC_LagAccumulator* acc, double mean, double* lagSums);
+void ZC_freeLagAccumulator(ZC_LagAccumulator* acc);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ----- #ifndef _ZC_Autocorr_H  ----- */
@@ -0,0 +1,33 @@
+/**
+ *  @file ZC_fft.h
+ *  @brief Header file for the ZC_fft.c.
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#ifndef _ZC_FFT_H
+#define _ZC_FFT_H
+
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*the first stages of the transform are done block by block, each block of this
+ *many points (16 bytes each in the split arrays) staying in L2*/
+#define ZC_FFT_BLOCK_SIZE 8192
+
+/*columns of the pruned transform of ZC_fftRealLowBins() transformed together*/
+#define ZC_FFT_TILE_COLUMNS 64
+
+void ZC_fftComplex(double* re, double* im, size_t n);
+void ZC_fftReal(void* data, int dataType, size_t n, double* re, double* im);
+void ZC_fftRealLowBins(void* data, int dataType, size_t n, size_t K, double* re, double* im);
+void ZC_freeFFTTwiddles();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ----- #ifndef _ZC_FFT_H  ----- */
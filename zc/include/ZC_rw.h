@@ -44,6 +44,9 @@ double *ZC_readDoubleData_systemEndian(char *srcFilePath, size_t *nbEle);
 float *ZC_readFloatData_systemEndian(char *srcFilePath, size_t *nbEle);
 double *ZC_readDoubleData(char *srcFilePath, size_t *nbEle);
 float *ZC_readFloatData(char *srcFilePath, size_t *nbEle);
+void ZC_readDataChunk(int fd, size_t elemSize, size_t offset, size_t nbEle, void *buf);
+void ZC_readFloatDataChunk(int fd, size_t offset, size_t nbEle, float *buf);
+void ZC_readDoubleDataChunk(int fd, size_t offset, size_t nbEle, double *buf);
 void ZC_writeByteData(unsigned char *bytes, size_t byteLength, char *tgtFilePath);
 void ZC_writeDoubleData(double *data, size_t nbEle, char *tgtFilePath);
 void ZC_writeFloatData(float *data, size_t nbEle, char *tgtFilePath);
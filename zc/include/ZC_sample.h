@@ -0,0 +1,49 @@
+/**
+ *  @file ZC_sample.h
+ *  @brief Header file for the ZC_sample.c.
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#ifndef _ZC_Sample_H
+#define _ZC_Sample_H
+
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*the sampling unit of the approximate mode: contiguous blocks of data points*/
+#define ZC_SAMPLE_BLOCK_SIZE 4096
+
+/*normal quantile of the 95% confidence intervals*/
+#define ZC_SAMPLE_Z 1.959964
+
+extern double sampleRatio; /*fraction of the data analyzed in the approximate mode (1: exact analysis)*/
+extern unsigned int sampleSeed;
+
+/**
+ * Sums over the sampled blocks needed by the ratio estimator of sum(y)/sum(n),
+ * where y is a per-block total (e.g., sum of the errors) and n the block length.
+ * */
+typedef struct ZC_RatioSums
+{
+	double y, n;
+	double yy, yn, nn;
+} ZC_RatioSums;
+
+size_t ZC_computeSampleBlockCount(size_t n);
+size_t* ZC_selectSampleBlocks(size_t n, double ratio, unsigned int seed, size_t* nbSampled);
+size_t ZC_getSampleBlockLength(size_t n, size_t block);
+void** ZC_getSampleBlockPointers(void* data, size_t elemSize, size_t n, size_t* blocks, size_t nbSampled, size_t* lengths);
+
+void ZC_initRatioSums(ZC_RatioSums* s);
+void ZC_addRatioSample(ZC_RatioSums* s, double y, double n);
+double ZC_estimateRatio(ZC_RatioSums* s, size_t nbSampled, size_t nbBlocks, double* halfWidth);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ----- #ifndef _ZC_Sample_H  ----- */
@@ -0,0 +1,109 @@
+/**
+ *  @file ZC_simd.h
+ *  @brief Header file for the ZC_simd.c: the vectorized kernels of the error statistics.
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#ifndef _ZC_Simd_H
+#define _ZC_Simd_H
+
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define ZC_SIMD_AUTO 0
+#define ZC_SIMD_SCALAR 1
+#define ZC_SIMD_AVX2 2
+#define ZC_SIMD_AVX512 3
+#define ZC_SIMD_NEON 4
+
+/*relative tolerance used by the validation mode for the sums (min/max and counts must match exactly)*/
+#define ZC_SIMD_VALIDATION_TOL 1E-10
+
+typedef struct ZC_DiffSums
+{
+	double sum1, sum2, sumDiff; /*sums of data1, data2 and diff=data2-data1*/
+	double sumErr, sumErrSqr; /*sums of |diff| and diff^2*/
+	double minDiff, maxDiff, minErr, maxErr;
+} ZC_DiffSums;
+
+typedef struct ZC_RelSums
+{
+	size_t n_rel; /*number of points with data1!=0*/
+	double minDiff_rel, maxDiff_rel, minErr_rel, maxErr_rel;
+	double sumErr_rel, sumErrSqr_rel;
+} ZC_RelSums;
+
+typedef struct ZC_CoMoments
+{
+	double m2_1, m2_2, m2_diff, c12, c1d;
+} ZC_CoMoments;
+
+typedef struct ZC_Kernels
+{
+	int type; /*ZC_SIMD_SCALAR, ZC_SIMD_AVX2, ...*/
+	const char* name;
+	
+	void (*diffSums_float)(const float* data1, const float* data2, size_t n, ZC_DiffSums* s);
+	void (*diffSums_double)(const double* data1, const double* data2, size_t n, ZC_DiffSums* s);
+	void (*relSums_float)(const float* data1, const float* data2, size_t n, ZC_RelSums* s);
+	void (*relSums_double)(const double* data1, const double* data2, size_t n, ZC_RelSums* s);
+	/*centered (co-)moments of data1, data2 and diff about the given means*/
+	void (*coMoments_float)(const float* data1, const float* data2, size_t n, double mean1, double mean2, double meanDiff, ZC_CoMoments* s);
+	void (*coMoments_double)(const double* data1, const double* data2, size_t n, double mean1, double mean2, double meanDiff, ZC_CoMoments* s);
+	
+	/*min, max and sum of the data (min and max start from data[0])*/
+	void (*valueSums_float)(const float* data, size_t n, double* min, double* max, double* sum);
+	void (*valueSums_double)(const double* data, size_t n, double* min, double* max, double* sum);
+	/*sum of (data[i]-center)^2*/
+	double (*sqDevSum_float)(const float* data, size_t n, double center);
+	double (*sqDevSum_double)(const double* data, size_t n, double center);
+	/*number of points whose error exceeds its bound (or is NaN), the bound being min (andMode=1) or
+	 *max (andMode=0) of absBound and pwrBound*|data1[i]|; maxErr is the maximal error*/
+	size_t (*boundViolations_float)(const float* data1, const float* data2, size_t n, double absBound, double pwrBound, int andMode, double* maxErr);
+	size_t (*boundViolations_double)(const double* data1, const double* data2, size_t n, double absBound, double pwrBound, int andMode, double* maxErr);
+} ZC_Kernels;
+
+extern int simdKernelType;
+extern int simdValidationFlag;
+extern size_t simdValidationErrors; /*incremented atomically, read it after the compare*/
+
+void ZC_diffSums_float_scalar(const float* data1, const float* data2, size_t n, ZC_DiffSums* s);
+void ZC_diffSums_double_scalar(const double* data1, const double* data2, size_t n, ZC_DiffSums* s);
+void ZC_relSums_float_scalar(const float* data1, const float* data2, size_t n, ZC_RelSums* s);
+void ZC_relSums_double_scalar(const double* data1, const double* data2, size_t n, ZC_RelSums* s);
+void ZC_coMoments_float_scalar(const float* data1, const float* data2, size_t n, double mean1, double mean2, double meanDiff, ZC_CoMoments* s);
+void ZC_coMoments_double_scalar(const double* data1, const double* data2, size_t n, double mean1, double mean2, double meanDiff, ZC_CoMoments* s);
+void ZC_valueSums_float_scalar(const float* data, size_t n, double* min, double* max, double* sum);
+void ZC_valueSums_double_scalar(const double* data, size_t n, double* min, double* max, double* sum);
+double ZC_sqDevSum_float_scalar(const float* data, size_t n, double center);
+double ZC_sqDevSum_double_scalar(const double* data, size_t n, double center);
+size_t ZC_boundViolations_float_scalar(const float* data1, const float* data2, size_t n, double absBound, double pwrBound, int andMode, double* maxErr);
+size_t ZC_boundViolations_double_scalar(const double* data1, const double* data2, size_t n, double absBound, double pwrBound, int andMode, double* maxErr);
+
+/*merge the results of the scalar tail into those of the vector loop*/
+void ZC_mergeDiffSums(ZC_DiffSums* s, ZC_DiffSums* tail);
+void ZC_mergeRelSums(ZC_RelSums* s, ZC_RelSums* tail);
+
+extern ZC_Kernels zc_scalarKernels;
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+extern ZC_Kernels zc_avx2Kernels;
+extern ZC_Kernels zc_avx512Kernels;
+#endif
+#if defined(__aarch64__)
+extern ZC_Kernels zc_neonKernels;
+#endif
+
+int ZC_parseSimdKernelType(const char* str);
+int ZC_detectSimdKernelType();
+void ZC_selectKernels(int type, int validation);
+ZC_Kernels* ZC_getKernels();
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ----- #ifndef _ZC_Simd_H  ----- */
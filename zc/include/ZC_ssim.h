@@ -5,24 +5,47 @@ extern "C" {
 #endif
 
 #include <stdlib.h>
+
+/*rows of the bands of the 2D and 3D SSIM (one task each)*/
+#define ZC_SSIM_BAND_ROWS 64
+/*points of the chunks of the 1D SSIM (one task each)*/
+#define ZC_SSIM_CHUNK_POINTS 65536
+
+double zc_get_ssim_float(const float *org, const float *rec, int xo, int yo, size_t W, size_t H, const double valueRange);
+double zc_get_ssim_double(const double *org, const double *rec, int xo, int yo, size_t W, size_t H, const double valueRange);
 double zc_calc_ssim_1d_float(const float *org, const float *rec, const size_t r1);
 double zc_calc_ssim_1d_double(const double *org, const double *rec, const size_t r1);
+double zc_calc_ssim_1d_file(int fd1, int fd2, int dataType, size_t r1, double valueRange);
 
 double zc_calc_ssim_2d_float(const float *org, const float *rec,
                   const size_t r2, const size_t r1); //r2 is height, r1 is width
 double zc_calc_ssim_2d_double(const double *org, const double *rec,
                   const size_t r2, const size_t r1);
+double zc_calc_ssim_2d_file(int fd1, int fd2, int dataType, size_t r2, size_t r1, double valueRange);
                   
 void zc_calc_ssim_3d_float(float *org, float *rec, size_t r3, size_t r2, size_t r1, double *min_ssim, double* avg_ssim, double* max_ssim);
 void zc_calc_ssim_3d_double(double *org, double *rec, size_t r3, size_t r2, size_t r1, double *min_ssim, double* avg_ssim, double* max_ssim);
+void zc_calc_ssim_3d_file(int fd1, int fd2, int dataType, size_t r3, size_t r2, size_t r1, double *min_ssim, double* avg_ssim, double* max_ssim);
+
+double zc_calc_ssim_volume_float(const float *org, const float *rec, size_t r4, size_t r3, size_t r2, size_t r1, double valueRange);
+double zc_calc_ssim_volume_double(const double *org, const double *rec, size_t r4, size_t r3, size_t r2, size_t r1, double valueRange);
+double zc_calc_ssim_volume_file(int fd1, int fd2, int dataType, size_t r4, size_t r3, size_t r2, size_t r1, double valueRange);
+
+void ZC_parseSsimProcGrid(char* s, int* grid);
 
 //mpi interfaces
+double zc_calc_ssim_1d_float_online(const float *org, const float *rec, const size_t r1);
+double zc_calc_ssim_1d_double_online(const double *org, const double *rec, const size_t r1);
+
 double zc_calc_ssim_2d_float_online(const float *org, const float *rec, const size_t r2, const size_t r1);
 double zc_calc_ssim_2d_double_online(const double *org, const double *rec, const size_t r2, const size_t r1);
 
 void zc_calc_ssim_3d_float_online(float *org, float *rec, size_t r3, size_t r2, size_t r1, double *global_min_ssim, double* global_avg_ssim, double* global_max_ssim);
 void zc_calc_ssim_3d_double_online(double *org, double *rec, size_t r3, size_t r2, size_t r1, double *global_min_ssim, double* global_avg_ssim, double* global_max_ssim);
 
+double zc_calc_ssim_volume_float_online(const float *org, const float *rec, size_t r4, size_t r3, size_t r2, size_t r1, double valueRange);
+double zc_calc_ssim_volume_double_online(const double *org, const double *rec, size_t r4, size_t r3, size_t r2, size_t r1, double valueRange);
+
 #ifdef __cplusplus
 }
 #endif
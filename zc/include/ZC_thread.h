@@ -0,0 +1,39 @@
+/**
+ *  @file ZC_thread.h
+ *  @brief Header file for the ZC_thread.c.
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#ifndef _ZC_Thread_H
+#define _ZC_Thread_H
+
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*the data are split into chunks of ZC_CHUNK_SIZE points independently of the 
+ * number of threads, so that the partial results and the order in which they 
+ * are merged do not depend on the thread count*/
+#define ZC_CHUNK_SIZE 262144
+
+extern int nbThreads;
+
+typedef void (*ZC_TaskFunc)(void* arg, int threadID, size_t taskID);
+
+void ZC_setNbThreads(int n);
+int ZC_getNbThreads();
+int ZC_computeThreadCount(size_t nbTasks);
+size_t ZC_computeChunkCount(size_t numOfElem);
+void ZC_runTasks(ZC_TaskFunc func, void* arg, size_t nbTasks);
+void ZC_freeThreadPool();
+void ZC_reduceSumTree(double* partials, size_t count, size_t width);
+void ZC_atomicMin(volatile size_t* p, size_t value);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ----- #ifndef _ZC_Thread_H  ----- */
@@ -0,0 +1,65 @@
+/**
+ *  @file ZC_verify.h
+ *  @brief Header file for the ZC_verify.c.
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#ifndef _ZC_Verify_H
+#define _ZC_Verify_H
+
+#include <stdlib.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*the data are checked by blocks of this many points, so the check stops soon after the first violation*/
+#define ZC_VERIFY_BLOCK_SIZE 4096
+
+extern size_t verifyMaxViolations; /*number of violating points reported (0: count all of them)*/
+
+/*result of the check of one chunk of the data (ZC_CHUNK_SIZE points)*/
+typedef struct ZC_VerifyChunk
+{
+	double maxErr;
+	size_t nbChecked;
+	size_t nbViolations;
+	size_t* violations; /*indices of the first violating points of the chunk*/
+} ZC_VerifyChunk;
+
+/**
+ * Result of the error-bound verification: the point i passes if
+ * |data2[i]-data1[i]| <= absBound (OR/AND) pwrBound*|data1[i]|.
+ * */
+typedef struct ZC_VerifyResult
+{
+	int pass;
+	int errBoundMode;
+	double absBound; /*absolute bound, with the REL bound already turned into an absolute one*/
+	double pwrBound; /*point-wise relative bound ratio (0: none)*/
+	int andMode; /*1: both bounds must hold, 0: one of them*/
+
+	double maxAbsErr; /*over the checked points only, if the check stopped early*/
+	size_t nbChecked;
+	size_t nbViolations; /*the violations found (all of them only if the check did not stop early)*/
+	size_t* violations; /*indices of the first min(nbViolations, maxViolations) violating points*/
+	size_t r5, r4, r3, r2, r1;
+} ZC_VerifyResult;
+
+int ZC_parseErrorBoundMode(const char* s);
+const char* ZC_getErrorBoundModeName(int errBoundMode);
+int ZC_errorBoundNeedsRange(int errBoundMode);
+void ZC_resolveErrorBound(ZC_VerifyResult* result, int errBoundMode, double absErrBound, double relBoundRatio,
+double pwrBoundRatio, double valueRange);
+void ZC_computeCoordinates(size_t index, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1, size_t* coords);
+void ZC_mergeVerifyChunks(ZC_VerifyResult* result, ZC_VerifyChunk* chunks, size_t nbChunks, size_t maxViolations);
+ZC_VerifyResult* ZC_verifyErrorBound(int dataType, void* data1, void* data2, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
+void ZC_printVerifyResult(ZC_VerifyResult* result, void* data1, void* data2, int dataType);
+void ZC_freeVerifyResult(ZC_VerifyResult* result);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* ----- #ifndef _ZC_Verify_H  ----- */
@@ -32,6 +32,12 @@
 #include "ZC_latex.h"
 #include "ZC_ByteToolkit.h"
 #include "ZC_conf.h"
+#include "ZC_thread.h"
+#include "ZC_sample.h"
+#include "ZC_simd.h"
+#include "ZC_fft.h"
+#include "ZC_PropertyAccumulator.h"
+#include "ZC_QuantileSketch.h"
 #ifdef HAVE_MPI
 #include <mpi.h>
 #endif
@@ -72,12 +78,22 @@ extern "C" {
 #define PDF_INTERVALS_REL 50000
 #define AUTOCORR_SIZE 100
 #define FFT_SIZE 128
+#define ZC_FFT_PARTIAL 0 /*fftMode: only the FFT_SIZE reported coefficients*/
+#define ZC_FFT_FULL 1 /*fftMode: the whole spectrum*/
+
+#define ZC_FFTW_ESTIMATE 0 /*fftwPlanner: FFTW_ESTIMATE plans (no measurement)*/
+#define ZC_FFTW_MEASURE 1 /*fftwPlanner: FFTW_MEASURE plans, with the wisdom kept in fftwWisdomFile*/
 #define ENTROPY_BLOCK_SIZE 100
 
 #define ABS 0
 #define REL 1
 #define ABS_AND_REL 2
 #define ABS_OR_REL 3
+#define PW_REL 10
+#define ABS_AND_PW_REL 11
+#define ABS_OR_PW_REL 12
+#define REL_AND_PW_REL 13
+#define REL_OR_PW_REL 14
 
 #define ZC_FLOAT 0
 #define ZC_DOUBLE 1
@@ -132,6 +148,7 @@ extern char *zc_cfgFile;
 extern int errorBoundMode;
 extern double absErrBound;
 extern double relBoundRatio;
+extern double pwrBoundRatio;
 
 extern int compressTimeFlag;
 extern int decompressTimeFlag;
@@ -142,9 +159,15 @@ extern int maxValueFlag;
 extern int valueRangeFlag;
 extern int avgValueFlag;
 extern int entropyFlag;
+extern int quantEntropyFlag;
+extern double quantEntropyBoundRatio;
 extern int autocorrFlag;
 extern int autocorr3DFlag;
+extern int autocorr3DMaxLag;
 extern int fftFlag;
+extern int fftMode;
+extern int fftwPlanner;
+extern char* fftwWisdomFile;
 extern int lapFlag;
 
 extern int minAbsErrFlag;
@@ -154,6 +177,7 @@ extern int errAutoCorrFlag;
 extern int errAutoCorr3DFlag;
 extern int absErrPDFFlag;
 extern int pwrErrPDFFlag;
+extern int pwrErrFlag;
 
 extern int minRelErrFlag;
 extern int avgRelErrFlag;
@@ -169,6 +193,9 @@ extern int pearsonCorrFlag;
 extern int KS_testFlag;
 extern int SSIMFlag;
 extern int SSIMIMAGE2DFlag;
+extern int ssimImage2DSlices;
+extern int SSIMVOLUME3DFlag;
+extern int ssimProcGrid[3];
 
 extern int plotAutoCorrFlag;
 
@@ -332,6 +359,7 @@ int ZC_executeCmd_RdoubleMatrix(char* cmd, int* m, int* n, double** data);
 
 //online interfaces
 long ZC_computeDataLength_online(size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
+ZC_DataProperty* ZC_createProperty_online(char* varName, int dataType, void *oriData, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
 ZC_DataProperty* ZC_startCmpr_online(char* varName, int dataType, void *oriData, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
 ZC_CompareData* ZC_endCmpr_online(ZC_DataProperty* dataProperty, char* solution, long cmprSize);
 void ZC_startDec_online();
@@ -340,6 +368,7 @@ void ZC_endDec_online(ZC_CompareData* compareResult, void *decData);
 
 //overall interfaces for checkingStatus==PROBE_COMPRESSOR
 ZC_DataProperty* ZC_startCmpr(char* varName, int dataType, void *oriData, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
+ZC_DataProperty* ZC_startCmpr_reuse(char* varName, int dataType, void *oriData, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1);
 ZC_CompareData* ZC_endCmpr(ZC_DataProperty* dataProperty, char* solution, long cmprSize);
 void ZC_startDec();
 void ZC_endDec(ZC_CompareData* compareResult, void *decData);
@@ -2,15 +2,31 @@
 #include <stdlib.h>
 #include <math.h>
 #include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
 #include "ZC_util.h"
 #include "ZC_DataProperty.h"
 #include "ZC_CompareData.h"
+#include "ZC_autocorr.h"
 #include "zc.h"
 #include "iniparser.h"
+#include "ZC_rw.h"
 #ifdef HAVE_ONLINEVIS
 #include "zserver.h"
 #endif
 
+ZC_MetricPlan metricPlan = {ZC_STAT_ALL, 1};
+
+void ZC_resolveMetricPlan(ZC_MetricPlan* plan)
+{
+	plan->statMask = 0;
+	if(pwrErrFlag || pwrErrPDFFlag)
+		plan->statMask |= ZC_STAT_REL;
+	if(pearsonCorrFlag || valErrCorrFlag || errAutoCorrFlag)
+		plan->statMask |= ZC_STAT_MOMENTS;
+	plan->errPDF = absErrPDFFlag || pwrErrPDFFlag;
+}
+
 void freeCompareResult_internal(ZC_CompareData* compareData)
 {
 	//free(compareData->property);
@@ -28,6 +44,11 @@ void freeCompareResult_internal(ZC_CompareData* compareData)
 		free(compareData->pwrErrPDF);
 	if(compareData->fftCoeff!=NULL)
 		free(compareData->fftCoeff);
+	if(compareData->absErrPDF_ci!=NULL)
+		free(compareData->absErrPDF_ci);
+	ZC_freeErrMap(compareData->errMap);
+	ZC_freeQuantileSketch(compareData->absErrSketch);
+	ZC_freeQuantileSketch(compareData->pwrErrSketch);
 	free(compareData);
 }
 
@@ -88,12 +109,317 @@ double* autoCorrAbsErr, double* absErrPDF)
 	return result;
 }
 
+void ZC_initCompareStat(ZC_CompareStat* stat)
+{
+	memset(stat, 0, sizeof(ZC_CompareStat));
+	stat->minDiff = 1E100;
+	stat->maxDiff = -1E100;
+	stat->minErr = 1E100;
+	stat->maxErr = 0;
+	stat->minDiff_rel = 1E100;
+	stat->maxDiff_rel = -1E100;
+	stat->minErr_rel = 1E100;
+	stat->maxErr_rel = 0;
+}
+
+/**
+ * Merge the statistics of another set of points into stat (pairwise update of 
+ * the means and the centered (co-)moments).
+ * */
+void ZC_mergeCompareStat(ZC_CompareStat* stat, ZC_CompareStat* other)
+{
+	if(other->n == 0)
+		return;
+	if(stat->n == 0)
+	{
+		*stat = *other;
+		return;
+	}
+	
+	double na = stat->n, nb = other->n;
+	double n = na + nb;
+	double w = na*nb/n;
+	double d1 = other->mean1 - stat->mean1;
+	double d2 = other->mean2 - stat->mean2;
+	double dd = other->meanDiff - stat->meanDiff;
+	
+	stat->mean1 += d1*nb/n;
+	stat->mean2 += d2*nb/n;
+	stat->meanDiff += dd*nb/n;
+	stat->m2_1 += other->m2_1 + d1*d1*w;
+	stat->m2_2 += other->m2_2 + d2*d2*w;
+	stat->m2_diff += other->m2_diff + dd*dd*w;
+	stat->c12 += other->c12 + d1*d2*w;
+	stat->c1d += other->c1d + d1*dd*w;
+	stat->n += other->n;
+	
+	if(stat->minDiff > other->minDiff) stat->minDiff = other->minDiff;
+	if(stat->maxDiff < other->maxDiff) stat->maxDiff = other->maxDiff;
+	if(stat->minErr > other->minErr) stat->minErr = other->minErr;
+	if(stat->maxErr < other->maxErr) stat->maxErr = other->maxErr;
+	stat->sumErr += other->sumErr;
+	stat->sumErrSqr += other->sumErrSqr;
+	
+	stat->n_rel += other->n_rel;
+	if(stat->minDiff_rel > other->minDiff_rel) stat->minDiff_rel = other->minDiff_rel;
+	if(stat->maxDiff_rel < other->maxDiff_rel) stat->maxDiff_rel = other->maxDiff_rel;
+	if(stat->minErr_rel > other->minErr_rel) stat->minErr_rel = other->minErr_rel;
+	if(stat->maxErr_rel < other->maxErr_rel) stat->maxErr_rel = other->maxErr_rel;
+	stat->sumErr_rel += other->sumErr_rel;
+	stat->sumErrSqr_rel += other->sumErrSqr_rel;
+}
+
+/**
+ * Merge count partial statistics with a fixed-shape pairwise tree, so that the
+ * result only depends on how the data were split (not on the thread count).
+ * The result is left in stats[0].
+ * */
+void ZC_reduceCompareStat(ZC_CompareStat* stats, size_t count)
+{
+	size_t stride, i;
+	for(stride = 1; stride < count; stride *= 2)
+		for(i = 0; i + stride < count; i += 2*stride)
+			ZC_mergeCompareStat(&stats[i], &stats[i+stride]);
+}
+
+/**
+ * Fill in the moment-style metrics of compareResult (error bounds, mse-based 
+ * metrics and correlations) from the accumulated statistics.
+ * */
+void ZC_applyCompareStat(ZC_CompareData* compareResult, ZC_CompareStat* stat)
+{
+	double numOfElem = stat->n;
+	double valRange = compareResult->property->valueRange;
+	double zeromean_variance = compareResult->property->zeromean_variance;
+	double mse = stat->sumErrSqr/numOfElem;
+	
+	if (minAbsErrFlag)
+		compareResult->minAbsErr = stat->minErr;
+
+	if (minRelErrFlag)
+		compareResult->minRelErr = stat->minErr/valRange;
+
+	if (maxAbsErrFlag)
+		compareResult->maxAbsErr = stat->maxErr;
+
+	if (maxRelErrFlag)
+		compareResult->maxRelErr = stat->maxErr/valRange;
+
+	if (avgAbsErrFlag)
+		compareResult->avgAbsErr = stat->sumErr/numOfElem;
+
+	if (avgRelErrFlag)
+		compareResult->avgRelErr = stat->sumErr/numOfElem/valRange;
+		
+	if (pwrErrFlag)
+	{
+		compareResult->minPWRErr = stat->minErr_rel;
+		compareResult->maxPWRErr = stat->maxErr_rel;
+		compareResult->avgPWRErr = stat->sumErr_rel/stat->n_rel;
+	}
+
+	if (pearsonCorrFlag)
+	{
+		double std1 = sqrt(stat->m2_1/numOfElem);
+		double std2 = sqrt(stat->m2_2/numOfElem);
+		double ee = stat->c12/numOfElem;
+		double pearsonCorr = 0;
+
+		if (std1*std2 != 0)
+			pearsonCorr = ee/std1/std2;
+
+		compareResult->pearsonCorr = pearsonCorr;
+	}
+
+	if (rmseFlag)
+		compareResult->rmse = sqrt(mse);
+
+	if (nrmseFlag)
+		compareResult->nrmse = sqrt(mse)/valRange;
+
+	if (snrFlag)
+		compareResult->snr = 10*log10(zeromean_variance/mse);
+
+	if (psnrFlag)
+		compareResult->psnr = -20.0*log10(sqrt(mse)/valRange);
+
+	//the correlation between the original data values and the compression errors
+	if (valErrCorrFlag)
+	{
+		double std1 = sqrt(stat->m2_1/numOfElem);
+		double stdDiff = sqrt(stat->m2_diff/numOfElem);
+		double ee = stat->c1d/numOfElem;
+		double valErrCorr = 0;
+
+		if (std1*stdDiff != 0)
+			valErrCorr = ee/std1/stdDiff;
+
+		compareResult->valErrCorr = valErrCorr;
+	}
+}
+
+/**
+ * The bins of the error distributions: the absolute errors span [minDiff, maxDiff], 
+ * the point-wise relative ones are clipped to +/-PWR_DIS_RNG_BOUND.
+ * */
+void ZC_computeErrPDFRange(ZC_CompareStat* stat, double* minDiff, double* interval, double* minDiff_rel, double* maxDiff_rel, double* interval_rel)
+{
+	double diffRange_rel = stat->maxDiff_rel - stat->minDiff_rel;
+	*minDiff = stat->minDiff;
+	*interval = (stat->maxDiff - stat->minDiff)/PDF_INTERVALS;
+	*minDiff_rel = stat->minDiff_rel;
+	*maxDiff_rel = stat->maxDiff_rel;
+	if(diffRange_rel>2*PWR_DIS_RNG_BOUND)
+	{
+		double avg = 0;
+		diffRange_rel = 2*PWR_DIS_RNG_BOUND;
+		*minDiff_rel = avg-PWR_DIS_RNG_BOUND;
+		*maxDiff_rel = avg+PWR_DIS_RNG_BOUND;
+	}
+	*interval_rel = diffRange_rel/PDF_INTERVALS_REL;
+}
+
+/**
+ * Allocate the (zeroed) counts of the error distributions that are requested 
+ * in the configuration and not degenerate; the others are left to NULL.
+ * */
+void ZC_allocErrPDFCounts(ZC_CompareStat* stat, double** absCounts, double** relCounts)
+{
+	double minDiff, interval, minDiff_rel, maxDiff_rel, interval_rel;
+	ZC_computeErrPDFRange(stat, &minDiff, &interval, &minDiff_rel, &maxDiff_rel, &interval_rel);
+	*absCounts = NULL;
+	*relCounts = NULL;
+	if(absErrPDFFlag && interval!=0)
+		*absCounts = (double*)calloc(PDF_INTERVALS, sizeof(double));
+	if(pwrErrPDFFlag && interval_rel!=0)
+		*relCounts = (double*)calloc(PDF_INTERVALS_REL, sizeof(double));
+}
+
+/**
+ * Normalize the counts into the distributions of compareResult, which takes 
+ * over the arrays allocated by ZC_allocErrPDFCounts().
+ * */
+void ZC_finalizeErrPDF(ZC_CompareData* compareResult, ZC_CompareStat* stat, double* absCounts, double* relCounts)
+{
+	size_t i;
+	double minDiff, interval, minDiff_rel, maxDiff_rel, interval_rel;
+	ZC_computeErrPDFRange(stat, &minDiff, &interval, &minDiff_rel, &maxDiff_rel, &interval_rel);
+	
+	if (absErrPDFFlag)
+	{
+		double *absErrPDF = absCounts;
+		if(interval==0)
+		{
+			absErrPDF = (double*)malloc(sizeof(double));
+			*absErrPDF = 0;
+		}
+		else
+		{
+			for (i = 0; i < PDF_INTERVALS; i++)
+				absErrPDF[i]/=stat->n;
+		}
+		compareResult->absErrPDF = absErrPDF;
+		compareResult->err_interval = interval;
+		compareResult->err_minValue = minDiff;
+	}
+	
+	if (pwrErrPDFFlag)
+	{
+		double *relErrPDF = relCounts;
+		if(interval_rel==0)
+		{
+			relErrPDF = (double*)malloc(sizeof(double));
+			*relErrPDF = 0;
+		}
+		else
+		{
+			for (i = 0; i < PDF_INTERVALS_REL; i++)
+				relErrPDF[i]/=stat->n_rel;
+		}
+		compareResult->pwrErrPDF = relErrPDF;
+		compareResult->err_interval_rel = interval_rel;
+		compareResult->err_minValue_rel = minDiff_rel;
+	}
+}
+
+/*empty statistics, of which the ZC_REDUCE_* parts of mask are reduced*/
+void ZC_initOnlineStat(ZC_OnlineStat* stat, int mask)
+{
+	stat->mask = mask;
+	ZC_initPropertyStat(&stat->property);
+	ZC_initCompareStat(&stat->compare);
+}
+
+void ZC_mergeOnlineStat(ZC_OnlineStat* stat, ZC_OnlineStat* other)
+{
+	if(stat->mask & ZC_REDUCE_PROPERTY)
+		ZC_mergePropertyStat(&stat->property, &other->property);
+	if(stat->mask & ZC_REDUCE_COMPARE)
+		ZC_mergeCompareStat(&stat->compare, &other->compare);
+}
+
+#ifdef HAVE_MPI
+/*the datatype and the MPI_Op of ZC_reduceOnlineStat_online(), created by its first call*/
+static MPI_Datatype zc_onlineStatType = MPI_DATATYPE_NULL;
+static MPI_Op zc_onlineStatOp = MPI_OP_NULL;
+
+/*the MPI_Op of ZC_reduceOnlineStat_online(): inout = in merged with inout, in this order*/
+static void ZC_mergeOnlineStatOp(void* in, void* inout, int* len, MPI_Datatype* type)
+{
+	int i;
+	ZC_OnlineStat* a = (ZC_OnlineStat*)in;
+	ZC_OnlineStat* b = (ZC_OnlineStat*)inout;
+	for(i=0;i<*len;i++)
+	{
+		ZC_OnlineStat merged = a[i];
+		ZC_mergeOnlineStat(&merged, &b[i]);
+		b[i] = merged;
+	}
+}
+
+/**
+ * Merge the statistics of all the ranks with a single MPI_Allreduce (collective, all the 
+ * ranks get the result), instead of one reduction per sum, minimum or maximum. The operator 
+ * is declared non-commutative, so the statistics are merged in the order of the ranks 
+ * and the result does not depend on the reduction algorithm of the MPI library.
+ * */
+void ZC_reduceOnlineStat_online(ZC_OnlineStat* stat)
+{
+	ZC_OnlineStat result;
+	if(zc_onlineStatOp == MPI_OP_NULL)
+	{
+		MPI_Type_contiguous(sizeof(ZC_OnlineStat), MPI_BYTE, &zc_onlineStatType);
+		MPI_Type_commit(&zc_onlineStatType);
+		MPI_Op_create(ZC_mergeOnlineStatOp, 0, &zc_onlineStatOp);
+	}
+	MPI_Allreduce(stat, &result, 1, zc_onlineStatType, zc_onlineStatOp, ZC_COMM_WORLD);
+	*stat = result;
+}
+
+/*free the datatype and the MPI_Op of ZC_reduceOnlineStat_online() (called by ZC_Finalize(); 
+ * after MPI_Finalize() they are already released by MPI)*/
+void ZC_freeOnlineStatOp()
+{
+	int finalized = 0;
+	if(zc_onlineStatOp == MPI_OP_NULL)
+		return;
+	MPI_Finalized(&finalized);
+	if(!finalized)
+	{
+		MPI_Op_free(&zc_onlineStatOp);
+		MPI_Type_free(&zc_onlineStatType);
+	}
+	zc_onlineStatOp = MPI_OP_NULL;
+	zc_onlineStatType = MPI_DATATYPE_NULL;
+}
+#endif
+
 void ZC_computeFFT_float_offline(ZC_CompareData* compareResult,float* data1, float* data2, size_t numOfElem)
 {
-	size_t fft_size = pow(2,(int)log2(numOfElem));
-	 
-	complex* fftCoeff1 = ZC_computeFFT(data1, fft_size, ZC_FLOAT);
-	complex* fftCoeff2 = ZC_computeFFT(data2, fft_size, ZC_FLOAT);
+	if(sampleRatio < 1) //approximate mode: the fft needs the whole data
+		return;
+	complex* fftCoeff1 = ZC_getFFTCoeff(compareResult->property); //the original's coefficients are computed only once
+	complex* fftCoeff2 = ZC_computeFFTCoeff(data2, numOfElem, ZC_FLOAT);
 	complex* fftCoeffRelDiff = (complex*)malloc(FFT_SIZE*sizeof(complex));
 	size_t i;
 	fftCoeffRelDiff[0].Re = fabs((fftCoeff2[0].Re - fftCoeff1[0].Re)/fftCoeff1[0].Re);
@@ -106,16 +432,15 @@ void ZC_computeFFT_float_offline(ZC_CompareData* compareResult,float* data1, flo
 		fftCoeffRelDiff[i].Amp= fabs((fftCoeff2[i].Amp - fftCoeff1[i].Amp)/fftCoeff1[i].Amp);
 	}			
 	compareResult->fftCoeff = fftCoeffRelDiff;
-	free(fftCoeff1);
 	free(fftCoeff2);	
 }
 
 void ZC_computeFFT_double_offline(ZC_CompareData* compareResult, double* data1, double* data2, size_t numOfElem)
 {
-	size_t fft_size = pow(2,(int)log2(numOfElem));
-	 
-	complex* fftCoeff1 = ZC_computeFFT(data1, fft_size, ZC_FLOAT);
-	complex* fftCoeff2 = ZC_computeFFT(data2, fft_size, ZC_FLOAT);
+	if(sampleRatio < 1) //approximate mode: the fft needs the whole data
+		return;
+	complex* fftCoeff1 = ZC_getFFTCoeff(compareResult->property); //the original's coefficients are computed only once
+	complex* fftCoeff2 = ZC_computeFFTCoeff(data2, numOfElem, ZC_DOUBLE);
 	complex* fftCoeffRelDiff = (complex*)malloc(FFT_SIZE*sizeof(complex));
 	size_t i;
 	fftCoeffRelDiff[0].Re = fabs((fftCoeff2[0].Re - fftCoeff1[0].Re)/fftCoeff1[0].Re);
@@ -128,7 +453,6 @@ void ZC_computeFFT_double_offline(ZC_CompareData* compareResult, double* data1,
 		fftCoeffRelDiff[i].Amp= fabs((fftCoeff2[i].Amp - fftCoeff1[i].Amp)/fftCoeff1[i].Amp);
 	}			
 	compareResult->fftCoeff = fftCoeffRelDiff;
-	free(fftCoeff1);
 	free(fftCoeff2);	
 }
 
@@ -185,8 +509,7 @@ void ZC_compareData_dec(ZC_CompareData* compareResult, void *decData)
 		}
 		else
 		{
-			if(fftFlag)
-				ZC_compareData_double_online(compareResult, data1, data2, r5, r4, r3, r2, r1);	
+			ZC_compareData_double_online(compareResult, data1, data2, r5, r4, r3, r2, r1);	
 		}
 #else
 		ZC_computeFFT_double_offline(compareResult, data1, data2, numOfElem);
@@ -200,6 +523,10 @@ void ZC_compareData_dec(ZC_CompareData* compareResult, void *decData)
 	}
 }
 
+/**
+ * The property of the result borrows oriData, like ZC_startCmpr(): call 
+ * ZC_releasePropertyData() on it before freeing oriData if the result is kept.
+ * */
 ZC_CompareData* ZC_compareData(char* varName, int dataType, void *oriData, void *decData, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
 {
 	ZC_CompareData* compareResult = (ZC_CompareData*)malloc(sizeof(ZC_CompareData));
@@ -220,7 +547,8 @@ ZC_CompareData* ZC_compareData(char* varName, int dataType, void *oriData, void
 		}//ZC_ONLINE
 		else
 		{
-			compareResult->property = ZC_startCmpr_online(varName, ZC_FLOAT, data1, r5, r4, r3, r2, r1);
+			//the basic properties of data1 are reduced together with the comparison
+			compareResult->property = ZC_createProperty_online(varName, ZC_FLOAT, data1, r5, r4, r3, r2, r1);
 			ZC_compareData_float_online(compareResult, data1, data2, r5, r4, r3, r2, r1);			
 		}
 #else
@@ -242,7 +570,8 @@ ZC_CompareData* ZC_compareData(char* varName, int dataType, void *oriData, void
 		}//ZC_ONLINE
 		else
 		{
-			compareResult->property = ZC_startCmpr_online(varName, ZC_DOUBLE, data1, r5, r4, r3, r2, r1);
+			//the basic properties of data1 are reduced together with the comparison
+			compareResult->property = ZC_createProperty_online(varName, ZC_DOUBLE, data1, r5, r4, r3, r2, r1);
 			ZC_compareData_double_online(compareResult, data1, data2, r5, r4, r3, r2, r1);
 		}
 #else
@@ -258,16 +587,196 @@ ZC_CompareData* ZC_compareData(char* varName, int dataType, void *oriData, void
 	return compareResult;
 }
 
+/**
+ * Compare k decompressed data sets decData[0..k-1] with the original data of 
+ * property (property->data, e.g., from ZC_startCmpr()), reading the original data 
+ * only once for the k candidates. solutions[j] (may be NULL) is the key of the 
+ * j-th result. The results are identical to k calls of ZC_compareData() (offline).
+ * */
+ZC_CompareData** ZC_compareData_batch(ZC_DataProperty* property, void** decData, char** solutions, int k)
+{
+	int j;
+	ZC_CompareData** compareResults = (ZC_CompareData**)malloc(sizeof(ZC_CompareData*)*k);
+	for(j=0;j<k;j++)
+	{
+		compareResults[j] = (ZC_CompareData*)malloc(sizeof(ZC_CompareData));
+		memset(compareResults[j], 0, sizeof(ZC_CompareData));
+		compareResults[j]->property = property;
+		if(solutions!=NULL && solutions[j]!=NULL)
+		{
+			compareResults[j]->solution = (char*)malloc(strlen(solutions[j])+1);
+			strcpy(compareResults[j]->solution, solutions[j]);
+		}
+	}
+	
+	if(property->dataType==ZC_FLOAT)
+		ZC_compareData_batch_float(compareResults, (float*)property->data, (float**)decData, k, 
+		property->r5, property->r4, property->r3, property->r2, property->r1);
+	else if(property->dataType==ZC_DOUBLE)
+		ZC_compareData_batch_double(compareResults, (double*)property->data, (double**)decData, k, 
+		property->r5, property->r4, property->r3, property->r2, property->r1);
+	else
+	{
+		printf("Error 2: dataType is wrong! (dataType == %d)\n", property->dataType);
+		exit(0);
+	}
+	return compareResults;
+}
+
+/**
+ * Compare the original and decompressed data files chunk by chunk, keeping only 
+ * chunkSize data points of each file in memory (see ZC_compareDataFile_float()). 
+ * The chunk size is rounded up to a multiple of ZC_STAT_BLOCK_SIZE; the data 
+ * that fit in one chunk are simply loaded and compared by ZC_compareData(); otherwise, 
+ * errAutoCorr3D and the fft metrics are skipped (they need the whole data).
+ * The returned property does not keep any data (property->data is NULL).
+ * */
+ZC_CompareData* ZC_compareDataFiles(char* varName, int dataType, char* oriFilePath, char* decFilePath, size_t chunkSize, 
+size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
+{
+	ZC_CompareData* compareResult = NULL;
+	size_t numOfElem = ZC_computeDataLength(r5, r4, r3, r2, r1);
+	size_t elemSize, nbEle1, nbEle2;
+	
+	if(dataType==ZC_FLOAT)
+		elemSize = sizeof(float);
+	else if(dataType==ZC_DOUBLE)
+		elemSize = sizeof(double);
+	else
+	{
+		printf("Error 2: dataType is wrong! (dataType == %d)\n", dataType);
+		exit(0);
+	}
+	
+	nbEle1 = ZC_checkFileSize(oriFilePath)/elemSize;
+	nbEle2 = ZC_checkFileSize(decFilePath)/elemSize;
+	if(nbEle1 < numOfElem || nbEle2 < numOfElem)
+	{
+		printf("Error: the data files contain %zu and %zu elements, but the dimensions require %zu\n", nbEle1, nbEle2, numOfElem);
+		exit(0);
+	}
+	
+	chunkSize = (chunkSize+ZC_STAT_BLOCK_SIZE-1)/ZC_STAT_BLOCK_SIZE*ZC_STAT_BLOCK_SIZE;
+	if(chunkSize == 0)
+		chunkSize = ZC_STAT_BLOCK_SIZE;
+	
+	if(numOfElem <= chunkSize)
+	{
+		void *data1, *data2;
+		if(dataType==ZC_FLOAT)
+		{
+			data1 = ZC_readFloatData(oriFilePath, &nbEle1);
+			data2 = ZC_readFloatData(decFilePath, &nbEle2);
+		}
+		else
+		{
+			data1 = ZC_readDoubleData(oriFilePath, &nbEle1);
+			data2 = ZC_readDoubleData(decFilePath, &nbEle2);
+		}
+		compareResult = ZC_compareData(varName, dataType, data1, data2, r5, r4, r3, r2, r1);
+		ZC_releasePropertyData(compareResult->property);
+		free(data1);
+		free(data2);
+		return compareResult;
+	}
+	
+	int fd1 = open(oriFilePath, O_RDONLY);
+	int fd2 = open(decFilePath, O_RDONLY);
+	if(fd1 < 0 || fd2 < 0)
+	{
+		printf("Failed to open input file %s or %s.\n", oriFilePath, decFilePath);
+		exit(1);
+	}
+	
+	if(fftFlag || errAutoCorr3DFlag)
+		printf("[ZC] Warning: fft and errAutoCorr3D are not computed on the data read chunk by chunk (chunkSize = %zu < %zu)\n", chunkSize, numOfElem);
+	
+	compareResult = (ZC_CompareData*)malloc(sizeof(ZC_CompareData));
+	memset(compareResult, 0, sizeof(ZC_CompareData));
+	
+	ZC_DataProperty* property = (ZC_DataProperty*)malloc(sizeof(ZC_DataProperty));
+	memset(property, 0, sizeof(ZC_DataProperty));
+	property->varName = (char*)malloc(sizeof(char)*100);
+	char* varN = rmFileExtension(varName); //remove the final "." if any
+	strcpy(property->varName, varN);
+	free(varN);
+	property->dataType = dataType;
+	property->numOfElem = numOfElem;
+	property->r5 = r5;
+	property->r4 = r4;
+	property->r3 = r3;
+	property->r2 = r2;
+	property->r1 = r1;
+	
+	ZC_DataProperty* found = (ZC_DataProperty*)ht_get(ecPropertyTable, property->varName);
+	if(found!=NULL)
+		freeDataProperty(found);
+	ht_set(ecPropertyTable, property->varName, property);
+	compareResult->property = property;
+	
+	if(dataType==ZC_FLOAT)
+		ZC_compareDataFile_float(compareResult, fd1, fd2, chunkSize, r5, r4, r3, r2, r1);
+	else
+		ZC_compareDataFile_double(compareResult, fd1, fd2, chunkSize, r5, r4, r3, r2, r1);
+	
+	close(fd1);
+	close(fd2);
+	return compareResult;
+}
+
 void ZC_printCompressionResult(ZC_CompareData* compareResult)
 {
 	printf("minAbsErr: %f\n", compareResult->minAbsErr);
 	printf("avgAbsErr: %f\n", compareResult->avgAbsErr);
 	printf("maxAbsErr: %f\n", compareResult->maxAbsErr);
+	if(ZC_isSampledResult(compareResult))
+	{
+		printf("(approximate results on %.2f%% of the data, with 95%% confidence intervals)\n", compareResult->sampleRatio*100);
+		printf("avgAbsErr: [%f, %f]\n", compareResult->avgAbsErr_low, compareResult->avgAbsErr_high);
+		printf("maxAbsErr: %s\n", compareResult->maxAbsErrExact ? "exact" : "lower bound (maximum of the sample)");
+		printf("rmse: %G [%G, %G]\n", compareResult->rmse, compareResult->rmse_low, compareResult->rmse_high);
+		ZC_DataProperty* property = compareResult->property;
+		int sampleRange = property != NULL && property->sampleRatio > 0 && property->sampleRatio < 1;
+		if(compareResult->rmse_low == 0)
+			printf("psnr (on the value range of the %s): %f [%f, unbounded (rmse_low = 0)]\n", sampleRange ? "sample" : "data", 
+			compareResult->psnr, compareResult->psnr_low);
+		else
+			printf("psnr (on the value range of the %s): %f [%f, %f]\n", sampleRange ? "sample" : "data", 
+			compareResult->psnr, compareResult->psnr_low, compareResult->psnr_high);
+	}
 }
 
+int ZC_isSampledResult(ZC_CompareData* compareResult)
+{
+	return compareResult->sampleRatio > 0 && compareResult->sampleRatio < 1;
+}
+
+/*number of lines returned by constructCompareDataString()*/
+int ZC_getCompareDataStringCount(ZC_CompareData* compareResult)
+{
+	int nbLines = ZC_CMP_STRING_COUNT;
+	if(ZC_isSampledResult(compareResult))
+		nbLines += ZC_CMP_SAMPLE_STRING_COUNT;
+	if(compareResult->errMap!=NULL)
+		nbLines += ZC_CMP_ERRMAP_STRING_COUNT;
+	if(compareResult->absErrSketch!=NULL)
+		nbLines += ZC_CMP_QUANTILE_STRING_COUNT;
+	if(compareResult->ssimVolume3DComputed)
+		nbLines += ZC_CMP_SSIM3D_STRING_COUNT;
+	return nbLines;
+}
+
+/**
+ * The lines of the .cmp file: ZC_CMP_STRING_COUNT lines, followed by 
+ * ZC_CMP_SAMPLE_STRING_COUNT lines for the approximate results (see ZC_isSampledResult()),
+ * ZC_CMP_ERRMAP_STRING_COUNT lines describing the error map, if any, the
+ * ZC_CMP_QUANTILE_STRING_COUNT error quantiles, if any, and the 3D SSIM, if any.
+ * */
 char** constructCompareDataString(ZC_CompareData* compareResult)
 {
-	char** s = (char**)malloc(33*sizeof(char*));
+	int i, k = ZC_CMP_STRING_COUNT;
+	char** s = (char**)malloc((ZC_CMP_STRING_COUNT+ZC_CMP_SAMPLE_STRING_COUNT+ZC_CMP_ERRMAP_STRING_COUNT
+	+ZC_CMP_QUANTILE_STRING_COUNT+ZC_CMP_SSIM3D_STRING_COUNT)*sizeof(char*));
 	s[0] = (char*)malloc(100*sizeof(char));
 	sprintf(s[0], "[COMPARE]\n");	
 	
@@ -362,13 +871,7 @@ char** constructCompareDataString(ZC_CompareData* compareResult)
 	s[30] = (char*)malloc(100*sizeof(char));
 	s[31] = (char*)malloc(100*sizeof(char));
 	s[32] = (char*)malloc(100*sizeof(char));
-	if(compareResult->property->r2==0)
-	{
-		strcpy(s[30], "ssimImage2D_min = -\n");
-		strcpy(s[31], "ssimImage2D_avg = -\n");
-		strcpy(s[32], "ssimImage2D_max = -\n");
-	}
-	else if(compareResult->property->r3==0)
+	if(compareResult->property->r3==0) //1D (windows of 7 points) or 2D data: the SSIM of the whole data
 	{
 		strcpy(s[30], "ssimImage2D_min = -\n");		
 		sprintf(s[31], "ssimImage2D_avg = %.10G\n", compareResult->ssimImage2D_avg);
@@ -380,6 +883,52 @@ char** constructCompareDataString(ZC_CompareData* compareResult)
 		sprintf(s[31], "ssimImage2D_avg = %.10G\n", compareResult->ssimImage2D_avg);
 		sprintf(s[32], "ssimImage2D_max = %.10G\n", compareResult->ssimImage2D_max);						
 	}
+	
+	if(ZC_isSampledResult(compareResult))
+	{
+		for(i=ZC_CMP_STRING_COUNT;i<ZC_CMP_STRING_COUNT+ZC_CMP_SAMPLE_STRING_COUNT;i++)
+			s[i] = (char*)malloc(100*sizeof(char));
+		sprintf(s[33], "sampleRatio = %.10G\n", compareResult->sampleRatio);
+		sprintf(s[34], "maxAbsErrExact = %d\n", compareResult->maxAbsErrExact);
+		sprintf(s[35], "avgAbsErr_low = %.10G\n", compareResult->avgAbsErr_low);
+		sprintf(s[36], "avgAbsErr_high = %.10G\n", compareResult->avgAbsErr_high);
+		sprintf(s[37], "rmse_low = %.10G\n", compareResult->rmse_low);
+		sprintf(s[38], "rmse_high = %.10G\n", compareResult->rmse_high);
+		sprintf(s[39], "psnr_low = %.10G\n", compareResult->psnr_low);
+		if(compareResult->rmse_low == 0)
+			sprintf(s[40], "psnr_high = unbounded\n");
+		else
+			sprintf(s[40], "psnr_high = %.10G\n", compareResult->psnr_high);
+		k += ZC_CMP_SAMPLE_STRING_COUNT;
+	}
+	
+	ZC_ErrMap* map = compareResult->errMap;
+	if(map!=NULL)
+	{
+		char dims[ZC_BUFS];
+		s[k] = (char*)malloc(100*sizeof(char));
+		ZC_constructErrMapDimString(map, map->tile, dims);
+		sprintf(s[k], "errMapTile = %s\n", dims);
+		s[k+1] = (char*)malloc(100*sizeof(char));
+		ZC_constructErrMapDimString(map, map->dims, dims);
+		sprintf(s[k+1], "errMapDims = %s\n", dims);
+		k += ZC_CMP_ERRMAP_STRING_COUNT;
+	}
+	
+	if(compareResult->absErrSketch!=NULL)
+	{
+		for(i=0;i<ZC_ERR_QUANTILE_COUNT;i++)
+			s[k++] = ZC_constructQuantileString("absErr", compareResult->absErrSketch, ZC_errQuantiles[i]);
+		for(i=0;i<ZC_ERR_QUANTILE_COUNT;i++)
+			s[k++] = ZC_constructQuantileString("pwrErr", compareResult->pwrErrSketch, ZC_errQuantiles[i]);
+	}
+	
+	if(compareResult->ssimVolume3DComputed)
+	{
+		s[k] = (char*)malloc(100*sizeof(char));
+		sprintf(s[k], "ssimVolume3D = %.10G\n", compareResult->ssimVolume3D);
+		k += ZC_CMP_SSIM3D_STRING_COUNT;
+	}
 
 	return s;
 }
@@ -399,10 +948,10 @@ void ZC_writeCompressionResult(ZC_CompareData* compareResult, char* solution, ch
 	
 	char tgtFilePath[ZC_BUFS_LONG];
 	sprintf(tgtFilePath, "%s/%s:%s.cmp", tgtWorkspaceDir, solution, varName); 
-	ZC_writeStrings(33, s, tgtFilePath);
+	int i, nbLines = ZC_getCompareDataStringCount(compareResult);
+	ZC_writeStrings(nbLines, s, tgtFilePath);
 	
-	int i;
-	for(i=0;i<=32;i++)
+	for(i=0;i<nbLines;i++)
 		free(s[i]);
 	free(s);
 	
@@ -434,7 +983,10 @@ void ZC_writeCompressionResult(ZC_CompareData* compareResult, char* solution, ch
 				//printf("%d\n", i);
 				ss[i+1] = (char*)malloc(sizeof(char)*ZC_BUFS);
 				double x = err_minValue+i*err_interval;
-				sprintf(ss[i+1], "%.10G %.10G\n", x, compareResult->absErrPDF[i]); 
+				if(compareResult->absErrPDF_ci!=NULL) //approximate mode: 95% confidence interval of the bin
+					sprintf(ss[i+1], "%.10G %.10G %.10G\n", x, compareResult->absErrPDF[i], compareResult->absErrPDF_ci[i]); 
+				else
+					sprintf(ss[i+1], "%.10G %.10G\n", x, compareResult->absErrPDF[i]); 
 			}
 			ZC_writeStrings(PDF_INTERVALS+1, ss, tgtFilePath);
 			for(i=0;i<PDF_INTERVALS+1;i++)
@@ -499,9 +1051,17 @@ void ZC_writeCompressionResult(ZC_CompareData* compareResult, char* solution, ch
 	{
 		memset(tgtFilePath, 0, ZC_BUFS);
 		sprintf(tgtFilePath, "%s/%s:%s.ac3d", tgtWorkspaceDir, solution, varName);
-		ZC_writeDoubleData_inBytes(compareResult->autoCorrAbsErr3D, compareResult->property->numOfElem, tgtFilePath);			
+		ZC_DataProperty* property = compareResult->property;
+		ZC_writeDoubleData_inBytes(compareResult->autoCorrAbsErr3D, 
+			ZC_getAutocorr3DLength(property->r5, property->r4, property->r3, property->r2, property->r1), tgtFilePath);			
 	}
 #endif	
+	if(compareResult->errMap!=NULL)
+	{
+		memset(tgtFilePath, 0, ZC_BUFS_LONG);
+		sprintf(tgtFilePath, "%s/%s:%s.emap", tgtWorkspaceDir, solution, varName);
+		ZC_writeErrMap(compareResult->errMap, tgtFilePath);
+	}
 	if(fftFlag)
 	{
 		char buf[ZC_BUFS];
@@ -1,6 +1,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <math.h>
+#include <string.h>
 #include <sys/stat.h>
 #include "ZC_util.h"
 #include "ZC_DataProperty.h"
@@ -13,274 +14,657 @@
 #include "ZC_R_math.h"
 #endif
 #include "ZC_ssim.h"
+#include "ZC_rw.h"
+#include "ZC_autocorr.h"
+
+/**
+ * The block statistics restricted to the parts in statMask. The function is 
+ * inlined with a constant mask into the specialized kernels below, so each of 
+ * them only contains the passes over the block that its metrics need (e.g., a 
+ * single pass without any relative-error work for psnr).
+ * */
+static inline void ZC_computeCompareStatBlockMask_double(ZC_CompareStat* stat, double* data1, double* data2, size_t n, const int statMask)
+{
+	ZC_Kernels* kernels = ZC_getKernels();
+	ZC_DiffSums ds;
+	ZC_RelSums rs;
+	ZC_CoMoments cm;
+	
+	ZC_initCompareStat(stat);
+	if(n == 0)
+		return;
+	
+	kernels->diffSums_double(data1, data2, n, &ds);
+	
+	double mean1 = ds.sum1/n, mean2 = ds.sum2/n, meanDiff = ds.sumDiff/n;
+	stat->n = n;
+	stat->mean1 = mean1;
+	stat->mean2 = mean2;
+	stat->meanDiff = meanDiff;
+	stat->minDiff = ds.minDiff;
+	stat->maxDiff = ds.maxDiff;
+	stat->minErr = ds.minErr;
+	stat->maxErr = ds.maxErr;
+	stat->sumErr = ds.sumErr;
+	stat->sumErrSqr = ds.sumErrSqr;
+	
+	if(statMask & ZC_STAT_REL)
+	{
+		kernels->relSums_double(data1, data2, n, &rs);
+		stat->n_rel = rs.n_rel;
+		stat->minDiff_rel = rs.minDiff_rel;
+		stat->maxDiff_rel = rs.maxDiff_rel;
+		stat->minErr_rel = rs.minErr_rel;
+		stat->maxErr_rel = rs.maxErr_rel;
+		stat->sumErr_rel = rs.sumErr_rel;
+		stat->sumErrSqr_rel = rs.sumErrSqr_rel;
+	}
+	
+	if(statMask & ZC_STAT_MOMENTS)
+	{
+		//the block is still in cache: compute the centered (co-)moments exactly
+		kernels->coMoments_double(data1, data2, n, mean1, mean2, meanDiff, &cm);
+		stat->m2_1 = cm.m2_1;
+		stat->m2_2 = cm.m2_2;
+		stat->m2_diff = cm.m2_diff;
+		stat->c12 = cm.c12;
+		stat->c1d = cm.c1d;
+	}
+}
 
-void ZC_compareData_double(ZC_CompareData* compareResult, double* data1, double* data2,
-size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
+#define ZC_COMPARE_STAT_BLOCK_DOUBLE(NAME, MASK) \
+static void NAME(ZC_CompareStat* stat, double* data1, double* data2, size_t n) \
+{ \
+	ZC_computeCompareStatBlockMask_double(stat, data1, data2, n, MASK); \
+}
+
+ZC_COMPARE_STAT_BLOCK_DOUBLE(ZC_computeCompareStatBlock0_double, 0)
+ZC_COMPARE_STAT_BLOCK_DOUBLE(ZC_computeCompareStatBlockRel_double, ZC_STAT_REL)
+ZC_COMPARE_STAT_BLOCK_DOUBLE(ZC_computeCompareStatBlockMoments_double, ZC_STAT_MOMENTS)
+ZC_COMPARE_STAT_BLOCK_DOUBLE(ZC_computeCompareStatBlockAll_double, ZC_STAT_ALL)
+
+typedef void (*ZC_CompareStatBlockFunc_double)(ZC_CompareStat* stat, double* data1, double* data2, size_t n);
+
+/*indexed by the statMask*/
+static ZC_CompareStatBlockFunc_double ZC_compareStatBlockFuncs_double[ZC_STAT_ALL+1] = {
+	ZC_computeCompareStatBlock0_double, 
+	ZC_computeCompareStatBlockRel_double, 
+	ZC_computeCompareStatBlockMoments_double, 
+	ZC_computeCompareStatBlockAll_double};
+
+void ZC_computeCompareStatBlock_double(ZC_CompareStat* stat, double* data1, double* data2, size_t n)
+{
+	ZC_computeCompareStatBlockAll_double(stat, data1, data2, n);
+}
+
+typedef struct ZC_CompareTask_double
 {
-	size_t i = 0;
-	double minDiff = data2[0]-data1[0];
-	double maxDiff = minDiff;
-	double minErr = fabs(minDiff);
-	double maxErr = minErr;
-	double sum1 = 0, sum2 = 0, sumDiff = 0, sumErr = 0, sumErrSqr = 0;
+	double* data1;
+	double* data2;
+	size_t n;
+	ZC_CompareStat* stats; /*one per chunk*/
+	ZC_CompareStatBlockFunc_double statBlock;
 	
-	double minDiff_rel = 1E100;
-	double maxDiff_rel = -1E100;
-	double minErr_rel = 1E100;
-	double maxErr_rel = 0;
-	double sumDiff_rel = 0, sumErr_rel = 0, sumErrSqr_rel = 0;
+	double minDiff, interval; /*error PDFs*/
+	double minDiff_rel, maxDiff_rel, interval_rel;
+	double* absErrPDF; /*one histogram per thread*/
+	double* relErrPDF;
 	
-	double err;
-	size_t numOfElem = compareResult->property->numOfElem;
-	double sumOfDiffSquare = 0, sumOfDiffSquare_rel = 0;
-	size_t numOfElem_ = 0;
+	double avgDiff; /*error autocorrelation*/
+	double* lagSums; /*AUTOCORR_SIZE+1 partial sums per chunk*/
+	
+	ZC_QuantileSketch* sketches; /*error quantiles: two per thread (absolute and point-wise relative errors)*/
+} ZC_CompareTask_double;
 
-	int dim = ZC_computeDimension(r5, r4, r3, r2, r1);
+static void ZC_computeCompareStatChunk_double(void* arg, int threadID, size_t taskID)
+{
+	ZC_CompareTask_double* t = (ZC_CompareTask_double*)arg;
+	size_t i, len, begin = taskID*ZC_CHUNK_SIZE;
+	size_t end = begin + ZC_CHUNK_SIZE < t->n ? begin + ZC_CHUNK_SIZE : t->n;
+	ZC_CompareStat block;
+	ZC_initCompareStat(&t->stats[taskID]);
+	for (i = begin; i < end; i += ZC_STAT_BLOCK_SIZE)
+	{
+		len = end - i < ZC_STAT_BLOCK_SIZE ? end - i : ZC_STAT_BLOCK_SIZE;
+		t->statBlock(&block, t->data1+i, t->data2+i, len);
+		ZC_mergeCompareStat(&t->stats[taskID], &block);
+	}
+}
+
+/**
+ * The first pass, restricted to the parts of ZC_CompareStat in statMask 
+ * (the others keep the values set by ZC_initCompareStat).
+ * */
+void ZC_computeCompareStatMask_double(ZC_CompareStat* stat, double* data1, double* data2, size_t n, int statMask)
+{
+	size_t nbChunks = ZC_computeChunkCount(n);
+	ZC_CompareTask_double task;
+	
+	ZC_initCompareStat(stat);
+	if(nbChunks == 0)
+		return;
+	
+	ZC_getKernels(); //select the kernels before starting the threads
+	task.data1 = data1;
+	task.data2 = data2;
+	task.n = n;
+	task.statBlock = ZC_compareStatBlockFuncs_double[statMask & ZC_STAT_ALL];
+	task.stats = (ZC_CompareStat*)malloc(sizeof(ZC_CompareStat)*nbChunks);
+	ZC_runTasks(ZC_computeCompareStatChunk_double, &task, nbChunks);
+	ZC_reduceCompareStat(task.stats, nbChunks);
+	*stat = task.stats[0];
+	free(task.stats);
+}
 
-	double *diff = (double*)malloc(numOfElem*sizeof(double));
-	double *relDiff = (double*)malloc(numOfElem*sizeof(double));
+void ZC_computeCompareStat_double(ZC_CompareStat* stat, double* data1, double* data2, size_t n)
+{
+	ZC_computeCompareStatMask_double(stat, data1, data2, n, ZC_STAT_ALL);
+}
 
-	for (i = 0; i < numOfElem; i++)
+static void ZC_computeErrPDFChunk_double(void* arg, int threadID, size_t taskID)
+{
+	ZC_CompareTask_double* t = (ZC_CompareTask_double*)arg;
+	size_t i, begin = taskID*ZC_CHUNK_SIZE;
+	size_t end = begin + ZC_CHUNK_SIZE < t->n ? begin + ZC_CHUNK_SIZE : t->n;
+	double *absErrPDF = t->absErrPDF==NULL ? NULL : t->absErrPDF + (size_t)threadID*PDF_INTERVALS;
+	double *relErrPDF = t->relErrPDF==NULL ? NULL : t->relErrPDF + (size_t)threadID*PDF_INTERVALS_REL;
+	double diff, relDiff;
+	int index;
+	
+	for (i = begin; i < end; i++)
 	{
-		sum1 += data1[i];
-		sum2 += data2[i];
-		
-		diff[i] = data2[i]-data1[i];
-		if(minDiff > diff[i]) minDiff = diff[i];
-		if(maxDiff < diff[i]) maxDiff = diff[i];
-		sumDiff += diff[i];
-		sumOfDiffSquare += diff[i]*diff[i];
-				
-		err = fabs(diff[i]);
-		if(minErr>err) minErr = err;
-		if(maxErr<err) maxErr = err;
-		sumErr += err;
-		sumErrSqr += err*err; //used for mse, nrmse, psnr
-	
-		if(data1[i]!=0)
+		diff = t->data2[i]-t->data1[i];
+		if(absErrPDF!=NULL)
 		{
-			numOfElem_ ++;
-			relDiff[i] = diff[i]/data1[i];
-			if(minDiff_rel > relDiff[i]) minDiff_rel = relDiff[i];
-			if(maxDiff_rel < relDiff[i]) maxDiff_rel = relDiff[i];
-			sumDiff_rel += relDiff[i];
-			sumOfDiffSquare_rel += relDiff[i]*relDiff[i];
-			
-			err = fabs(relDiff[i]);
-			if(minErr_rel>err) minErr_rel = err;
-			if(maxErr_rel<err) maxErr_rel = err;
-			sumErr_rel += err;
-			sumErrSqr_rel += err*err;
-		}	
+			index = (int)((diff-t->minDiff)/t->interval);
+			if(index==PDF_INTERVALS)
+				index = PDF_INTERVALS-1;
+			absErrPDF[index] += 1;
+		}
+		if(relErrPDF!=NULL && t->data1[i]!=0)
+		{
+			relDiff = diff/t->data1[i];
+			if(relDiff>t->maxDiff_rel)
+				relDiff = t->maxDiff_rel;
+			if(relDiff<t->minDiff_rel)
+				relDiff = t->minDiff_rel;
+			index = (int)((relDiff-t->minDiff_rel)/t->interval_rel);
+			if(index==PDF_INTERVALS_REL)
+				index = PDF_INTERVALS_REL-1;
+			relErrPDF[index] += 1;
+		}
 	}
+}
+
+/**
+ * Add the counts of the error distributions of (data1, data2) to absCounts 
+ * (PDF_INTERVALS bins) and relCounts (PDF_INTERVALS_REL bins); either may be NULL.
+ * The ranges are taken from stat, so the counts of several chunks can be accumulated.
+ * Each thread fills its own histogram; the counts are integers, so summing them 
+ * is exact in any order.
+ * */
+void ZC_countErrPDF_double(ZC_CompareStat* stat, double* data1, double* data2, size_t n, double* absCounts, double* relCounts)
+{
+	size_t i;
+	int j;
+	size_t nbChunks = ZC_computeChunkCount(n);
+	int threadCount = ZC_computeThreadCount(nbChunks);
+	ZC_CompareTask_double task;
 	
-	ZC_DataProperty* property = compareResult->property;
-	
-	double zeromean_variance = property->zeromean_variance;
-	double valRange = property->valueRange;
-	double mean1 = sum1/numOfElem;
-	double mean2 = sum2/numOfElem;
+	if(nbChunks == 0 || (absCounts==NULL && relCounts==NULL))
+		return;
 	
-	double avgDiff = sumDiff/numOfElem;
-	double avgErr = sumErr/numOfElem;
+	ZC_computeErrPDFRange(stat, &task.minDiff, &task.interval, &task.minDiff_rel, &task.maxDiff_rel, &task.interval_rel);
+	task.data1 = data1;
+	task.data2 = data2;
+	task.n = n;
+	task.absErrPDF = absCounts==NULL ? NULL : (double*)calloc((size_t)threadCount*PDF_INTERVALS, sizeof(double));
+	task.relErrPDF = relCounts==NULL ? NULL : (double*)calloc((size_t)threadCount*PDF_INTERVALS_REL, sizeof(double));
 	
-	double diffRange = maxDiff - minDiff;
-	double mse = sumErrSqr/numOfElem;
+	ZC_runTasks(ZC_computeErrPDFChunk_double, &task, nbChunks);
 	
-	double avgErr_rel = sumErr_rel/numOfElem;
-	double diffRange_rel = maxDiff_rel - minDiff_rel;
-	double mse_rel = sumErrSqr_rel/numOfElem_;
-	if(diffRange_rel>2*PWR_DIS_RNG_BOUND)
+	if(absCounts!=NULL)
+	{
+		for (j = 0; j < threadCount; j++)
+			for (i = 0; i < PDF_INTERVALS; i++)
+				absCounts[i] += task.absErrPDF[(size_t)j*PDF_INTERVALS+i];
+		free(task.absErrPDF);
+	}
+	if(relCounts!=NULL)
 	{
-		double avg = 0;//sumDiff_rel/numOfElem_;
-		diffRange_rel = 2*PWR_DIS_RNG_BOUND;
-		minDiff_rel = avg-PWR_DIS_RNG_BOUND;
-		maxDiff_rel = avg+PWR_DIS_RNG_BOUND;
+		for (j = 0; j < threadCount; j++)
+			for (i = 0; i < PDF_INTERVALS_REL; i++)
+				relCounts[i] += task.relErrPDF[(size_t)j*PDF_INTERVALS_REL+i];
+		free(task.relErrPDF);
 	}
+}
+
+static void ZC_addErrSketchesChunk_double(void* arg, int threadID, size_t taskID)
+{
+	ZC_CompareTask_double* t = (ZC_CompareTask_double*)arg;
+	size_t i, begin = taskID*ZC_CHUNK_SIZE;
+	size_t end = begin + ZC_CHUNK_SIZE < t->n ? begin + ZC_CHUNK_SIZE : t->n;
+	ZC_QuantileSketch *absSketch = t->sketches + 2*threadID, *pwrSketch = absSketch + 1;
+	double err;
 	
-	int index;
-	
-	if (minAbsErrFlag)
-		compareResult->minAbsErr = minErr;
+	for (i = begin; i < end; i++)
+	{
+		err = fabs(t->data2[i]-t->data1[i]);
+		ZC_addSketchValue(absSketch, err);
+		if(t->data1[i]!=0)
+			ZC_addSketchValue(pwrSketch, err/fabs(t->data1[i]));
+	}
+}
 
-	if (minRelErrFlag)
-		compareResult->minRelErr = minErr/valRange;
+/**
+ * Add the absolute errors |data2-data1| to absSketch and the point-wise relative errors 
+ * |data2-data1|/|data1| (data1!=0) to pwrSketch: one pair of sketches per thread, merged 
+ * at the end, so the sketches of several chunks can be accumulated in any order.
+ * */
+void ZC_addErrSketches_double(ZC_QuantileSketch* absSketch, ZC_QuantileSketch* pwrSketch, double* data1, double* data2, size_t n)
+{
+	int j;
+	size_t nbChunks = ZC_computeChunkCount(n);
+	int threadCount = ZC_computeThreadCount(nbChunks);
+	ZC_CompareTask_double task;
+	
+	if(nbChunks == 0)
+		return;
+	task.data1 = data1;
+	task.data2 = data2;
+	task.n = n;
+	task.sketches = ZC_createQuantileSketches(2*threadCount);
+	ZC_runTasks(ZC_addErrSketchesChunk_double, &task, nbChunks);
+	for (j = 0; j < threadCount; j++)
+	{
+		ZC_mergeQuantileSketch(absSketch, &task.sketches[2*j]);
+		ZC_mergeQuantileSketch(pwrSketch, &task.sketches[2*j+1]);
+	}
+	free(task.sketches);
+}
 
-	if (maxAbsErrFlag)
-		compareResult->maxAbsErr = maxErr;
+/**
+ * The second (optional) pass: the distributions of the errors, whose ranges 
+ * are only known after the first pass.
+ * */
+void ZC_computeErrPDF_double(ZC_CompareData* compareResult, ZC_CompareStat* stat, double* data1, double* data2, size_t n)
+{
+	double *absCounts = NULL, *relCounts = NULL;
+	ZC_allocErrPDFCounts(stat, &absCounts, &relCounts);
+	ZC_countErrPDF_double(stat, data1, data2, n, absCounts, relCounts);
+	ZC_finalizeErrPDF(compareResult, stat, absCounts, relCounts);
+}
 
-	if (maxRelErrFlag)
-		compareResult->maxRelErr = maxErr/valRange;
+static void ZC_computeErrLagSumsChunk_double(void* arg, int threadID, size_t taskID)
+{
+	ZC_CompareTask_double* t = (ZC_CompareTask_double*)arg;
+	size_t i, k, h, len, begin = taskID*ZC_CHUNK_SIZE;
+	size_t end = begin + ZC_CHUNK_SIZE < t->n ? begin + ZC_CHUNK_SIZE : t->n;
+	double* lagSums = t->lagSums + taskID*(AUTOCORR_SIZE+1);
+	double avgDiff = t->avgDiff;
+	double y[AUTOCORR_SIZE+ZC_LAG_TILE_SIZE];
+	
+	//the products are attributed to the chunk of their second element
+	memset(lagSums, 0, sizeof(double)*(AUTOCORR_SIZE+1));
+	for (k = begin; k < end; k += len)
+	{
+		len = end - k < ZC_LAG_TILE_SIZE ? end - k : ZC_LAG_TILE_SIZE;
+		h = k < AUTOCORR_SIZE ? k : AUTOCORR_SIZE;
+		for (i = 0; i < h+len; i++)
+			y[i] = (t->data2[k-h+i]-t->data1[k-h+i])-avgDiff;
+		ZC_accumulateLagProducts(y, h+len, h, AUTOCORR_SIZE, lagSums);
+	}
+}
 
-	if (avgAbsErrFlag)
-		compareResult->avgAbsErr = avgErr;
+/**
+ * Sums of the products of the centered errors (diff[i]-avgDiff)*(diff[i+delta]-avgDiff) 
+ * for delta = 0..AUTOCORR_SIZE (diff = data2-data1), by FFT or in one blocked pass.
+ * */
+static void ZC_computeErrLagSums_double(double* data1, double* data2, size_t numOfElem, double avgDiff, double* lagSums)
+{
+	size_t i;
+	if (numOfElem == 0)
+		memset(lagSums, 0, sizeof(double)*(AUTOCORR_SIZE+1));
+	else if (ZC_useLagSumsFFT(numOfElem, AUTOCORR_SIZE))
+	{
+		double *diff = (double*)malloc(numOfElem*sizeof(double));
+		for (i = 0; i < numOfElem; i++)
+			diff[i] = (data2[i]-data1[i])-avgDiff;
+		ZC_computeLagSumsFFT(diff, numOfElem, AUTOCORR_SIZE, lagSums);
+		free(diff);
+	}
+	else
+	{
+		size_t nbChunks = ZC_computeChunkCount(numOfElem);
+		ZC_CompareTask_double task;
+		task.data1 = data1;
+		task.data2 = data2;
+		task.n = numOfElem;
+		task.avgDiff = avgDiff;
+		task.lagSums = (double*)malloc(sizeof(double)*(AUTOCORR_SIZE+1)*nbChunks);
+		ZC_runTasks(ZC_computeErrLagSumsChunk_double, &task, nbChunks);
+		ZC_reduceSumTree(task.lagSums, nbChunks, AUTOCORR_SIZE+1);
+		memcpy(lagSums, task.lagSums, sizeof(double)*(AUTOCORR_SIZE+1));
+		free(task.lagSums);
+	}
+}
 
-	if (avgRelErrFlag)
-		compareResult->avgRelErr = avgErr/valRange;
-		
-	compareResult->minPWRErr = minErr_rel;
-	compareResult->maxPWRErr = maxErr_rel;
-	compareResult->avgPWRErr = sumErr_rel/numOfElem_;
+/**
+ * Autocorrelation of the errors for lags 1..AUTOCORR_SIZE, computing the 
+ * errors on the fly (avgDiff and varDiff are the mean and variance of data2-data1).
+ * All the lags are accumulated in one blocked pass over the data.
+ * */
+double* ZC_computeErrAutoCorr_double(double* data1, double* data2, size_t numOfElem, double avgDiff, double varDiff)
+{
+	size_t i, delta;
+	double *autoCorrAbsErr = (double*)malloc((AUTOCORR_SIZE+1)*sizeof(double));
 
-	if (absErrPDFFlag)
+	if (numOfElem > 4096)
 	{
-		double interval = diffRange/PDF_INTERVALS;
-		double *absErrPDF = NULL;
-		if(interval==0)
+		if (varDiff == 0)
 		{
-			absErrPDF = (double*)malloc(sizeof(double));
-			*absErrPDF = 0;
+			for (delta = 1; delta <= AUTOCORR_SIZE; delta++)
+				autoCorrAbsErr[delta] = 1;
 		}
 		else
 		{
-			absErrPDF = (double*)malloc(sizeof(double)*PDF_INTERVALS);
-			memset(absErrPDF, 0, PDF_INTERVALS*sizeof(double));
-
-			for (i = 0; i < numOfElem; i++)
-			{
-				index = (int)((diff[i]-minDiff)/interval);
-				if(index==PDF_INTERVALS)
-					index = PDF_INTERVALS-1;
-				absErrPDF[index] += 1;
-			}
-
-			for (i = 0; i < PDF_INTERVALS; i++)
-				absErrPDF[i]/=numOfElem;			
+			double lagSums[AUTOCORR_SIZE+1];
+			ZC_computeErrLagSums_double(data1, data2, numOfElem, avgDiff, lagSums);
+			for (delta = 1; delta <= AUTOCORR_SIZE; delta++)
+				autoCorrAbsErr[delta] = lagSums[delta]/(numOfElem-delta)/varDiff;
 		}
-		compareResult->absErrPDF = absErrPDF;
-		compareResult->err_interval = interval;
-		compareResult->err_minValue = minDiff;		
 	}
-
-	if (pwrErrPDFFlag)
+	else
 	{
-		double interval = diffRange_rel/PDF_INTERVALS_REL;
-		double *relErrPDF = NULL;
-		if(interval==0)
-		{
-			relErrPDF = (double*)malloc(sizeof(double));
-			*relErrPDF = 0;
-		}
-		else
-		{
-			relErrPDF = (double*)malloc(sizeof(double)*PDF_INTERVALS_REL);
-			memset(relErrPDF, 0, PDF_INTERVALS_REL*sizeof(double));
-
-			for (i = 0; i < numOfElem; i++)
-			{
-				if(data1[i]!=0)
-				{
-					if(relDiff[i]>maxDiff_rel)
-						relDiff[i] = maxDiff_rel;
-					if(relDiff[i]<minDiff_rel)
-						relDiff[i] = minDiff_rel;
-					index = (int)((relDiff[i]-minDiff_rel)/interval);
-					if(index==PDF_INTERVALS_REL)
-						index = PDF_INTERVALS_REL-1;
-					relErrPDF[index] += 1;					
-				}
-			}
-			for (i = 0; i < PDF_INTERVALS_REL; i++)
-				relErrPDF[i]/=numOfElem_;			
-		}
-		compareResult->pwrErrPDF = relErrPDF;
-		compareResult->err_interval_rel = interval;
-		compareResult->err_minValue_rel = minDiff_rel;		
+		//small data: the error array costs at most 4096 doubles
+		double *diff = (double*)malloc(numOfElem*sizeof(double));
+		double diff_0 = data2[0]-data1[0];
+		for (i = 0; i < numOfElem; i++)
+			diff[i] = (data2[i]-data1[i])-diff_0;
+		ZC_computeLagCorrelations(diff, numOfElem, AUTOCORR_SIZE, 0, autoCorrAbsErr);
+		free(diff);
 	}
+	
+	autoCorrAbsErr[0] = 1;
+	return autoCorrAbsErr;
+}
 
-	if (errAutoCorrFlag)
+/**
+ * Add the len points starting at the point number offset (data1 and data2 point at it) 
+ * to the sums of their tiles. The points are streamed row by row, so this works for 
+ * any range of points, e.g., the chunks of ZC_compareDataFile_double().
+ * */
+void ZC_updateErrMap_double(ZC_ErrMap* map, double* data1, double* data2, size_t offset, size_t len)
+{
+	size_t i, j, m, seg, i1, r1 = map->r[0], t1 = map->tile[0];
+	while (len > 0)
 	{
-		double *autoCorrAbsErr = (double*)malloc((AUTOCORR_SIZE+1)*sizeof(double));
-
-		size_t delta;
-
-		if (numOfElem > 4096)
+		i1 = offset%r1;
+		seg = r1 - i1 < len ? r1 - i1 : len;
+		double* tiles = ZC_getErrMapRowTiles(map, offset/r1);
+		for (i = 0; i < seg; i += m)
 		{
-			double covDiff = 0;
-			for (i = 0; i < numOfElem; i++)
+			//the part of the row in the tile (i1+i)/t1
+			double* a = tiles + (i1+i)/t1*ZC_ERRMAP_ACC_COUNT;
+			m = t1 - (i1+i)%t1 < seg - i ? t1 - (i1+i)%t1 : seg - i;
+			if (a[ZC_ERRMAP_COUNT] == 0)
+				a[ZC_ERRMAP_PILOT] = data1[i];
+			
+			double pilot = a[ZC_ERRMAP_PILOT], maxErr = a[ZC_ERRMAP_MAX];
+			double sumDiff = 0, sumDiff2 = 0, sum1 = 0, sum2 = 0, sum11 = 0, sum22 = 0, sum12 = 0;
+			for (j = i; j < i + m; j++)
 			{
-				covDiff += (diff[i] - avgDiff)*(diff[i] - avgDiff);
+				double x = data1[j] - pilot, y = data2[j] - pilot;
+				double diff = data2[j] - data1[j];
+				double err = fabs(diff);
+				if (maxErr < err)
+					maxErr = err;
+				sumDiff += diff;
+				sumDiff2 += diff*diff;
+				sum1 += x;
+				sum2 += y;
+				sum11 += x*x;
+				sum22 += y*y;
+				sum12 += x*y;
 			}
+			a[ZC_ERRMAP_COUNT] += m;
+			a[ZC_ERRMAP_MAX] = maxErr;
+			a[ZC_ERRMAP_SUM_DIFF] += sumDiff;
+			a[ZC_ERRMAP_SUM_DIFF2] += sumDiff2;
+			a[ZC_ERRMAP_SUM1] += sum1;
+			a[ZC_ERRMAP_SUM2] += sum2;
+			a[ZC_ERRMAP_SUM11] += sum11;
+			a[ZC_ERRMAP_SUM22] += sum22;
+			a[ZC_ERRMAP_SUM12] += sum12;
+		}
+		data1 += seg;
+		data2 += seg;
+		offset += seg;
+		len -= seg;
+	}
+}
 
-			covDiff = covDiff/numOfElem;
+typedef struct ZC_ErrMapTask_double
+{
+	ZC_ErrMap* map;
+	double* data1;
+	double* data2;
+	size_t n, taskSize; /*taskSize: a whole number of layers of tiles*/
+} ZC_ErrMapTask_double;
 
-			if (covDiff == 0)
-			{
-				for (delta = 1; delta <= AUTOCORR_SIZE; delta++)
-					autoCorrAbsErr[delta] = 1;
-			}
-			else
-			{
-				for (delta = 1; delta <= AUTOCORR_SIZE; delta++)
-				{
-					double sum = 0;
+static void ZC_computeErrMapChunk_double(void* arg, int threadID, size_t taskID)
+{
+	ZC_ErrMapTask_double* t = (ZC_ErrMapTask_double*)arg;
+	size_t begin = taskID*t->taskSize;
+	size_t end = begin + t->taskSize < t->n ? begin + t->taskSize : t->n;
+	ZC_updateErrMap_double(t->map, t->data1+begin, t->data2+begin, begin, end-begin);
+}
 
-					for (i = 0; i < numOfElem-delta; i++)
-					{
-						sum += (diff[i]-avgDiff)*(diff[i+delta]-avgDiff);
-					}
+/**
+ * Blockwise error map of the in-memory data: the tasks are layers of tiles along the 
+ * slowest dimension, so every tile is accumulated by one thread, in the order of the data.
+ * */
+ZC_ErrMap* ZC_computeErrMap_double(double* data1, double* data2, double valueRange, 
+size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
+{
+	size_t nbLayers;
+	ZC_ErrMapTask_double task;
+	task.map = ZC_constructErrMap(r5, r4, r3, r2, r1);
+	task.data1 = data1;
+	task.data2 = data2;
+	task.n = ZC_computeDataLength(r5, r4, r3, r2, r1);
+	task.taskSize = ZC_getErrMapLayerSize(task.map, &nbLayers);
+	if (task.taskSize < ZC_CHUNK_SIZE)
+		task.taskSize *= ZC_CHUNK_SIZE/task.taskSize;
+	ZC_runTasks(ZC_computeErrMapChunk_double, &task, (task.n + task.taskSize - 1)/task.taskSize);
+	ZC_finalizeErrMap(task.map, valueRange);
+	return task.map;
+}
 
-					autoCorrAbsErr[delta] = sum/(numOfElem-delta)/covDiff;
-				}
-			}
+typedef struct ZC_VerifyTask_double
+{
+	double* data1;
+	double* data2;
+	size_t n, maxViolations;
+	ZC_VerifyResult* bound;
+	ZC_VerifyChunk* chunks;
+	volatile size_t stopChunk; /*first chunk that found maxViolations violations*/
+} ZC_VerifyTask_double;
+
+static void ZC_verifyErrorBoundChunk_double(void* arg, int threadID, size_t taskID)
+{
+	ZC_VerifyTask_double* t = (ZC_VerifyTask_double*)arg;
+	ZC_VerifyChunk* c = &t->chunks[taskID];
+	ZC_VerifyResult* b = t->bound;
+	size_t i, j, len, count, begin = taskID*ZC_CHUNK_SIZE;
+	size_t end = begin + ZC_CHUNK_SIZE < t->n ? begin + ZC_CHUNK_SIZE : t->n;
+	double maxErr, err;
+	const ZC_Kernels* kernels = ZC_getKernels();
+	c->maxErr = 0;
+	c->nbChecked = 0;
+	c->nbViolations = 0;
+	c->violations = t->maxViolations > 0 ? (size_t*)malloc(sizeof(size_t)*t->maxViolations) : NULL;
+	//the chunks after a chunk that already has all the reported violations are useless
+	for (i = begin; i < end && t->stopChunk > taskID; i += ZC_VERIFY_BLOCK_SIZE)
+	{
+		len = end - i < ZC_VERIFY_BLOCK_SIZE ? end - i : ZC_VERIFY_BLOCK_SIZE;
+		count = kernels->boundViolations_double(t->data1+i, t->data2+i, len, b->absBound, b->pwrBound, b->andMode, &maxErr);
+		if (c->maxErr < maxErr)
+			c->maxErr = maxErr;
+		c->nbChecked += len;
+		if (count == 0)
+			continue;
+		if (t->maxViolations == 0)
+		{
+			c->nbViolations += count;
+			continue;
 		}
-		else
+		//rare: locate the violating points of the block
+		for (j = i; j < i + len && c->nbViolations < t->maxViolations; j++)
+			if (ZC_boundViolations_double_scalar(t->data1+j, t->data2+j, 1, b->absBound, b->pwrBound, b->andMode, &err))
+				c->violations[c->nbViolations++] = j;
+		if (c->nbViolations == t->maxViolations)
 		{
-			for (delta = 1; delta <= AUTOCORR_SIZE; delta++)
-			{
-				double avg_0 = 0;
-				double avg_1 = 0;
-
-				for (i = 0; i < numOfElem-delta; i++)
-				{
-					avg_0 += diff[i];
-					avg_1 += diff[i+delta];
-				}
-
-				avg_0 = avg_0 / (numOfElem-delta);
-				avg_1 = avg_1 / (numOfElem-delta);
-
-				double cov_0 = 0;
-				double cov_1 = 0;
-
-				for (i = 0; i < numOfElem-delta; i++)
-				{
-					cov_0 += (diff[i] - avg_0) * (diff[i] - avg_0);
-					cov_1 += (diff[i+delta] - avg_1) * (diff[i+delta] - avg_1);
-				}
-
-				cov_0 = cov_0/(numOfElem-delta);
-				cov_1 = cov_1/(numOfElem-delta);
+			ZC_atomicMin(&t->stopChunk, taskID);
+			break;
+		}
+	}
+}
 
-				cov_0 = sqrt(cov_0);
-				cov_1 = sqrt(cov_1);
+/**
+ * Check |data2[i]-data1[i]| against the error bound, block by block with the vectorized 
+ * kernels, and stop once maxViolations violating points have been found (0: check all the 
+ * points and count the violations). The value range is only computed for the REL bounds.
+ * */
+ZC_VerifyResult* ZC_verifyErrorBound_double(double* data1, double* data2, int errBoundMode, double absErrBound, double relBoundRatio, 
+double pwrBoundRatio, size_t maxViolations, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
+{
+	size_t i, nbChunks;
+	ZC_VerifyTask_double task;
+	ZC_VerifyResult* result = (ZC_VerifyResult*)malloc(sizeof(ZC_VerifyResult));
+	task.n = ZC_computeDataLength(r5, r4, r3, r2, r1);
+	nbChunks = ZC_computeChunkCount(task.n);
+	result->r5 = r5;
+	result->r4 = r4;
+	result->r3 = r3;
+	result->r2 = r2;
+	result->r1 = r1;
+	double valueRange = ZC_errorBoundNeedsRange(errBoundMode) ? ZC_computeValueRange_double(data1, task.n) : 0;
+	ZC_resolveErrorBound(result, errBoundMode, absErrBound, relBoundRatio, pwrBoundRatio, valueRange);
+	
+	ZC_getKernels(); //select the kernels before starting the threads
+	task.data1 = data1;
+	task.data2 = data2;
+	task.maxViolations = maxViolations;
+	task.bound = result;
+	task.chunks = (ZC_VerifyChunk*)malloc(sizeof(ZC_VerifyChunk)*nbChunks);
+	task.stopChunk = nbChunks;
+	ZC_runTasks(ZC_verifyErrorBoundChunk_double, &task, nbChunks);
+	ZC_mergeVerifyChunks(result, task.chunks, nbChunks, maxViolations);
+	for (i = 0; i < nbChunks; i++)
+		free(task.chunks[i].violations);
+	free(task.chunks);
+	return result;
+}
 
+typedef struct ZC_BatchTask_double
+{
+	double* data1;
+	double** data2;
+	int k;
+	size_t n, nbChunks;
+	ZC_CompareStat* stats; /*k x nbChunks*/
+	ZC_CompareStatBlockFunc_double statBlock;
+} ZC_BatchTask_double;
+
+static void ZC_computeCompareStatBatchChunk_double(void* arg, int threadID, size_t taskID)
+{
+	ZC_BatchTask_double* t = (ZC_BatchTask_double*)arg;
+	size_t i, len, begin = taskID*ZC_CHUNK_SIZE;
+	size_t end = begin + ZC_CHUNK_SIZE < t->n ? begin + ZC_CHUNK_SIZE : t->n;
+	ZC_CompareStat block;
+	int j;
+	for (j = 0; j < t->k; j++)
+		ZC_initCompareStat(&t->stats[j*t->nbChunks+taskID]);
+	//each block of the original data is compared with all the candidates while it is in cache
+	for (i = begin; i < end; i += ZC_STAT_BLOCK_SIZE)
+	{
+		len = end - i < ZC_STAT_BLOCK_SIZE ? end - i : ZC_STAT_BLOCK_SIZE;
+		for (j = 0; j < t->k; j++)
+		{
+			t->statBlock(&block, t->data1+i, t->data2[j]+i, len);
+			ZC_mergeCompareStat(&t->stats[j*t->nbChunks+taskID], &block);
+		}
+	}
+}
 
-				if (cov_0*cov_1 == 0)
-				{
-					for (delta = 1; delta <= AUTOCORR_SIZE; delta++)
-						autoCorrAbsErr[delta] = 0;
-				}
-				else
-				{
-					double sum = 0;
+/**
+ * The first pass for k candidates data2[0..k-1] against the same data1, reading 
+ * data1 only once. The blocks, chunks and reduction tree are those of 
+ * ZC_computeCompareStatMask_double(), so stats[j] is identical to its result for data2[j].
+ * */
+void ZC_computeCompareStatBatch_double(ZC_CompareStat* stats, double* data1, double** data2, int k, size_t n, int statMask)
+{
+	int j;
+	size_t nbChunks = ZC_computeChunkCount(n);
+	ZC_BatchTask_double task;
+	
+	for (j = 0; j < k; j++)
+		ZC_initCompareStat(&stats[j]);
+	if(nbChunks == 0 || k <= 0)
+		return;
+	
+	ZC_getKernels(); //select the kernels before starting the threads
+	task.data1 = data1;
+	task.data2 = data2;
+	task.k = k;
+	task.n = n;
+	task.nbChunks = nbChunks;
+	task.statBlock = ZC_compareStatBlockFuncs_double[statMask & ZC_STAT_ALL];
+	task.stats = (ZC_CompareStat*)malloc(sizeof(ZC_CompareStat)*nbChunks*k);
+	ZC_runTasks(ZC_computeCompareStatBatchChunk_double, &task, nbChunks);
+	for (j = 0; j < k; j++)
+	{
+		ZC_reduceCompareStat(task.stats+j*nbChunks, nbChunks);
+		stats[j] = task.stats[j*nbChunks];
+	}
+	free(task.stats);
+}
 
-					for (i = 0; i < numOfElem-delta; i++)
-						sum += (diff[i]-avg_0)*(diff[i+delta]-avg_1);
+/*all the metrics of compareResult, given the statistics of the first pass*/
+static void ZC_compareDataWithStat_double(ZC_CompareData* compareResult, ZC_CompareStat* statp, double* data1, double* data2, 
+size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
+{
+	size_t numOfElem = compareResult->property->numOfElem;
+	int dim = ZC_computeDimension(r5, r4, r3, r2, r1);
+	ZC_CompareStat stat = *statp;
+	
+	ZC_applyCompareStat(compareResult, &stat);
+	
+	//second pass: the histogram-based metrics
+	if (metricPlan.errPDF)
+		ZC_computeErrPDF_double(compareResult, &stat, data1, data2, numOfElem);
 
-					autoCorrAbsErr[delta] = sum/(numOfElem-delta)/(cov_0*cov_1);
-				}
-			}
+	if (errAutoCorrFlag)
+		compareResult->autoCorrAbsErr = ZC_computeErrAutoCorr_double(data1, data2, numOfElem, stat.meanDiff, stat.m2_diff/numOfElem);
+	
+	if (errMapFlag)
+		compareResult->errMap = ZC_computeErrMap_double(data1, data2, compareResult->property->valueRange, r5, r4, r3, r2, r1);
 
-		}
-        
-		autoCorrAbsErr[0] = 1;
-		compareResult->autoCorrAbsErr = autoCorrAbsErr;
+	if (errQuantilesFlag)
+	{
+		compareResult->absErrSketch = ZC_createQuantileSketch();
+		compareResult->pwrErrSketch = ZC_createQuantileSketch();
+		ZC_addErrSketches_double(compareResult->absErrSketch, compareResult->pwrErrSketch, data1, data2, numOfElem);
 	}
 
 #ifdef HAVE_FFTW3	
 	if(errAutoCorr3DFlag)
 	{
+		size_t i;
+		double *diff = (double*)malloc(numOfElem*sizeof(double));
+		for (i = 0; i < numOfElem; i++)
+			diff[i] = data2[i]-data1[i];
 		switch(dim)
 		{
 		case 1:
@@ -301,77 +685,11 @@ size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
 		default: 
 			printf("Error: wrong dimension (dim=%d)\n", dim);
 			exit(0);
-		}		
+		}
+		free(diff);
 	}
 #endif
 
-	if (pearsonCorrFlag)
-	{
-		double prodSum = 0, sum1 = 0, sum2 = 0;
-    	for (i = 0; i < numOfElem; i++)
-    	{
-    		prodSum += (data1[i]-mean1)*(data2[i]-mean2);
-    		sum1 += (data1[i]-mean1)*(data1[i]-mean1);
-    		sum2 += (data2[i]-mean2)*(data2[i]-mean2);
-    	}
-
-    	double std1 = sqrt(sum1/numOfElem);
-    	double std2 = sqrt(sum2/numOfElem);
-    	double ee = prodSum/numOfElem;
-    	double pearsonCorr = 0;
-
-    	if (std1*std2 != 0)
-    		pearsonCorr = ee/std1/std2;
-
-    	compareResult->pearsonCorr = pearsonCorr;
-	}
-
-	if (rmseFlag)
-	{
-		double rmse = sqrt(mse);
-		compareResult->rmse = rmse;
-	}
-
-	if (nrmseFlag)
-	{
-		double nrmse = sqrt(mse)/valRange;
-		compareResult->nrmse = nrmse;
-	}
-
-	if(snrFlag)
-	{
-		compareResult->snr = 10*log10(zeromean_variance/mse);
-		//printf("compareResult->snr=%f ccompareResult->snr_db=%f", compareResult->snr, compareResult->snr_db); 		
-	}
-
-	if (psnrFlag)
-	{
-		double psnr = -20.0*log10(sqrt(mse)/valRange);
-		compareResult->psnr = psnr;
-	}
-
-	//the correlation between the original data values and the compression errors
-	if (valErrCorrFlag)
-	{
-		double prodSum = 0, sum1 = 0, sumDiff = 0;
-    	for (i = 0; i < numOfElem; i++)
-    	{
-    		prodSum += (data1[i]-mean1)*(diff[i]-avgDiff);
-    		sum1 += (data1[i]-mean1)*(data1[i]-mean1);
-    		sumDiff += (diff[i]-avgDiff)*(diff[i]-avgDiff);
-    	}
-
-    	double std1 = sqrt(sum1/numOfElem);
-    	double stdDiff = sqrt(sumDiff/numOfElem);
-    	double ee = prodSum/numOfElem;
-      	double valErrCorr = 0;
-
-    	if (std1*stdDiff != 0)
-    		valErrCorr = ee/std1/stdDiff;
-
-		compareResult->valErrCorr = valErrCorr;
-	}
-
 #ifdef HAVE_R
 	if(KS_testFlag)
 	{
@@ -392,6 +710,9 @@ size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
 	{
 		switch(dim)
 		{
+		case 1:
+			compareResult->ssimImage2D_avg = zc_calc_ssim_1d_double(data1, data2, r1);
+			break;
 		case 2:
 			compareResult->ssimImage2D_avg = zc_calc_ssim_2d_double(data1, data2, r2, r1);	
 			break;
@@ -404,387 +725,594 @@ size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
 		case 5:
 			zc_calc_ssim_3d_double(data1, data2, r5*r4*r3, r2, r1, &(compareResult->ssimImage2D_min), &(compareResult->ssimImage2D_avg), &(compareResult->ssimImage2D_max));
 			break;
-		default: //1D data is meaningless here
+		default:
 			compareResult->ssimImage2D_min = 0; 
 			compareResult->ssimImage2D_avg = -1;
 			compareResult->ssimImage2D_max = -2;
 		}
 	}
+	
+	if(SSIMVOLUME3DFlag && dim >= 3) //the r5 x r4 volumes of r3 x r2 x r1 points
+	{
+		size_t nbVolumes = dim==3 ? 1 : (dim==4 ? r4 : r5*r4);
+		compareResult->ssimVolume3D = zc_calc_ssim_volume_double(data1, data2, nbVolumes, r3, r2, r1, compareResult->property->valueRange);
+		compareResult->ssimVolume3DComputed = 1;
+	}
+}
 
-	free(diff);
-	free(relDiff);
+void ZC_compareData_double(ZC_CompareData* compareResult, double* data1, double* data2, 
+size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
+{
+	size_t nbSampled;
+	ZC_resolveMetricPlan(&metricPlan); //the metric flags may have been changed since ZC_ReadConf()
+	size_t* blocks = ZC_selectSampleBlocks(compareResult->property->numOfElem, sampleRatio, sampleSeed, &nbSampled);
+	if(blocks!=NULL)
+	{
+		ZC_compareDataSample_double(compareResult, data1, data2, blocks, nbSampled);
+		free(blocks);
+		return;
+	}
+	
+	//first pass: all the moment-style metrics of the metric plan
+	ZC_CompareStat stat;
+	ZC_computeCompareStatMask_double(&stat, data1, data2, compareResult->property->numOfElem, metricPlan.statMask);
+	ZC_compareDataWithStat_double(compareResult, &stat, data1, data2, r5, r4, r3, r2, r1);
+}
 
+/**
+ * Compare k decompressed candidates data2[0..k-1] with the same original data1 
+ * (compareResults[j]->property describes data1); the first pass reads data1 once 
+ * for all of them. The results are identical to k calls of ZC_compareData_double().
+ * */
+void ZC_compareData_batch_double(ZC_CompareData** compareResults, double* data1, double** data2, int k, 
+size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
+{
+	int j;
+	ZC_resolveMetricPlan(&metricPlan);
+	if(sampleRatio < 1) //the samples are small: compare them one by one
+	{
+		for (j = 0; j < k; j++)
+			ZC_compareData_double(compareResults[j], data1, data2[j], r5, r4, r3, r2, r1);
+		return;
+	}
+	ZC_CompareStat* stats = (ZC_CompareStat*)malloc(sizeof(ZC_CompareStat)*k);
+	ZC_computeCompareStatBatch_double(stats, data1, data2, k, compareResults[0]->property->numOfElem, metricPlan.statMask);
+	for (j = 0; j < k; j++)
+		ZC_compareDataWithStat_double(compareResults[j], &stats[j], data1, data2[j], r5, r4, r3, r2, r1);
+	free(stats);
 }
 
-#ifdef HAVE_MPI
+/*approximate mode: the sampled blocks are processed by groups of ZC_CHUNK_SIZE points*/
+#define ZC_SAMPLE_GROUP (ZC_CHUNK_SIZE/ZC_SAMPLE_BLOCK_SIZE)
 
-void ZC_compareData_double_online(ZC_CompareData* compareResult, double* data1, double* data2, 
-size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
+typedef struct ZC_SampleTask_double
 {
-	size_t i = 0;
-	double minDiff = data2[0]-data1[0];
-	double maxDiff = minDiff;
-	double minErr = fabs(minDiff);
-	double maxErr = minErr;
-	double sum1 = 0, sum2 = 0, sumDiff = 0, sumErr = 0, sumErrSqr = 0;
+	double** blocks1; /*the sampled blocks of the original and decompressed data*/
+	double** blocks2;
+	size_t* lengths;
+	size_t nbSampled;
+	ZC_CompareStat* stats; /*one per sampled block*/
+	ZC_CompareStatBlockFunc_double statBlock;
 	
-	double minDiff_rel = 1E100;
-	double maxDiff_rel = -1E100;
-	double minErr_rel = 1E100;
-	double maxErr_rel = 0;
-	double sumDiff_rel = 0, sumErr_rel = 0, sumErrSqr_rel = 0;
+	double minDiff, interval; /*error PDFs*/
+	double minDiff_rel, maxDiff_rel, interval_rel;
+	double* absErrPDF; /*per thread: the counts, their squares and their products by the block lengths*/
+	double* relErrPDF;
 	
-	double err;
-	long numOfElem = ZC_computeDataLength(r5, r4, r3, r2, r1);	
-		
-	if(globalDataLength <= 0)
-		MPI_Allreduce(&numOfElem, &globalDataLength, 1, MPI_LONG, MPI_SUM, ZC_COMM_WORLD);
-			
-	double sumOfDiffSquare = 0;
-	long numOfElem_ = 0; //used to record the number of elements for relative-error-bound cases
-
-	int dim = ZC_computeDimension(r5, r4, r3, r2, r1);
+	double avgDiff; /*error autocorrelation*/
+	double* lagSums; /*AUTOCORR_SIZE+1 partial sums per group*/
+} ZC_SampleTask_double;
 
-	double *diff = (double*)malloc(numOfElem*sizeof(double));
-	double *relDiff = (double*)malloc(numOfElem*sizeof(double));
+static void ZC_computeSampleStatGroup_double(void* arg, int threadID, size_t taskID)
+{
+	ZC_SampleTask_double* t = (ZC_SampleTask_double*)arg;
+	size_t j, end = (taskID+1)*ZC_SAMPLE_GROUP < t->nbSampled ? (taskID+1)*ZC_SAMPLE_GROUP : t->nbSampled;
+	for (j = taskID*ZC_SAMPLE_GROUP; j < end; j++)
+		t->statBlock(&t->stats[j], t->blocks1[j], t->blocks2[j], t->lengths[j]);
+}
 
-	for (i = 0; i < numOfElem; i++)
+static void ZC_computeSampleErrGroup_double(void* arg, int threadID, size_t taskID)
+{
+	ZC_SampleTask_double* t = (ZC_SampleTask_double*)arg;
+	size_t i, j, k, end = (taskID+1)*ZC_SAMPLE_GROUP < t->nbSampled ? (taskID+1)*ZC_SAMPLE_GROUP : t->nbSampled;
+	double *absErrPDF = t->absErrPDF==NULL ? NULL : t->absErrPDF + (size_t)threadID*3*PDF_INTERVALS;
+	double *relErrPDF = t->relErrPDF==NULL ? NULL : t->relErrPDF + (size_t)threadID*PDF_INTERVALS_REL;
+	double *lagSums = t->lagSums==NULL ? NULL : t->lagSums + taskID*(AUTOCORR_SIZE+1);
+	int *blockCounts = NULL, *touched = NULL, nbTouched, index;
+	double *y = NULL, diff, relDiff;
+	
+	if(absErrPDF!=NULL)
 	{
-		sum1 += data1[i];
-		sum2 += data2[i];
-		
-		diff[i] = data2[i]-data1[i];
-		if(minDiff > diff[i]) minDiff = diff[i];
-		if(maxDiff < diff[i]) maxDiff = diff[i];
-		sumDiff += diff[i];
-		sumOfDiffSquare += diff[i]*diff[i];
-				
-		err = fabs(diff[i]);
-		if(minErr>err) minErr = err;
-		if(maxErr<err) maxErr = err;
-		sumErr += err;
-		sumErrSqr += err*err; //used for mse, nrmse, psnr
-	
-		if(data1[i]!=0)
-		{
-			numOfElem_ ++;
-			relDiff[i] = diff[i]/data1[i];
-			if(minDiff_rel > relDiff[i]) minDiff_rel = relDiff[i];
-			if(maxDiff_rel < relDiff[i]) maxDiff_rel = relDiff[i];
-			sumDiff_rel += relDiff[i];
-			
-			err = fabs(relDiff[i]);
-			if(minErr_rel>err) minErr_rel = err;
-			if(maxErr_rel<err) maxErr_rel = err;
-			sumErr_rel += err;
-			sumErrSqr_rel += err*err;
-		}	
+		blockCounts = (int*)calloc(PDF_INTERVALS, sizeof(int));
+		touched = (int*)malloc(sizeof(int)*ZC_SAMPLE_BLOCK_SIZE);
+	}
+	if(lagSums!=NULL)
+	{
+		y = (double*)malloc(sizeof(double)*ZC_SAMPLE_BLOCK_SIZE);
+		memset(lagSums, 0, sizeof(double)*(AUTOCORR_SIZE+1));
 	}
 	
-	ZC_DataProperty* property = compareResult->property;
-	
-	double zeromean_variance = property->zeromean_variance;
-	double global_valRange = property->valueRange;
-	
-	double global_sum1, global_sum2, global_sumErr, global_maxDiff, global_minDiff, global_sumErrSqr, global_sumDiff;
-	double global_maxErr_rel, global_minErr_rel, global_sumErr_rel, global_maxErr, global_minErr, global_maxDiff_rel, global_minDiff_rel; 
-	long global_numOfElem_;
-	//Compute the global sum and mean 
-	
-	double sum_localBuffer[6], sum_globalBuffer[6];
-	double max_localBuffer[4], max_globalBuffer[4];
-	double min_localBuffer[4], min_globalBuffer[4];
-	
-	sum_localBuffer[0] = sum1;
-	sum_localBuffer[1] = sum2;
-	sum_localBuffer[2] = sumErr;
-	sum_localBuffer[3] = sumErrSqr;
-	sum_localBuffer[4] = sumErr_rel;
-	sum_localBuffer[5] = sumDiff;
-	max_localBuffer[0] = maxErr;
-	max_localBuffer[1] = maxDiff;
-	max_localBuffer[2] = maxErr_rel;
-	max_localBuffer[3] = maxDiff_rel;
-	min_localBuffer[0] = minErr;
-	min_localBuffer[1] = minDiff;
-	min_localBuffer[2] = minErr_rel;
-	min_localBuffer[3] = minDiff_rel;
-	
-	MPI_Allreduce(sum_localBuffer, sum_globalBuffer, 6, MPI_DOUBLE, MPI_SUM, ZC_COMM_WORLD);
-	MPI_Allreduce(max_localBuffer, max_globalBuffer, 4, MPI_DOUBLE, MPI_MAX, ZC_COMM_WORLD);
-	MPI_Allreduce(min_localBuffer, min_globalBuffer, 4, MPI_DOUBLE, MPI_MIN, ZC_COMM_WORLD);	
-	MPI_Allreduce(&numOfElem_, &global_numOfElem_, 1, MPI_LONG, MPI_SUM, ZC_COMM_WORLD);
-			
-	global_sum1 = sum_globalBuffer[0];
-	global_sum2 = sum_globalBuffer[1];
-	global_sumErr = sum_globalBuffer[2];
-	global_sumErrSqr = sum_globalBuffer[3];
-	global_sumErr_rel = sum_globalBuffer[4];
-	global_sumDiff = sum_globalBuffer[5];
-	
-	global_maxErr = max_globalBuffer[0];
-	global_maxDiff = max_globalBuffer[1];
-	global_maxErr_rel = max_globalBuffer[2];
-	global_maxDiff_rel = max_globalBuffer[3];
-	
-	global_minErr = min_globalBuffer[0];
-	global_minDiff = min_globalBuffer[1];
-	global_minErr_rel = min_globalBuffer[2];	
-	global_minDiff_rel = min_globalBuffer[3];
-			
-	double global_mean1 = global_sum1/globalDataLength;
-	double global_mean2 = global_sum2/globalDataLength;
-	
-	double global_avgErr = global_sumErr/globalDataLength;
-	double global_diffRange = global_maxDiff - global_minDiff;
-	double global_mse = global_sumErrSqr/globalDataLength;
-	
-	double global_avgErr_rel = global_sumErr_rel/global_numOfElem_;
-	double global_avgDiff = global_sumDiff/globalDataLength;
-	
-	double global_diffRange_rel = global_maxDiff_rel - global_minDiff_rel;
-		
-	size_t index;
-	
-	if (minAbsErrFlag)
-		compareResult->minAbsErr = global_minErr;
-
-	if (minRelErrFlag)
-		compareResult->minRelErr = global_minErr/global_valRange;
-
-	if (maxAbsErrFlag)
-		compareResult->maxAbsErr = global_maxErr;
-
-	if (maxRelErrFlag)
-		compareResult->maxRelErr = global_maxErr/global_valRange;
-
-	if (avgAbsErrFlag)
-		compareResult->avgAbsErr = global_avgErr;
-
-	if (avgRelErrFlag)
-		compareResult->avgRelErr = global_avgErr/global_valRange;
-		
-	compareResult->minPWRErr = global_minErr_rel;
-	compareResult->maxPWRErr = global_maxErr_rel;
-	compareResult->avgPWRErr = global_sumErr_rel/global_numOfElem_;
-
-	if (absErrPDFFlag)
+	for (j = taskID*ZC_SAMPLE_GROUP; j < end; j++)
 	{
-		double interval = global_diffRange/PDF_INTERVALS;
-		double *absErrPDF = NULL, *global_absErrPDF = NULL; 
-						
-		if(interval==0)
-		{
-			global_absErrPDF = (double*)malloc(sizeof(double));
-			*global_absErrPDF = 0;
-		}
-		else
+		double *data1 = t->blocks1[j], *data2 = t->blocks2[j];
+		size_t len = t->lengths[j];
+		nbTouched = 0;
+		for (i = 0; i < len; i++)
 		{
-			absErrPDF = (double*)malloc(sizeof(double)*PDF_INTERVALS);
-			memset(absErrPDF, 0, PDF_INTERVALS*sizeof(double));
-			global_absErrPDF = (double*)malloc(sizeof(double)*PDF_INTERVALS);
-			memset(global_absErrPDF, 0, PDF_INTERVALS*sizeof(double));
-			
-			for (i = 0; i < numOfElem; i++)
+			diff = data2[i]-data1[i];
+			if(absErrPDF!=NULL)
 			{
-				index = (size_t)((diff[i]-global_minDiff)/interval);
+				index = (int)((diff-t->minDiff)/t->interval);
 				if(index==PDF_INTERVALS)
 					index = PDF_INTERVALS-1;
-				absErrPDF[index] += 1;
+				if(blockCounts[index]++ == 0)
+					touched[nbTouched++] = index;
 			}
-
-			MPI_Reduce(absErrPDF, global_absErrPDF, PDF_INTERVALS, MPI_DOUBLE, MPI_SUM, 0, ZC_COMM_WORLD);
-			
-			free(absErrPDF);
-			
-			if(myRank==0)
+			if(relErrPDF!=NULL && data1[i]!=0)
 			{
-				for (i = 0; i < PDF_INTERVALS; i++)
-					global_absErrPDF[i]/=globalDataLength;						
+				relDiff = diff/data1[i];
+				if(relDiff>t->maxDiff_rel)
+					relDiff = t->maxDiff_rel;
+				if(relDiff<t->minDiff_rel)
+					relDiff = t->minDiff_rel;
+				index = (int)((relDiff-t->minDiff_rel)/t->interval_rel);
+				if(index==PDF_INTERVALS_REL)
+					index = PDF_INTERVALS_REL-1;
+				relErrPDF[index] += 1;
 			}
+			if(y!=NULL)
+				y[i] = diff-t->avgDiff;
 		}
-		if(myRank==0)
+		//the per-block counts give the between-block variance of each bin
+		for (k = 0; k < nbTouched; k++)
 		{
-			compareResult->absErrPDF = global_absErrPDF;
-			compareResult->err_interval = interval;
-			compareResult->err_minValue = global_minDiff;					
+			double c = blockCounts[touched[k]];
+			absErrPDF[touched[k]] += c;
+			absErrPDF[PDF_INTERVALS+touched[k]] += c*c;
+			absErrPDF[2*PDF_INTERVALS+touched[k]] += c*len;
+			blockCounts[touched[k]] = 0;
 		}
+		//only the lags inside each sampled block are observed
+		if(y!=NULL)
+			ZC_accumulateLagProducts(y, len, 0, AUTOCORR_SIZE, lagSums);
 	}
+	free(blockCounts);
+	free(touched);
+	free(y);
+}
 
-	if (pwrErrPDFFlag)
+/**
+ * Approximate mode: compare only the nbSampled blocks blocks1[j]/blocks2[j] 
+ * (of lengths[j] points) drawn by ZC_selectSampleBlocks() among the blocks of 
+ * property->numOfElem points. The metrics are those of the sample, i.e., ratio 
+ * estimates of the ones of the whole data; avgAbsErr, rmse, psnr and the bins of 
+ * absErrPDF come with 95% confidence intervals, and the maximal error of the sample 
+ * is only a lower bound (maxAbsErrExact = 0). errAutoCorr only uses the lags inside 
+ * the blocks; the metrics needing the whole data (errAutoCorr3D, ssim) are skipped.
+ * */
+static void ZC_compareSampleBlocks_double(ZC_CompareData* compareResult, double** blocks1, double** blocks2, size_t* lengths, size_t nbSampled)
+{
+	size_t i, j, delta;
+	size_t nbBlocks = ZC_computeSampleBlockCount(compareResult->property->numOfElem);
+	size_t nbGroups = (nbSampled + ZC_SAMPLE_GROUP - 1)/ZC_SAMPLE_GROUP;
+	int threadCount = ZC_computeThreadCount(nbGroups);
+	double valRange = compareResult->property->valueRange, hw;
+	ZC_SampleTask_double task;
+	ZC_CompareStat stat;
+	ZC_RatioSums errSums, sqrSums;
+	
+	ZC_getKernels(); //select the kernels before starting the threads
+	task.blocks1 = blocks1;
+	task.blocks2 = blocks2;
+	task.lengths = lengths;
+	task.nbSampled = nbSampled;
+	task.statBlock = ZC_compareStatBlockFuncs_double[metricPlan.statMask & ZC_STAT_ALL];
+	task.stats = (ZC_CompareStat*)malloc(sizeof(ZC_CompareStat)*nbSampled);
+	ZC_runTasks(ZC_computeSampleStatGroup_double, &task, nbGroups);
+	
+	ZC_initRatioSums(&errSums);
+	ZC_initRatioSums(&sqrSums);
+	for (j = 0; j < nbSampled; j++)
 	{
-		double interval = global_diffRange_rel/PDF_INTERVALS_REL;
-		double *relErrPDF = NULL, *global_relErrPDF = NULL;
-		if(interval==0)
-		{
-			relErrPDF = (double*)malloc(sizeof(double));
-			*relErrPDF = 0;
-		}
-		else
-		{			
-			relErrPDF = (double*)malloc(sizeof(double)*PDF_INTERVALS_REL);
-			memset(relErrPDF, 0, PDF_INTERVALS_REL*sizeof(double));
-			global_relErrPDF = (double*)malloc(sizeof(double)*PDF_INTERVALS_REL);
-			memset(global_relErrPDF, 0, PDF_INTERVALS_REL*sizeof(double));	
-			
-			for (i = 0; i < numOfElem; i++)
+		ZC_addRatioSample(&errSums, task.stats[j].sumErr, lengths[j]);
+		ZC_addRatioSample(&sqrSums, task.stats[j].sumErrSqr, lengths[j]);
+	}
+	ZC_reduceCompareStat(task.stats, nbSampled);
+	stat = task.stats[0];
+	free(task.stats);
+	
+	ZC_applyCompareStat(compareResult, &stat);
+	compareResult->sampleRatio = (double)stat.n/compareResult->property->numOfElem;
+	compareResult->maxAbsErrExact = 0;
+	
+	double avgErr = ZC_estimateRatio(&errSums, nbSampled, nbBlocks, &hw);
+	compareResult->avgAbsErr_low = avgErr - hw < 0 ? 0 : avgErr - hw;
+	compareResult->avgAbsErr_high = avgErr + hw;
+	double mse = ZC_estimateRatio(&sqrSums, nbSampled, nbBlocks, &hw);
+	compareResult->rmse_low = mse - hw < 0 ? 0 : sqrt(mse - hw);
+	compareResult->rmse_high = sqrt(mse + hw);
+	compareResult->psnr_low = -20.0*log10(compareResult->rmse_high/valRange);
+	compareResult->psnr_high = compareResult->rmse_low == 0 ? HUGE_VAL : -20.0*log10(compareResult->rmse_low/valRange);
+	
+	//second pass over the sample: the error PDFs and the error autocorrelation
+	double *absCounts = NULL, *relCounts = NULL;
+	if (metricPlan.errPDF)
+		ZC_allocErrPDFCounts(&stat, &absCounts, &relCounts);
+	ZC_computeErrPDFRange(&stat, &task.minDiff, &task.interval, &task.minDiff_rel, &task.maxDiff_rel, &task.interval_rel);
+	task.absErrPDF = absCounts==NULL ? NULL : (double*)calloc((size_t)threadCount*3*PDF_INTERVALS, sizeof(double));
+	task.relErrPDF = relCounts==NULL ? NULL : (double*)calloc((size_t)threadCount*PDF_INTERVALS_REL, sizeof(double));
+	task.avgDiff = stat.meanDiff;
+	task.lagSums = errAutoCorrFlag ? (double*)malloc(sizeof(double)*(AUTOCORR_SIZE+1)*nbGroups) : NULL;
+	if (task.absErrPDF!=NULL || task.relErrPDF!=NULL || task.lagSums!=NULL)
+		ZC_runTasks(ZC_computeSampleErrGroup_double, &task, nbGroups);
+	
+	if (absCounts!=NULL)
+	{
+		int t;
+		double *sqrCounts = (double*)calloc(PDF_INTERVALS, sizeof(double));
+		double *lenCounts = (double*)calloc(PDF_INTERVALS, sizeof(double));
+		ZC_RatioSums binSums;
+		ZC_initRatioSums(&binSums);
+		for (j = 0; j < nbSampled; j++)
+			ZC_addRatioSample(&binSums, 0, lengths[j]);
+		//all the sums are integers: they do not depend on the number of threads
+		for (t = 0; t < threadCount; t++)
+			for (i = 0; i < PDF_INTERVALS; i++)
 			{
-				if(data1[i]!=0)
-				{
-					if(relDiff[i]>maxDiff_rel)
-						relDiff[i] = maxDiff_rel;
-					if(relDiff[i]<minDiff_rel)
-						relDiff[i] = minDiff_rel;
-					index = (size_t)((relDiff[i]-minDiff_rel)/interval);
-					if(index==PDF_INTERVALS_REL)
-						index = PDF_INTERVALS_REL-1;
-					relErrPDF[index] += 1;
-				}
+				absCounts[i] += task.absErrPDF[(size_t)t*3*PDF_INTERVALS+i];
+				sqrCounts[i] += task.absErrPDF[(size_t)t*3*PDF_INTERVALS+PDF_INTERVALS+i];
+				lenCounts[i] += task.absErrPDF[(size_t)t*3*PDF_INTERVALS+2*PDF_INTERVALS+i];
 			}
-			
-			MPI_Reduce(relErrPDF, global_relErrPDF, PDF_INTERVALS, MPI_DOUBLE, MPI_SUM, 0, ZC_COMM_WORLD);			
-			
-			free(relErrPDF);
-			
-			if(myRank==0)
-			{
-				for (i = 0; i < PDF_INTERVALS_REL; i++)
-					global_relErrPDF[i]/=global_numOfElem_;						
-			}		
-		}
-		if(myRank==0)
+		compareResult->absErrPDF_ci = (double*)malloc(sizeof(double)*PDF_INTERVALS);
+		for (i = 0; i < PDF_INTERVALS; i++)
 		{
-			compareResult->pwrErrPDF = relErrPDF;
-			compareResult->err_interval_rel = interval;
-			compareResult->err_minValue_rel = minDiff_rel;			
-		}		
+			binSums.y = absCounts[i];
+			binSums.yy = sqrCounts[i];
+			binSums.yn = lenCounts[i];
+			ZC_estimateRatio(&binSums, nbSampled, nbBlocks, &compareResult->absErrPDF_ci[i]);
+		}
+		free(sqrCounts);
+		free(lenCounts);
+		free(task.absErrPDF);
 	}
-
+	if (relCounts!=NULL)
+	{
+		int t;
+		for (t = 0; t < threadCount; t++)
+			for (i = 0; i < PDF_INTERVALS_REL; i++)
+				relCounts[i] += task.relErrPDF[(size_t)t*PDF_INTERVALS_REL+i];
+		free(task.relErrPDF);
+	}
+	if (metricPlan.errPDF)
+		ZC_finalizeErrPDF(compareResult, &stat, absCounts, relCounts);
+	
 	if (errAutoCorrFlag)
-	{	
+	{
+		double varDiff = stat.m2_diff/stat.n;
 		double *autoCorrAbsErr = (double*)malloc((AUTOCORR_SIZE+1)*sizeof(double));
-		
-		double ccov[AUTOCORR_SIZE+1], gcov[AUTOCORR_SIZE+1];
-		memset(ccov, 0, sizeof(double)*(AUTOCORR_SIZE+1));
-		memset(gcov, 0, sizeof(double)*(AUTOCORR_SIZE+1));
-		
-		int delta;
-		double var = 0, gvar = 0;
-		for (i = 0; i < numOfElem; i++)
-			var += (diff[i] - global_avgDiff)*(diff[i] - global_avgDiff);
-		
-		for(delta = 1; delta <= AUTOCORR_SIZE; delta++)
+		ZC_reduceSumTree(task.lagSums, nbGroups, AUTOCORR_SIZE+1);
+		for (delta = 1; delta <= AUTOCORR_SIZE; delta++)
 		{
-			double cov = 0;
-			for (i = 0; i < numOfElem-delta; i++)
-				cov += (diff[i] - global_avgDiff)*(diff[i+delta] - global_avgDiff);
-			ccov[delta] = cov;	
+			double nbPairs = 0;
+			for (j = 0; j < nbSampled; j++)
+				nbPairs += lengths[j] > delta ? lengths[j] - delta : 0;
+			autoCorrAbsErr[delta] = varDiff == 0 || nbPairs == 0 ? 1 : task.lagSums[delta]/nbPairs/varDiff;
 		}
-		
-		MPI_Reduce(&var, &gvar, 1, MPI_DOUBLE, MPI_SUM, 0, ZC_COMM_WORLD);
-		MPI_Reduce(ccov, gcov, AUTOCORR_SIZE+1, MPI_DOUBLE, MPI_SUM, 0, ZC_COMM_WORLD);		
-		
-		if(myRank==0)
-		{	
-			gvar = gvar/globalDataLength;
-			if (gvar == 0)
-			{
-				for (delta = 1; delta <= AUTOCORR_SIZE; delta++)
-					autoCorrAbsErr[delta] = 1;
-			}
-			else
-			{
-				for (delta = 1; delta <= AUTOCORR_SIZE; delta++)
-				{
-					autoCorrAbsErr[delta] = gcov[delta]/(globalDataLength-nbProc*delta)/gvar;				
-				}
-			}
-			autoCorrAbsErr[0] = 1;
-			compareResult->autoCorrAbsErr = autoCorrAbsErr;					
-		}		
+		autoCorrAbsErr[0] = 1;
+		compareResult->autoCorrAbsErr = autoCorrAbsErr;
+		free(task.lagSums);
 	}
+}
 
-	double p_localBuffer[3], p_globalBuffer[3];
+/**
+ * Approximate mode on in-memory data: compare the blocks selected by 
+ * ZC_selectSampleBlocks() (see ZC_compareSampleBlocks_double()).
+ * */
+void ZC_compareDataSample_double(ZC_CompareData* compareResult, double* data1, double* data2, size_t* blocks, size_t nbSampled)
+{
+	size_t n = compareResult->property->numOfElem;
+	ZC_resolveMetricPlan(&metricPlan);
+	size_t* lengths = (size_t*)malloc(sizeof(size_t)*nbSampled);
+	double** blocks1 = (double**)ZC_getSampleBlockPointers(data1, sizeof(double), n, blocks, nbSampled, lengths);
+	double** blocks2 = (double**)ZC_getSampleBlockPointers(data2, sizeof(double), n, blocks, nbSampled, lengths);
+	ZC_compareSampleBlocks_double(compareResult, blocks1, blocks2, lengths, nbSampled);
+	free(blocks1);
+	free(blocks2);
+	free(lengths);
+}
 
-	if (pearsonCorrFlag)
+/*approximate mode of ZC_compareDataFile_double(): read and compare only the sampled blocks*/
+static void ZC_compareDataFileSample_double(ZC_CompareData* compareResult, int fd1, int fd2, size_t* blocks, size_t nbSampled)
+{
+	size_t j, n = compareResult->property->numOfElem;
+	double* buffer1 = (double*)malloc(sizeof(double)*nbSampled*ZC_SAMPLE_BLOCK_SIZE);
+	double* buffer2 = (double*)malloc(sizeof(double)*nbSampled*ZC_SAMPLE_BLOCK_SIZE);
+	double** blocks1 = (double**)malloc(sizeof(double*)*nbSampled);
+	double** blocks2 = (double**)malloc(sizeof(double*)*nbSampled);
+	size_t* lengths = (size_t*)malloc(sizeof(size_t)*nbSampled);
+	for (j = 0; j < nbSampled; j++)
 	{
-		double prodSum = 0, sum1 = 0, sum2 = 0;
-    	for (i = 0; i < numOfElem; i++)
-    	{
-    		prodSum += (data1[i]-global_mean1)*(data2[i]-global_mean2);
-    		sum1 += (data1[i]-global_mean1)*(data1[i]-global_mean1);
-    		sum2 += (data2[i]-global_mean2)*(data2[i]-global_mean2);
-    	}
+		blocks1[j] = buffer1 + j*ZC_SAMPLE_BLOCK_SIZE;
+		blocks2[j] = buffer2 + j*ZC_SAMPLE_BLOCK_SIZE;
+		lengths[j] = ZC_getSampleBlockLength(n, blocks[j]);
+		ZC_readDoubleDataChunk(fd1, blocks[j]*ZC_SAMPLE_BLOCK_SIZE, lengths[j], blocks1[j]);
+		ZC_readDoubleDataChunk(fd2, blocks[j]*ZC_SAMPLE_BLOCK_SIZE, lengths[j], blocks2[j]);
+	}
+	ZC_DataProperty* property = compareResult->property;
+	property->sampleRatio = ZC_computeSampleValueStat_double(blocks1, lengths, nbSampled, &property->minValue, 
+	&property->maxValue, &property->avgValue, &property->zeromean_variance)/(double)n;
+	property->valueRange = property->maxValue - property->minValue;
+	ZC_compareSampleBlocks_double(compareResult, blocks1, blocks2, lengths, nbSampled);
+	free(buffer1);
+	free(buffer2);
+	free(blocks1);
+	free(blocks2);
+	free(lengths);
+}
 
-		p_localBuffer[0] = prodSum;
-		p_localBuffer[1] = sum1;
-		p_localBuffer[2] = sum2;
+/**
+ * Compare the data stored in the files fd1 (original) and fd2 (decompressed), 
+ * holding only chunkSize points of each file in memory.
+ * 
+ * All the moment-style metrics, the value range of the original data and the 
+ * autocorrelation of the errors are accumulated in a single pass over the files. 
+ * The error distributions need a second pass, because their bins depend on the 
+ * ranges of the errors. The ssim metrics read the files by bands of rows (or by slices), 
+ * the 2D ssim of 3D+ data only the sampled slices. errAutoCorr3D and the fft metrics 
+ * (fftFlag) are not supported: they need the whole data.
+ * compareResult->property must be allocated; its value statistics are filled here.
+ * In the approximate mode (sampleRatio<1), only the sampled blocks are read, and 
+ * they are held in memory together.
+ * */
+void ZC_compareDataFile_double(ZC_CompareData* compareResult, int fd1, int fd2, size_t chunkSize, 
+size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
+{
+	size_t i, len, offset;
+	size_t numOfElem = ZC_computeDataLength(r5, r4, r3, r2, r1);
+	size_t nbSampled;
+	ZC_resolveMetricPlan(&metricPlan);
+	size_t* blocks = ZC_selectSampleBlocks(numOfElem, sampleRatio, sampleSeed, &nbSampled);
+	if(blocks!=NULL)
+	{
+		ZC_compareDataFileSample_double(compareResult, fd1, fd2, blocks, nbSampled);
+		free(blocks);
+		return;
+	}
+	
+	int dim = ZC_computeDimension(r5, r4, r3, r2, r1);
+	ZC_DataProperty* property = compareResult->property;
+	ZC_Kernels* kernels = ZC_getKernels();
+	
+	double *data1 = (double*)malloc(chunkSize*sizeof(double));
+	double *data2 = (double*)malloc(chunkSize*sizeof(double));
+	double *diff = NULL;
+	double min = 0, max = 0, cmin, cmax, csum;
+	ZC_LagAccumulator acc;
+	ZC_ErrMap* errMap = errMapFlag ? ZC_constructErrMap(r5, r4, r3, r2, r1) : NULL;
+	if (errQuantilesFlag)
+	{
+		compareResult->absErrSketch = ZC_createQuantileSketch();
+		compareResult->pwrErrSketch = ZC_createQuantileSketch();
+	}
+	
+	//first pass: the moments, the value range, the lagged products of the errors, the error map and the error quantiles
+	ZC_CompareStat stat, chunkStat;
+	ZC_initCompareStat(&stat);
+	for (offset = 0; offset < numOfElem; offset += len)
+	{
+		len = numOfElem - offset < chunkSize ? numOfElem - offset : chunkSize;
+		ZC_readDoubleDataChunk(fd1, offset, len, data1);
+		ZC_readDoubleDataChunk(fd2, offset, len, data2);
 		
-		MPI_Reduce(p_localBuffer, p_globalBuffer, 3, MPI_DOUBLE, MPI_SUM, 0, ZC_COMM_WORLD);
+		ZC_computeCompareStatMask_double(&chunkStat, data1, data2, len, metricPlan.statMask | ZC_STAT_MOMENTS);
+		kernels->valueSums_double(data1, len, &cmin, &cmax, &csum);
+		if(offset == 0)
+		{
+			min = cmin;
+			max = cmax;
+		}
+		if(min>cmin) min = cmin;
+		if(max<cmax) max = cmax;
 		
-		if(myRank==0)
+		if (errAutoCorrFlag)
 		{
-			double global_std1, global_std2, global_ee, global_pearsonCorr = 0;
-			global_std1 = sqrt(p_globalBuffer[1]/globalDataLength);
-			global_std2 = sqrt(p_globalBuffer[2]/globalDataLength);
-			global_ee = p_globalBuffer[0]/globalDataLength;
-			if(global_std1*global_std2 != 0)
-				global_pearsonCorr = global_ee/global_std1/global_std2;
-			compareResult->pearsonCorr = global_pearsonCorr;
+			if(offset == 0)
+			{
+				//shifting the errors by the mean of the first chunk keeps the products well conditioned
+				diff = (double*)malloc(chunkSize*sizeof(double));
+				ZC_initLagAccumulator(&acc, AUTOCORR_SIZE, chunkStat.meanDiff);
+			}
+			for (i = 0; i < len; i++)
+				diff[i] = data2[i]-data1[i];
+			ZC_updateLagAccumulator(&acc, diff, len);
 		}
+		if (errMap != NULL)
+			ZC_updateErrMap_double(errMap, data1, data2, offset, len);
+		if (errQuantilesFlag)
+			ZC_addErrSketches_double(compareResult->absErrSketch, compareResult->pwrErrSketch, data1, data2, len);
+		ZC_mergeCompareStat(&stat, &chunkStat);
 	}
-
-	if (rmseFlag)
+	
+	double med = min+(max-min)/2;
+	property->minValue = min;
+	property->maxValue = max;
+	property->valueRange = max - min;
+	property->avgValue = stat.mean1;
+	property->zeromean_variance = (stat.m2_1 + numOfElem*(stat.mean1-med)*(stat.mean1-med))/numOfElem;
+	ZC_applyCompareStat(compareResult, &stat);
+	
+	if (errMap != NULL)
 	{
-		double global_rmse = sqrt(global_mse);
-		compareResult->rmse = global_rmse;
+		ZC_finalizeErrMap(errMap, property->valueRange);
+		compareResult->errMap = errMap;
 	}
-
-	if (nrmseFlag)
+	
+	if (errAutoCorrFlag)
 	{
-		double nrmse = sqrt(global_mse)/global_valRange;
-		compareResult->nrmse = nrmse;
+		size_t delta;
+		double varDiff = stat.m2_diff/numOfElem;
+		double *autoCorrAbsErr = (double*)malloc((AUTOCORR_SIZE+1)*sizeof(double));
+		double lagSums[AUTOCORR_SIZE+1];
+		ZC_computeCenteredLagSums(&acc, stat.meanDiff, lagSums);
+		for (delta = 1; delta <= AUTOCORR_SIZE; delta++)
+			autoCorrAbsErr[delta] = varDiff == 0 ? 1 : lagSums[delta]/(numOfElem-delta)/varDiff;
+		autoCorrAbsErr[0] = 1;
+		compareResult->autoCorrAbsErr = autoCorrAbsErr;
+		ZC_freeLagAccumulator(&acc);
+		free(diff);
 	}
-
-	if(snrFlag)
+	
+	//second pass: the histogram-based metrics
+	if (metricPlan.errPDF)
 	{
-		compareResult->snr = 10*log10(zeromean_variance/global_mse);
+		double *absCounts = NULL, *relCounts = NULL;
+		ZC_allocErrPDFCounts(&stat, &absCounts, &relCounts);
+		if(absCounts!=NULL || relCounts!=NULL)
+			for (offset = 0; offset < numOfElem; offset += len)
+			{
+				len = numOfElem - offset < chunkSize ? numOfElem - offset : chunkSize;
+				ZC_readDoubleDataChunk(fd1, offset, len, data1);
+				ZC_readDoubleDataChunk(fd2, offset, len, data2);
+				ZC_countErrPDF_double(&stat, data1, data2, len, absCounts, relCounts);
+			}
+		ZC_finalizeErrPDF(compareResult, &stat, absCounts, relCounts);
 	}
-
-	if (psnrFlag)
+	free(data1);
+	free(data2);
+	
+	if(SSIMIMAGE2DFlag)
 	{
-		double psnr = -20.0*log10(sqrt(global_mse)/global_valRange);
-		compareResult->psnr = psnr;
+		switch(dim)
+		{
+		case 1:
+			compareResult->ssimImage2D_avg = zc_calc_ssim_1d_file(fd1, fd2, ZC_DOUBLE, r1, compareResult->property->valueRange);
+			break;
+		case 2:
+			compareResult->ssimImage2D_avg = zc_calc_ssim_2d_file(fd1, fd2, ZC_DOUBLE, r2, r1, compareResult->property->valueRange);
+			break;
+		case 3:
+			zc_calc_ssim_3d_file(fd1, fd2, ZC_DOUBLE, r3, r2, r1, &(compareResult->ssimImage2D_min), &(compareResult->ssimImage2D_avg), &(compareResult->ssimImage2D_max));
+			break;
+		case 4:
+			zc_calc_ssim_3d_file(fd1, fd2, ZC_DOUBLE, r4*r3, r2, r1, &(compareResult->ssimImage2D_min), &(compareResult->ssimImage2D_avg), &(compareResult->ssimImage2D_max));
+			break;
+		case 5:
+			zc_calc_ssim_3d_file(fd1, fd2, ZC_DOUBLE, r5*r4*r3, r2, r1, &(compareResult->ssimImage2D_min), &(compareResult->ssimImage2D_avg), &(compareResult->ssimImage2D_max));
+			break;
+		default:
+			compareResult->ssimImage2D_min = 0; 
+			compareResult->ssimImage2D_avg = -1;
+			compareResult->ssimImage2D_max = -2;
+		}
 	}
-
-	if (valErrCorrFlag)
+	
+	if(SSIMVOLUME3DFlag && dim >= 3)
 	{
-		double prodSum = 0, sum1 = 0, sumDiff = 0;
-    	for (i = 0; i < numOfElem; i++)
-    	{
-    		prodSum += (data1[i]-global_mean1)*(diff[i]-global_avgDiff);
-    		sum1 += (data1[i]-global_mean1)*(data1[i]-global_mean1);
-    		sumDiff += (diff[i]-global_avgDiff)*(diff[i]-global_avgDiff);
-    	}
+		size_t nbVolumes = dim==3 ? 1 : (dim==4 ? r4 : r5*r4);
+		compareResult->ssimVolume3D = zc_calc_ssim_volume_file(fd1, fd2, ZC_DOUBLE, nbVolumes, r3, r2, r1, compareResult->property->valueRange);
+		compareResult->ssimVolume3DComputed = 1;
+	}
+}
 
-		p_localBuffer[0] = prodSum;
-		p_localBuffer[1] = sum1;
-		p_localBuffer[2] = sumDiff;
-		
-		MPI_Reduce(p_localBuffer, p_globalBuffer, 3, MPI_DOUBLE, MPI_SUM, 0, ZC_COMM_WORLD);
-		
-		if(myRank==0)
-		{
-			double global_std1, global_ee, global_stdDiff, global_valErrCorr = 0;				
-			global_std1 = sqrt(p_globalBuffer[1]/globalDataLength);
-			global_stdDiff = sqrt(p_globalBuffer[2]/globalDataLength);
-			global_ee = p_globalBuffer[0]/globalDataLength;
+#ifdef HAVE_MPI
 
-			if (global_std1*global_stdDiff != 0)
-				global_valErrCorr = global_ee/global_std1/global_stdDiff;
+/**
+ * The comparison of the data of all the ranks (collective), in two reductions: one MPI_Allreduce 
+ * of the statistics of the first pass (ZC_reduceOnlineStat_online()), together with the basic 
+ * properties of data1 if they are still pending (see ZC_compareData()), then one MPI_Reduce 
+ * to rank 0 of the error distributions and of the lag sums of the errors, whose results 
+ * are only kept on rank 0.
+ * */
+void ZC_compareData_double_online(ZC_CompareData* compareResult, double* data1, double* data2, 
+size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
+{
+	size_t numOfElem = ZC_computeDataLength(r5, r4, r3, r2, r1);
+	int dim = ZC_computeDimension(r5, r4, r3, r2, r1);
+	ZC_DataProperty* property = compareResult->property;
+	ZC_OnlineStat stat;
 
-			compareResult->valErrCorr = global_valErrCorr;			
+	ZC_resolveMetricPlan(&metricPlan);
+	ZC_initOnlineStat(&stat, ZC_REDUCE_COMPARE);
+	if(property->pendingMask & ZC_PROP_BASIC)
+	{
+		stat.mask |= ZC_REDUCE_PROPERTY;
+		ZC_computePropertyStat_double(&stat.property, data1, numOfElem);
+	}
+	ZC_computeCompareStatMask_double(&stat.compare, data1, data2, numOfElem, metricPlan.statMask);
+	ZC_reduceOnlineStat_online(&stat);
+	if(stat.mask & ZC_REDUCE_PROPERTY)
+		ZC_applyPropertyStat(property, &stat.property);
+	globalDataLength = stat.compare.n;
+	ZC_applyCompareStat(compareResult, &stat.compare);
+	
+	//the second pass: the counts of the error distributions and the lag sums of the errors
+	int nbAbs = 0, nbRel = 0, nbSums;
+	double *absCounts = NULL, *relCounts = NULL, *sums;
+	if(metricPlan.errPDF)
+		ZC_allocErrPDFCounts(&stat.compare, &absCounts, &relCounts);
+	if(absCounts!=NULL)
+		nbAbs = PDF_INTERVALS;
+	if(relCounts!=NULL)
+		nbRel = PDF_INTERVALS_REL;
+	nbSums = nbAbs + nbRel + (errAutoCorrFlag ? AUTOCORR_SIZE+1 : 0);
+	sums = (double*)malloc(sizeof(double)*(nbSums+1));
+	if(nbAbs + nbRel > 0)
+	{
+		ZC_countErrPDF_double(&stat.compare, data1, data2, numOfElem, absCounts, relCounts);
+		if(absCounts!=NULL)
+			memcpy(sums, absCounts, sizeof(double)*nbAbs);
+		if(relCounts!=NULL)
+			memcpy(sums+nbAbs, relCounts, sizeof(double)*nbRel);
+	}
+	if(errAutoCorrFlag)
+		ZC_computeErrLagSums_double(data1, data2, numOfElem, stat.compare.meanDiff, sums+nbAbs+nbRel);
+	if(nbSums > 0)
+		MPI_Reduce(myRank==0 ? MPI_IN_PLACE : sums, sums, nbSums, MPI_DOUBLE, MPI_SUM, 0, ZC_COMM_WORLD);
+	
+	if(myRank==0)
+	{
+		if(absCounts!=NULL)
+			memcpy(absCounts, sums, sizeof(double)*nbAbs);
+		if(relCounts!=NULL)
+			memcpy(relCounts, sums+nbAbs, sizeof(double)*nbRel);
+		if(metricPlan.errPDF)
+			ZC_finalizeErrPDF(compareResult, &stat.compare, absCounts, relCounts);
+	}
+	else
+	{
+		free(absCounts);
+		free(relCounts);
+	}
+	
+	if (errAutoCorrFlag && myRank==0)
+	{
+		//each rank contributes the lagged products within its own part of the data
+		double *autoCorrAbsErr = (double*)malloc((AUTOCORR_SIZE+1)*sizeof(double));
+		double *lagSums = sums+nbAbs+nbRel;
+		double varDiff = stat.compare.m2_diff/globalDataLength;
+		int delta;
+		if (varDiff == 0)
+		{
+			for (delta = 1; delta <= AUTOCORR_SIZE; delta++)
+				autoCorrAbsErr[delta] = 1;
+		}
+		else
+		{
+			for (delta = 1; delta <= AUTOCORR_SIZE; delta++)
+				autoCorrAbsErr[delta] = lagSums[delta]/(globalDataLength-nbProc*delta)/varDiff;
 		}
+		autoCorrAbsErr[0] = 1;
+		compareResult->autoCorrAbsErr = autoCorrAbsErr;
+	}
+	free(sums);
+
+	if (errQuantilesFlag)
+	{
+		compareResult->absErrSketch = ZC_createQuantileSketch();
+		compareResult->pwrErrSketch = ZC_createQuantileSketch();
+		ZC_addErrSketches_double(compareResult->absErrSketch, compareResult->pwrErrSketch, data1, data2, numOfElem);
+		ZC_reduceQuantileSketch_online(compareResult->absErrSketch);
+		ZC_reduceQuantileSketch_online(compareResult->pwrErrSketch);
 	}
 
 #ifdef HAVE_R
@@ -807,6 +1335,9 @@ size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
 	{
 		switch(dim)
 		{
+		case 1:
+			compareResult->ssimImage2D_avg = zc_calc_ssim_1d_double_online(data1, data2, r1);
+			break;
 		case 2:
 			compareResult->ssimImage2D_avg = zc_calc_ssim_2d_double_online(data1, data2, r2, r1);	
 			break;
@@ -819,15 +1350,19 @@ size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
 		case 5:
 			zc_calc_ssim_3d_double_online(data1, data2, r5*r4*r3, r2, r1, &(compareResult->ssimImage2D_min), &(compareResult->ssimImage2D_avg), &(compareResult->ssimImage2D_max));
 			break;
-		default: //1D data is meaningless here
+		default:
 			compareResult->ssimImage2D_min = 0; 
 			compareResult->ssimImage2D_avg = -1;
 			compareResult->ssimImage2D_max = -2;
 		}
 	}
-
-	free(diff);
-	free(relDiff);	
+	
+	if(SSIMVOLUME3DFlag && dim >= 3)
+	{
+		size_t nbVolumes = dim==3 ? 1 : (dim==4 ? r4 : r5*r4);
+		compareResult->ssimVolume3D = zc_calc_ssim_volume_double_online(data1, data2, nbVolumes, r3, r2, r1, property->valueRange);
+		compareResult->ssimVolume3DComputed = 1;
+	}
 }
 
 #endif
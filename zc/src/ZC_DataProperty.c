@@ -3,51 +3,318 @@
 #include <assert.h>
 #include <sys/stat.h>
 #include "ZC_DataProperty.h"
+#include "ZC_autocorr.h"
 #include "zc.h"
 #include "iniparser.h"
 
 /* For entropy calculation */
-void hash_init(HashEntry *table, size_t table_size)
+void hash_init(HashTable *table, size_t capacity)
 {
-	size_t i;
-	for (i = 0; i < table_size; i++)
-		table[i].flag = 0;
+	table->size = 16;
+	table->shift = 60;
+	while(table->size < 2*capacity)
+	{
+		table->size *= 2;
+		table->shift--;
+	}
+	table->count = 0;
+	table->entries = (HashEntry*)calloc(table->size, sizeof(HashEntry));
 }
 
-size_t hash_get(HashEntry *table, unsigned long key, size_t table_size)
+/*Fibonacci hashing: the high bits of key*2^64/phi, so that consecutive keys are spread*/
+static inline size_t hash_index(HashTable *table, unsigned long key)
 {
-      int hash = (key % table_size);
-      while (table[hash].flag != 0 && table[hash].key != key)
-            hash = (hash + 1) % table_size;
-      if (table[hash].flag == 0)
-            return -1;
-      else
-            return table[hash].num;
+	return (size_t)(((uint64_t)key*11400714819323198485ULL) >> table->shift);
 }
 
-void hash_put(HashEntry *table, unsigned long key, size_t table_size)
+long hash_get(HashTable *table, unsigned long key)
 {
-	size_t hash = (key % table_size);
-	size_t i = 0;
-	for (i=0;table[hash].flag != 0 && table[hash].key != key && i<table_size;i++)
-		hash = (hash + 1) % table_size;
-		
-	if(i==table_size)
+	size_t mask = table->size - 1, hash = hash_index(table, key);
+	while (table->entries[hash].num != 0 && table->entries[hash].key != key)
+		hash = (hash + 1) & mask;
+	return table->entries[hash].num;
+}
+
+static void hash_grow(HashTable *table)
+{
+	size_t i, oldSize = table->size;
+	HashEntry* old = table->entries;
+	table->size *= 2;
+	table->shift--;
+	table->entries = (HashEntry*)calloc(table->size, sizeof(HashEntry));
+	if(table->entries==NULL)
 	{
-		printf("Error: hash table_size is not long enough!\n");
+		printf("Error: not enough memory for the hash table (%zu entries)\n", table->size);
 		exit(0);
-	}	
-		
-	if (table[hash].flag != 0)
-	table[hash].num++;
+	}
+	table->count = 0;
+	for(i=0;i<oldSize;i++)
+		if(old[i].num != 0)
+			hash_put(table, old[i].key, old[i].num);
+	free(old);
+}
+
+/*add num to the count of key*/
+void hash_put(HashTable *table, unsigned long key, long num)
+{
+	size_t mask = table->size - 1, hash = hash_index(table, key);
+	while (table->entries[hash].num != 0 && table->entries[hash].key != key)
+		hash = (hash + 1) & mask;
+	if (table->entries[hash].num == 0)
+	{
+		table->entries[hash].key = key;
+		table->count++;
+	}
+	table->entries[hash].num += num;
+	if(2*table->count > table->size)
+		hash_grow(table);
+}
+
+void hash_free(HashTable *table)
+{
+	free(table->entries);
+	table->entries = NULL;
+	table->size = 0;
+	table->count = 0;
+}
+
+/**
+ * Byte histogram of bytes[0..n): the count of the byte value b is the sum of
+ * tables[k*256+b], k=0..ZC_BYTE_SUBTABLES-1.
+ * */
+void ZC_countBytes(const unsigned char* bytes, size_t n, long* tables)
+{
+	size_t i;
+	long* t0 = tables;
+	long* t1 = tables + 256;
+	long* t2 = tables + 512;
+	long* t3 = tables + 768;
+	for(i=0;i+4<=n;i+=4)
+	{
+		t0[bytes[i]]++;
+		t1[bytes[i+1]]++;
+		t2[bytes[i+2]]++;
+		t3[bytes[i+3]]++;
+	}
+	for(;i<n;i++)
+		t0[bytes[i]]++;
+}
+
+/**
+ * The values are quantized as (value-min)/(2*errBound) rounded to the nearest integer,
+ * i.e., the keys of a quantizer with the absolute error bound errBound.
+ * */
+void ZC_initQuantCounts(ZC_QuantCounts* counts, double min, double valueRange, double errBound)
+{
+	if(errBound <= 0)
+	{
+		printf("Error: the error bound of the quantized entropy must be positive (errBound=%G)\n", errBound);
+		exit(0);
+	}
+	counts->min = min;
+	counts->scale = 1/(2*errBound);
+	if(valueRange*counts->scale > ZC_QUANT_MAX_KEYS)
+	{
+		printf("Error: the error bound of the quantized entropy is too small for the value range (errBound=%G, valueRange=%G)\n", 
+		errBound, valueRange);
+		exit(0);
+	}
+	counts->nbBins = (size_t)(valueRange*counts->scale+0.5)+1;
+	ZC_initEmptyQuantCounts(counts, counts);
+}
+
+/*empty counts with the same quantization as model (e.g., one per thread)*/
+void ZC_initEmptyQuantCounts(ZC_QuantCounts* counts, ZC_QuantCounts* model)
+{
+	counts->min = model->min;
+	counts->scale = model->scale;
+	counts->nbBins = model->nbBins;
+	memset(&counts->table, 0, sizeof(HashTable));
+	if(counts->nbBins <= ZC_QUANT_DIRECT_BINS)
+		counts->bins = (long*)calloc(counts->nbBins, sizeof(long));
 	else
 	{
-	table[hash].flag = 1;
-	table[hash].key = key;
-	table[hash].num = 1;
+		counts->bins = NULL;
+		hash_init(&counts->table, 4096);
 	}
 }
 
+void ZC_mergeQuantCounts(ZC_QuantCounts* a, ZC_QuantCounts* b)
+{
+	size_t i;
+	if(a->bins!=NULL)
+	{
+		for(i=0;i<a->nbBins;i++)
+			a->bins[i] += b->bins[i];
+	}
+	else
+	{
+		for(i=0;i<b->table.size;i++)
+			if(b->table.entries[i].num != 0)
+				hash_put(&a->table, b->table.entries[i].key, b->table.entries[i].num);
+	}
+}
+
+static int ZC_compareHashEntries(const void* a, const void* b)
+{
+	unsigned long ka = ((HashEntry*)a)->key, kb = ((HashEntry*)b)->key;
+	return ka < kb ? -1 : (ka > kb ? 1 : 0);
+}
+
+/*Shannon entropy (in bits) of the quantized values, summed in the order of the keys*/
+double ZC_computeQuantEntropy(ZC_QuantCounts* counts, double total)
+{
+	size_t i, m = 0;
+	double entVal = 0;
+	if(counts->bins!=NULL)
+	{
+		for(i=0;i<counts->nbBins;i++)
+			if(counts->bins[i] != 0)
+			{
+				double prob = counts->bins[i]/total;
+				entVal -= prob*log(prob)/log(2);
+			}
+		return entVal;
+	}
+	//the layout of the table depends on the order of the insertions
+	HashEntry* entries = (HashEntry*)malloc(sizeof(HashEntry)*(counts->table.count+1));
+	for(i=0;i<counts->table.size;i++)
+		if(counts->table.entries[i].num != 0)
+			entries[m++] = counts->table.entries[i];
+	qsort(entries, m, sizeof(HashEntry), ZC_compareHashEntries);
+	for(i=0;i<m;i++)
+	{
+		double prob = entries[i].num/total;
+		entVal -= prob*log(prob)/log(2);
+	}
+	free(entries);
+	return entVal;
+}
+
+void ZC_freeQuantCounts(ZC_QuantCounts* counts)
+{
+	free(counts->bins);
+	counts->bins = NULL;
+	hash_free(&counts->table);
+}
+
+void ZC_initPropertyStat(ZC_PropertyStat* stat)
+{
+	memset(stat, 0, sizeof(ZC_PropertyStat));
+	stat->min = 1E100;
+	stat->max = -1E100;
+}
+
+/*merge the statistics of another set of values into stat (pairwise update of the mean and m2)*/
+void ZC_mergePropertyStat(ZC_PropertyStat* stat, ZC_PropertyStat* other)
+{
+	if(other->n == 0)
+		return;
+	if(stat->n == 0)
+	{
+		*stat = *other;
+		return;
+	}
+	
+	double na = stat->n, nb = other->n;
+	double n = na + nb;
+	double d = other->mean - stat->mean;
+	stat->mean += d*nb/n;
+	stat->m2 += other->m2 + d*d*na*nb/n;
+	stat->n += other->n;
+	if(stat->min > other->min) stat->min = other->min;
+	if(stat->max < other->max) stat->max = other->max;
+}
+
+/**
+ * Fill in the basic properties (ZC_PROP_BASIC) from the statistics of all the values; 
+ * m2 is also kept as sumSqrDev. zeromean_variance is the mean squared deviation from the 
+ * middle of the value range, i.e., (m2 + n*(mean-med)^2)/n.
+ * */
+void ZC_applyPropertyStat(ZC_DataProperty* property, ZC_PropertyStat* stat)
+{
+	double med = stat->min + (stat->max - stat->min)/2;
+	double d = stat->mean - med;
+	property->numOfElem = stat->n;
+	property->minValue = stat->min;
+	property->maxValue = stat->max;
+	property->valueRange = stat->max - stat->min;
+	property->avgValue = stat->mean;
+	property->zeromean_variance = (stat->m2 + stat->n*d*d)/stat->n;
+	property->sumSqrDev = stat->m2;
+	property->sumSqrDevReady = 1;
+	property->pendingMask &= ~ZC_PROP_BASIC;
+}
+
+#ifdef HAVE_MPI
+/**
+ * Merge the counts of the ranks: a reduction of the direct bins (the same on all the ranks,
+ * min and valueRange being global), or a gather of the (key, count) pairs of the hash tables
+ * to rank 0. Returns the entropy on rank 0 (0 on the other ranks).
+ * */
+double ZC_reduceQuantEntropy_online(ZC_QuantCounts* counts, double total)
+{
+	size_t i;
+	int r;
+	double entVal = 0;
+	if(counts->bins!=NULL)
+	{
+		long* gbins = myRank==0 ? (long*)malloc(sizeof(long)*counts->nbBins) : NULL;
+		MPI_Reduce(counts->bins, gbins, counts->nbBins, MPI_LONG, MPI_SUM, 0, ZC_COMM_WORLD);
+		if(myRank==0)
+		{
+			free(counts->bins);
+			counts->bins = gbins;
+			entVal = ZC_computeQuantEntropy(counts, total);
+		}
+		return entVal;
+	}
+
+	int m = 0;
+	long* pairs = (long*)malloc(sizeof(long)*2*(counts->table.count+1));
+	for(i=0;i<counts->table.size;i++)
+		if(counts->table.entries[i].num != 0)
+		{
+			pairs[2*m] = (long)counts->table.entries[i].key;
+			pairs[2*m+1] = counts->table.entries[i].num;
+			m++;
+		}
+	int* sizes = NULL, *displs = NULL;
+	long* gpairs = NULL;
+	if(myRank==0)
+	{
+		sizes = (int*)malloc(sizeof(int)*nbProc);
+		displs = (int*)malloc(sizeof(int)*nbProc);
+	}
+	m *= 2;
+	MPI_Gather(&m, 1, MPI_INT, sizes, 1, MPI_INT, 0, ZC_COMM_WORLD);
+	if(myRank==0)
+	{
+		size_t totalSize = 0;
+		for(r=0;r<nbProc;r++)
+		{
+			displs[r] = totalSize;
+			totalSize += sizes[r];
+		}
+		gpairs = (long*)malloc(sizeof(long)*(totalSize+1));
+	}
+	MPI_Gatherv(pairs, m, MPI_LONG, gpairs, sizes, displs, MPI_LONG, 0, ZC_COMM_WORLD);
+	if(myRank==0)
+	{
+		//rank 0 adds the counts of the other ranks to its own table
+		for(r=1;r<nbProc;r++)
+			for(i=0;i<(size_t)sizes[r];i+=2)
+				hash_put(&counts->table, (unsigned long)gpairs[displs[r]+i], gpairs[displs[r]+i+1]);
+		entVal = ZC_computeQuantEntropy(counts, total);
+		free(sizes);
+		free(displs);
+		free(gpairs);
+	}
+	free(pairs);
+	return entVal;
+}
+#endif
+
 int ZC_computeDimension(size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
 {
 	if(r1==0)
@@ -88,118 +355,45 @@ void ZC_constructDimString(size_t r5, size_t r4, size_t r3, size_t r2, size_t r1
 	}
 }
 
-/* For FFT and iFFT calculation */
+/* For FFT and iFFT calculation (tmp: n points of scratch, used as the split arrays of ZC_fftComplex()) */
 void fft(complex *v, size_t n, complex *tmp)
 {
-	if(n>1) {			/* otherwise, do nothing and return */
-		size_t k,m;
-		complex z, w, *vo, *ve;
-		ve = tmp;
-		vo = tmp+n/2;
-		for(k=0; k<n/2; k++) {
-			ve[k] = v[2*k];
-			vo[k] = v[2*k+1];
-		}
-		fft(ve, n/2, v);		/* FFT on even-indexed elements of v[] */
-		fft(vo, n/2, v);		/* FFT on odd-indexed elements of v[] */
-		for(m = 0; m < n/2; m++) {
-			w.Re = cos(2*PI*m/(double)n);
-			w.Im = -sin(2*PI*m/(double)n);
-			z.Re = w.Re*vo[m].Re - w.Im*vo[m].Im;	/* Re(w*vo[m]) */
-			z.Im = w.Re*vo[m].Im + w.Im*vo[m].Re;	/* Im(w*vo[m]) */
-			v[m].Re = ve[m].Re + z.Re;
-			v[m].Im = ve[m].Im + z.Im;
-			v[m+n/2].Re = ve[m].Re - z.Re;
-			v[m+n/2].Im = ve[m].Im - z.Im;
-		}
+	size_t i;
+	double *re = (double*)tmp, *im = re + n;
+	for(i = 0; i < n; i++)
+	{
+		re[i] = v[i].Re;
+		im[i] = v[i].Im;
+	}
+	ZC_fftComplex(re, im, n);
+	for(i = 0; i < n; i++)
+	{
+		v[i].Re = re[i];
+		v[i].Im = im[i];
 	}
-	return;
 }
 
+/*the inverse transform (not normalized): ifft(v) = conj(fft(conj(v)))*/
 void ifft(complex *v, size_t n, complex *tmp)
 {
-	if(n>1) {			/* otherwise, do nothing and return */
-		size_t k,m;
-		complex z, w, *vo, *ve;
-		ve = tmp;
-		vo = tmp+n/2;
-		for(k = 0; k < n/2; k++) {
-			ve[k] = v[2*k];
-			vo[k] = v[2*k+1];
-		}
-		ifft(ve, n/2, v);		/* FFT on even-indexed elements of v[] */
-		ifft(vo, n/2, v);		/* FFT on odd-indexed elements of v[] */
-		for(m = 0; m < n/2; m++) {
-			w.Re = cos(2*PI*m/(double)n);
-			w.Im = sin(2*PI*m/(double)n);
-			z.Re = w.Re*vo[m].Re - w.Im*vo[m].Im;	/* Re(w*vo[m]) */
-			z.Im = w.Re*vo[m].Im + w.Im*vo[m].Re;	/* Im(w*vo[m]) */
-			v[m].Re = ve[m].Re + z.Re;
-			v[m].Im = ve[m].Im + z.Im;
-			v[m+n/2].Re = ve[m].Re - z.Re;
-			v[m+n/2].Im = ve[m].Im - z.Im;
-		}
+	size_t i;
+	double *re = (double*)tmp, *im = re + n;
+	for(i = 0; i < n; i++)
+	{
+		re[i] = v[i].Re;
+		im[i] = -v[i].Im;
+	}
+	ZC_fftComplex(re, im, n);
+	for(i = 0; i < n; i++)
+	{
+		v[i].Re = re[i];
+		v[i].Im = -im[i];
 	}
-	return;
 }
 
 void computeLap(double *data, double *lap, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
 {
-	if (r2 == 0)		// compute Laplacian of 1D data
-	{
-		size_t x, y;
-			for (x = 0; x < r1; x++) {
-				unsigned long i = max(1u, min(x, r1 - 2));
-				double fxx = 1 * data[(i - 1)] - 2 * data[(i + 0)] + 1 * data[(i + 1)];
-				double ddf = fxx;
-				lap[x] = ddf;
-			}
-	}
-	else if (r3 ==0)	// computer Laplacian of 2D data
-	{
-		size_t x, y;
-		for (y = 0; y < r2; y++) {
-			unsigned long j = max(1u, min(y, r2 - 2));
-			for (x = 0; x < r1; x++) {
-				unsigned long i = max(1u, min(x, r1 - 2));
-				double fxx = +1 * data[(i - 1) + r1 * (j + 0)]
-						-2 * data[(i + 0) + r1 * (j + 0)]
-								+1 * data[(i + 1) + r1 * (j + 0)];
-				double fyy = +1 * data[(i + 0) + r1 * (j - 1)]
-						-2 * data[(i + 0) + r1 * (j + 0)]
-								+1 * data[(i + 0) + r1 * (j + 1)];
-				double ddf = fxx + fyy;
-				lap[x + y * r1] = ddf;
-			}
-		}
-	}
-	else if (r4 == 0)	/*computer Laplacian of 3D data*/
-	{
-		size_t x, y, z;
-		for (z = 0; z < r3; z++) {
-			unsigned long k = max(1u, min(z, r3 - 2));
-			for (y = 0; y < r2; y++) {
-				unsigned long j = max(1u, min(y, r2 - 2));
-				for (x = 0; x < r1; x++) {
-					unsigned long i = max(1u, min(x, r1 - 2));
-					double fxx = +1 * data[(i - 1) + r1 * ((j + 0) + r2 * (k + 0))]
-											   -2 * data[(i + 0) + r1 * ((j + 0) + r2 * (k + 0))]
-															 +1 * data[(i + 1) + r1 * ((j + 0) + r2 * (k + 0))];
-					double fyy = +1 * data[(i + 0) + r1 * ((j - 1) + r2 * (k + 0))]
-											   -2 * data[(i + 0) + r1 * ((j + 0) + r2 * (k + 0))]
-															 +1 * data[(i + 0) + r1 * ((j + 1) + r2 * (k + 0))];
-					double fzz = +1 * data[(i + 0) + r1 * ((j + 0) + r2 * (k - 1))]
-											   -2 * data[(i + 0) + r1 * ((j + 0) + r2 * (k + 0))]
-															 +1 * data[(i + 0) + r1 * ((j + 0) + r2 * (k + 1))];
-					double ddf = fxx + fyy + fzz;
-					lap[x + y * r1 + z * r1 * r2] = ddf;
-				}
-			}
-		}
-	}
-	/* TODO: computer Laplacian of 4D and 5D data*/
-
-	return;
+	ZC_computeLaplacian_double(data, lap, r5, r4, r3, r2, r1);
 }
 
 void freeDataProperty_internal(ZC_DataProperty* dataProperty)
@@ -214,6 +408,7 @@ void freeDataProperty_internal(ZC_DataProperty* dataProperty)
 		free(dataProperty->fftCoeff);
 	if(dataProperty->lap!=NULL)
 		free(dataProperty->lap);
+	ZC_freeQuantileSketch(dataProperty->valueSketch);
 	free(dataProperty);
 }
 
@@ -261,50 +456,244 @@ double entropy, double* autocorr, complex* fftCoeff)
 	this->entropy = entropy;
 	this->autocorr = autocorr;
 	this->fftCoeff = fftCoeff;
+	this->valueSketch = NULL;
+	this->sumSqrDevReady = 0;
+	this->pendingMask = 0;
 	return this;
 }
 
+/**
+ * Property of the data whose values are not computed yet: each ZC_PROP_* property is computed 
+ * from data when it is first read by its accessor (ZC_getEntropy(), ...) or required by 
+ * ZC_requireProperties(), and then kept. The data are borrowed, not copied: the buffer must 
+ * stay alive (and unchanged) as long as the property is used, or be given up before it is 
+ * freed by ZC_releasePropertyData().
+ * */
+ZC_DataProperty* ZC_createDataProperty(char* varName, int dataType, void* data, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
+{
+	if(dataType!=ZC_FLOAT && dataType!=ZC_DOUBLE)
+	{
+		printf("Error: Wrong data type!\n");
+		exit(0);
+	}
+	ZC_DataProperty* property = (ZC_DataProperty*)malloc(sizeof(ZC_DataProperty));
+	memset(property, 0, sizeof(ZC_DataProperty));
+	char* varN = rmFileExtension(varName);
+	property->varName = (char*)malloc(strlen(varN)+1);
+	strcpy(property->varName, varN);
+	free(varN);
+	property->dataType = dataType;
+	property->data = data;
+	property->r5 = r5;
+	property->r4 = r4;
+	property->r3 = r3;
+	property->r2 = r2;
+	property->r1 = r1;
+	property->numOfElem = ZC_computeDataLength(r5, r4, r3, r2, r1);
+	property->pendingMask = ZC_PROP_ALL;
+	return property;
+}
+
+/*the properties enabled in the configuration (the basic ones are always computed)*/
+int ZC_getFlaggedProperties()
+{
+	int mask = ZC_PROP_BASIC;
+	if(entropyFlag) mask |= ZC_PROP_ENTROPY;
+	if(quantEntropyFlag) mask |= ZC_PROP_QUANT_ENTROPY;
+	if(valueQuantilesFlag) mask |= ZC_PROP_QUANTILES;
+	if(autocorrFlag) mask |= ZC_PROP_AUTOCORR;
+#ifdef HAVE_FFTW3
+	if(autocorr3DFlag) mask |= ZC_PROP_AUTOCORR3D;
+#endif
+	if(fftFlag) mask |= ZC_PROP_FFT;
+	if(lapFlag) mask |= ZC_PROP_LAP;
+	return mask;
+}
+
+/*properties needed to compute each ZC_PROP_* property (in the order of the bits)*/
+static const int ZC_propertyDependencies[ZC_PROP_COUNT] = {0, 0, ZC_PROP_BASIC, 0, ZC_PROP_BASIC, 0, 0, 0};
+
+/**
+ * Compute the properties of mask (ZC_PROP_* bits) that are still pending, after their 
+ * dependencies; each property is computed at most once. Nothing is computed if the 
+ * property does not hold its data any more (data == NULL).
+ * */
+void ZC_requireProperties(ZC_DataProperty* property, int mask)
+{
+	int k;
+	if(property->data==NULL)
+		return;
+	for(k=0;k<ZC_PROP_COUNT;k++)
+	{
+		int id = 1<<k;
+		if((mask & id)==0 || (property->pendingMask & id)==0)
+			continue;
+		ZC_requireProperties(property, ZC_propertyDependencies[k]);
+		if(property->dataType==ZC_FLOAT)
+			ZC_computeProperty_float(property, id);
+		else
+			ZC_computeProperty_double(property, id);
+		property->pendingMask &= ~id;
+	}
+}
+
+/**
+ * Compute the properties enabled in the configuration that are still pending, and then 
+ * stop borrowing the data (data = NULL): the other pending properties are dropped, so 
+ * that the caller can free the data buffer while keeping the property.
+ * */
+void ZC_releasePropertyData(ZC_DataProperty* property)
+{
+	ZC_requireProperties(property, ZC_getFlaggedProperties());
+	property->pendingMask = 0;
+	property->data = NULL;
+}
+
+double ZC_getMinValue(ZC_DataProperty* property)
+{
+	ZC_requireProperties(property, ZC_PROP_BASIC);
+	return property->minValue;
+}
+
+double ZC_getMaxValue(ZC_DataProperty* property)
+{
+	ZC_requireProperties(property, ZC_PROP_BASIC);
+	return property->maxValue;
+}
+
+double ZC_getValueRange(ZC_DataProperty* property)
+{
+	ZC_requireProperties(property, ZC_PROP_BASIC);
+	return property->valueRange;
+}
+
+double ZC_getAvgValue(ZC_DataProperty* property)
+{
+	ZC_requireProperties(property, ZC_PROP_BASIC);
+	return property->avgValue;
+}
+
+double ZC_getZeromeanVariance(ZC_DataProperty* property)
+{
+	ZC_requireProperties(property, ZC_PROP_BASIC);
+	return property->zeromean_variance;
+}
+
+double ZC_getEntropy(ZC_DataProperty* property)
+{
+	ZC_requireProperties(property, ZC_PROP_ENTROPY);
+	return property->entropy;
+}
+
+double ZC_getQuantEntropy(ZC_DataProperty* property)
+{
+	ZC_requireProperties(property, ZC_PROP_QUANT_ENTROPY);
+	return property->quantEntropy;
+}
+
+ZC_QuantileSketch* ZC_getValueSketch(ZC_DataProperty* property)
+{
+	ZC_requireProperties(property, ZC_PROP_QUANTILES);
+	return property->valueSketch;
+}
+
+double* ZC_getAutocorr(ZC_DataProperty* property)
+{
+	ZC_requireProperties(property, ZC_PROP_AUTOCORR);
+	return property->autocorr;
+}
+
+/*NULL without FFTW3*/
+void* ZC_getAutocorr3D(ZC_DataProperty* property)
+{
+	ZC_requireProperties(property, ZC_PROP_AUTOCORR3D);
+	return property->autocorr3D;
+}
+
+double* ZC_getLaplacian(ZC_DataProperty* property)
+{
+	ZC_requireProperties(property, ZC_PROP_LAP);
+	return property->lap;
+}
+
+/**
+ * The n fft coefficients of the first n values of data (n being a power of two), with their 
+ * amplitudes: the real-input transform gives the first n/2+1 ones, the others are their conjugates.
+ * */
 complex* ZC_computeFFT(void* data, size_t n, int dataType)
 {
-	size_t i;
+	size_t i, half = n/2;
+	if(dataType!=ZC_FLOAT && dataType!=ZC_DOUBLE)
+	{
+		printf("Error: Wrong data type!\n");
+		exit(0);
+	}
 	complex *fftCoeff = (complex*)malloc(n*sizeof(complex));
-    complex *scratch  = (complex*)malloc(n*sizeof(complex));
-
-	if(dataType==ZC_FLOAT)
+	double *re = (double*)malloc((half+1)*sizeof(double));
+	double *im = (double*)malloc((half+1)*sizeof(double));
+	ZC_fftReal(data, dataType, n, re, im);
+	for (i = 0; i <= half && i < n; i++)
 	{
-		float* data_ = (float*)data;
-		for (i = 0; i < n; i++)
-		{
-			fftCoeff[i].Re = data_[i];
-			fftCoeff[i].Im = 0;
-		}		
+		fftCoeff[i].Re = re[i];
+		fftCoeff[i].Im = im[i];
+		fftCoeff[i].Amp = sqrt(re[i]*re[i] + im[i]*im[i]);
 	}
-	else if(dataType==ZC_DOUBLE)
+	for (; i < n; i++)
 	{
-		double* data_ = (double*)data;
-		for (i = 0; i < n; i++)
-		{
-			fftCoeff[i].Re = data_[i];
-			fftCoeff[i].Im = 0;
-		}
+		fftCoeff[i].Re = fftCoeff[n-i].Re;
+		fftCoeff[i].Im = -fftCoeff[n-i].Im;
+		fftCoeff[i].Amp = fftCoeff[n-i].Amp;
 	}
-	else
+	free(re);
+	free(im);
+	return fftCoeff;
+}
+
+/*number of fft coefficients kept for numOfElem values: the whole spectrum (FULL fftMode) or the reported ones*/
+size_t ZC_getFFTCoeffCount(size_t numOfElem)
+{
+	size_t fft_size = pow(2, (int)log2(numOfElem));
+	return fftMode==ZC_FFT_FULL ? fft_size : FFT_SIZE;
+}
+
+/**
+ * The fft coefficients of the largest power-of-two prefix of the data: all of them in the 
+ * FULL fftMode, otherwise only the FFT_SIZE ones that are reported, by the pruned transform.
+ * */
+complex* ZC_computeFFTCoeff(void* data, size_t numOfElem, int dataType)
+{
+	size_t i, fft_size = pow(2, (int)log2(numOfElem));
+	if(fftMode==ZC_FFT_FULL)
+		return ZC_computeFFT(data, fft_size, dataType);
+	if(dataType!=ZC_FLOAT && dataType!=ZC_DOUBLE)
 	{
 		printf("Error: Wrong data type!\n");
 		exit(0);
 	}
-
-	fft(fftCoeff, n, scratch);
-    for (i = 0; i < n; i++)
-    {
-        fftCoeff[i].Amp = sqrt(fftCoeff[i].Re*fftCoeff[i].Re + fftCoeff[i].Im*fftCoeff[i].Im);
-    }
-    
-    free(scratch);
-    
+	double re[FFT_SIZE], im[FFT_SIZE];
+	complex *fftCoeff = (complex*)malloc(FFT_SIZE*sizeof(complex));
+	ZC_fftRealLowBins(data, dataType, fft_size, FFT_SIZE, re, im);
+	for (i = 0; i < FFT_SIZE; i++)
+	{
+		fftCoeff[i].Re = re[i];
+		fftCoeff[i].Im = im[i];
+		fftCoeff[i].Amp = sqrt(re[i]*re[i] + im[i]*im[i]);
+	}
 	return fftCoeff;
 }
 
+/**
+ * The fft coefficients of the original data (ZC_computeFFTCoeff()), 
+ * computed on first use and kept in the property for the following comparisons.
+ * */
+complex* ZC_getFFTCoeff(ZC_DataProperty* property)
+{
+	ZC_requireProperties(property, ZC_PROP_FFT);
+	if(property->fftCoeff==NULL) //property not made by ZC_createDataProperty()
+		property->fftCoeff = ZC_computeFFTCoeff(property->data, property->numOfElem, property->dataType);
+	return property->fftCoeff;
+}
+
 ZC_DataProperty* ZC_genProperties(char* varName, int dataType, void *oriData, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
 {
 	char* varN = varName;//rmFileExtension(varName);
@@ -394,12 +783,20 @@ int ZC_moveDataProperty(ZC_DataProperty* target, ZC_DataProperty* source)
 	target->valueRange = source->valueRange;
 	target->avgValue = source->avgValue;
 	target->entropy = source->entropy;
+	target->quantEntropy = source->quantEntropy;
 	target->zeromean_variance = source->zeromean_variance;
+	target->sumSqrDevReady = source->sumSqrDevReady;
+	target->sumSqrDev = source->sumSqrDev;
 	if(target->autocorr==NULL && source->autocorr!=NULL)
 	{
 		target->autocorr = (double*)malloc((AUTOCORR_SIZE+1)*sizeof(double));
 		memcpy(target->autocorr, source->autocorr, (AUTOCORR_SIZE+1)*sizeof(double));
 	}
+	if(target->valueSketch==NULL && source->valueSketch!=NULL)
+	{
+		target->valueSketch = source->valueSketch;
+		source->valueSketch = NULL;
+	}
 #ifdef HAVE_MPI
 	if(myRank==0)
 	{
@@ -409,12 +806,14 @@ int ZC_moveDataProperty(ZC_DataProperty* target, ZC_DataProperty* source)
 	{
 		if(target->autocorr3D==NULL && source->autocorr3D !=NULL)
 		{
-			target->autocorr3D = (double*)malloc(sizeof(double)*source->numOfElem);
-			memcpy(target->autocorr3D, source->autocorr3D, sizeof(double)*source->numOfElem);
+			size_t ac3dSize = ZC_getAutocorr3DLength(source->r5, source->r4, source->r3, source->r2, source->r1)
+				*(source->dataType==ZC_FLOAT ? sizeof(float) : sizeof(double));
+			target->autocorr3D = malloc(ac3dSize);
+			memcpy(target->autocorr3D, source->autocorr3D, ac3dSize);
 		}
 		if(target->fftCoeff==NULL && source->fftCoeff!=NULL)
 		{
-			size_t fft_size = pow(2, (int)log2(source->numOfElem));
+			size_t fft_size = ZC_getFFTCoeffCount(source->numOfElem);
 			target->fftCoeff = (complex*)malloc(sizeof(complex)*fft_size);
 			memcpy(target->fftCoeff, source->fftCoeff, sizeof(complex)*fft_size);
 		}		
@@ -422,17 +821,31 @@ int ZC_moveDataProperty(ZC_DataProperty* target, ZC_DataProperty* source)
 #else
 	if(target->autocorr3D==NULL && source->autocorr3D !=NULL)
 	{
-		target->autocorr3D = (double*)malloc(sizeof(double)*source->numOfElem);
-		memcpy(target->autocorr3D, source->autocorr3D, sizeof(double)*source->numOfElem);
+		size_t ac3dSize = ZC_getAutocorr3DLength(source->r5, source->r4, source->r3, source->r2, source->r1)
+			*(source->dataType==ZC_FLOAT ? sizeof(float) : sizeof(double));
+		target->autocorr3D = malloc(ac3dSize);
+		memcpy(target->autocorr3D, source->autocorr3D, ac3dSize);
 	}
 	if(target->fftCoeff==NULL && source->fftCoeff!=NULL)
 	{
-		size_t fft_size = pow(2, (int)log2(source->numOfElem));
+		size_t fft_size = ZC_getFFTCoeffCount(source->numOfElem);
 		target->fftCoeff = (complex*)malloc(sizeof(complex)*fft_size);
 		memcpy(target->fftCoeff, source->fftCoeff, sizeof(complex)*fft_size);
 	}
 #endif	
-	//TODO: to copy double* lap, which actually is not plotted yet.
+	if(target->lap==NULL && source->lap!=NULL)
+	{
+		target->lap = source->lap;
+		source->lap = NULL;
+	}
+	
+	//the properties not computed yet stay pending if the target keeps the same data
+	target->pendingMask = target->data==source->data ? source->pendingMask : 0;
+	if(target->autocorr!=NULL) target->pendingMask &= ~ZC_PROP_AUTOCORR;
+	if(target->valueSketch!=NULL) target->pendingMask &= ~ZC_PROP_QUANTILES;
+	if(target->autocorr3D!=NULL) target->pendingMask &= ~ZC_PROP_AUTOCORR3D;
+	if(target->fftCoeff!=NULL) target->pendingMask &= ~ZC_PROP_FFT;
+	if(target->lap!=NULL) target->pendingMask &= ~ZC_PROP_LAP;
 	
 	freeDataProperty_internal(source);
 	return ZC_SCES;
@@ -451,9 +864,11 @@ void ZC_printDataProperty(ZC_DataProperty* property)
 	//printf("(property->autocorr)[90]=%f\n", (property->autocorr)[90]);
 }
 
+/*the lines of the .prop file, followed by NULL*/
 char** constructDataPropertyString(ZC_DataProperty* property)
 {
-	char** s = (char**)malloc(15*sizeof(char*));
+	int i, k = 15;
+	char** s = (char**)malloc((17+ZC_VALUE_QUANTILE_COUNT)*sizeof(char*));
 	s[0] = (char*)malloc(100*sizeof(char));
 	sprintf(s[0], "[PROPERTY]\n");
 	
@@ -488,6 +903,15 @@ char** constructDataPropertyString(ZC_DataProperty* property)
 		sprintf(s[14], "autocorr = %.10G\n", (property->autocorr)[1]);
 	else 
 		strcpy(s[14], "autocorr = -\n");
+	if(quantEntropyFlag)
+	{
+		s[k] = (char*)malloc(100*sizeof(char));
+		sprintf(s[k++], "quantEntropy = %.10G\n", property->quantEntropy);
+	}
+	if(property->valueSketch!=NULL)
+		for(i=0;i<ZC_VALUE_QUANTILE_COUNT;i++)
+			s[k++] = ZC_constructQuantileString("value", property->valueSketch, ZC_valueQuantiles[i]);
+	s[k] = NULL;
 	return s;
 }
 
@@ -531,7 +955,11 @@ void ZC_writeFFTResults(char* varName, complex* fftCoeff, char* tgtWorkspaceDir)
 
 void ZC_writeDataProperty(ZC_DataProperty* property, char* tgtWorkspaceDir)
 {
+	ZC_requireProperties(property, ZC_getFlaggedProperties());
 	char** s = constructDataPropertyString(property);
+	int nbLines = 0;
+	while(s[nbLines]!=NULL)
+		nbLines++;
 	
 	DIR *dir = opendir(tgtWorkspaceDir);
 	if(dir==NULL)
@@ -539,9 +967,9 @@ void ZC_writeDataProperty(ZC_DataProperty* property, char* tgtWorkspaceDir)
 
 	char tgtFilePath[ZC_BUFS];
 	sprintf(tgtFilePath, "%s/%s.prop", tgtWorkspaceDir, property->varName); 
-	ZC_writeStrings(15, s, tgtFilePath);
+	ZC_writeStrings(nbLines, s, tgtFilePath);
 	size_t i;
-	for(i=0;i<15;i++)
+	for(i=0;i<nbLines;i++)
 		free(s[i]);
 	free(s);
 	/*write the fft coefficients and amplitudes*/
@@ -568,28 +996,19 @@ void ZC_writeDataProperty(ZC_DataProperty* property, char* tgtWorkspaceDir)
 	{
 		memset(tgtFilePath, 0, ZC_BUFS);
 		sprintf(tgtFilePath, "%s/%s.ac3d", tgtWorkspaceDir, property->varName);
+		size_t ac3dLength = ZC_getAutocorr3DLength(property->r5, property->r4, property->r3, property->r2, property->r1);
 		if(property->dataType==ZC_FLOAT)
-			ZC_writeFloatData_inBytes((float*)(property->autocorr3D), property->numOfElem, tgtFilePath);
+			ZC_writeFloatData_inBytes((float*)(property->autocorr3D), ac3dLength, tgtFilePath);
 		else
-			ZC_writeDoubleData_inBytes((double*)(property->autocorr3D), property->numOfElem, tgtFilePath);	
+			ZC_writeDoubleData_inBytes((double*)(property->autocorr3D), ac3dLength, tgtFilePath);	
 	}
 
-	/*write Laplacian*/
+	/*write Laplacian (binary doubles, in the order of the data)*/
 	if(property->lap!=NULL)
 	{
-		char **lap = (char**)malloc(property->numOfElem*sizeof(char*));
-
-		for (i = 0; i < property->numOfElem; i++)
-		{
-			lap[i] = (char*)malloc(sizeof(char)*50);
-			sprintf(lap[i], "%f\n", (property->lap)[i]);
-		}
 		memset(tgtFilePath, 0, ZC_BUFS);
 		sprintf(tgtFilePath, "%s/%s.lap", tgtWorkspaceDir, property->varName);
-		ZC_writeStrings(property->numOfElem, lap, tgtFilePath);
-		for (i = 0; i < property->numOfElem; i++)
-			free(lap[i]);
-		free(lap);
+		ZC_writeDoubleData_inBytes(property->lap, property->numOfElem, tgtFilePath);
 	}
 	if(dir!=NULL)
 		closedir(dir);
@@ -638,5 +1057,6 @@ ZC_DataProperty* ZC_loadDataProperty(char* propResultFile)
 	
 	ZC_DataProperty* property = ZC_constructDataProperty(var, dataType, r5, r4, r3, r2, r1, numOfElem, minValue, maxValue, 
 	valueRange, avgValue, entropy, autocorr_array, fftCoeff);
+	property->quantEntropy = (double)iniparser_getdouble(ini, "PROPERTY:quantEntropy", 0);
 	return property;
 }
@@ -4,50 +4,31 @@
 #include <sys/stat.h>
 #include "ZC_DataProperty.h"
 #include "zc.h"
+#include "ZC_autocorr.h"
 #include "iniparser.h"
 #include "ZC_FFTW3_math.h"
 
+static void ZC_computeLagSums_float(float* data, size_t numOfElem, double center, double* lagSums);
+
 #ifdef HAVE_MPI
 
+/**
+ * The basic properties of the data of all the ranks (collective), with a single reduction 
+ * (see ZC_reduceOnlineStat_online()); sets globalDataLength as well.
+ * */
 void ZC_genBasicProperties_float_online(float* data, size_t numOfElem, ZC_DataProperty* property)
 {
-	size_t i;
+	ZC_OnlineStat stat;
 	property->dataType = ZC_FLOAT;
 	property->data = data;	
 	
-	//property->numOfElem = numOfElem;
-	double min=data[0],max=data[0],sum=0;
-
-    for(i=0;i<numOfElem;i++)
-	{
-		if(min>data[i]) min = data[i];
-		if(max<data[i]) max = data[i];
-		sum += data[i];
-	}
-	
-	if(globalDataLength>0)
-		property->numOfElem = globalDataLength;
-	else
-	{
-		MPI_Allreduce(&numOfElem, &globalDataLength, 1, MPI_LONG, MPI_SUM, ZC_COMM_WORLD);
-		property->numOfElem = globalDataLength;
-	}
-	MPI_Allreduce(&min, &property->minValue, 1, MPI_DOUBLE, MPI_MIN, ZC_COMM_WORLD);
-	MPI_Allreduce(&max, &property->maxValue, 1, MPI_DOUBLE, MPI_MAX, ZC_COMM_WORLD);
-	MPI_Allreduce(&sum, &property->avgValue, 1, MPI_DOUBLE, MPI_SUM, ZC_COMM_WORLD);
-	property->avgValue = property->avgValue/globalDataLength;
-	
-	//compute zeromean_variance for the following computation of SNR
-	double med = property->minValue + (property->maxValue - property->minValue)/2;
-	double sum_of_square = 0;
-	for(i=0;i<numOfElem;i++)
-		sum_of_square += (data[i] - med)*(data[i] - med);
-	MPI_Allreduce(&sum_of_square, &property->zeromean_variance, 1, MPI_DOUBLE, MPI_SUM, ZC_COMM_WORLD);
-	property->zeromean_variance = property->zeromean_variance/globalDataLength;
-	property->valueRange = property->maxValue - property->minValue;	
+	ZC_initOnlineStat(&stat, ZC_REDUCE_PROPERTY);
+	ZC_computePropertyStat_float(&stat.property, data, numOfElem);
+	ZC_reduceOnlineStat_online(&stat);
+	ZC_applyPropertyStat(property, &stat.property);
+	globalDataLength = stat.property.n;
 }
 
-
 ZC_DataProperty* ZC_genProperties_float_online(char* varName, float *data, size_t numOfElem, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
 {
 	size_t i = 0;
@@ -62,114 +43,82 @@ ZC_DataProperty* ZC_genProperties_float_online(char* varName, float *data, size_
 	
 	ZC_genBasicProperties_float_online(data, numOfElem, property);
 	
+	//the byte counts (entropy) and the lag sums (autocorr) of all the ranks are summed on rank 0 by one reduction
+	size_t table_size = 256;
+	int nbSums = 0;
+	double sums[256+AUTOCORR_SIZE+1];
+	double *byteCounts = NULL, *lagSums = NULL;
 	if(entropyFlag)
 	{
-		double entVal = 0.0;
-		unsigned char index = 0;
-		size_t totalLen = numOfElem*sizeof(float);
-		size_t table_size = 256;
-		long *table = (long*)malloc(table_size*sizeof(long));
-		memset(table, 0, table_size*sizeof(long));
-		long *gtable = (long*)malloc(table_size*sizeof(long));
-		memset(gtable, 0, table_size*sizeof(long));
-				
-		unsigned char* bytes = (unsigned char*)data;	
-		for(i=0;i<totalLen;i++)
-		{
-			index = bytes[i];
-			table[index]++;
-		}
-		
-		MPI_Reduce(table, gtable, table_size, MPI_LONG, MPI_SUM, 0, ZC_COMM_WORLD);
-		
-		if(myRank==0)
-		{
-			size_t sum = globalDataLength * sizeof(float);
-			for (i = 0; i<table_size; i++)
-				if (gtable[i] != 0)
-				{
-					double prob = (double)gtable[i]/sum;
-					entVal -= prob*log(prob)/log(2);
-				}
-		}
-
-		property->entropy = entVal;
+		long *table = (long*)malloc(ZC_BYTE_SUBTABLES*table_size*sizeof(long));
+		memset(table, 0, ZC_BYTE_SUBTABLES*table_size*sizeof(long));
+		ZC_countBytes((unsigned char*)data, numOfElem*sizeof(float), table);
+		byteCounts = sums + nbSums;
+		for(i=0;i<table_size;i++)
+			byteCounts[i] = 0;
+		for(i=0;i<ZC_BYTE_SUBTABLES*table_size;i++)
+			byteCounts[i%table_size] += table[i];
+		nbSums += table_size;
 		free(table);
-		free(gtable);			
-		
-/*		double absErr = 1E-3 * property->valueRange; //TODO change fixed value to user input
+	}
+	if(autocorrFlag)
+	{
+		lagSums = sums + nbSums;
+		ZC_computeLagSums_float(data, numOfElem, property->avgValue, lagSums);
+		nbSums += AUTOCORR_SIZE+1;
+	}
+	if(nbSums > 0)
+		MPI_Reduce(myRank==0 ? MPI_IN_PLACE : sums, sums, nbSums, MPI_DOUBLE, MPI_SUM, 0, ZC_COMM_WORLD);
+	
+	if(entropyFlag && myRank==0)
+	{
 		double entVal = 0.0;
-		size_t table_size;
-		table_size = (size_t)(property->valueRange/absErr)+1;	
-		long *table = (long*)malloc(table_size*sizeof(long));
-		memset(table, 0, table_size*sizeof(long));
-		long *gtable = (long*)malloc(table_size*sizeof(long));
-		memset(gtable, 0, table_size*sizeof(long));
-		
-		unsigned long index = 0;
-		for (i = 0; i < numOfElem; i++)
- 		{
-			index = (unsigned long)((data[i]-property->minValue)/absErr);
-			table[index]++;
-		}
- 
-		MPI_Reduce(table, gtable, table_size, MPI_LONG, MPI_SUM, 0, ZC_COMM_WORLD);
- 
-		if(myRank==0)
-		{
-			for (i = 0; i<table_size; i++)
-				if (gtable[i] != 0)
-				{
-					double prob = (double)gtable[i]/globalDataLength;
-					entVal -= prob*log(prob)/log(2);
-				}
-		}
-
+		size_t sum = globalDataLength * sizeof(float);
+		for (i = 0; i<table_size; i++)
+			if (byteCounts[i] != 0)
+			{
+				double prob = byteCounts[i]/sum;
+				entVal -= prob*log(prob)/log(2);
+			}
 		property->entropy = entVal;
-		free(table);
-		free(gtable);*/
 	}
-	if(autocorrFlag)
+	if(autocorrFlag && myRank==0)
 	{
-		double ccov[AUTOCORR_SIZE+1], gcov[AUTOCORR_SIZE+1];
-		memset(ccov, 0, sizeof(double)*(AUTOCORR_SIZE+1));
-		memset(gcov, 0, sizeof(double)*(AUTOCORR_SIZE+1));
-		
+		//each rank contributes the lagged products within its own part of the data
 		double *autocorr = (double*)malloc((AUTOCORR_SIZE+1)*sizeof(double));
 		int delta;
-		double var = 0, gvar = 0;
-		for (i = 0; i < numOfElem; i++)
-			var += (data[i] - property->avgValue)*(data[i] - property->avgValue);
-		
-		for(delta = 1; delta <= AUTOCORR_SIZE; delta++)
+		double gvar = property->sumSqrDev/globalDataLength;
+		if (gvar == 0)
 		{
-			double cov = 0;
-			for (i = 0; i < numOfElem-delta; i++)
-				cov += (data[i] - property->avgValue)*(data[i+delta] - property->avgValue);
-			ccov[delta] = cov;	
+			for (delta = 1; delta <= AUTOCORR_SIZE; delta++)
+				autocorr[delta] = 1;
 		}
-		
-		MPI_Reduce(&var, &gvar, 1, MPI_DOUBLE, MPI_SUM, 0, ZC_COMM_WORLD);
-		MPI_Reduce(ccov, gcov, AUTOCORR_SIZE+1, MPI_DOUBLE, MPI_SUM, 0, ZC_COMM_WORLD);
-		
-		if(myRank==0)
-		{	
-			gvar = gvar/globalDataLength;
-			if (gvar == 0)
-			{
-				for (delta = 1; delta <= AUTOCORR_SIZE; delta++)
-					autocorr[delta] = 1;
-			}
-			else
-			{
-				for (delta = 1; delta <= AUTOCORR_SIZE; delta++)
-				{
-					autocorr[delta] = gcov[delta]/(globalDataLength-nbProc*delta)/gvar;				
-				}
-			}
-			autocorr[0] = 1;
-			property->autocorr = autocorr;					
+		else
+		{
+			for (delta = 1; delta <= AUTOCORR_SIZE; delta++)
+				autocorr[delta] = lagSums[delta]/(globalDataLength-nbProc*delta)/gvar;
 		}
+		autocorr[0] = 1;
+		property->autocorr = autocorr;
+	}
+	if(quantEntropyFlag)
+	{
+		//the bins start from the global min, so the counts of the ranks can be merged
+		ZC_QuantCounts counts;
+		double valueRange = property->valueRange;
+		if(valueRange > 0)
+		{
+			ZC_initQuantCounts(&counts, property->minValue, valueRange, quantEntropyBoundRatio*valueRange);
+			ZC_countQuantValues_float(data, numOfElem, &counts);
+			property->quantEntropy = ZC_reduceQuantEntropy_online(&counts, globalDataLength);
+			ZC_freeQuantCounts(&counts);
+		}
+	}
+	if(valueQuantilesFlag)
+	{
+		property->valueSketch = ZC_createQuantileSketch();
+		ZC_addValueSketch_float(property->valueSketch, data, numOfElem);
+		ZC_reduceQuantileSketch_online(property->valueSketch);
 	}
 	//TODO compute FFT 
 	
@@ -180,71 +129,492 @@ ZC_DataProperty* ZC_genProperties_float_online(char* varName, float *data, size_
 }
 #endif
 
-ZC_DataProperty* ZC_genProperties_float(char* varName, float *data, size_t numOfElem, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
+typedef struct ZC_PropertyTask_float
 {
-	size_t i = 0;
-	ZC_DataProperty* property = (ZC_DataProperty*)malloc(sizeof(ZC_DataProperty));
-	memset(property, 0, sizeof(ZC_DataProperty));
-	
-	property->varName = (char*)malloc(strlen(varName)+1);
-	
-	char* varN = rmFileExtension(varName);
-	strcpy(property->varName, varN);
-	free(varN);
-	
-	property->dataType = ZC_FLOAT;
-	property->data = data;
+	float* data;
+	size_t n;
+	double* partials; /*per-chunk results*/
+	long* tables; /*one byte histogram (ZC_BYTE_SUBTABLES sub-histograms) per thread*/
+	ZC_QuantCounts* quantCounts; /*one per thread*/
+	ZC_QuantileSketch* sketches; /*one per thread*/
+	double center;
+	int width;
+} ZC_PropertyTask_float;
+
+static void ZC_computeMinMaxSumChunk_float(void* arg, int threadID, size_t taskID)
+{
+	ZC_PropertyTask_float* t = (ZC_PropertyTask_float*)arg;
+	size_t begin = taskID*ZC_CHUNK_SIZE;
+	size_t end = begin + ZC_CHUNK_SIZE < t->n ? begin + ZC_CHUNK_SIZE : t->n;
+	double min, max, sum;
+	ZC_getKernels()->valueSums_float(t->data+begin, end-begin, &min, &max, &sum);
+	t->partials[taskID*3] = sum;
+	t->partials[taskID*3+1] = min;
+	t->partials[taskID*3+2] = max;
+}
 
-	property->numOfElem = numOfElem;
-	double min=data[0],max=data[0],sum=0,avg,valueRange;
+/*value range of the data (e.g., for the REL error bounds), without the other properties*/
+double ZC_computeValueRange_float(float* data, size_t numOfElem)
+{
+	size_t i, nbChunks = ZC_computeChunkCount(numOfElem);
+	double min, max;
+	ZC_PropertyTask_float task;
+	if(nbChunks == 0)
+		return 0;
+	task.data = data;
+	task.n = numOfElem;
+	task.partials = (double*)malloc(sizeof(double)*3*nbChunks);
+	ZC_runTasks(ZC_computeMinMaxSumChunk_float, &task, nbChunks);
+	min = task.partials[1];
+	max = task.partials[2];
+	for(i=1;i<nbChunks;i++)
+	{
+		if(min>task.partials[i*3+1]) min = task.partials[i*3+1];
+		if(max<task.partials[i*3+2]) max = task.partials[i*3+2];
+	}
+	free(task.partials);
+	return max - min;
+}
 
-	int dim = ZC_computeDimension(r5, r4, r3, r2, r1);
+/*partial sums of (data[i]-center)^2 (slot 0) and of the lagged products (slots 1..width-1), 
+ *the products being attributed to the chunk of their second element*/
+static void ZC_computeLagSumsChunk_float(void* arg, int threadID, size_t taskID)
+{
+	ZC_PropertyTask_float* t = (ZC_PropertyTask_float*)arg;
+	size_t i, k, h, len, begin = taskID*ZC_CHUNK_SIZE;
+	size_t end = begin + ZC_CHUNK_SIZE < t->n ? begin + ZC_CHUNK_SIZE : t->n;
+	size_t maxLag = t->width - 1;
+	float* data = t->data;
+	double c = t->center;
+	double* sums = t->partials + taskID*t->width;
+	if(maxLag > 0)
+	{
+		double* y = (double*)malloc(sizeof(double)*(maxLag+ZC_LAG_TILE_SIZE));
+		memset(sums, 0, sizeof(double)*t->width);
+		for (k = begin; k < end; k += len)
+		{
+			len = end - k < ZC_LAG_TILE_SIZE ? end - k : ZC_LAG_TILE_SIZE;
+			h = k < maxLag ? k : maxLag;
+			for (i = 0; i < h+len; i++)
+				y[i] = data[k-h+i]-c;
+			ZC_accumulateLagProducts(y, h+len, h, maxLag, sums);
+		}
+		free(y);
+	}
+	sums[0] = ZC_getKernels()->sqDevSum_float(data+begin, end-begin, c);
+}
 
-    for(i=0;i<numOfElem;i++)
+/**
+ * Sums of (data[i]-center)^2 (lagSums[0]) and of the products (data[i]-center)*(data[i+delta]-center) 
+ * (lagSums[delta], delta = 1..AUTOCORR_SIZE), by FFT or in one blocked pass over the data.
+ * */
+static void ZC_computeLagSums_float(float* data, size_t numOfElem, double center, double* lagSums)
+{
+	size_t i, nbChunks = ZC_computeChunkCount(numOfElem);
+	ZC_PropertyTask_float task;
+	if(nbChunks == 0)
 	{
-		if(min>data[i]) min = data[i];
-		if(max<data[i]) max = data[i];
-		sum += data[i];
+		memset(lagSums, 0, sizeof(double)*(AUTOCORR_SIZE+1));
+		return;
+	}
+	if (ZC_useLagSumsFFT(numOfElem, AUTOCORR_SIZE))
+	{
+		double *ddata = (double*)malloc(numOfElem*sizeof(double));
+		for(i=0;i<numOfElem;i++)
+			ddata[i] = data[i]-center;
+		ZC_computeLagSumsFFT(ddata, numOfElem, AUTOCORR_SIZE, lagSums);
+		free(ddata);
+		return;
 	}
+	ZC_getKernels(); //select the kernels before starting the threads
+	task.data = data;
+	task.n = numOfElem;
+	task.center = center;
+	task.width = AUTOCORR_SIZE+1;
+	task.partials = (double*)malloc(sizeof(double)*(AUTOCORR_SIZE+1)*nbChunks);
+	ZC_runTasks(ZC_computeLagSumsChunk_float, &task, nbChunks);
+	ZC_reduceSumTree(task.partials, nbChunks, AUTOCORR_SIZE+1);
+	memcpy(lagSums, task.partials, sizeof(double)*(AUTOCORR_SIZE+1));
+	free(task.partials);
+}
 
-	double med = min+(max-min)/2;
-	double sum_of_square = 0;
-	for(i=0;i<numOfElem;i++)
-		sum_of_square += (data[i] - med)*(data[i] - med);
-	property->zeromean_variance = sum_of_square/numOfElem;
+/*the mergeable basic statistics of the data, e.g., of the local part of the data in the online mode*/
+void ZC_computePropertyStat_float(ZC_PropertyStat* stat, float* data, size_t numOfElem)
+{
+	size_t i, nbChunks = ZC_computeChunkCount(numOfElem);
+	ZC_PropertyTask_float task;
+	ZC_initPropertyStat(stat);
+	if(nbChunks == 0)
+		return;
+	ZC_getKernels(); //select the kernels before starting the threads
+	task.data = data;
+	task.n = numOfElem;
+	task.partials = (double*)malloc(sizeof(double)*3*nbChunks);
+	ZC_runTasks(ZC_computeMinMaxSumChunk_float, &task, nbChunks);
+	for(i=0;i<nbChunks;i++)
+	{
+		if(stat->min>task.partials[i*3+1]) stat->min = task.partials[i*3+1];
+		if(stat->max<task.partials[i*3+2]) stat->max = task.partials[i*3+2];
+	}
+	ZC_reduceSumTree(task.partials, nbChunks, 3);
+	stat->n = numOfElem;
+	stat->mean = task.partials[0]/numOfElem;
+	free(task.partials);
+
+	task.center = stat->mean;
+	task.width = 1;
+	task.partials = (double*)malloc(sizeof(double)*nbChunks);
+	ZC_runTasks(ZC_computeLagSumsChunk_float, &task, nbChunks);
+	ZC_reduceSumTree(task.partials, nbChunks, 1);
+	stat->m2 = task.partials[0];
+	free(task.partials);
+}
 
-	avg = sum/numOfElem;
-	valueRange = max - min;
+/**
+ * Approximate mode: min, max, average and zeromean_variance (around the mid-range) 
+ * of the nbSampled blocks[j] of lengths[j] points; returns the number of sampled points.
+ * */
+size_t ZC_computeSampleValueStat_float(float** blocks, size_t* lengths, size_t nbSampled, double* min, double* max, double* avg, double* zeromean_variance)
+{
+	size_t i, j, count = 0;
+	double sum = 0, sum_of_square = 0;
+	*min = blocks[0][0];
+	*max = blocks[0][0];
+	for(j=0;j<nbSampled;j++)
+	{
+		for(i=0;i<lengths[j];i++)
+		{
+			if(*min>blocks[j][i]) *min = blocks[j][i];
+			if(*max<blocks[j][i]) *max = blocks[j][i];
+			sum += blocks[j][i];
+		}
+		count += lengths[j];
+	}
+	double med = *min+(*max-*min)/2;
+	for(j=0;j<nbSampled;j++)
+		for(i=0;i<lengths[j];i++)
+			sum_of_square += (blocks[j][i] - med)*(blocks[j][i] - med);
+	*avg = sum/count;
+	*zeromean_variance = sum_of_square/count;
+	return count;
+}
 
-	if (minValueFlag)
-		property->minValue = min;
+static void ZC_computeByteTableChunk_float(void* arg, int threadID, size_t taskID)
+{
+	ZC_PropertyTask_float* t = (ZC_PropertyTask_float*)arg;
+	size_t begin = taskID*ZC_CHUNK_SIZE;
+	size_t end = begin + ZC_CHUNK_SIZE < t->n ? begin + ZC_CHUNK_SIZE : t->n;
+	unsigned char* bytes = (unsigned char*)(t->data+begin);
+	ZC_countBytes(bytes, (end-begin)*sizeof(float), t->tables + threadID*ZC_BYTE_SUBTABLES*256);
+}
 
-	if (maxValueFlag)
-		property->maxValue = max;
+static void ZC_computeQuantCountsChunk_float(void* arg, int threadID, size_t taskID)
+{
+	ZC_PropertyTask_float* t = (ZC_PropertyTask_float*)arg;
+	size_t i, begin = taskID*ZC_CHUNK_SIZE;
+	size_t end = begin + ZC_CHUNK_SIZE < t->n ? begin + ZC_CHUNK_SIZE : t->n;
+	float* data = t->data;
+	ZC_QuantCounts* counts = t->quantCounts + threadID;
+	double k, min = counts->min, scale = counts->scale, top = counts->nbBins-0.5;
+	//the values out of [min, min+valueRange] (approximate mode) and NaN are put in the extreme bins
+#define ZC_QUANT_KEY(x) (k = ((x)-min)*scale+0.5, !(k >= 0) ? 0 : (k < top ? (size_t)k : counts->nbBins-1))
+	if(counts->bins!=NULL)
+	{
+		long* bins = counts->bins;
+		for(i=begin;i<end;i++)
+			bins[ZC_QUANT_KEY(data[i])]++;
+	}
+	else
+	{
+		//runs of equal keys (frequent in smooth data) are added to the table at once
+		unsigned long key, last = ZC_QUANT_KEY(data[begin]);
+		long run = 0;
+		for(i=begin;i<end;i++)
+		{
+			key = ZC_QUANT_KEY(data[i]);
+			if(key != last)
+			{
+				hash_put(&counts->table, last, run);
+				last = key;
+				run = 0;
+			}
+			run++;
+		}
+		hash_put(&counts->table, last, run);
+	}
+#undef ZC_QUANT_KEY
+}
 
-	if (avgValueFlag)
-		property->avgValue = avg;
+/**
+ * Add the quantized values of the data (see ZC_initQuantCounts()) to counts:
+ * each thread counts its chunks in its own table, the tables being merged at the end.
+ * */
+void ZC_countQuantValues_float(float* data, size_t numOfElem, ZC_QuantCounts* counts)
+{
+	int t, threadCount;
+	size_t nbChunks = ZC_computeChunkCount(numOfElem);
+	ZC_PropertyTask_float task;
+	if(nbChunks == 0)
+		return;
+	threadCount = ZC_computeThreadCount(nbChunks);
+	task.data = data;
+	task.n = numOfElem;
+	task.quantCounts = (ZC_QuantCounts*)malloc(sizeof(ZC_QuantCounts)*threadCount);
+	task.quantCounts[0] = *counts;
+	for(t=1;t<threadCount;t++)
+		ZC_initEmptyQuantCounts(&task.quantCounts[t], counts);
+	ZC_runTasks(ZC_computeQuantCountsChunk_float, &task, nbChunks);
+	for(t=1;t<threadCount;t++)
+	{
+		ZC_mergeQuantCounts(&task.quantCounts[0], &task.quantCounts[t]);
+		ZC_freeQuantCounts(&task.quantCounts[t]);
+	}
+	*counts = task.quantCounts[0];
+	free(task.quantCounts);
+}
+
+/*entropy of the values quantized with the absolute error bound errBound (0 if the data are constant)*/
+double ZC_computeQuantEntropy_float(float* data, size_t numOfElem, double min, double valueRange, double errBound)
+{
+	ZC_QuantCounts counts;
+	double entVal;
+	if(valueRange == 0 || numOfElem == 0)
+		return 0;
+	ZC_initQuantCounts(&counts, min, valueRange, errBound);
+	ZC_countQuantValues_float(data, numOfElem, &counts);
+	entVal = ZC_computeQuantEntropy(&counts, numOfElem);
+	ZC_freeQuantCounts(&counts);
+	return entVal;
+}
+
+static void ZC_addValueSketchChunk_float(void* arg, int threadID, size_t taskID)
+{
+	ZC_PropertyTask_float* t = (ZC_PropertyTask_float*)arg;
+	size_t i, begin = taskID*ZC_CHUNK_SIZE;
+	size_t end = begin + ZC_CHUNK_SIZE < t->n ? begin + ZC_CHUNK_SIZE : t->n;
+	ZC_QuantileSketch* sketch = t->sketches + threadID;
+	for(i=begin;i<end;i++)
+		ZC_addSketchValue(sketch, t->data[i]);
+}
+
+/*add the values of the data to sketch: one sketch per thread, merged at the end*/
+void ZC_addValueSketch_float(ZC_QuantileSketch* sketch, float* data, size_t numOfElem)
+{
+	int t, threadCount;
+	size_t nbChunks = ZC_computeChunkCount(numOfElem);
+	ZC_PropertyTask_float task;
+	if(nbChunks == 0)
+		return;
+	threadCount = ZC_computeThreadCount(nbChunks);
+	task.data = data;
+	task.n = numOfElem;
+	task.sketches = ZC_createQuantileSketches(threadCount);
+	ZC_runTasks(ZC_addValueSketchChunk_float, &task, nbChunks);
+	for(t=0;t<threadCount;t++)
+		ZC_mergeQuantileSketch(sketch, &task.sketches[t]);
+	free(task.sketches);
+}
+
+typedef struct ZC_LaplacianTask_float
+{
+	float* data;
+	double* lap;
+	size_t n[5]; /*r1, r2, r3, r4, r5 (1 for the missing dimensions)*/
+	size_t rowsPerTask;
+	size_t colsPerTask;
+	size_t nbRowBlocks;
+	size_t nbColBlocks;
+} ZC_LaplacianTask_float;
+
+/**
+ * out[x] for x in [a,b): the Laplacian at x+shift of the row C, with the pairs of neighbor
+ * rows A[p] and B[p] in the other dimensions (no term along the row if xStencil is 0).
+ * */
+static void ZC_computeLaplacianRow_float(float* C, float** A, float** B, int nbPairs, int xStencil, double* out, size_t a, size_t b, long shift)
+{
+	size_t x;
+	int p;
+	float* c = C + shift;
+	for(x=a;x<b;x++)
+		out[x] = xStencil ? (double)c[x-1] - 2*(double)c[x] + (double)c[x+1] : 0;
+	for(p=0;p<nbPairs;p++)
+	{
+		float* u = A[p] + shift;
+		float* v = B[p] + shift;
+		for(x=a;x<b;x++)
+			out[x] += (double)u[x] - 2*(double)c[x] + (double)v[x];
+	}
+}
+
+/*the points on the border take the Laplacian of the nearest interior point (as computeLap() always did)*/
+static size_t ZC_clampLaplacianIndex(size_t i, size_t n)
+{
+	if(n < 3)
+		return i;
+	return i < 1 ? 1 : (i > n-2 ? n-2 : i);
+}
+
+/*one block of rows and columns of a plane (r2 x r1), by tiles of ZC_LAP_TILE_SIZE columns*/
+static void ZC_computeLaplacianBlock_float(void* arg, int threadID, size_t taskID)
+{
+	ZC_LaplacianTask_float* t = (ZC_LaplacianTask_float*)arg;
+	size_t* n = t->n;
+	size_t colBlock = taskID%t->nbColBlocks;
+	size_t rowBlock = (taskID/t->nbColBlocks)%t->nbRowBlocks;
+	size_t plane = taskID/t->nbColBlocks/t->nbRowBlocks;
+	size_t planeSize = n[0]*n[1], stride = planeSize;
+	size_t x0 = colBlock*t->colsPerTask, x1 = x0 + t->colsPerTask < n[0] ? x0 + t->colsPerTask : n[0];
+	size_t y0 = rowBlock*t->rowsPerTask, y1 = y0 + t->rowsPerTask < n[1] ? y0 + t->rowsPerTask : n[1];
+	size_t tx0, tx1, y, d, q = plane, cplane = 0;
+	long offsets[4];
+	int nbPairs = 0, xStencil = n[0] >= 3;
+	float *A[4], *B[4];
+	if(n[1] >= 3)
+		offsets[nbPairs++] = n[0];
+	//the outer dimensions: the clamped plane and its neighbor planes
+	for(d=2;d<5;d++)
+	{
+		size_t i = q%n[d];
+		q /= n[d];
+		cplane += ZC_clampLaplacianIndex(i, n[d])*(stride/planeSize);
+		if(n[d] >= 3)
+			offsets[nbPairs++] = stride;
+		stride *= n[d];
+	}
+	for(tx0=x0;tx0<x1;tx0=tx1)
+	{
+		tx1 = tx0 + ZC_LAP_TILE_SIZE < x1 ? tx0 + ZC_LAP_TILE_SIZE : x1;
+		for(y=y0;y<y1;y++)
+		{
+			int p;
+			float* C = t->data + cplane*planeSize + ZC_clampLaplacianIndex(y, n[1])*n[0];
+			double* out = t->lap + plane*planeSize + y*n[0];
+			for(p=0;p<nbPairs;p++)
+			{
+				A[p] = C - offsets[p];
+				B[p] = C + offsets[p];
+			}
+			if(!xStencil)
+			{
+				ZC_computeLaplacianRow_float(C, A, B, nbPairs, 0, out, tx0, tx1, 0);
+				continue;
+			}
+			size_t a = tx0 > 1 ? tx0 : 1, b = tx1 < n[0]-1 ? tx1 : n[0]-1;
+			if(a < b)
+				ZC_computeLaplacianRow_float(C, A, B, nbPairs, 1, out, a, b, 0);
+			if(tx0 == 0)
+				ZC_computeLaplacianRow_float(C, A, B, nbPairs, 1, out, 0, 1, 1);
+			if(tx1 == n[0])
+				ZC_computeLaplacianRow_float(C, A, B, nbPairs, 1, out, n[0]-1, n[0], -1);
+		}
+	}
+}
+
+/**
+ * Laplacian (sum over the dimensions of f[i-1]-2f[i]+f[i+1]) of 1D to 5D data, directly on the float data.
+ * The planes (r2 x r1) are split into blocks of rows (or of columns for long rows), processed in parallel.
+ * */
+void ZC_computeLaplacian_float(float* data, double* lap, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
+{
+	ZC_LaplacianTask_float task;
+	size_t nbPlanes;
+	int d;
+	size_t r[5] = {r1, r2, r3, r4, r5};
+	if(r1 == 0)
+		return;
+	task.data = data;
+	task.lap = lap;
+	for(d=0;d<5;d++)
+		task.n[d] = r[d]==0 ? 1 : r[d];
+	nbPlanes = task.n[2]*task.n[3]*task.n[4];
+	task.colsPerTask = task.n[0] < ZC_CHUNK_SIZE ? task.n[0] : ZC_CHUNK_SIZE;
+	task.rowsPerTask = ZC_CHUNK_SIZE/task.colsPerTask < task.n[1] ? ZC_CHUNK_SIZE/task.colsPerTask : task.n[1];
+	task.nbColBlocks = (task.n[0]-1)/task.colsPerTask+1;
+	task.nbRowBlocks = (task.n[1]-1)/task.rowsPerTask+1;
+	ZC_runTasks(ZC_computeLaplacianBlock_float, &task, nbPlanes*task.nbRowBlocks*task.nbColBlocks);
+}
+
+/**
+ * Compute the property id (one of the ZC_PROP_* bits) of the float data of the property; 
+ * its dependencies (see ZC_requireProperties()) must be computed before.
+ * */
+void ZC_computeProperty_float(ZC_DataProperty* property, int id)
+{
+	size_t i = 0;
+	float* data = (float*)property->data;
+	size_t numOfElem = property->numOfElem;
+	size_t r5 = property->r5, r4 = property->r4, r3 = property->r3, r2 = property->r2, r1 = property->r1;
+
+	//per-chunk partial results are merged in a fixed order, independently of the number of threads
+	size_t nbChunks = ZC_computeChunkCount(numOfElem);
+	ZC_PropertyTask_float task;
+	ZC_getKernels(); //select the kernels before starting the threads
+	task.data = data;
+	task.n = numOfElem;
 	
-	if (valueRangeFlag)
-		property->valueRange = valueRange;
-    
-	if(entropyFlag)
+	switch(id)
+	{
+	case ZC_PROP_BASIC:
+	{
+		double min=data[0],max=data[0],sum=0,avg;
+		size_t nbSampled;
+		size_t* blocks = ZC_selectSampleBlocks(numOfElem, sampleRatio, sampleSeed, &nbSampled);
+		if(blocks!=NULL)
+		{
+			//approximate mode: the basic properties are those of the sampled blocks
+			size_t* lengths = (size_t*)malloc(sizeof(size_t)*nbSampled);
+			float** sampleBlocks = (float**)ZC_getSampleBlockPointers(data, sizeof(float), numOfElem, blocks, nbSampled, lengths);
+			property->sampleRatio = ZC_computeSampleValueStat_float(sampleBlocks, lengths, nbSampled, &min, &max, &avg, 
+			&property->zeromean_variance)/(double)numOfElem;
+			free(sampleBlocks);
+			free(lengths);
+			free(blocks);
+		}
+		else
+		{
+			task.partials = (double*)malloc(sizeof(double)*3*nbChunks);
+			ZC_runTasks(ZC_computeMinMaxSumChunk_float, &task, nbChunks);
+			for(i=0;i<nbChunks;i++)
+			{
+				if(min>task.partials[i*3+1]) min = task.partials[i*3+1];
+				if(max<task.partials[i*3+2]) max = task.partials[i*3+2];
+			}
+			ZC_reduceSumTree(task.partials, nbChunks, 3);
+			sum = task.partials[0];
+			free(task.partials);
+
+			double med = min+(max-min)/2;
+			task.center = med;
+			task.width = 1;
+			task.partials = (double*)malloc(sizeof(double)*nbChunks);
+			ZC_runTasks(ZC_computeLagSumsChunk_float, &task, nbChunks);
+			ZC_reduceSumTree(task.partials, nbChunks, 1);
+			property->zeromean_variance = task.partials[0]/numOfElem;
+			free(task.partials);
+			avg = sum/numOfElem;
+		}
+		property->minValue = min;
+		property->maxValue = max;
+		property->avgValue = avg;
+		property->valueRange = max - min;
+		break;
+	}
+	case ZC_PROP_ENTROPY:
 	{
 		double entVal = 0.0;
-		unsigned char index = 0;
 		size_t totalLen = numOfElem*sizeof(float);
 		size_t table_size = 256;
 		long *table = (long*)malloc(table_size*sizeof(long));
 		memset(table, 0, table_size*sizeof(long));
 				
-		unsigned char* bytes = (unsigned char*)data;	
-		for(i=0;i<totalLen;i++)
-		{
-			index = bytes[i];
-			table[index]++;
-		}
+		int threadCount = ZC_computeThreadCount(nbChunks);
+		task.tables = (long*)calloc(threadCount*ZC_BYTE_SUBTABLES*table_size, sizeof(long));
+		ZC_runTasks(ZC_computeByteTableChunk_float, &task, nbChunks);
+		for(i=0;i<threadCount*ZC_BYTE_SUBTABLES*table_size;i++)
+			table[i%table_size] += task.tables[i];
+		free(task.tables);
 		
-		size_t sum = numOfElem*sizeof(float);
+		size_t sum = totalLen;
 		for (i = 0; i<table_size; i++)
 			if (table[i] != 0)
 			{
@@ -254,21 +624,28 @@ ZC_DataProperty* ZC_genProperties_float(char* varName, float *data, size_t numOf
 
 		property->entropy = entVal;
 		free(table);
+		break;
 	}
-
-	if(autocorrFlag)
+	case ZC_PROP_QUANT_ENTROPY:
+		property->quantEntropy = ZC_computeQuantEntropy_float(data, numOfElem, property->minValue, property->valueRange, 
+		quantEntropyBoundRatio*property->valueRange);
+		break;
+	case ZC_PROP_QUANTILES:
+		property->valueSketch = ZC_createQuantileSketch();
+		ZC_addValueSketch_float(property->valueSketch, data, numOfElem);
+		break;
+	case ZC_PROP_AUTOCORR:
 	{
+		double avg = property->avgValue;
 		double *autocorr = (double*)malloc((AUTOCORR_SIZE+1)*sizeof(double));
 
 		int delta;
 
 		if (numOfElem > 4096)
 		{
-			double cov = 0;
-			for (i = 0; i < numOfElem; i++)
-				cov += (data[i] - avg)*(data[i] - avg);
-
-			cov = cov/numOfElem;
+			double cov, lagSums[AUTOCORR_SIZE+1];
+			ZC_computeLagSums_float(data, numOfElem, avg, lagSums);
+			cov = lagSums[0]/numOfElem;
 
 			if (cov == 0)
 			{
@@ -278,71 +655,26 @@ ZC_DataProperty* ZC_genProperties_float(char* varName, float *data, size_t numOf
 			else
 			{
 				for(delta = 1; delta <= AUTOCORR_SIZE; delta++)
-				{
-					double sum = 0;
-
-					for (i = 0; i < numOfElem-delta; i++)
-						sum += (data[i]-avg)*(data[i+delta]-avg);
-						
-					autocorr[delta] = sum/(numOfElem-delta)/cov;
-				}
+					autocorr[delta] = lagSums[delta]/(numOfElem-delta)/cov;
 			}
 		}
 		else
 		{
-			for (delta = 1; delta <= AUTOCORR_SIZE; delta++)
-			{
-				double avg_0 = 0;
-				double avg_1 = 0;
-
-				for (i = 0; i < numOfElem-delta; i++)
-				{
-					avg_0 += data[i];
-					avg_1 += data[i+delta];
-				}
-
-				avg_0 = avg_0 / (numOfElem-delta);
-				avg_1 = avg_1 / (numOfElem-delta);
-
-				double cov_0 = 0;
-				double cov_1 = 0;
-
-				for (i = 0; i < numOfElem-delta; i++)
-				{
-					cov_0 += (data[i]-avg_0)*(data[i]-avg_0);
-					cov_1 += (data[i+delta]-avg_1)*(data[i+delta]-avg_1);
-				}
-
-				cov_0 = cov_0/(numOfElem-delta);
-				cov_1 = cov_1/(numOfElem-delta);
-
-				cov_0 = sqrt(cov_0);
-				cov_1 = sqrt(cov_1);
-
-				if (cov_0*cov_1 == 0)
-				{
-					for (delta = 1; delta <= AUTOCORR_SIZE; delta++)
-						autocorr[delta] = 1;
-				}
-				else
-				{
-					double sum = 0;
-
-					for (i = 0; i < numOfElem-delta; i++)
-						sum += (data[i]-avg_0)*(data[i+delta]-avg_1);
-
-					autocorr[delta] = sum/(numOfElem-delta)/(cov_0*cov_1);
-				}
-			}
+			double *ddata = (double*)malloc(numOfElem*sizeof(double));
+			for(i=0;i<numOfElem;i++)
+				ddata[i] = (double)data[i]-data[0];
+			ZC_computeLagCorrelations(ddata, numOfElem, AUTOCORR_SIZE, 1, autocorr);
+			free(ddata);
 		}
 
 		autocorr[0] = 1;
 		property->autocorr = autocorr;
+		break;
 	}
-	
 #ifdef HAVE_FFTW3	
-	if(autocorr3DFlag)
+	case ZC_PROP_AUTOCORR3D:
 	{
+		int dim = ZC_computeDimension(r5, r4, r3, r2, r1);
 		switch(dim)
 		{
 		case 1:
@@ -364,25 +696,27 @@ ZC_DataProperty* ZC_genProperties_float(char* varName, float *data, size_t numOf
 			printf("Error: wrong dimension (dim=%d)\n", dim);
 			exit(0);
 		}
+		break;
 	}
 #endif	
-	
-	if(fftFlag)
-	{
-        size_t fft_size = pow(2, (int)log2(numOfElem));
-        property->fftCoeff = ZC_computeFFT(data, fft_size, ZC_FLOAT);
-	}
-	
-	if (lapFlag)
+	case ZC_PROP_FFT:
+        property->fftCoeff = ZC_computeFFTCoeff(data, numOfElem, ZC_FLOAT);
+		break;
+	case ZC_PROP_LAP:
 	{
 		double *lap = (double*)malloc(numOfElem*sizeof(double));
-		double *ddata = (double*)malloc(numOfElem*sizeof(double));
-		for(i=0;i<numOfElem;i++)
-			ddata[i] = data[i];
-		computeLap(ddata, lap, r5, r4, r3, r2, r1);
-		free(ddata);
+		ZC_computeLaplacian_float(data, lap, r5, r4, r3, r2, r1);
 		property->lap = lap;
+		break;
+	}
 	}
+}
 
+/*all the properties enabled in the configuration, computed at once (see ZC_createDataProperty() for the lazy ones)*/
+ZC_DataProperty* ZC_genProperties_float(char* varName, float *data, size_t numOfElem, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
+{
+	ZC_DataProperty* property = ZC_createDataProperty(varName, ZC_FLOAT, data, r5, r4, r3, r2, r1);
+	property->numOfElem = numOfElem;
+	ZC_requireProperties(property, ZC_getFlaggedProperties());
 	return property;
 }
@@ -0,0 +1,184 @@
+/**
+ *  @file ZC_ErrMap.c
+ *  @brief Blockwise error maps (per-tile metrics) of the compare functions.
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "ZC_ErrMap.h"
+#include "ZC_rw.h"
+
+/**
+ * Parse the tile shape of the [COMPARE] section, given along r1..r5 (e.g., "16 16 16");
+ * the missing sizes are 1, and NULL or an empty string selects the default shape.
+ * */
+void ZC_parseErrMapTile(char* s, size_t* tile)
+{
+	int k;
+	char* end;
+	memset(tile, 0, 5*sizeof(size_t));
+	if(s==NULL)
+		return;
+	for(k=0;k<5;k++)
+	{
+		size_t t = strtoul(s, &end, 10);
+		if(end==s)
+			break;
+		if(t==0)
+		{
+			printf("Error: wrong errMapTile: %s\n", s);
+			exit(0);
+		}
+		tile[k] = t;
+		s = end;
+	}
+	if(k>0)
+		for(;k<5;k++)
+			tile[k] = 1;
+}
+
+ZC_ErrMap* ZC_constructErrMap(size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
+{
+	int k;
+	size_t rr[5] = {r1, r2, r3, r4, r5};
+	ZC_ErrMap* map = (ZC_ErrMap*)malloc(sizeof(ZC_ErrMap));
+	int dim = 0;
+	for(k=0;k<5;k++)
+	{
+		map->r[k] = rr[k]==0 ? 1 : rr[k];
+		if(rr[k]!=0)
+			dim = k+1;
+	}
+
+	if(errMapTile[0]==0)
+	{
+		//default shape: tiles of about 4096 points
+		size_t defaultTile = dim==1 ? 4096 : (dim==2 ? 64 : 16);
+		for(k=0;k<5;k++)
+			map->tile[k] = k<dim && k<3 ? defaultTile : 1;
+	}
+	else
+		memcpy(map->tile, errMapTile, 5*sizeof(size_t));
+
+	map->nbTiles = 1;
+	for(k=0;k<5;k++)
+	{
+		if(map->tile[k]>map->r[k])
+			map->tile[k] = map->r[k];
+		map->dims[k] = (map->r[k]+map->tile[k]-1)/map->tile[k];
+		map->nbTiles *= map->dims[k];
+	}
+
+	map->dim = dim;
+	map->acc = (double*)calloc(ZC_ERRMAP_ACC_COUNT*map->nbTiles, sizeof(double));
+	map->maxAbsErr = NULL;
+	map->rmse = NULL;
+	map->psnr = NULL;
+	map->bias = NULL;
+	map->ssim = NULL;
+	return map;
+}
+
+/**
+ * Number of points of a layer of tiles along the slowest dimension: the layers are
+ * contiguous in memory and do not share any tile, so they can be updated in parallel.
+ * */
+size_t ZC_getErrMapLayerSize(ZC_ErrMap* map, size_t* nbLayers)
+{
+	int k, d = 0;
+	size_t size = 1;
+	for(k=0;k<5;k++)
+		if(map->r[k]>1)
+			d = k;
+	for(k=0;k<d;k++)
+		size *= map->r[k];
+	*nbLayers = map->dims[d];
+	return size*map->tile[d];
+}
+
+/*sums of the first tile crossed by the row (of r1 points) number row*/
+double* ZC_getErrMapRowTiles(ZC_ErrMap* map, size_t row)
+{
+	int k;
+	size_t j[5], index = 0;
+	for(k=1;k<5;k++)
+	{
+		j[k] = (row%map->r[k])/map->tile[k];
+		row /= map->r[k];
+	}
+	for(k=4;k>=1;k--)
+		index = index*map->dims[k] + j[k];
+	return map->acc + index*map->dims[0]*ZC_ERRMAP_ACC_COUNT;
+}
+
+/**
+ * Turn the sums of every tile into its metrics, with the value range of the whole
+ * data for the PSNR and the SSIM constants (the ones of zc_get_ssim_float()).
+ * */
+void ZC_finalizeErrMap(ZC_ErrMap* map, double valueRange)
+{
+	size_t i;
+	double range2 = valueRange*valueRange;
+	double C1 = (0.01*0.01)*range2, C2 = (0.03*0.03)*range2, C3 = (0.015*0.015)*range2;
+	double* fields = (double*)malloc(ZC_ERRMAP_FIELD_COUNT*map->nbTiles*sizeof(double));
+	map->maxAbsErr = fields;
+	map->rmse = fields + map->nbTiles;
+	map->psnr = fields + 2*map->nbTiles;
+	map->bias = fields + 3*map->nbTiles;
+	map->ssim = fields + 4*map->nbTiles;
+
+	for(i=0;i<map->nbTiles;i++)
+	{
+		double* a = map->acc + i*ZC_ERRMAP_ACC_COUNT;
+		double n = a[ZC_ERRMAP_COUNT];
+		double mse = a[ZC_ERRMAP_SUM_DIFF2]/n;
+		map->maxAbsErr[i] = a[ZC_ERRMAP_MAX];
+		map->rmse[i] = sqrt(mse);
+		map->psnr[i] = 20*log10(valueRange)-10*log10(mse);
+		map->bias[i] = a[ZC_ERRMAP_SUM_DIFF]/n;
+
+		double m1 = a[ZC_ERRMAP_SUM1]/n, m2 = a[ZC_ERRMAP_SUM2]/n;
+		double sxx = a[ZC_ERRMAP_SUM11]/n - m1*m1;
+		double syy = a[ZC_ERRMAP_SUM22]/n - m2*m2;
+		double sxy = a[ZC_ERRMAP_SUM12]/n - m1*m2;
+		if (sxx < 0) sxx = 0;
+		if (syy < 0) syy = 0;
+		double sxsy = sqrt(sxx*syy);
+		m1 += a[ZC_ERRMAP_PILOT]; //the luminance term needs the unshifted means
+		m2 += a[ZC_ERRMAP_PILOT];
+		double l = (2*m1*m2 + C1)/(m1*m1 + m2*m2 + C1);
+		double c = (2*sxsy + C2)/(sxx + syy + C2);
+		double s = (sxy + C3)/(sxsy + C3);
+		map->ssim[i] = l*c*s;
+	}
+	free(map->acc);
+	map->acc = NULL;
+}
+
+/*sizes (tile or dims of the map) in the format of ZC_constructDimString(), e.g., 38X4X3*/
+void ZC_constructErrMapDimString(ZC_ErrMap* map, size_t* sizes, char* output)
+{
+	int k;
+	output += sprintf(output, "%zu", sizes[map->dim-1]);
+	for(k=map->dim-2;k>=0;k--)
+		output += sprintf(output, "X%zu", sizes[k]);
+}
+
+/*the ZC_ERRMAP_FIELD_COUNT fields, one after the other, each with the tiles in the order of the data*/
+void ZC_writeErrMap(ZC_ErrMap* map, char* tgtFilePath)
+{
+	ZC_writeDoubleData_inBytes(map->maxAbsErr, ZC_ERRMAP_FIELD_COUNT*map->nbTiles, tgtFilePath);
+}
+
+void ZC_freeErrMap(ZC_ErrMap* map)
+{
+	if(map==NULL)
+		return;
+	free(map->acc);
+	free(map->maxAbsErr); //holds all the fields
+	free(map);
+}
@@ -1,32 +1,497 @@
-#include "3rdParty/autocorr.h"
+/**
+ *  @file ZC_FFTW3_math.c
+ *  @brief Transforms computed by FFTW3, with the plans cached by shape.
+ *  (C) 2018 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <fftw3.h>
+#include "zc.h"
+#include "ZC_FFTW3_math.h"
 
 /**
- * Compute 3D auto correlation (calling the function implemented by Peter Linstrom)
- *  
+ * Cached pair of plans (forward r2c and, if needed, backward c2r) of one shape and precision.
+ * The plans are created on scratch arrays and executed on the arrays of each call with the
+ * new-array execute functions (all the arrays come from fftw_malloc(), so they have the
+ * alignment of the planning arrays).
  * */
- 
-double* autocorr_3d_double(double* input, size_t nx, size_t ny, size_t nz)
+typedef struct ZC_FFTWPlan
+{
+	int dataType; /*ZC_DOUBLE (fftw) or ZC_FLOAT (fftwf)*/
+	int rank;
+	int dims[3]; /*real sizes, the slowest dimension first*/
+	int inverse; /*1: the backward plan is needed*/
+	int nbThreads;
+	unsigned long lastUse;
+	fftw_plan forward;
+	fftw_plan backward;
+#ifdef HAVE_FFTW3F
+	fftwf_plan forwardf;
+	fftwf_plan backwardf;
+#endif
+} ZC_FFTWPlan;
+
+static ZC_FFTWPlan zc_fftwPlans[ZC_FFTW_PLAN_CACHE_SIZE];
+static int zc_fftwPlanCount = 0;
+static unsigned long zc_fftwClock = 0;
+static int zc_fftwReady = 0; /*threads initialized and wisdom imported*/
+
+static void ZC_prepareFFTW()
+{
+	if(zc_fftwReady)
+		return;
+#ifdef HAVE_FFTW3_THREADS
+	fftw_init_threads();
+#ifdef HAVE_FFTW3F
+	fftwf_init_threads();
+#endif
+#endif
+	if(fftwPlanner==ZC_FFTW_MEASURE && fftwWisdomFile!=NULL)
+	{
+		fftw_import_wisdom_from_filename(fftwWisdomFile);
+#ifdef HAVE_FFTW3F
+		char path[ZC_BUFS_LONG];
+		sprintf(path, "%s.f", fftwWisdomFile);
+		fftwf_import_wisdom_from_filename(path);
+#endif
+	}
+	zc_fftwReady = 1;
+}
+
+/*the wisdom of the new plans is saved for the next runs (fftwWisdomFile, and fftwWisdomFile.f for fftwf)*/
+static void ZC_saveFFTWWisdom(int dataType)
+{
+	if(fftwPlanner!=ZC_FFTW_MEASURE || fftwWisdomFile==NULL)
+		return;
+	if(dataType==ZC_DOUBLE)
+		fftw_export_wisdom_to_filename(fftwWisdomFile);
+#ifdef HAVE_FFTW3F
+	else
+	{
+		char path[ZC_BUFS_LONG];
+		sprintf(path, "%s.f", fftwWisdomFile);
+		fftwf_export_wisdom_to_filename(path);
+	}
+#endif
+}
+
+static void ZC_destroyFFTWPlan(ZC_FFTWPlan* p)
+{
+	if(p->dataType==ZC_DOUBLE)
+	{
+		fftw_destroy_plan(p->forward);
+		if(p->backward!=NULL)
+			fftw_destroy_plan(p->backward);
+	}
+#ifdef HAVE_FFTW3F
+	else
+	{
+		fftwf_destroy_plan(p->forwardf);
+		if(p->backwardf!=NULL)
+			fftwf_destroy_plan(p->backwardf);
+	}
+#endif
+}
+
+/**
+ * The plans of the real transform of the given shape (rank<=3, dims slowest first) in the
+ * precision of dataType, created on the first call and then taken from the cache, so repeated
+ * calls on the same shape (e.g., one per time step) have no planning cost. The least recently
+ * used plans are destroyed when the cache is full.
+ * */
+static ZC_FFTWPlan* ZC_getFFTWPlan(int dataType, int rank, int* dims, int inverse)
 {
-	double* output = (double*)malloc(sizeof(double)*nx*ny*nz);
-	autocorrelate3d(output, input, nx, ny, nz);
+	int i, k, threadCount;
+	size_t realSize = 1, complexSize;
+	ZC_FFTWPlan* p = NULL;
+	for(k=0;k<rank;k++)
+		realSize *= dims[k];
+	complexSize = realSize/dims[rank-1]*(dims[rank-1]/2+1);
+	threadCount = ZC_computeThreadCount(ZC_computeChunkCount(realSize));
+
+	for(i=0;i<zc_fftwPlanCount;i++)
+	{
+		ZC_FFTWPlan* q = &zc_fftwPlans[i];
+		if(q->dataType==dataType && q->rank==rank && q->inverse>=inverse && q->nbThreads==threadCount
+		&& memcmp(q->dims, dims, sizeof(int)*rank)==0)
+		{
+			q->lastUse = ++zc_fftwClock;
+			return q;
+		}
+	}
+
+	ZC_prepareFFTW();
+	if(zc_fftwPlanCount < ZC_FFTW_PLAN_CACHE_SIZE)
+		p = &zc_fftwPlans[zc_fftwPlanCount++];
+	else
+	{
+		p = &zc_fftwPlans[0];
+		for(i=1;i<ZC_FFTW_PLAN_CACHE_SIZE;i++)
+			if(zc_fftwPlans[i].lastUse < p->lastUse)
+				p = &zc_fftwPlans[i];
+		ZC_destroyFFTWPlan(p);
+	}
+	p->dataType = dataType;
+	p->rank = rank;
+	memcpy(p->dims, dims, sizeof(int)*rank);
+	p->inverse = inverse;
+	p->nbThreads = threadCount;
+	p->lastUse = ++zc_fftwClock;
+
+	unsigned flags = fftwPlanner==ZC_FFTW_MEASURE ? FFTW_MEASURE : FFTW_ESTIMATE;
+	if(dataType==ZC_DOUBLE)
+	{
+		double* f = (double*)fftw_malloc(sizeof(double)*realSize);
+		fftw_complex* g = (fftw_complex*)fftw_malloc(sizeof(fftw_complex)*complexSize);
+#ifdef HAVE_FFTW3_THREADS
+		fftw_plan_with_nthreads(threadCount);
+#endif
+		p->forward = fftw_plan_dft_r2c(rank, dims, f, g, flags);
+		p->backward = inverse ? fftw_plan_dft_c2r(rank, dims, g, f, flags) : NULL;
+		fftw_free(f);
+		fftw_free(g);
+	}
+#ifdef HAVE_FFTW3F
+	else
+	{
+		float* f = (float*)fftwf_malloc(sizeof(float)*realSize);
+		fftwf_complex* g = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex)*complexSize);
+#ifdef HAVE_FFTW3_THREADS
+		fftwf_plan_with_nthreads(threadCount);
+#endif
+		p->forwardf = fftwf_plan_dft_r2c(rank, dims, f, g, flags);
+		p->backwardf = inverse ? fftwf_plan_dft_c2r(rank, dims, g, f, flags) : NULL;
+		fftwf_free(f);
+		fftwf_free(g);
+	}
+#endif
+	ZC_saveFFTWWisdom(dataType);
+	return p;
+}
+
+/*destroy the cached plans (called by ZC_Finalize())*/
+void ZC_freeFFTWPlans()
+{
+	int i;
+	for(i=0;i<zc_fftwPlanCount;i++)
+		ZC_destroyFFTWPlan(&zc_fftwPlans[i]);
+	zc_fftwPlanCount = 0;
+	if(zc_fftwReady)
+	{
+#ifdef HAVE_FFTW3_THREADS
+		fftw_cleanup_threads();
+#ifdef HAVE_FFTW3F
+		fftwf_cleanup_threads();
+#endif
+#else
+		fftw_cleanup();
+#ifdef HAVE_FFTW3F
+		fftwf_cleanup();
+#endif
+#endif
+		zc_fftwReady = 0;
+	}
+}
+
+/*mean and 1/sqrt(n*variance) of the nbEle values of input (ZC_FLOAT or ZC_DOUBLE)*/
+static void ZC_computeAutocorrNorm(void* input, int dataType, size_t nbEle, double* mean, double* scale)
+{
+	size_t i;
+	double val, u = 0, s = 0;
+	for(i=0;i<nbEle;i++)
+	{
+		val = dataType==ZC_FLOAT ? ((float*)input)[i] : ((double*)input)[i];
+		u += val;
+		s += val*val;
+	}
+	u /= nbEle;
+	s /= nbEle;
+	s -= u*u;
+	// guard against round-off error
+	if (s < 0)
+		s = 0;
+	*mean = u;
+	*scale = 1/sqrt(nbEle*s);
+}
+
+/**
+ * 3D autocorrelation of input[nz][ny][nx] (ZC_FLOAT or ZC_DOUBLE), as autocorrelate3d()
+ * of 3rdParty/autocorr.h (Peter Lindstrom): the normalized data are zero-padded to
+ * (2nz)x(2ny)x(2nx), transformed, squared in magnitude and transformed back, the
+ * zero lag being at output[nz/2][ny/2][nx/2]. The output has the type of the input;
+ * the float data are transformed in single precision when fftwf is available.
+ * */
+static void* ZC_autocorr3D(void* input, int dataType, size_t nx, size_t ny, size_t nz)
+{
+	size_t x, y, z, i, j, k, n = nx*ny*nz;
+	size_t realSize = 8*n, complexSize = 4*(nx+1)*ny*nz;
+	int dims[3] = {(int)(2*nz), (int)(2*ny), (int)(2*nx)};
+	double u, q;
+	ZC_computeAutocorrNorm(input, dataType, n, &u, &q);
+#ifdef HAVE_FFTW3F
+	if(dataType==ZC_FLOAT)
+	{
+		float* data = (float*)input;
+		float* output = (float*)malloc(sizeof(float)*n);
+		ZC_FFTWPlan* p = ZC_getFFTWPlan(ZC_FLOAT, 3, dims, 1);
+		float* f = (float*)fftwf_malloc(sizeof(float)*realSize);
+		fftwf_complex* g = (fftwf_complex*)fftwf_malloc(sizeof(fftwf_complex)*complexSize);
+		memset(f, 0, sizeof(float)*realSize);
+		for (z = 0; z < nz; z++)
+			for (y = 0; y < ny; y++)
+				for (x = 0; x < nx; x++)
+					f[x + 2 * nx * (y + 2 * ny * z)] = (data[x + nx * (y + ny * z)] - u) * q;
+		fftwf_execute_dft_r2c(p->forwardf, f, g);
+		for (i = 0; i < complexSize; i++)
+		{
+			g[i][0] = g[i][0] * g[i][0] + g[i][1] * g[i][1];
+			g[i][1] = 0;
+		}
+		fftwf_execute_dft_c2r(p->backwardf, g, f);
+		for (k = 0; k < nz; k++) {
+			z = (2 * nz + k - nz / 2) % (2 * nz);
+			for (j = 0; j < ny; j++) {
+				y = (2 * ny + j - ny / 2) % (2 * ny);
+				for (i = 0; i < nx; i++) {
+					x = (2 * nx + i - nx / 2) % (2 * nx);
+					output[i + nx * (j + ny * k)] = f[x + 2 * nx * (y + 2 * ny * z)] / (8 * n);
+				}
+			}
+		}
+		fftwf_free(f);
+		fftwf_free(g);
+		return output;
+	}
+#endif
+	ZC_FFTWPlan* p = ZC_getFFTWPlan(ZC_DOUBLE, 3, dims, 1);
+	double* f = (double*)fftw_malloc(sizeof(double)*realSize);
+	fftw_complex* g = (fftw_complex*)fftw_malloc(sizeof(fftw_complex)*complexSize);
+	memset(f, 0, sizeof(double)*realSize);
+	for (z = 0; z < nz; z++)
+		for (y = 0; y < ny; y++)
+			for (x = 0; x < nx; x++)
+			{
+				i = x + nx * (y + ny * z);
+				f[x + 2 * nx * (y + 2 * ny * z)] = ((dataType==ZC_FLOAT ? ((float*)input)[i] : ((double*)input)[i]) - u) * q;
+			}
+	fftw_execute_dft_r2c(p->forward, f, g);
+	for (i = 0; i < complexSize; i++)
+	{
+		g[i][0] = g[i][0] * g[i][0] + g[i][1] * g[i][1];
+		g[i][1] = 0;
+	}
+	fftw_execute_dft_c2r(p->backward, g, f);
+	void* output = malloc((dataType==ZC_FLOAT ? sizeof(float) : sizeof(double))*n);
+	for (k = 0; k < nz; k++) {
+		z = (2 * nz + k - nz / 2) % (2 * nz);
+		for (j = 0; j < ny; j++) {
+			y = (2 * ny + j - ny / 2) % (2 * ny);
+			for (i = 0; i < nx; i++) {
+				x = (2 * nx + i - nx / 2) % (2 * nx);
+				double val = f[x + 2 * nx * (y + 2 * ny * z)] / (8 * n);
+				if(dataType==ZC_FLOAT)
+					((float*)output)[i + nx * (j + ny * k)] = val;
+				else
+					((double*)output)[i + nx * (j + ny * k)] = val;
+			}
+		}
+	}
+	fftw_free(f);
+	fftw_free(g);
 	return output;
 }
 
+/*smallest size >= n whose prime factors are 2, 3, 5 and 7 (fast FFTW transforms)*/
+static size_t ZC_getFFTWSize(size_t n)
+{
+	size_t m, size = n;
+	for(;;size++)
+	{
+		m = size;
+		while(m%2==0) m /= 2;
+		while(m%3==0) m /= 3;
+		while(m%5==0) m /= 5;
+		while(m%7==0) m /= 7;
+		if(m==1)
+			return size;
+	}
+}
+
+/*normalized values of the planes [z, z+count) of input (ZC_FLOAT or ZC_DOUBLE) in the planes of f (row 
+ *length px, plane size px*py); the planes out of [0, nz) are zeros*/
+static void ZC_fillAutocorrSlab(double* f, void* input, int dataType, size_t nx, size_t ny, long nz,
+long z, size_t count, size_t px, size_t py, double u, double q)
+{
+	size_t x, y, k;
+	for (k = 0; k < count; k++)
+	{
+		double* plane = f + k*px*py;
+		if(z+(long)k < 0 || z+(long)k >= nz)
+			continue;
+		for (y = 0; y < ny; y++)
+		{
+			size_t i = nx * (y + ny * (z + k));
+			for (x = 0; x < nx; x++)
+				plane[x + px * y] = ((dataType==ZC_FLOAT ? ((float*)input)[i+x] : ((double*)input)[i+x]) - u) * q;
+		}
+	}
+}
+
+/**
+ * Bounded-lag 3D autocorrelation of input[nz][ny][nx] (ZC_FLOAT or ZC_DOUBLE): the same
+ * normalized correlations as ZC_autocorr3D(), but only for the lags -L..L of each axis
+ * (L = min(maxLag, n-1)), i.e., an output of (2Lx+1)x(2Ly+1)x(2Lz+1) values, the zero lag
+ * being in the middle.
+ * 
+ * The data are streamed by z-slabs of S = ZC_AUTOCORR3D_SLAB_LAGS*Lz planes: the slab
+ * (A) and the slab with Lz planes of halo on each side (B) are padded by the max lags only
+ * (to (nx+Lx)x(ny+Ly)x(S+2Lz), rounded up to fast FFT sizes), so the circular correlation
+ * of A and B gives the linear one for the requested lags. The lag correlation does not
+ * depend on the position of the slab, so the products conj(FA)*FB are summed over the slabs
+ * and transformed back once. The memory is about 4 slabs with their halos, instead of
+ * 16 times the whole data.
+ * */
+static void* ZC_autocorrLags3D(void* input, int dataType, size_t nx, size_t ny, size_t nz, int maxLag)
+{
+	size_t lx = (size_t)maxLag < nx ? (size_t)maxLag : nx-1;
+	size_t ly = (size_t)maxLag < ny ? (size_t)maxLag : ny-1;
+	size_t lz = (size_t)maxLag < nz ? (size_t)maxLag : nz-1;
+	size_t slab = ZC_AUTOCORR3D_SLAB_LAGS*lz < nz && lz > 0 ? ZC_AUTOCORR3D_SLAB_LAGS*lz : nz;
+	size_t px = ZC_getFFTWSize(nx+lx), py = ZC_getFFTWSize(ny+ly), pz = ZC_getFFTWSize(slab+2*lz);
+	size_t realSize = px*py*pz, complexSize = (px/2+1)*py*pz, ox = 2*lx+1, oy = 2*ly+1, oz = 2*lz+1;
+	size_t i, j, k, z0, n = nx*ny*nz;
+	int dims[3] = {(int)pz, (int)py, (int)px};
+	double u, q;
+	ZC_computeAutocorrNorm(input, dataType, n, &u, &q);
+
+	ZC_FFTWPlan* p = ZC_getFFTWPlan(ZC_DOUBLE, 3, dims, 1);
+	double* a = (double*)fftw_malloc(sizeof(double)*realSize);
+	double* b = (double*)fftw_malloc(sizeof(double)*realSize);
+	fftw_complex* fa = (fftw_complex*)fftw_malloc(sizeof(fftw_complex)*complexSize);
+	fftw_complex* fb = (fftw_complex*)fftw_malloc(sizeof(fftw_complex)*complexSize);
+	fftw_complex* sum = (fftw_complex*)fftw_malloc(sizeof(fftw_complex)*complexSize);
+	memset(sum, 0, sizeof(fftw_complex)*complexSize);
+	for (z0 = 0; z0 < nz; z0 += slab)
+	{
+		size_t count = z0+slab <= nz ? slab : nz-z0;
+		memset(a, 0, sizeof(double)*realSize);
+		memset(b, 0, sizeof(double)*realSize);
+		ZC_fillAutocorrSlab(a+lz*px*py, input, dataType, nx, ny, nz, z0, count, px, py, u, q);
+		ZC_fillAutocorrSlab(b, input, dataType, nx, ny, nz, (long)z0-(long)lz, count+2*lz, px, py, u, q);
+		fftw_execute_dft_r2c(p->forward, a, fa);
+		fftw_execute_dft_r2c(p->forward, b, fb);
+		for (i = 0; i < complexSize; i++)
+		{
+			//conj(fa)*fb
+			sum[i][0] += fa[i][0] * fb[i][0] + fa[i][1] * fb[i][1];
+			sum[i][1] += fa[i][0] * fb[i][1] - fa[i][1] * fb[i][0];
+		}
+	}
+	fftw_execute_dft_c2r(p->backward, sum, a);
+
+	void* output = malloc((dataType==ZC_FLOAT ? sizeof(float) : sizeof(double))*ox*oy*oz);
+	for (k = 0; k < oz; k++)
+	{
+		size_t z = (pz + k - lz) % pz;
+		for (j = 0; j < oy; j++)
+		{
+			size_t y = (py + j - ly) % py;
+			for (i = 0; i < ox; i++)
+			{
+				size_t x = (px + i - lx) % px;
+				double val = a[x + px * (y + py * z)] / realSize;
+				if(dataType==ZC_FLOAT)
+					((float*)output)[i + ox * (j + oy * k)] = val;
+				else
+					((double*)output)[i + ox * (j + oy * k)] = val;
+			}
+		}
+	}
+	fftw_free(a);
+	fftw_free(b);
+	fftw_free(fa);
+	fftw_free(fb);
+	fftw_free(sum);
+	return output;
+}
+
+/**
+ * Compute 3D auto correlation (the algorithm of Peter Lindstrom, see 3rdParty/autocorr.h)
+ * of the whole volume, or only of the lags up to autocorr3DMaxLag if it is positive 
+ * (see ZC_getAutocorr3DLength() for the number of output values).
+ * */
+
+double* autocorr_3d_double(double* input, size_t nx, size_t ny, size_t nz)
+{
+	if(autocorr3DMaxLag > 0)
+		return (double*)ZC_autocorrLags3D(input, ZC_DOUBLE, nx, ny, nz, autocorr3DMaxLag);
+	return (double*)ZC_autocorr3D(input, ZC_DOUBLE, nx, ny, nz);
+}
+
 float* autocorr_3d_float(float* input, size_t nx, size_t ny, size_t nz)
 {
-	size_t i, nbEle = nx*ny*nz;
-	double* output = (double*)malloc(sizeof(double)*nbEle);
-	double* input2 = (double*)malloc(sizeof(double)*nbEle);
-	for(i=0;i<nbEle;i++)
-		input2[i] = input[i];
-	
-	autocorrelate3d(output, input2, nx, ny, nz);
-	free(input2);
-	float* output2 = (float*)malloc(sizeof(float)*nbEle);
-	for(i=0;i<nbEle;i++)
-		output2[i] = output[i];
-	free(output);
-	return output2;
+	if(autocorr3DMaxLag > 0)
+		return (float*)ZC_autocorrLags3D(input, ZC_FLOAT, nx, ny, nz, autocorr3DMaxLag);
+	return (float*)ZC_autocorr3D(input, ZC_FLOAT, nx, ny, nz);
+}
+
+/**
+ * Lag sums of a 1D series by the convolution theorem: lagSums[delta] = sum of
+ * input[i]*input[i+delta] for delta=0..maxLag. The series is zero-padded to a
+ * power of two >= n+maxLag, so that the circular correlation equals the linear one
+ * for the requested lags.
+ * */
+void autocorr_1d_lagSums(double* input, size_t n, int maxLag, double* lagSums)
+{
+	size_t i, nfft = 1;
+	int delta;
+	while(nfft < n + maxLag)
+		nfft *= 2;
+	int dims[1] = {(int)nfft};
+	ZC_FFTWPlan* p = ZC_getFFTWPlan(ZC_DOUBLE, 1, dims, 1);
+	double* f = (double*)fftw_malloc(sizeof(double)*nfft);
+	fftw_complex* g = (fftw_complex*)fftw_malloc(sizeof(fftw_complex)*(nfft/2+1));
+
+	memcpy(f, input, sizeof(double)*n);
+	memset(f+n, 0, sizeof(double)*(nfft-n));
+	fftw_execute_dft_r2c(p->forward, f, g);
+	for(i = 0; i < nfft/2+1; i++)
+	{
+		g[i][0] = g[i][0]*g[i][0] + g[i][1]*g[i][1];
+		g[i][1] = 0;
+	}
+	fftw_execute_dft_c2r(p->backward, g, f);
+	for(delta = 0; delta <= maxLag; delta++)
+		lagSums[delta] = f[delta]/nfft;
+
+	fftw_free(f);
+	fftw_free(g);
 }
 
+/**
+ * The first n/2+1 coefficients of the forward transform of the n real values of input,
+ * split into their real and imaginary parts.
+ * */
+void fft_r2c_1d(double* input, size_t n, double* re, double* im)
+{
+	size_t i;
+	int dims[1] = {(int)n};
+	ZC_FFTWPlan* p = ZC_getFFTWPlan(ZC_DOUBLE, 1, dims, 0);
+	double* f = (double*)fftw_malloc(sizeof(double)*n);
+	fftw_complex* g = (fftw_complex*)fftw_malloc(sizeof(fftw_complex)*(n/2+1));
+
+	memcpy(f, input, sizeof(double)*n);
+	fftw_execute_dft_r2c(p->forward, f, g);
+	for(i = 0; i < n/2+1; i++)
+	{
+		re[i] = g[i][0];
+		im[i] = g[i][1];
+	}
 
+	fftw_free(f);
+	fftw_free(g);
+}
@@ -0,0 +1,460 @@
+/**
+ *  @file ZC_PropertyAccumulator.c
+ *  @brief Streaming properties of time-stepped data (e.g., in situ analysis of a simulation).
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include "zc.h"
+#include "ZC_autocorr.h"
+#include "ZC_PropertyAccumulator.h"
+
+void ZC_initTemporalStat(ZC_TemporalStat* stat)
+{
+	memset(stat, 0, sizeof(ZC_TemporalStat));
+}
+
+void ZC_updateTemporalStat(ZC_TemporalStat* stat, double value)
+{
+	double t = stat->nbSteps, d = value - stat->mean;
+	if(stat->nbSteps==0)
+	{
+		stat->min = value;
+		stat->max = value;
+		stat->first = value;
+	}
+	stat->nbSteps++;
+	stat->mean += d/stat->nbSteps;
+	stat->m2 += d*(value - stat->mean);
+	if(stat->min>value) stat->min = value;
+	if(stat->max<value) stat->max = value;
+	stat->last = value;
+	stat->sumT += t;
+	stat->sumTT += t*t;
+	stat->sumTY += t*value;
+}
+
+/**
+ * Merge b into a (Chan et al.), the steps of b following those of a:
+ * the step indices of b are shifted by a->nbSteps for the drift.
+ * */
+void ZC_mergeTemporalStat(ZC_TemporalStat* a, ZC_TemporalStat* b)
+{
+	double na = a->nbSteps, nb = b->nbSteps, n = na + nb;
+	if(b->nbSteps==0)
+		return;
+	if(a->nbSteps==0)
+	{
+		*a = *b;
+		return;
+	}
+	double d = b->mean - a->mean;
+	a->sumTY += b->sumTY + na*nb*b->mean;
+	a->sumTT += b->sumTT + 2*na*b->sumT + nb*na*na;
+	a->sumT += b->sumT + nb*na;
+	a->mean += d*nb/n;
+	a->m2 += b->m2 + d*d*na*nb/n;
+	if(a->min>b->min) a->min = b->min;
+	if(a->max<b->max) a->max = b->max;
+	a->last = b->last;
+	a->nbSteps += b->nbSteps;
+}
+
+double ZC_getTemporalVariance(ZC_TemporalStat* stat)
+{
+	return stat->nbSteps==0 ? 0 : stat->m2/stat->nbSteps;
+}
+
+/*slope of the least-squares line of the values against the step index (change per step)*/
+double ZC_getTemporalDrift(ZC_TemporalStat* stat)
+{
+	double n = stat->nbSteps;
+	double varT = stat->sumTT - stat->sumT*stat->sumT/n;
+	if(stat->nbSteps < 2 || varT == 0)
+		return 0;
+	return (stat->sumTY - stat->sumT*stat->mean)/varT;
+}
+
+ZC_PropertyAccumulator* ZC_initPropertyAccumulator(char* varName, int dataType, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
+{
+	int delta;
+	size_t i, numOfElem = ZC_computeDataLength(r5, r4, r3, r2, r1);
+	if(dataType!=ZC_FLOAT && dataType!=ZC_DOUBLE)
+	{
+		printf("Error: dataType is wrong in ZC_initPropertyAccumulator().\n");
+		exit(0);
+	}
+	if(numOfElem==0)
+	{
+		printf("Error: the data are empty in ZC_initPropertyAccumulator().\n");
+		exit(0);
+	}
+	ZC_PropertyAccumulator* acc = (ZC_PropertyAccumulator*)malloc(sizeof(ZC_PropertyAccumulator));
+	memset(acc, 0, sizeof(ZC_PropertyAccumulator));
+	acc->dataType = dataType;
+	acc->numOfElem = numOfElem;
+	acc->maxLag = autocorrFlag && numOfElem > AUTOCORR_SIZE ? AUTOCORR_SIZE : 0;
+
+	acc->mean = (double*)malloc(sizeof(double)*numOfElem);
+	acc->m2 = (double*)malloc(sizeof(double)*numOfElem);
+	acc->minEnvelope = (double*)malloc(sizeof(double)*numOfElem);
+	acc->maxEnvelope = (double*)malloc(sizeof(double)*numOfElem);
+	for(i=0;i<numOfElem;i++)
+	{
+		acc->mean[i] = 0;
+		acc->m2[i] = 0;
+	}
+
+	ZC_DataProperty* property = (ZC_DataProperty*)malloc(sizeof(ZC_DataProperty));
+	memset(property, 0, sizeof(ZC_DataProperty));
+	char* varN = rmFileExtension(varName);
+	property->varName = (char*)malloc(strlen(varN)+1);
+	strcpy(property->varName, varN);
+	free(varN);
+	property->dataType = dataType;
+	property->r5 = r5;
+	property->r4 = r4;
+	property->r3 = r3;
+	property->r2 = r2;
+	property->r1 = r1;
+	property->numOfElem = numOfElem;
+	if(acc->maxLag > 0)
+		property->autocorr = (double*)malloc(sizeof(double)*(AUTOCORR_SIZE+1));
+	acc->property = property;
+
+	ZC_initTemporalStat(&acc->minValue);
+	ZC_initTemporalStat(&acc->maxValue);
+	ZC_initTemporalStat(&acc->avgValue);
+	ZC_initTemporalStat(&acc->variance);
+	ZC_initTemporalStat(&acc->entropy);
+	acc->autocorr = (ZC_TemporalStat*)malloc(sizeof(ZC_TemporalStat)*(acc->maxLag+1));
+	for(delta=0;delta<=acc->maxLag;delta++)
+		ZC_initTemporalStat(&acc->autocorr[delta]);
+
+	acc->nbChunks = ZC_computeChunkCount(numOfElem);
+	acc->partials = (double*)malloc(sizeof(double)*(acc->maxLag+2)*acc->nbChunks);
+	acc->extrema = (double*)malloc(sizeof(double)*2*acc->nbChunks);
+	acc->sums = (double*)malloc(sizeof(double)*ZC_ACC_SUMS_SIZE(acc->maxLag));
+	return acc;
+}
+
+/**
+ * Called by ZC_updatePropertyAccumulator_float/double before the pass over the data:
+ * the work space only grows with the number of threads, so the steps do not allocate memory once it is warmed up.
+ * */
+void ZC_prepareAccumulatorStep(ZC_PropertyAccumulator* acc, void* data)
+{
+	int threadCount = ZC_computeThreadCount(acc->nbChunks);
+	if(acc->nbTables < threadCount)
+	{
+		free(acc->tables);
+		free(acc->tiles);
+		acc->tables = (long*)malloc(sizeof(long)*ZC_BYTE_SUBTABLES*256*threadCount);
+		acc->tiles = (double*)malloc(sizeof(double)*(acc->maxLag+ZC_LAG_TILE_SIZE)*threadCount);
+		acc->nbTables = threadCount;
+	}
+	memset(acc->tables, 0, sizeof(long)*ZC_BYTE_SUBTABLES*256*acc->nbTables);
+	ZC_getKernels(); //select the kernels before starting the threads
+	acc->data = data;
+	if(acc->nbSteps==0)
+	{
+		//any value close to the data would do: the first value (of the first rank)
+		acc->pilot = acc->dataType==ZC_FLOAT ? ((float*)data)[0] : ((double*)data)[0];
+#ifdef HAVE_MPI
+		if(executionMode==ZC_ONLINE)
+			MPI_Bcast(&acc->pilot, 1, MPI_DOUBLE, 0, ZC_COMM_WORLD);
+#endif
+	}
+}
+
+/**
+ * Called once the local step sums (acc->sums, without the byte histogram) and the local
+ * extrema (acc->property->minValue/maxValue) are ready: reduces them over the ranks
+ * (two collectives per step), derives the properties of the step and updates their statistics.
+ * The lag sums are centered as in ZC_computeCenteredLagSums().
+ * */
+void ZC_finishAccumulatorStep(ZC_PropertyAccumulator* acc)
+{
+	int t, b, delta, L = acc->maxLag;
+	double* sums = acc->sums;
+	double* hist = sums + ZC_ACC_PROD + 2*(L+1);
+	ZC_DataProperty* property = acc->property;
+	for(b=0;b<256;b++)
+	{
+		long count = 0;
+		for(t=0;t<acc->nbTables*ZC_BYTE_SUBTABLES;t++)
+			count += acc->tables[t*256+b];
+		hist[b] = count;
+	}
+#ifdef HAVE_MPI
+	if(executionMode==ZC_ONLINE)
+	{
+		double extrema[2] = {-property->minValue, property->maxValue};
+		MPI_Allreduce(MPI_IN_PLACE, sums, ZC_ACC_SUMS_SIZE(L), MPI_DOUBLE, MPI_SUM, ZC_COMM_WORLD);
+		MPI_Allreduce(MPI_IN_PLACE, extrema, 2, MPI_DOUBLE, MPI_MAX, ZC_COMM_WORLD);
+		property->minValue = -extrema[0];
+		property->maxValue = extrema[1];
+	}
+#endif
+	double n = sums[ZC_ACC_COUNT], parts = sums[ZC_ACC_PARTS], sum = sums[ZC_ACC_SUM];
+	double e = sum/n; //average - pilot
+	double med = (property->minValue + (property->maxValue - property->minValue)/2) - acc->pilot;
+	double* prod = sums + ZC_ACC_PROD;
+	double* sumAB = prod + L + 1; //sum of y[i], i<n-delta, plus sum of y[i], i>=delta
+
+	property->numOfElem = n;
+	property->avgValue = acc->pilot + e;
+	property->valueRange = property->maxValue - property->minValue;
+	property->zeromean_variance = (prod[0] - 2*med*sum + n*med*med)/n;
+	double var = (prod[0] - e*sumAB[0] + n*e*e)/n;
+	if(var < 0)
+		var = 0;
+
+	double entVal = 0, totalLen = n*(acc->dataType==ZC_FLOAT ? sizeof(float) : sizeof(double));
+	for(b=0;b<256;b++)
+		if(hist[b] != 0)
+		{
+			double prob = hist[b]/totalLen;
+			entVal -= prob*log(prob)/log(2);
+		}
+	property->entropy = entVal;
+
+	if(L > 0)
+	{
+		property->autocorr[0] = 1;
+		for(delta=1;delta<=L;delta++)
+		{
+			double lagSum = prod[delta] - e*sumAB[delta] + (n-parts*delta)*e*e;
+			property->autocorr[delta] = var == 0 ? 0 : lagSum/(n-parts*delta)/var;
+			ZC_updateTemporalStat(&acc->autocorr[delta], property->autocorr[delta]);
+		}
+	}
+	ZC_updateTemporalStat(&acc->minValue, property->minValue);
+	ZC_updateTemporalStat(&acc->maxValue, property->maxValue);
+	ZC_updateTemporalStat(&acc->avgValue, property->avgValue);
+	ZC_updateTemporalStat(&acc->variance, var);
+	ZC_updateTemporalStat(&acc->entropy, property->entropy);
+
+	acc->pilot = property->avgValue;
+	acc->data = NULL;
+	acc->nbSteps++;
+}
+
+/**
+ * Accumulate one time step of the data (acc->numOfElem points): one pass over the data,
+ * plus, in the online mode, two collectives for the properties of the global field.
+ * */
+void ZC_updatePropertyAccumulator(ZC_PropertyAccumulator* acc, void* data)
+{
+	if(acc->dataType==ZC_FLOAT)
+		ZC_updatePropertyAccumulator_float(acc, (float*)data);
+	else
+		ZC_updatePropertyAccumulator_double(acc, (double*)data);
+}
+
+/**
+ * Merge the accumulator b into a: both cover the same points, and the steps of b follow
+ * those of a (e.g., two parts of a run analyzed separately, or an analysis restarted from a checkpoint).
+ * */
+void ZC_mergePropertyAccumulator(ZC_PropertyAccumulator* a, ZC_PropertyAccumulator* b)
+{
+	size_t i;
+	int delta;
+	if(a->numOfElem!=b->numOfElem || a->dataType!=b->dataType || a->maxLag!=b->maxLag)
+	{
+		printf("Error: the accumulators do not match in ZC_mergePropertyAccumulator().\n");
+		exit(0);
+	}
+	if(b->nbSteps==0)
+		return;
+	double na = a->nbSteps, nb = b->nbSteps, n = na + nb;
+	for(i=0;i<a->numOfElem;i++)
+	{
+		double d = b->mean[i] - a->mean[i];
+		if(a->nbSteps==0)
+		{
+			a->minEnvelope[i] = b->minEnvelope[i];
+			a->maxEnvelope[i] = b->maxEnvelope[i];
+		}
+		a->mean[i] += d*nb/n;
+		a->m2[i] += b->m2[i] + d*d*na*nb/n;
+		if(a->minEnvelope[i]>b->minEnvelope[i]) a->minEnvelope[i] = b->minEnvelope[i];
+		if(a->maxEnvelope[i]<b->maxEnvelope[i]) a->maxEnvelope[i] = b->maxEnvelope[i];
+	}
+	ZC_mergeTemporalStat(&a->minValue, &b->minValue);
+	ZC_mergeTemporalStat(&a->maxValue, &b->maxValue);
+	ZC_mergeTemporalStat(&a->avgValue, &b->avgValue);
+	ZC_mergeTemporalStat(&a->variance, &b->variance);
+	ZC_mergeTemporalStat(&a->entropy, &b->entropy);
+	for(delta=1;delta<=a->maxLag;delta++)
+		ZC_mergeTemporalStat(&a->autocorr[delta], &b->autocorr[delta]);
+
+	//the last step is that of b
+	ZC_DataProperty* pa = a->property;
+	ZC_DataProperty* pb = b->property;
+	pa->numOfElem = pb->numOfElem;
+	pa->minValue = pb->minValue;
+	pa->maxValue = pb->maxValue;
+	pa->valueRange = pb->valueRange;
+	pa->avgValue = pb->avgValue;
+	pa->entropy = pb->entropy;
+	pa->zeromean_variance = pb->zeromean_variance;
+	if(a->maxLag > 0)
+		memcpy(pa->autocorr, pb->autocorr, sizeof(double)*(AUTOCORR_SIZE+1));
+	a->pilot = b->pilot;
+	a->nbSteps += b->nbSteps;
+}
+
+/**
+ * Properties of the last step accumulated, named stepName (e.g., to write them with 
+ * ZC_writeDataProperty()), so that a step needs no other pass over the data than that of 
+ * ZC_updatePropertyAccumulator(). Returns a new ZC_DataProperty (to be freed by 
+ * freeDataProperty_internal()) with data = NULL, without FFT and Laplacian.
+ * */
+ZC_DataProperty* ZC_getAccumulatorStepProperty(ZC_PropertyAccumulator* acc, char* stepName)
+{
+	ZC_DataProperty* p = acc->property;
+	ZC_DataProperty* property = (ZC_DataProperty*)malloc(sizeof(ZC_DataProperty));
+	memcpy(property, p, sizeof(ZC_DataProperty));
+	char* varN = rmFileExtension(stepName);
+	property->varName = (char*)malloc(strlen(varN)+1);
+	strcpy(property->varName, varN);
+	free(varN);
+	if(p->autocorr!=NULL)
+	{
+		property->autocorr = (double*)malloc(sizeof(double)*(AUTOCORR_SIZE+1));
+		memcpy(property->autocorr, p->autocorr, sizeof(double)*(AUTOCORR_SIZE+1));
+	}
+	return property;
+}
+
+/**
+ * Properties of the field over all the steps: the envelope of the values, and the
+ * average over the steps of the average, entropy, zeromean_variance and autocorrelation.
+ * Returns a new ZC_DataProperty (to be freed by freeDataProperty_internal()) with data = NULL.
+ * */
+ZC_DataProperty* ZC_finalizePropertyAccumulator(ZC_PropertyAccumulator* acc)
+{
+	int delta;
+	ZC_DataProperty* p = acc->property;
+	ZC_DataProperty* property = (ZC_DataProperty*)malloc(sizeof(ZC_DataProperty));
+	memset(property, 0, sizeof(ZC_DataProperty));
+	property->varName = (char*)malloc(strlen(p->varName)+1);
+	strcpy(property->varName, p->varName);
+	property->dataType = p->dataType;
+	property->r5 = p->r5;
+	property->r4 = p->r4;
+	property->r3 = p->r3;
+	property->r2 = p->r2;
+	property->r1 = p->r1;
+	property->numOfElem = p->numOfElem;
+	property->minValue = acc->minValue.min;
+	property->maxValue = acc->maxValue.max;
+	property->valueRange = property->maxValue - property->minValue;
+	property->avgValue = acc->avgValue.mean;
+	property->entropy = acc->entropy.mean;
+	property->zeromean_variance = acc->variance.mean;
+	if(acc->maxLag > 0)
+	{
+		property->autocorr = (double*)malloc(sizeof(double)*(AUTOCORR_SIZE+1));
+		property->autocorr[0] = 1;
+		for(delta=1;delta<=acc->maxLag;delta++)
+			property->autocorr[delta] = acc->autocorr[delta].mean;
+	}
+	return property;
+}
+
+static void ZC_constructTemporalStatString(char* s, const char* name, ZC_TemporalStat* stat)
+{
+	sprintf(s, "%s %.10G %.10G %.10G %.10G %.10G %.10G %.10G\n", name, stat->mean, sqrt(ZC_getTemporalVariance(stat)),
+	stat->min, stat->max, stat->first, stat->last, ZC_getTemporalDrift(stat));
+}
+
+/**
+ * Write the statistics over the steps of the properties of the field into tgtWorkspaceDir/varName.tprop:
+ * one line per property (the autocorrelation for each lag), with its mean, standard deviation,
+ * min, max, first and last values, and drift per step.
+ * */
+void ZC_writePropertyAccumulator(ZC_PropertyAccumulator* acc, char* tgtWorkspaceDir)
+{
+	int i, delta, nbLines = 7 + acc->maxLag;
+	char tgtFilePath[ZC_BUFS], name[32];
+	char** s = (char**)malloc(sizeof(char*)*nbLines);
+	for(i=0;i<nbLines;i++)
+		s[i] = (char*)malloc(sizeof(char)*ZC_BUFS);
+	sprintf(s[0], "#steps = %zu\n", acc->nbSteps);
+	sprintf(s[1], "#property mean std min max first last drift\n");
+	ZC_constructTemporalStatString(s[2], "minValue", &acc->minValue);
+	ZC_constructTemporalStatString(s[3], "maxValue", &acc->maxValue);
+	ZC_constructTemporalStatString(s[4], "avgValue", &acc->avgValue);
+	ZC_constructTemporalStatString(s[5], "variance", &acc->variance);
+	ZC_constructTemporalStatString(s[6], "entropy", &acc->entropy);
+	for(delta=1;delta<=acc->maxLag;delta++)
+	{
+		sprintf(name, "autocorr_%d", delta);
+		ZC_constructTemporalStatString(s[6+delta], name, &acc->autocorr[delta]);
+	}
+
+	DIR *dir = opendir(tgtWorkspaceDir);
+	if(dir==NULL)
+		mkdir(tgtWorkspaceDir,0775);
+	else
+		closedir(dir);
+	sprintf(tgtFilePath, "%s/%s.tprop", tgtWorkspaceDir, acc->property->varName);
+	ZC_writeStrings(nbLines, s, tgtFilePath);
+	for(i=0;i<nbLines;i++)
+		free(s[i]);
+	free(s);
+}
+
+/**
+ * Write the temporal mean, variance, min and max of each (local) point into
+ * tgtWorkspaceDir/varName.tmean, .tvar, .tmin and .tmax (binary doubles).
+ * */
+void ZC_writeTemporalPointStat(ZC_PropertyAccumulator* acc, char* tgtWorkspaceDir)
+{
+	size_t i, n = acc->numOfElem;
+	char tgtFilePath[ZC_BUFS];
+	char* varName = acc->property->varName;
+	DIR *dir = opendir(tgtWorkspaceDir);
+	if(dir==NULL)
+		mkdir(tgtWorkspaceDir,0775);
+	else
+		closedir(dir);
+	sprintf(tgtFilePath, "%s/%s.tmean", tgtWorkspaceDir, varName);
+	ZC_writeDoubleData_inBytes(acc->mean, n, tgtFilePath);
+	double* var = (double*)malloc(sizeof(double)*n);
+	for(i=0;i<n;i++)
+		var[i] = acc->nbSteps==0 ? 0 : acc->m2[i]/acc->nbSteps;
+	sprintf(tgtFilePath, "%s/%s.tvar", tgtWorkspaceDir, varName);
+	ZC_writeDoubleData_inBytes(var, n, tgtFilePath);
+	free(var);
+	sprintf(tgtFilePath, "%s/%s.tmin", tgtWorkspaceDir, varName);
+	ZC_writeDoubleData_inBytes(acc->minEnvelope, n, tgtFilePath);
+	sprintf(tgtFilePath, "%s/%s.tmax", tgtWorkspaceDir, varName);
+	ZC_writeDoubleData_inBytes(acc->maxEnvelope, n, tgtFilePath);
+}
+
+void ZC_freePropertyAccumulator(ZC_PropertyAccumulator* acc)
+{
+	if(acc==NULL)
+		return;
+	free(acc->mean);
+	free(acc->m2);
+	free(acc->minEnvelope);
+	free(acc->maxEnvelope);
+	freeDataProperty_internal(acc->property);
+	free(acc->autocorr);
+	free(acc->partials);
+	free(acc->extrema);
+	free(acc->sums);
+	free(acc->tables);
+	free(acc->tiles);
+	free(acc);
+}
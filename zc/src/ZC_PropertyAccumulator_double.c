@@ -0,0 +1,94 @@
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "zc.h"
+#include "ZC_autocorr.h"
+#include "ZC_PropertyAccumulator.h"
+
+/**
+ * One pass over a chunk of the step, tile by tile: the per-point statistics,
+ * the byte histogram, and the sums and lag products of the values shifted by the pilot
+ * (attributed to the chunk of their second element), while the tile stays in L1.
+ * */
+static void ZC_accumulateStepChunk_double(void* arg, int threadID, size_t taskID)
+{
+	ZC_PropertyAccumulator* acc = (ZC_PropertyAccumulator*)arg;
+	size_t i, j, k, h, len, begin = taskID*ZC_CHUNK_SIZE;
+	size_t end = begin + ZC_CHUNK_SIZE < acc->numOfElem ? begin + ZC_CHUNK_SIZE : acc->numOfElem;
+	size_t maxLag = acc->maxLag;
+	int first = acc->nbSteps==0;
+	double* data = (double*)acc->data;
+	double c = acc->pilot, w = 1.0/(acc->nbSteps+1);
+	double *mean = acc->mean, *m2 = acc->m2, *lo = acc->minEnvelope, *hi = acc->maxEnvelope;
+	double* sums = acc->partials + taskID*(maxLag+2);
+	double* y = acc->tiles + threadID*(maxLag+ZC_LAG_TILE_SIZE);
+	long* tables = acc->tables + threadID*ZC_BYTE_SUBTABLES*256;
+	double min = data[begin], max = data[begin], sum = 0, sumSqr = 0;
+	memset(sums, 0, sizeof(double)*(maxLag+2));
+	for (k = begin; k < end; k += len)
+	{
+		len = end - k < ZC_LAG_TILE_SIZE ? end - k : ZC_LAG_TILE_SIZE;
+		h = k < maxLag ? k : maxLag;
+		for (i = 0; i < h; i++)
+			y[i] = data[k-h+i]-c;
+		for (i = k, j = h; i < k+len; i++, j++)
+		{
+			double x = data[i], d = x - mean[i];
+			mean[i] += d*w;
+			m2[i] += d*(x - mean[i]);
+			if(first || lo[i]>x) lo[i] = x;
+			if(first || hi[i]<x) hi[i] = x;
+			if(min>x) min = x;
+			if(max<x) max = x;
+			y[j] = x - c;
+			sum += y[j];
+		}
+		ZC_countBytes((unsigned char*)(data+k), len*sizeof(double), tables);
+		if(maxLag > 0)
+			ZC_accumulateLagProducts(y, h+len, h, maxLag, sums+1);
+		else
+			for (j = 0; j < len; j++)
+				sumSqr += y[j]*y[j];
+	}
+	sums[0] = sum;
+	if(maxLag == 0)
+		sums[1] = sumSqr;
+	acc->extrema[taskID*2] = min;
+	acc->extrema[taskID*2+1] = max;
+}
+
+/*accumulate one time step (see ZC_updatePropertyAccumulator())*/
+void ZC_updatePropertyAccumulator_double(ZC_PropertyAccumulator* acc, double* data)
+{
+	size_t i, n = acc->numOfElem;
+	int delta, L = acc->maxLag;
+	double* sums = acc->sums;
+	ZC_prepareAccumulatorStep(acc, data);
+	ZC_runTasks(ZC_accumulateStepChunk_double, acc, acc->nbChunks);
+
+	double c = acc->pilot, min = acc->extrema[0], max = acc->extrema[1];
+	for(i=1;i<acc->nbChunks;i++)
+	{
+		if(min>acc->extrema[i*2]) min = acc->extrema[i*2];
+		if(max<acc->extrema[i*2+1]) max = acc->extrema[i*2+1];
+	}
+	ZC_reduceSumTree(acc->partials, acc->nbChunks, L+2);
+
+	double headSum = 0, tailSum = 0, sum = acc->partials[0];
+	sums[ZC_ACC_COUNT] = n;
+	sums[ZC_ACC_PARTS] = 1;
+	sums[ZC_ACC_SUM] = sum;
+	for(delta=0;delta<=L;delta++)
+	{
+		if(delta > 0)
+		{
+			headSum += data[delta-1]-c;
+			tailSum += data[n-delta]-c;
+		}
+		sums[ZC_ACC_PROD+delta] = acc->partials[1+delta];
+		sums[ZC_ACC_PROD+L+1+delta] = 2*sum - headSum - tailSum;
+	}
+	acc->property->minValue = min;
+	acc->property->maxValue = max;
+	ZC_finishAccumulatorStep(acc);
+}
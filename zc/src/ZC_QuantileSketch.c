@@ -0,0 +1,196 @@
+/**
+ *  @file ZC_QuantileSketch.c
+ *  @brief Mergeable quantile sketches of the values (valueQuantiles) and of the errors (errQuantiles).
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <float.h>
+#include "zc.h"
+#include "ZC_QuantileSketch.h"
+
+double ZC_valueQuantiles[ZC_VALUE_QUANTILE_COUNT] = {0.0001, 0.001, 0.01, 0.1, 0.5, 0.9, 0.99, 0.999, 0.9999};
+double ZC_errQuantiles[ZC_ERR_QUANTILE_COUNT] = {0.5, 0.9, 0.99, 0.999, 0.9999};
+
+static void ZC_initSketchStore(ZC_SketchStore* store)
+{
+	store->maxIndex = LONG_MIN;
+	memset(store->counts, 0, sizeof(store->counts));
+}
+
+void ZC_initQuantileSketch(ZC_QuantileSketch* sketch)
+{
+	sketch->n = 0;
+	sketch->min = DBL_MAX;
+	sketch->max = -DBL_MAX;
+	sketch->zeroCount = 0;
+	ZC_initSketchStore(&sketch->positive);
+	ZC_initSketchStore(&sketch->negative);
+}
+
+ZC_QuantileSketch* ZC_createQuantileSketch()
+{
+	return ZC_createQuantileSketches(1);
+}
+
+/*count sketches, e.g., one per thread (freed by free())*/
+ZC_QuantileSketch* ZC_createQuantileSketches(int count)
+{
+	int i;
+	ZC_QuantileSketch* sketches = (ZC_QuantileSketch*)malloc(sizeof(ZC_QuantileSketch)*count);
+	for(i=0;i<count;i++)
+		ZC_initQuantileSketch(&sketches[i]);
+	return sketches;
+}
+
+/**
+ * Move the window of the bins up, so that it ends at maxIndex (>store->maxIndex);
+ * the bins falling below the window are added to its lowest bin.
+ * */
+void ZC_shiftSketchStore(ZC_SketchStore* store, long maxIndex)
+{
+	long i, d, sum = 0;
+	if(store->maxIndex != LONG_MIN)
+	{
+		d = maxIndex - store->maxIndex;
+		if(d > ZC_SKETCH_BINS-1)
+			d = ZC_SKETCH_BINS-1;
+		for(i=0;i<=d;i++)
+			sum += store->counts[i];
+		memmove(store->counts+1, store->counts+d+1, (ZC_SKETCH_BINS-d-1)*sizeof(long));
+		memset(store->counts+ZC_SKETCH_BINS-d, 0, d*sizeof(long));
+		store->counts[0] = sum;
+	}
+	store->maxIndex = maxIndex;
+}
+
+static void ZC_mergeSketchStore(ZC_SketchStore* a, ZC_SketchStore* b)
+{
+	long i, k;
+	if(b->maxIndex == LONG_MIN)
+		return;
+	if(b->maxIndex > a->maxIndex)
+		ZC_shiftSketchStore(a, b->maxIndex);
+	k = b->maxIndex - a->maxIndex; //b's bin i goes to a's bin i+k (k<=0)
+	for(i=0;i<ZC_SKETCH_BINS;i++)
+		a->counts[i+k < 0 ? 0 : i+k] += b->counts[i];
+}
+
+/*add the values counted by b to a; the result does not depend on the order of the merges*/
+void ZC_mergeQuantileSketch(ZC_QuantileSketch* a, ZC_QuantileSketch* b)
+{
+	a->n += b->n;
+	if(a->min > b->min) a->min = b->min;
+	if(a->max < b->max) a->max = b->max;
+	a->zeroCount += b->zeroCount;
+	ZC_mergeSketchStore(&a->positive, &b->positive);
+	ZC_mergeSketchStore(&a->negative, &b->negative);
+}
+
+/*middle of the bin of the given index (see ZC_getSketchIndex())*/
+static double ZC_getSketchBinValue(long index)
+{
+	long e = index >= 0 ? index/ZC_SKETCH_BINS_PER_OCTAVE : -((-index+ZC_SKETCH_BINS_PER_OCTAVE-1)/ZC_SKETCH_BINS_PER_OCTAVE);
+	long j = index - e*ZC_SKETCH_BINS_PER_OCTAVE;
+	return ldexp(1 + (j+0.5)/ZC_SKETCH_BINS_PER_OCTAVE, (int)e);
+}
+
+/**
+ * The q-quantile (0<=q<=1) of the values: the value of rank q*(n-1) in the sorted order,
+ * within 1/64 of its magnitude, unless its bin was merged into the lowest bin of the window
+ * (magnitudes below 2^-32 times the largest one). The extremes (q=0 and q=1) are exact.
+ * */
+double ZC_getSketchQuantile(ZC_QuantileSketch* sketch, double q)
+{
+	long i;
+	double value, rank, count = 0;
+	if(sketch->n == 0)
+		return 0;
+	if(q <= 0)
+		return sketch->min;
+	if(q >= 1)
+		return sketch->max;
+	rank = q*(sketch->n-1);
+	value = sketch->max;
+	//the negative values in increasing order (decreasing magnitudes), zero, then the positive values
+	for(i=ZC_SKETCH_BINS-1;i>=0;i--)
+		if(sketch->negative.counts[i] > 0 && (count += sketch->negative.counts[i]) > rank)
+			break;
+	if(i >= 0)
+		value = -ZC_getSketchBinValue(sketch->negative.maxIndex-(ZC_SKETCH_BINS-1)+i);
+	else if((count += sketch->zeroCount) > rank)
+		value = 0;
+	else
+	{
+		for(i=0;i<ZC_SKETCH_BINS;i++)
+			if(sketch->positive.counts[i] > 0 && (count += sketch->positive.counts[i]) > rank)
+				break;
+		if(i < ZC_SKETCH_BINS)
+			value = ZC_getSketchBinValue(sketch->positive.maxIndex-(ZC_SKETCH_BINS-1)+i);
+	}
+	if(value < sketch->min) value = sketch->min;
+	if(value > sketch->max) value = sketch->max;
+	return value;
+}
+
+/*name of the q-quantile in the output files, e.g., p99.9 for q=0.999*/
+void ZC_getQuantileName(double q, char* output)
+{
+	sprintf(output, "p%.10G", q*100);
+}
+
+/*the line "<prefix>_<name of q> = <q-quantile>" of the .prop and .cmp files*/
+char* ZC_constructQuantileString(char* prefix, ZC_QuantileSketch* sketch, double q)
+{
+	char name[ZC_BUFS];
+	size_t size;
+	char* s;
+	ZC_getQuantileName(q, name);
+	size = strlen(prefix) + strlen(name) + 32; //"_", " = ", the value (at most 17 characters) and "\n"
+	s = (char*)malloc(size*sizeof(char));
+	snprintf(s, size, "%s_%s = %.10G\n", prefix, name, ZC_getSketchQuantile(sketch, q));
+	return s;
+}
+
+void ZC_freeQuantileSketch(ZC_QuantileSketch* sketch)
+{
+	if(sketch!=NULL)
+		free(sketch);
+}
+
+#ifdef HAVE_MPI
+/**
+ * Merge the sketches of all the ranks (collective): the windows are first moved to
+ * the global largest magnitudes, then the counts are summed. All the ranks get the result.
+ * */
+void ZC_reduceQuantileSketch_online(ZC_QuantileSketch* sketch)
+{
+	long maxIndex[2] = {sketch->positive.maxIndex, sketch->negative.maxIndex};
+	double extrema[2] = {-sketch->min, sketch->max};
+	long* counts = (long*)malloc(sizeof(long)*(2*ZC_SKETCH_BINS+2));
+
+	MPI_Allreduce(MPI_IN_PLACE, maxIndex, 2, MPI_LONG, MPI_MAX, ZC_COMM_WORLD);
+	MPI_Allreduce(MPI_IN_PLACE, extrema, 2, MPI_DOUBLE, MPI_MAX, ZC_COMM_WORLD);
+	if(maxIndex[0] > sketch->positive.maxIndex)
+		ZC_shiftSketchStore(&sketch->positive, maxIndex[0]);
+	if(maxIndex[1] > sketch->negative.maxIndex)
+		ZC_shiftSketchStore(&sketch->negative, maxIndex[1]);
+
+	memcpy(counts, sketch->positive.counts, sizeof(long)*ZC_SKETCH_BINS);
+	memcpy(counts+ZC_SKETCH_BINS, sketch->negative.counts, sizeof(long)*ZC_SKETCH_BINS);
+	counts[2*ZC_SKETCH_BINS] = sketch->zeroCount;
+	counts[2*ZC_SKETCH_BINS+1] = (long)sketch->n;
+	MPI_Allreduce(MPI_IN_PLACE, counts, 2*ZC_SKETCH_BINS+2, MPI_LONG, MPI_SUM, ZC_COMM_WORLD);
+	memcpy(sketch->positive.counts, counts, sizeof(long)*ZC_SKETCH_BINS);
+	memcpy(sketch->negative.counts, counts+ZC_SKETCH_BINS, sizeof(long)*ZC_SKETCH_BINS);
+	sketch->zeroCount = counts[2*ZC_SKETCH_BINS];
+	sketch->n = counts[2*ZC_SKETCH_BINS+1];
+	sketch->min = -extrema[0];
+	sketch->max = extrema[1];
+	free(counts);
+}
+#endif
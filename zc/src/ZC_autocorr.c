@@ -0,0 +1,272 @@
+/**
+ *  @file ZC_autocorr.c
+ *  @brief Autocorrelation helpers shared by the property and compare functions.
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "zc.h"
+#include "ZC_autocorr.h"
+#include "ZC_thread.h"
+#ifdef HAVE_FFTW3
+#include "ZC_FFTW3_math.h"
+#endif
+
+#define ZC_LAG_UNROLL 8
+
+/**
+ * prod[delta] += sum of y[j-delta]*y[j] over the positions j>=delta in [first, m), 
+ * for delta=0..maxLag (so y must hold the maxLag values preceding first, if any).
+ * 
+ * Instead of one sweep over the whole series per lag, the positions are processed 
+ * by tiles of ZC_LAG_TILE_SIZE: all the lags of a tile are accumulated while the tile 
+ * is in L1, ZC_LAG_UNROLL lags at a time, so each y[j] is loaded once for 
+ * ZC_LAG_UNROLL independent sums. Every sum is accumulated in the order of j.
+ * */
+void ZC_accumulateLagProducts(const double* y, size_t m, size_t first, int maxLag, double* prod)
+{
+	size_t t, j, j0, end;
+	int delta, k;
+	for(t = first; t < m; t = end)
+	{
+		end = t + ZC_LAG_TILE_SIZE < m ? t + ZC_LAG_TILE_SIZE : m;
+		for(delta = 0; delta <= maxLag; delta += ZC_LAG_UNROLL)
+		{
+			double s[ZC_LAG_UNROLL] = {0};
+			//the first positions of the series miss some of the lagged values
+			j0 = (size_t)(delta+ZC_LAG_UNROLL-1);
+			if(j0 < t)
+				j0 = t;
+			if(j0 > end)
+				j0 = end;
+			for(j = t; j < j0; j++)
+				for(k = 0; k < ZC_LAG_UNROLL; k++)
+					if(j >= (size_t)(delta+k))
+						s[k] += y[j-delta-k]*y[j];
+			
+			const double* p = y - delta;
+			for(j = j0; j < end; j++)
+			{
+				double yj = y[j];
+				s[0] += p[j]*yj;
+				s[1] += p[j-1]*yj;
+				s[2] += p[j-2]*yj;
+				s[3] += p[j-3]*yj;
+				s[4] += p[j-4]*yj;
+				s[5] += p[j-5]*yj;
+				s[6] += p[j-6]*yj;
+				s[7] += p[j-7]*yj;
+			}
+			for(k = 0; k < ZC_LAG_UNROLL && delta+k <= maxLag; k++)
+				prod[delta+k] += s[k];
+		}
+	}
+}
+
+/**
+ * The lag-delta correlation of the series with the means and standard deviations 
+ * of its two overlapping parts (x[0..n-delta) and x[delta..n)), as computed by the 
+ * small-data branches of the autocorrelation. y = x - x[0] (a constant part is then 
+ * exactly 0). One blocked pass gives all the lag products; the sums over the parts 
+ * are obtained by removing the first/last delta values from the total sums.
+ * If a part has a null deviation, all the coefficients are set to zeroValue.
+ * */
+void ZC_computeLagCorrelations(const double* y, size_t n, int maxLag, double zeroValue, double* autocorr)
+{
+	size_t i;
+	int delta;
+	double* prod = (double*)calloc(maxLag+1, sizeof(double));
+	double sum = 0, sumSqr = 0, headSum = 0, headSqr = 0, tailSum = 0, tailSqr = 0;
+	
+	ZC_accumulateLagProducts(y, n, 0, maxLag, prod);
+	for(i = 0; i < n; i++)
+	{
+		sum += y[i];
+		sumSqr += y[i]*y[i];
+	}
+	
+	for(delta = 1; delta <= maxLag; delta++)
+	{
+		double m = n - delta;
+		headSum += y[delta-1];
+		headSqr += y[delta-1]*y[delta-1];
+		tailSum += y[n-delta];
+		tailSqr += y[n-delta]*y[n-delta];
+		
+		double sum_0 = sum - tailSum, sum_1 = sum - headSum;
+		double cov_0 = (sumSqr - tailSqr - sum_0*sum_0/m)/m;
+		double cov_1 = (sumSqr - headSqr - sum_1*sum_1/m)/m;
+		cov_0 = cov_0 > 0 ? sqrt(cov_0) : 0;
+		cov_1 = cov_1 > 0 ? sqrt(cov_1) : 0;
+		
+		if (cov_0*cov_1 == 0)
+		{
+			for (delta = 1; delta <= maxLag; delta++)
+				autocorr[delta] = zeroValue;
+		}
+		else
+			autocorr[delta] = (prod[delta] - sum_0*sum_1/m)/m/(cov_0*cov_1);
+	}
+	free(prod);
+}
+
+/**
+ * Whether the lag sums of n values should be computed by FFT: it costs 
+ * O(n log n) instead of O(n maxLag), but needs the whole series and FFTW3.
+ * */
+int ZC_useLagSumsFFT(size_t n, int maxLag)
+{
+#ifdef HAVE_FFTW3
+	return maxLag >= ZC_AUTOCORR_FFT_MIN_LAG && n >= ZC_AUTOCORR_FFT_MIN_SIZE;
+#else
+	return 0;
+#endif
+}
+
+/**
+ * lagSums[delta] = sum of y[i]*y[i+delta], delta=0..maxLag, by FFT (y is kept unchanged).
+ * Without FFTW3, the blocked products are used instead.
+ * */
+void ZC_computeLagSumsFFT(double* y, size_t n, int maxLag, double* lagSums)
+{
+	int delta;
+	for(delta = 0; delta <= maxLag; delta++)
+		lagSums[delta] = 0;
+#ifdef HAVE_FFTW3
+	autocorr_1d_lagSums(y, n, maxLag, lagSums);
+#else
+	ZC_accumulateLagProducts(y, n, 0, maxLag, lagSums);
+#endif
+}
+
+/**
+ * Number of values of the 3D autocorrelation (autocorr3D, errAutoCorr3D) of data of the
+ * given dimensions, computed on nx=r1, ny=r2, nz=r3*r4*r5: the whole volume, or the
+ * (2L+1) lags of each axis (L = min(autocorr3DMaxLag, n-1)) if autocorr3DMaxLag is positive.
+ * */
+size_t ZC_getAutocorr3DLength(size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
+{
+	size_t k, length = 1, dims[3];
+	dims[0] = r1;
+	dims[1] = r2 > 0 ? r2 : 1;
+	dims[2] = (r3 > 0 ? r3 : 1)*(r4 > 0 ? r4 : 1)*(r5 > 0 ? r5 : 1);
+	for(k = 0; k < 3; k++)
+	{
+		if(autocorr3DMaxLag > 0)
+			length *= 2*((size_t)autocorr3DMaxLag < dims[k] ? (size_t)autocorr3DMaxLag : dims[k]-1) + 1;
+		else
+			length *= dims[k];
+	}
+	return length;
+}
+
+typedef struct ZC_LagTask
+{
+	double* y;
+	size_t begin, end; /*positions of the current chunk in y*/
+	int maxLag;
+	double* partials;
+} ZC_LagTask;
+
+/*products y[j-delta]*y[j] for the positions j of one sub-range of the current chunk*/
+static void ZC_computeLagProductsTask(void* arg, int threadID, size_t taskID)
+{
+	ZC_LagTask* t = (ZC_LagTask*)arg;
+	size_t begin = t->begin + taskID*ZC_CHUNK_SIZE;
+	size_t end = begin + ZC_CHUNK_SIZE < t->end ? begin + ZC_CHUNK_SIZE : t->end;
+	size_t h = begin < (size_t)t->maxLag ? begin : (size_t)t->maxLag;
+	double* prod = t->partials + taskID*(t->maxLag+1);
+	memset(prod, 0, (t->maxLag+1)*sizeof(double));
+	ZC_accumulateLagProducts(t->y + begin - h, end - begin + h, h, t->maxLag, prod);
+}
+
+void ZC_initLagAccumulator(ZC_LagAccumulator* acc, int maxLag, double pilot)
+{
+	acc->maxLag = maxLag;
+	acc->n = 0;
+	acc->pilot = pilot;
+	acc->sum = 0;
+	acc->prod = (double*)calloc(maxLag+1, sizeof(double));
+	acc->head = (double*)calloc(maxLag, sizeof(double));
+	acc->tail = (double*)calloc(maxLag, sizeof(double));
+	acc->buffer = NULL;
+	acc->bufferSize = 0;
+}
+
+/**
+ * Add the next m values of the series. The products whose second element lies 
+ * in this chunk are accumulated, using the values carried from the previous chunk.
+ * */
+void ZC_updateLagAccumulator(ZC_LagAccumulator* acc, double* data, size_t m)
+{
+	size_t j, L = acc->maxLag;
+	size_t c = acc->n < L ? acc->n : L; //number of carried values
+	if(acc->bufferSize < c + m)
+	{
+		acc->bufferSize = c + m;
+		acc->buffer = (double*)realloc(acc->buffer, acc->bufferSize*sizeof(double));
+	}
+	double* y = acc->buffer;
+	memcpy(y, acc->tail + (L - c), c*sizeof(double));
+	for(j = 0; j < m; j++)
+	{
+		y[c+j] = data[j] - acc->pilot;
+		acc->sum += y[c+j];
+	}
+	
+	ZC_LagTask task;
+	size_t nbTasks = ZC_computeChunkCount(m);
+	task.y = y;
+	task.begin = c;
+	task.end = c + m;
+	task.maxLag = acc->maxLag;
+	task.partials = (double*)malloc(sizeof(double)*(L+1)*nbTasks);
+	ZC_runTasks(ZC_computeLagProductsTask, &task, nbTasks);
+	ZC_reduceSumTree(task.partials, nbTasks, L+1);
+	for(j = 0; j <= L; j++)
+		acc->prod[j] += task.partials[j];
+	free(task.partials);
+	
+	for(j = acc->n; j < L && j - acc->n < m; j++)
+		acc->head[j] = y[c + j - acc->n];
+	
+	//keep the last L values, right-aligned in tail
+	size_t total = c + m, keep = total < L ? total : L;
+	memmove(acc->tail + (L - keep), y + (total - keep), keep*sizeof(double));
+	acc->n += m;
+}
+
+/**
+ * lagSums[delta] = sum_{i<n-delta} (x[i]-mean)*(x[i+delta]-mean), for delta=0..maxLag
+ * (requires n > maxLag).
+ * */
+void ZC_computeCenteredLagSums(ZC_LagAccumulator* acc, double mean, double* lagSums)
+{
+	int delta;
+	size_t n = acc->n, L = acc->maxLag;
+	double e = mean - acc->pilot;
+	double headSum = 0, tailSum = 0;
+	for(delta = 0; delta <= acc->maxLag; delta++)
+	{
+		if(delta > 0)
+		{
+			headSum += acc->head[delta-1];
+			tailSum += acc->tail[L-delta];
+		}
+		double sumA = acc->sum - tailSum; //sum of y[i], i<n-delta
+		double sumB = acc->sum - headSum; //sum of y[i], i>=delta
+		lagSums[delta] = acc->prod[delta] - e*(sumA + sumB) + (n-delta)*e*e;
+	}
+}
+
+void ZC_freeLagAccumulator(ZC_LagAccumulator* acc)
+{
+	free(acc->prod);
+	free(acc->head);
+	free(acc->tail);
+	free(acc->buffer);
+}
@@ -16,6 +16,7 @@
 #include "iniparser.h"
 #include "ZC_rw.h"
 #include "ZC_DataProperty.h"
+#include "ZC_ssim.h"
 
 void loadProperty(char* property_dir, char* fileName)
 {
@@ -145,6 +146,40 @@ int ZC_ReadConf() {
 		visMode = 0;
 	else
 		visMode = 1;
+	
+	ZC_setNbThreads((int)iniparser_getint(ini, "ENV:nbThreads", 1));
+	
+	sampleRatio = iniparser_getdouble(ini, "ENV:sampleRatio", 1);
+	if(sampleRatio <= 0 || sampleRatio > 1)
+	{
+		printf("Error: sampleRatio must be in (0,1] (sampleRatio = %f)\n", sampleRatio);
+		exit(0);
+	}
+	sampleSeed = (unsigned int)iniparser_getint(ini, "ENV:sampleSeed", 1);
+	
+	char* fftwPlannerString = iniparser_getstring(ini, "ENV:fftwPlanner", "ESTIMATE");
+	if(strcmp(fftwPlannerString, "ESTIMATE")==0 || strcmp(fftwPlannerString, "estimate")==0)
+		fftwPlanner = ZC_FFTW_ESTIMATE;
+	else if(strcmp(fftwPlannerString, "MEASURE")==0 || strcmp(fftwPlannerString, "measure")==0)
+		fftwPlanner = ZC_FFTW_MEASURE;
+	else
+	{
+		printf("Error: wrong fftwPlanner: %s\n", fftwPlannerString);
+		printf("Example: fftwPlanner = ESTIMATE or MEASURE\n");
+		exit(0);
+	}
+	char* fftwWisdomFileString = iniparser_getstring(ini, "ENV:fftwWisdomFile", NULL);
+	if(fftwWisdomFile!=NULL)
+		free(fftwWisdomFile);
+	fftwWisdomFile = NULL;
+	if(fftwWisdomFileString!=NULL && strlen(fftwWisdomFileString)>0)
+	{
+		fftwWisdomFile = (char*)malloc(sizeof(char)*(strlen(fftwWisdomFileString)+1));
+		strcpy(fftwWisdomFile, fftwWisdomFileString);
+	}
+	
+	char* simdKernelString = iniparser_getstring(ini, "ENV:simdKernel", "AUTO");
+	ZC_selectKernels(ZC_parseSimdKernelType(simdKernelString), (int)iniparser_getint(ini, "ENV:simdValidation", 0));
 
 	char *y = (char*)&x;
 	
@@ -163,9 +198,35 @@ int ZC_ReadConf() {
 	valueRangeFlag= (int)iniparser_getint(ini, "DATA:valueRange", 0);
 	avgValueFlag= (int)iniparser_getint(ini, "DATA:avgValue", 0);
 	entropyFlag= (int)iniparser_getint(ini, "DATA:entropy", 0);
+	quantEntropyFlag = (int)iniparser_getint(ini, "DATA:quantEntropy", 0);
+	quantEntropyBoundRatio = (double)iniparser_getdouble(ini, "DATA:quantEntropyBoundRatio", 1E-4);
+	if(quantEntropyFlag && quantEntropyBoundRatio <= 0)
+	{
+		printf("Error: quantEntropyBoundRatio must be positive (%G)\n", quantEntropyBoundRatio);
+		exit(0);
+	}
+	valueQuantilesFlag = (int)iniparser_getint(ini, "DATA:valueQuantiles", 0);
 	autocorrFlag= (int)iniparser_getint(ini, "DATA:autocorr", 0);
 	autocorr3DFlag = (int)iniparser_getint(ini, "DATA:autocorr3D", 0);
+	autocorr3DMaxLag = (int)iniparser_getint(ini, "DATA:autocorr3DMaxLag", 0);
+	if(autocorr3DMaxLag < 0)
+	{
+		printf("Error: wrong autocorr3DMaxLag: %d\n", autocorr3DMaxLag);
+		printf("Example: autocorr3DMaxLag = 0 (whole volume) or 32\n");
+		exit(0);
+	}
 	fftFlag= (int)iniparser_getint(ini, "DATA:fft", 0);
+	char* fftModeString = iniparser_getstring(ini, "DATA:fftMode", "PARTIAL");
+	if(strcmp(fftModeString, "PARTIAL")==0 || strcmp(fftModeString, "partial")==0)
+		fftMode = ZC_FFT_PARTIAL;
+	else if(strcmp(fftModeString, "FULL")==0 || strcmp(fftModeString, "full")==0)
+		fftMode = ZC_FFT_FULL;
+	else
+	{
+		printf("Error: wrong fftMode: %s\n", fftModeString);
+		printf("Example: fftMode = PARTIAL or FULL\n");
+		exit(0);
+	}
 	lapFlag= (int)iniparser_getint(ini, "DATA:lap", 0);
 	
 	compressTimeFlag = (int)iniparser_getint(ini, "COMPARE:compressTime", 0);
@@ -179,6 +240,7 @@ int ZC_ReadConf() {
 	errAutoCorr3DFlag = (int)iniparser_getint(ini, "COMPARE:errAutoCorr3D", 0);
 	absErrPDFFlag = (int)iniparser_getint(ini, "COMPARE:absErrPDF", 0);
 	pwrErrPDFFlag = (int)iniparser_getint(ini, "COMPARE:pwrErrPDF", 0);
+	pwrErrFlag = (int)iniparser_getint(ini, "COMPARE:pwrErr", 1);
 	
 	minRelErrFlag = (int)iniparser_getint(ini, "COMPARE:minRelErr", 0);
 	avgRelErrFlag = (int)iniparser_getint(ini, "COMPARE:avgRelErr", 0);
@@ -196,6 +258,37 @@ int ZC_ReadConf() {
 	KS_testFlag = (int)iniparser_getint(ini, "COMPARE:KS_test", 0);
 	SSIMFlag = (int)iniparser_getint(ini, "COMPARE:ssim", 0);
 	SSIMIMAGE2DFlag = (int)iniparser_getint(ini, "COMPARE:ssimImage2D", 0);
+	ssimImage2DSlices = (int)iniparser_getint(ini, "COMPARE:ssimImage2DSlices", 20);
+	if(ssimImage2DSlices < 0)
+	{
+		printf("Error: wrong ssimImage2DSlices: %d\n", ssimImage2DSlices);
+		printf("Example: ssimImage2DSlices = 20 or 0 (all the slices)\n");
+		exit(0);
+	}
+	SSIMVOLUME3DFlag = (int)iniparser_getint(ini, "COMPARE:ssimVolume3D", 0);
+	ZC_parseSsimProcGrid(iniparser_getstring(ini, "COMPARE:ssimProcGrid", NULL), ssimProcGrid);
+	
+	errMapFlag = (int)iniparser_getint(ini, "COMPARE:errMap", 1);
+	ZC_parseErrMapTile(iniparser_getstring(ini, "COMPARE:errMapTile", NULL), errMapTile);
+	errQuantilesFlag = (int)iniparser_getint(ini, "COMPARE:errQuantiles", 0);
+	
+	char* errBoundModeString = iniparser_getstring(ini, "COMPARE:errorBoundMode", NULL);
+	if(errBoundModeString!=NULL)
+	{
+		errorBoundMode = ZC_parseErrorBoundMode(errBoundModeString);
+		if(errorBoundMode < 0)
+		{
+			printf("Error: wrong errorBoundMode: %s\n", errBoundModeString);
+			printf("Example: errorBoundMode = ABS, REL, ABS_AND_REL, ABS_OR_REL, PW_REL, ABS_AND_PW_REL, ABS_OR_PW_REL, REL_AND_PW_REL or REL_OR_PW_REL\n");
+			exit(0);
+		}
+	}
+	absErrBound = iniparser_getdouble(ini, "COMPARE:absErrBound", 0);
+	relBoundRatio = iniparser_getdouble(ini, "COMPARE:relBoundRatio", 0);
+	pwrBoundRatio = iniparser_getdouble(ini, "COMPARE:pw_relBoundRatio", 0);
+	verifyMaxViolations = (size_t)iniparser_getint(ini, "COMPARE:maxViolations", 1);
+	
+	ZC_resolveMetricPlan(&metricPlan);
 
 	ecPropertyTable = ht_create( HASHTABLE_SIZE );			
 	ecCompareDataTable = ht_create(HASHTABLE_SIZE);
@@ -0,0 +1,475 @@
+/**
+ *  @file ZC_fft.c
+ *  @brief Iterative radix-2 FFT (split real/imaginary arrays) used by the fft coefficients.
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include "zc.h"
+#include "ZC_fft.h"
+#include "ZC_thread.h"
+#ifdef HAVE_FFTW3
+#include "ZC_FFTW3_math.h"
+#endif
+
+/**
+ * Twiddle tables cached per size: zc_fftTables[l][k] = cos(2*PI*k/2^l) for k=0..2^l/4, the 
+ * sines and the other cosines of the size being obtained by symmetry. The table of each 
+ * stage is contiguous (and small for the in-cache stages), instead of strided in a table 
+ * of the largest size. They are built under zc_fftTablesLock, since the transforms may 
+ * be run by several threads.
+ * */
+static double* zc_fftTables[64];
+static pthread_mutex_t zc_fftTablesLock = PTHREAD_MUTEX_INITIALIZER;
+
+typedef struct ZC_FFTTask
+{
+	double* re;
+	double* im;
+	size_t n; /*size of the complex transform*/
+	size_t len; /*butterfly span of the stage*/
+	size_t taskSize;
+	int logn;
+	double* table;
+	void* data;
+	int dataType;
+} ZC_FFTTask;
+
+static void ZC_computeTwiddleChunk(void* arg, int threadID, size_t taskID)
+{
+	ZC_FFTTask* t = (ZC_FFTTask*)arg;
+	size_t k, begin = taskID*ZC_CHUNK_SIZE;
+	size_t end = begin + ZC_CHUNK_SIZE < t->n ? begin + ZC_CHUNK_SIZE : t->n;
+	for(k = begin; k < end; k++)
+		t->table[k] = cos(2*PI*k/(double)t->len);
+}
+
+/*the tables of the sizes 4..n*/
+static void ZC_prepareFFTTwiddles(size_t n)
+{
+	int l;
+	ZC_FFTTask task;
+	pthread_mutex_lock(&zc_fftTablesLock);
+	for(l = 2; ((size_t)1 << l) <= n; l++)
+	{
+		if(zc_fftTables[l] != NULL)
+			continue;
+		task.len = (size_t)1 << l;
+		task.n = task.len/4;
+		task.table = (double*)malloc(sizeof(double)*(task.n+1));
+		ZC_runTasks(ZC_computeTwiddleChunk, &task, ZC_computeChunkCount(task.n));
+		task.table[task.n] = 0;
+		zc_fftTables[l] = task.table;
+	}
+	pthread_mutex_unlock(&zc_fftTablesLock);
+}
+
+void ZC_freeFFTTwiddles()
+{
+	int l;
+	pthread_mutex_lock(&zc_fftTablesLock);
+	for(l = 0; l < 64; l++)
+	{
+		free(zc_fftTables[l]);
+		zc_fftTables[l] = NULL;
+	}
+	pthread_mutex_unlock(&zc_fftTablesLock);
+}
+
+static int ZC_log2(size_t n)
+{
+	int logn = 0;
+	while(((size_t)1 << logn) < n)
+		logn++;
+	if(((size_t)1 << logn) != n)
+	{
+		printf("Error: the fft size (%zu) must be a power of two\n", n);
+		exit(0);
+	}
+	return logn;
+}
+
+static inline size_t ZC_reverseBits(size_t i, int logn)
+{
+	uint64_t x = i;
+	x = ((x >> 1) & 0x5555555555555555ULL) | ((x & 0x5555555555555555ULL) << 1);
+	x = ((x >> 2) & 0x3333333333333333ULL) | ((x & 0x3333333333333333ULL) << 2);
+	x = ((x >> 4) & 0x0F0F0F0F0F0F0F0FULL) | ((x & 0x0F0F0F0F0F0F0F0FULL) << 4);
+	x = ((x >> 8) & 0x00FF00FF00FF00FFULL) | ((x & 0x00FF00FF00FF00FFULL) << 8);
+	x = ((x >> 16) & 0x0000FFFF0000FFFFULL) | ((x & 0x0000FFFF0000FFFFULL) << 16);
+	x = (x >> 32) | (x << 32);
+	return (size_t)(x >> (64-logn));
+}
+
+/*t = (c - i*s)*(re2[j] + i*im2[j]), then the butterfly of the points j and j+half*/
+#define ZC_BUTTERFLY(c, s) \
+		tr = (c)*re2[j] + (s)*im2[j]; \
+		ti = (c)*im2[j] - (s)*re2[j]; \
+		re2[j] = re1[j] - tr; \
+		im2[j] = im1[j] - ti; \
+		re1[j] += tr; \
+		im1[j] += ti;
+
+/**
+ * Butterflies [j0, j1) of the group of len points starting at g (DIT, after the bit reversal),
+ * with the twiddles e^(-2*PI*i*j/len) = T[j] - i*T[q-j] for j<=q=len/4, -T[2q-j] - i*T[j-q] after.
+ * */
+static inline void ZC_butterflies(double* re, double* im, size_t g, size_t len, const double* T, size_t j0, size_t j1)
+{
+	size_t j, half = len/2, q = len/4;
+	double tr, ti;
+	double *re1 = re+g, *im1 = im+g, *re2 = re+g+half, *im2 = im+g+half;
+	if(len == 2)
+	{
+		j = 0;
+		ZC_BUTTERFLY(1, 0)
+		return;
+	}
+	for(j = j0; j < j1 && j <= q; j++)
+	{
+		ZC_BUTTERFLY(T[j], T[q-j])
+	}
+	for(; j < j1; j++)
+	{
+		ZC_BUTTERFLY(-T[2*q-j], T[j-q])
+	}
+}
+
+static void ZC_bitReverseChunk(void* arg, int threadID, size_t taskID)
+{
+	ZC_FFTTask* t = (ZC_FFTTask*)arg;
+	size_t i, r, begin = taskID*ZC_CHUNK_SIZE;
+	size_t end = begin + ZC_CHUNK_SIZE < t->n ? begin + ZC_CHUNK_SIZE : t->n;
+	double x;
+	for(i = begin; i < end; i++)
+	{
+		r = ZC_reverseBits(i, t->logn);
+		if(i < r) //each pair is swapped by the task of its first point
+		{
+			x = t->re[i]; t->re[i] = t->re[r]; t->re[r] = x;
+			x = t->im[i]; t->im[i] = t->im[r]; t->im[r] = x;
+		}
+	}
+}
+
+/*all the stages of span <= t->len, on one block of t->len points*/
+static void ZC_fftBlock(void* arg, int threadID, size_t taskID)
+{
+	ZC_FFTTask* t = (ZC_FFTTask*)arg;
+	size_t len, g, begin = taskID*t->len;
+	int l;
+	for(len = 2, l = 1; len <= t->len; len *= 2, l++)
+		for(g = begin; g < begin + t->len; g += len)
+			ZC_butterflies(t->re, t->im, g, len, zc_fftTables[l], 0, len/2);
+}
+
+/*t->taskSize butterflies of the stage of span t->len (taskSize divides len/2)*/
+static void ZC_fftStageChunk(void* arg, int threadID, size_t taskID)
+{
+	ZC_FFTTask* t = (ZC_FFTTask*)arg;
+	size_t half = t->len/2, p = taskID*t->taskSize;
+	size_t j0 = p%half;
+	ZC_butterflies(t->re, t->im, p/half*t->len, t->len, t->table, j0, j0 + t->taskSize);
+}
+
+/**
+ * Stages of the transform of n points, in bit-reversed order: the stages of span
+ * <= ZC_FFT_BLOCK_SIZE are done block by block in cache, each of the following
+ * stages is split into tasks of contiguous butterflies.
+ * */
+static void ZC_runFFTStages(double* re, double* im, size_t n)
+{
+	ZC_FFTTask task;
+	size_t block = n < ZC_FFT_BLOCK_SIZE ? n : ZC_FFT_BLOCK_SIZE;
+	task.re = re;
+	task.im = im;
+	task.n = n;
+	task.len = block;
+	ZC_runTasks(ZC_fftBlock, &task, n/block);
+	for(task.len = 2*block; task.len <= n; task.len *= 2)
+	{
+		task.taskSize = task.len/2 < ZC_CHUNK_SIZE/2 ? task.len/2 : ZC_CHUNK_SIZE/2;
+		task.table = zc_fftTables[ZC_log2(task.len)];
+		ZC_runTasks(ZC_fftStageChunk, &task, n/2/task.taskSize);
+	}
+}
+
+/**
+ * In-place forward transform (not normalized) of the n complex points (re[i], im[i]),
+ * n being a power of two.
+ * */
+void ZC_fftComplex(double* re, double* im, size_t n)
+{
+	ZC_FFTTask task;
+	if(n < 2)
+		return;
+	ZC_prepareFFTTwiddles(n);
+	task.re = re;
+	task.im = im;
+	task.n = n;
+	task.logn = ZC_log2(n);
+	ZC_runTasks(ZC_bitReverseChunk, &task, ZC_computeChunkCount(n));
+	ZC_runFFTStages(re, im, n);
+}
+
+#ifndef HAVE_FFTW3
+
+/*z[k] = x[2k] + i*x[2k+1] at the bit-reversed position r of k (gathered, so the writes are sequential)*/
+static void ZC_packRealChunk(void* arg, int threadID, size_t taskID)
+{
+	ZC_FFTTask* t = (ZC_FFTTask*)arg;
+	size_t k, r, begin = taskID*ZC_CHUNK_SIZE;
+	size_t end = begin + ZC_CHUNK_SIZE < t->n ? begin + ZC_CHUNK_SIZE : t->n;
+	for(r = begin; r < end; r++)
+	{
+		k = t->logn > 0 ? ZC_reverseBits(r, t->logn) : 0;
+		if(t->dataType==ZC_FLOAT)
+		{
+			t->re[r] = ((float*)t->data)[2*k];
+			t->im[r] = ((float*)t->data)[2*k+1];
+		}
+		else
+		{
+			t->re[r] = ((double*)t->data)[2*k];
+			t->im[r] = ((double*)t->data)[2*k+1];
+		}
+	}
+}
+
+/**
+ * X[k] and X[m-k] of the real transform of 2m points from Z[k] and Z[m-k], Z being
+ * the transform of the m packed points: X[k] = E + W^k*O, X[m-k] = conj(E - W^k*O), with
+ * E = (Z[k]+conj(Z[m-k]))/2 and O = (Z[k]-conj(Z[m-k]))/(2i).
+ * */
+static void ZC_unpackRealChunk(void* arg, int threadID, size_t taskID)
+{
+	ZC_FFTTask* t = (ZC_FFTTask*)arg;
+	size_t k, m = t->n, begin = taskID*ZC_CHUNK_SIZE;
+	size_t end = begin + ZC_CHUNK_SIZE < m/2 ? begin + ZC_CHUNK_SIZE : m/2;
+	double* re = t->re;
+	double* im = t->im;
+	const double* T = t->table; /*size 2m: e^(-2*PI*i*k/(2m)) = T[k] - i*T[m/2-k] for k<m/2*/
+	double c, s, er, ei, or_, oi, wr, wi;
+	if(begin == 0)
+		begin = 1;
+	for(k = begin; k < end; k++)
+	{
+		er = (re[k]+re[m-k])/2;
+		ei = (im[k]-im[m-k])/2;
+		or_ = (im[k]+im[m-k])/2;
+		oi = (re[m-k]-re[k])/2;
+		c = T[k];
+		s = T[m/2-k];
+		wr = c*or_ + s*oi;
+		wi = c*oi - s*or_;
+		re[k] = er + wr;
+		im[k] = ei + wi;
+		re[m-k] = er - wr;
+		im[m-k] = wi - ei;
+	}
+}
+
+#endif
+
+/**
+ * The first n/2+1 coefficients of the (not normalized) transform of the n real values
+ * of data (ZC_FLOAT or ZC_DOUBLE), n being a power of two; the others are the conjugates
+ * (X[n-k] = conj(X[k])). re and im hold n/2+1 values each.
+ *
+ * The n values are transformed as n/2 complex points, so the transform needs
+ * no other memory than re and im. With FFTW3, its r2c transform is used instead.
+ * */
+void ZC_fftReal(void* data, int dataType, size_t n, double* re, double* im)
+{
+	if(n < 2)
+	{
+		re[0] = dataType==ZC_FLOAT ? ((float*)data)[0] : ((double*)data)[0];
+		im[0] = 0;
+		return;
+	}
+	ZC_log2(n);
+#ifdef HAVE_FFTW3
+	size_t i;
+	double* input = (double*)data;
+	if(dataType==ZC_FLOAT)
+	{
+		input = (double*)malloc(sizeof(double)*n);
+		for(i = 0; i < n; i++)
+			input[i] = ((float*)data)[i];
+	}
+	fft_r2c_1d(input, n, re, im);
+	if(dataType==ZC_FLOAT)
+		free(input);
+#else
+	size_t m = n/2;
+	ZC_FFTTask task;
+	ZC_prepareFFTTwiddles(n);
+	task.re = re;
+	task.im = im;
+	task.n = m;
+	task.logn = ZC_log2(m);
+	task.data = data;
+	task.dataType = dataType;
+	ZC_runTasks(ZC_packRealChunk, &task, ZC_computeChunkCount(m));
+	ZC_runFFTStages(re, im, m);
+
+	task.table = zc_fftTables[ZC_log2(n)];
+	ZC_runTasks(ZC_unpackRealChunk, &task, ZC_computeChunkCount(m/2));
+	double r0 = re[0], i0 = im[0];
+	re[0] = r0 + i0;
+	im[0] = 0;
+	re[m] = r0 - i0;
+	im[m] = 0;
+	if(m >= 2)
+		im[m/2] = -im[m/2];
+#endif
+}
+
+typedef struct ZC_LowBinsTask
+{
+	void* data;
+	int dataType;
+	size_t n, K, P; /*the data seen as K rows of P = n/K columns*/
+	int logK;
+	size_t colsPerTask;
+	double* partials; /*2K sums per task*/
+} ZC_LowBinsTask;
+
+static void ZC_fftLowBinsChunk(void* arg, int threadID, size_t taskID)
+{
+	ZC_LowBinsTask* t = (ZC_LowBinsTask*)arg;
+	size_t K = t->K, P = t->P, m, c, k, j, g, len, half, q, R;
+	size_t c0 = taskID*t->colsPerTask, c1 = c0 + t->colsPerTask < P ? c0 + t->colsPerTask : P;
+	double* accRe = t->partials + taskID*2*K;
+	double* accIm = accRe + K;
+	double* tre = (double*)malloc(sizeof(double)*K*ZC_FFT_TILE_COLUMNS);
+	double* tim = (double*)malloc(sizeof(double)*K*ZC_FFT_TILE_COLUMNS);
+	double wr, wi, pr, pi, tr, ti, cs, sn, x;
+	double *re1, *im1, *re2, *im2;
+	int l;
+	memset(accRe, 0, sizeof(double)*2*K);
+	for(; c0 < c1; c0 += R)
+	{
+		R = c1 - c0 < ZC_FFT_TILE_COLUMNS ? c1 - c0 : ZC_FFT_TILE_COLUMNS;
+		//the rows of the tile, in bit-reversed order
+		for(m = 0; m < K; m++)
+		{
+			double* row = tre + ZC_reverseBits(m, t->logK)*ZC_FFT_TILE_COLUMNS;
+			if(t->dataType==ZC_FLOAT)
+				for(c = 0; c < R; c++)
+					row[c] = ((float*)t->data)[m*P+c0+c];
+			else
+				for(c = 0; c < R; c++)
+					row[c] = ((double*)t->data)[m*P+c0+c];
+		}
+		memset(tim, 0, sizeof(double)*K*ZC_FFT_TILE_COLUMNS);
+		//K-point transforms of the R columns, the butterflies running along the columns
+		for(len = 2, l = 1; len <= K; len *= 2, l++)
+		{
+			half = len/2;
+			q = len/4;
+			for(g = 0; g < K; g += len)
+				for(j = 0; j < half; j++)
+				{
+					if(len == 2)
+					{
+						cs = 1;
+						sn = 0;
+					}
+					else if(j <= q)
+					{
+						cs = zc_fftTables[l][j];
+						sn = zc_fftTables[l][q-j];
+					}
+					else
+					{
+						cs = -zc_fftTables[l][2*q-j];
+						sn = zc_fftTables[l][j-q];
+					}
+					re1 = tre + (g+j)*ZC_FFT_TILE_COLUMNS;
+					im1 = tim + (g+j)*ZC_FFT_TILE_COLUMNS;
+					re2 = re1 + half*ZC_FFT_TILE_COLUMNS;
+					im2 = im1 + half*ZC_FFT_TILE_COLUMNS;
+					for(c = 0; c < R; c++)
+					{
+						tr = cs*re2[c] + sn*im2[c];
+						ti = cs*im2[c] - sn*re2[c];
+						re2[c] = re1[c] - tr;
+						im2[c] = im1[c] - ti;
+						re1[c] += tr;
+						im1[c] += ti;
+					}
+				}
+		}
+		//X[k] += e^(-2*PI*i*r*k/n)*Y_r[k] for the columns r
+		for(c = 0; c < R; c++)
+		{
+			x = 2*PI*(double)(c0+c)/(double)t->n;
+			wr = cos(x);
+			wi = -sin(x);
+			pr = 1;
+			pi = 0;
+			for(k = 0; k < K; k++)
+			{
+				tr = tre[k*ZC_FFT_TILE_COLUMNS+c];
+				ti = tim[k*ZC_FFT_TILE_COLUMNS+c];
+				accRe[k] += pr*tr - pi*ti;
+				accIm[k] += pr*ti + pi*tr;
+				x = pr*wr - pi*wi;
+				pi = pr*wi + pi*wr;
+				pr = x;
+			}
+		}
+	}
+	free(tre);
+	free(tim);
+}
+
+/**
+ * The first K coefficients X[0..K-1] of the (not normalized) transform of the n real values 
+ * of data, n and K being powers of two, without the whole spectrum: with x seen as K rows
+ * of P = n/K columns, X[k] = sum over the columns r of e^(-2*PI*i*r*k/n)*Y_r[k], Y_r being the 
+ * K-point transform of the column r. The cost is O(n*log(K)) with O(K) memory, instead of 
+ * O(n*log(n)) with O(n) memory.
+ * */
+void ZC_fftRealLowBins(void* data, int dataType, size_t n, size_t K, double* re, double* im)
+{
+	size_t k, nbTasks;
+	ZC_LowBinsTask task;
+	ZC_log2(n);
+	if(n <= K) //tiny data: the whole transform, X being n-periodic
+	{
+		double* fre = (double*)malloc(sizeof(double)*(n/2+1));
+		double* fim = (double*)malloc(sizeof(double)*(n/2+1));
+		ZC_fftReal(data, dataType, n, fre, fim);
+		for(k = 0; k < K; k++)
+		{
+			size_t j = k%n;
+			re[k] = j <= n/2 ? fre[j] : fre[n-j];
+			im[k] = j <= n/2 ? fim[j] : -fim[n-j];
+		}
+		free(fre);
+		free(fim);
+		return;
+	}
+	task.data = data;
+	task.dataType = dataType;
+	task.n = n;
+	task.K = K;
+	task.logK = ZC_log2(K);
+	task.P = n/K;
+	task.colsPerTask = ZC_CHUNK_SIZE/K > ZC_FFT_TILE_COLUMNS ? ZC_CHUNK_SIZE/K : ZC_FFT_TILE_COLUMNS;
+	nbTasks = (task.P + task.colsPerTask - 1)/task.colsPerTask;
+	task.partials = (double*)malloc(sizeof(double)*2*K*nbTasks);
+	ZC_prepareFFTTwiddles(K);
+	ZC_runTasks(ZC_fftLowBinsChunk, &task, nbTasks);
+	ZC_reduceSumTree(task.partials, nbTasks, 2*K);
+	memcpy(re, task.partials, sizeof(double)*K);
+	memcpy(im, task.partials+K, sizeof(double)*K);
+	free(task.partials);
+}
@@ -219,6 +219,47 @@ float *ZC_readFloatData(char *srcFilePath, size_t *nbEle)
 	}
 }
 
+/**
+ * Read nbEle values of elemSize bytes starting at element offset of the file 
+ * descriptor fd (pread, so several chunks can be read without seeking).
+ * The bytes are swapped if the data endian type differs from the system one.
+ * */
+void ZC_readDataChunk(int fd, size_t elemSize, size_t offset, size_t nbEle, void *buf)
+{
+	size_t i, done = 0, byteLength = nbEle*elemSize;
+	unsigned char* bytes = (unsigned char*)buf;
+	while(done < byteLength)
+	{
+		ssize_t r = pread(fd, bytes+done, byteLength-done, (off_t)(offset*elemSize+done));
+		if(r <= 0)
+		{
+			printf("Failed to read the data chunk at element %zu.\n", offset);
+			exit(1);
+		}
+		done += r;
+	}
+	if(dataEndianType!=sysEndianType)
+	{
+		for(i = 0;i<nbEle;i++)
+		{
+			if(elemSize==4)
+				ZC_symTransform_4bytes(bytes+i*4);
+			else if(elemSize==8)
+				ZC_symTransform_8bytes(bytes+i*8);
+		}
+	}
+}
+
+void ZC_readFloatDataChunk(int fd, size_t offset, size_t nbEle, float *buf)
+{
+	ZC_readDataChunk(fd, sizeof(float), offset, nbEle, buf);
+}
+
+void ZC_readDoubleDataChunk(int fd, size_t offset, size_t nbEle, double *buf)
+{
+	ZC_readDataChunk(fd, sizeof(double), offset, nbEle, buf);
+}
+
 double *ZC_readDoubleData_systemEndian(char *srcFilePath, size_t *nbEle)
 {
 	size_t inSize;
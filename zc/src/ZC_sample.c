@@ -0,0 +1,116 @@
+/**
+ *  @file ZC_sample.c
+ *  @brief Block sampling and estimators of the approximate (screening) mode.
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "ZC_sample.h"
+
+static unsigned long long ZC_nextRandom(unsigned long long* state)
+{
+	//splitmix64: the sample only depends on the seed (not on the rand() state of the application)
+	unsigned long long z = (*state += 0x9E3779B97F4A7C15ULL);
+	z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+	return z ^ (z >> 31);
+}
+
+size_t ZC_computeSampleBlockCount(size_t n)
+{
+	return (n + ZC_SAMPLE_BLOCK_SIZE - 1)/ZC_SAMPLE_BLOCK_SIZE;
+}
+
+size_t ZC_getSampleBlockLength(size_t n, size_t block)
+{
+	size_t begin = block*ZC_SAMPLE_BLOCK_SIZE;
+	return n - begin < ZC_SAMPLE_BLOCK_SIZE ? n - begin : ZC_SAMPLE_BLOCK_SIZE;
+}
+
+/**
+ * Stratified sample of the blocks of ZC_SAMPLE_BLOCK_SIZE points of n data points:
+ * the blocks are split into ceil(ratio*nbBlocks) (at least 2) consecutive strata and
+ * one block is drawn at random in each stratum, so the sample covers the whole field.
+ * Returns the indices of the sampled blocks in increasing order, or NULL if the
+ * sample would be the whole data (ratio>=1 or too few blocks).
+ * */
+size_t* ZC_selectSampleBlocks(size_t n, double ratio, unsigned int seed, size_t* nbSampled)
+{
+	size_t j, nbBlocks = ZC_computeSampleBlockCount(n);
+	size_t m = (size_t)ceil(ratio*nbBlocks);
+	unsigned long long state = seed;
+
+	*nbSampled = nbBlocks;
+	if(ratio >= 1 || ratio <= 0)
+		return NULL;
+	if(m < 2)
+		m = 2;
+	if(m >= nbBlocks)
+		return NULL;
+
+	size_t* blocks = (size_t*)malloc(sizeof(size_t)*m);
+	for(j=0;j<m;j++)
+	{
+		size_t begin = j*nbBlocks/m, end = (j+1)*nbBlocks/m;
+		blocks[j] = begin + ZC_nextRandom(&state)%(end-begin);
+	}
+	*nbSampled = m;
+	return blocks;
+}
+
+/**
+ * Pointers to the sampled blocks of the in-memory data (elements of elemSize bytes),
+ * and their lengths (lengths must hold nbSampled values).
+ * */
+void** ZC_getSampleBlockPointers(void* data, size_t elemSize, size_t n, size_t* blocks, size_t nbSampled, size_t* lengths)
+{
+	size_t j;
+	void** pointers = (void**)malloc(sizeof(void*)*nbSampled);
+	for(j=0;j<nbSampled;j++)
+	{
+		pointers[j] = (char*)data + blocks[j]*ZC_SAMPLE_BLOCK_SIZE*elemSize;
+		lengths[j] = ZC_getSampleBlockLength(n, blocks[j]);
+	}
+	return pointers;
+}
+
+void ZC_initRatioSums(ZC_RatioSums* s)
+{
+	s->y = s->n = 0;
+	s->yy = s->yn = s->nn = 0;
+}
+
+void ZC_addRatioSample(ZC_RatioSums* s, double y, double n)
+{
+	s->y += y;
+	s->n += n;
+	s->yy += y*y;
+	s->yn += y*n;
+	s->nn += n*n;
+}
+
+/**
+ * Ratio estimate of sum(y)/sum(n) over the nbBlocks blocks from nbSampled sampled ones,
+ * and the half-width of its 95% confidence interval (the variance is the one of a simple
+ * random sample of blocks, with the finite population correction).
+ * */
+double ZC_estimateRatio(ZC_RatioSums* s, size_t nbSampled, size_t nbBlocks, double* halfWidth)
+{
+	double r = s->y/s->n;
+	if(nbSampled >= nbBlocks)
+		*halfWidth = 0;
+	else if(nbSampled < 2)
+		*halfWidth = HUGE_VAL;
+	else
+	{
+		double m = nbSampled, nbar = s->n/m;
+		double dev2 = (s->yy - 2*r*s->yn + r*r*s->nn)/(m - 1);
+		if(dev2 < 0)
+			dev2 = 0;
+		*halfWidth = ZC_SAMPLE_Z*sqrt((1 - m/nbBlocks)*dev2/m)/nbar;
+	}
+	return r;
+}
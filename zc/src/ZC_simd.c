@@ -0,0 +1,611 @@
+/**
+ *  @file ZC_simd.c
+ *  @brief Scalar reference kernels, runtime dispatch and validation of the vectorized kernels.
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "ZC_simd.h"
+
+int simdKernelType = ZC_SIMD_AUTO;
+int simdValidationFlag = 0;
+size_t simdValidationErrors = 0;
+
+static ZC_Kernels* zc_kernels = NULL; /*the selected kernels*/
+static ZC_Kernels* zc_checkedKernels = NULL; /*the kernels checked by the validation mode*/
+
+/*****************************scalar reference kernels*****************************/
+
+void ZC_diffSums_float_scalar(const float* data1, const float* data2, size_t n, ZC_DiffSums* s)
+{
+	size_t i;
+	double diff, err;
+	double sum1 = 0, sum2 = 0, sumDiff = 0, sumErr = 0, sumErrSqr = 0;
+	double minDiff = 1E100, maxDiff = -1E100, minErr = 1E100, maxErr = 0;
+	for (i = 0; i < n; i++)
+	{
+		sum1 += data1[i];
+		sum2 += data2[i];
+		diff = data2[i]-data1[i];
+		if(minDiff > diff) minDiff = diff;
+		if(maxDiff < diff) maxDiff = diff;
+		sumDiff += diff;
+		err = fabs(diff);
+		if(minErr>err) minErr = err;
+		if(maxErr<err) maxErr = err;
+		sumErr += err;
+		sumErrSqr += err*err;
+	}
+	s->sum1 = sum1;
+	s->sum2 = sum2;
+	s->sumDiff = sumDiff;
+	s->sumErr = sumErr;
+	s->sumErrSqr = sumErrSqr;
+	s->minDiff = minDiff;
+	s->maxDiff = maxDiff;
+	s->minErr = minErr;
+	s->maxErr = maxErr;
+}
+
+void ZC_relSums_float_scalar(const float* data1, const float* data2, size_t n, ZC_RelSums* s)
+{
+	size_t i, n_rel = 0;
+	double diff, relDiff, err;
+	double minDiff_rel = 1E100, maxDiff_rel = -1E100, minErr_rel = 1E100, maxErr_rel = 0;
+	double sumErr_rel = 0, sumErrSqr_rel = 0;
+	for (i = 0; i < n; i++)
+	{
+		if(data1[i]!=0)
+		{
+			n_rel ++;
+			diff = data2[i]-data1[i];
+			relDiff = diff/data1[i];
+			if(minDiff_rel > relDiff) minDiff_rel = relDiff;
+			if(maxDiff_rel < relDiff) maxDiff_rel = relDiff;
+			err = fabs(relDiff);
+			if(minErr_rel>err) minErr_rel = err;
+			if(maxErr_rel<err) maxErr_rel = err;
+			sumErr_rel += err;
+			sumErrSqr_rel += err*err;
+		}
+	}
+	s->n_rel = n_rel;
+	s->minDiff_rel = minDiff_rel;
+	s->maxDiff_rel = maxDiff_rel;
+	s->minErr_rel = minErr_rel;
+	s->maxErr_rel = maxErr_rel;
+	s->sumErr_rel = sumErr_rel;
+	s->sumErrSqr_rel = sumErrSqr_rel;
+}
+
+void ZC_coMoments_float_scalar(const float* data1, const float* data2, size_t n, double mean1, double mean2, double meanDiff, ZC_CoMoments* s)
+{
+	size_t i;
+	double diff;
+	double m2_1 = 0, m2_2 = 0, m2_diff = 0, c12 = 0, c1d = 0;
+	for (i = 0; i < n; i++)
+	{
+		double d1 = data1[i]-mean1;
+		double d2 = data2[i]-mean2;
+		diff = data2[i]-data1[i];
+		double dd = diff-meanDiff;
+		m2_1 += d1*d1;
+		m2_2 += d2*d2;
+		m2_diff += dd*dd;
+		c12 += d1*d2;
+		c1d += d1*dd;
+	}
+	s->m2_1 = m2_1;
+	s->m2_2 = m2_2;
+	s->m2_diff = m2_diff;
+	s->c12 = c12;
+	s->c1d = c1d;
+}
+
+void ZC_valueSums_float_scalar(const float* data, size_t n, double* min, double* max, double* sum)
+{
+	size_t i;
+	double min_ = data[0], max_ = data[0], sum_ = 0;
+	for (i = 0; i < n; i++)
+	{
+		if(min_>data[i]) min_ = data[i];
+		if(max_<data[i]) max_ = data[i];
+		sum_ += data[i];
+	}
+	*min = min_;
+	*max = max_;
+	*sum = sum_;
+}
+
+double ZC_sqDevSum_float_scalar(const float* data, size_t n, double center)
+{
+	size_t i;
+	double sum = 0;
+	for (i = 0; i < n; i++)
+		sum += (data[i]-center)*(data[i]-center);
+	return sum;
+}
+
+size_t ZC_boundViolations_float_scalar(const float* data1, const float* data2, size_t n, double absBound, double pwrBound, int andMode, double* maxErr)
+{
+	size_t i, count = 0;
+	double err, bound, max = 0;
+	for (i = 0; i < n; i++)
+	{
+		err = fabs(data2[i]-data1[i]);
+		bound = pwrBound*fabs(data1[i]);
+		if(andMode)
+			bound = bound < absBound ? bound : absBound;
+		else
+			bound = bound > absBound ? bound : absBound;
+		if(max<err) max = err;
+		if(!(err<=bound)) count++;
+	}
+	*maxErr = max;
+	return count;
+}
+
+void ZC_diffSums_double_scalar(const double* data1, const double* data2, size_t n, ZC_DiffSums* s)
+{
+	size_t i;
+	double diff, err;
+	double sum1 = 0, sum2 = 0, sumDiff = 0, sumErr = 0, sumErrSqr = 0;
+	double minDiff = 1E100, maxDiff = -1E100, minErr = 1E100, maxErr = 0;
+	for (i = 0; i < n; i++)
+	{
+		sum1 += data1[i];
+		sum2 += data2[i];
+		diff = data2[i]-data1[i];
+		if(minDiff > diff) minDiff = diff;
+		if(maxDiff < diff) maxDiff = diff;
+		sumDiff += diff;
+		err = fabs(diff);
+		if(minErr>err) minErr = err;
+		if(maxErr<err) maxErr = err;
+		sumErr += err;
+		sumErrSqr += err*err;
+	}
+	s->sum1 = sum1;
+	s->sum2 = sum2;
+	s->sumDiff = sumDiff;
+	s->sumErr = sumErr;
+	s->sumErrSqr = sumErrSqr;
+	s->minDiff = minDiff;
+	s->maxDiff = maxDiff;
+	s->minErr = minErr;
+	s->maxErr = maxErr;
+}
+
+void ZC_relSums_double_scalar(const double* data1, const double* data2, size_t n, ZC_RelSums* s)
+{
+	size_t i, n_rel = 0;
+	double diff, relDiff, err;
+	double minDiff_rel = 1E100, maxDiff_rel = -1E100, minErr_rel = 1E100, maxErr_rel = 0;
+	double sumErr_rel = 0, sumErrSqr_rel = 0;
+	for (i = 0; i < n; i++)
+	{
+		if(data1[i]!=0)
+		{
+			n_rel ++;
+			diff = data2[i]-data1[i];
+			relDiff = diff/data1[i];
+			if(minDiff_rel > relDiff) minDiff_rel = relDiff;
+			if(maxDiff_rel < relDiff) maxDiff_rel = relDiff;
+			err = fabs(relDiff);
+			if(minErr_rel>err) minErr_rel = err;
+			if(maxErr_rel<err) maxErr_rel = err;
+			sumErr_rel += err;
+			sumErrSqr_rel += err*err;
+		}
+	}
+	s->n_rel = n_rel;
+	s->minDiff_rel = minDiff_rel;
+	s->maxDiff_rel = maxDiff_rel;
+	s->minErr_rel = minErr_rel;
+	s->maxErr_rel = maxErr_rel;
+	s->sumErr_rel = sumErr_rel;
+	s->sumErrSqr_rel = sumErrSqr_rel;
+}
+
+void ZC_coMoments_double_scalar(const double* data1, const double* data2, size_t n, double mean1, double mean2, double meanDiff, ZC_CoMoments* s)
+{
+	size_t i;
+	double diff;
+	double m2_1 = 0, m2_2 = 0, m2_diff = 0, c12 = 0, c1d = 0;
+	for (i = 0; i < n; i++)
+	{
+		double d1 = data1[i]-mean1;
+		double d2 = data2[i]-mean2;
+		diff = data2[i]-data1[i];
+		double dd = diff-meanDiff;
+		m2_1 += d1*d1;
+		m2_2 += d2*d2;
+		m2_diff += dd*dd;
+		c12 += d1*d2;
+		c1d += d1*dd;
+	}
+	s->m2_1 = m2_1;
+	s->m2_2 = m2_2;
+	s->m2_diff = m2_diff;
+	s->c12 = c12;
+	s->c1d = c1d;
+}
+
+void ZC_valueSums_double_scalar(const double* data, size_t n, double* min, double* max, double* sum)
+{
+	size_t i;
+	double min_ = data[0], max_ = data[0], sum_ = 0;
+	for (i = 0; i < n; i++)
+	{
+		if(min_>data[i]) min_ = data[i];
+		if(max_<data[i]) max_ = data[i];
+		sum_ += data[i];
+	}
+	*min = min_;
+	*max = max_;
+	*sum = sum_;
+}
+
+double ZC_sqDevSum_double_scalar(const double* data, size_t n, double center)
+{
+	size_t i;
+	double sum = 0;
+	for (i = 0; i < n; i++)
+		sum += (data[i]-center)*(data[i]-center);
+	return sum;
+}
+
+size_t ZC_boundViolations_double_scalar(const double* data1, const double* data2, size_t n, double absBound, double pwrBound, int andMode, double* maxErr)
+{
+	size_t i, count = 0;
+	double err, bound, max = 0;
+	for (i = 0; i < n; i++)
+	{
+		err = fabs(data2[i]-data1[i]);
+		bound = pwrBound*fabs(data1[i]);
+		if(andMode)
+			bound = bound < absBound ? bound : absBound;
+		else
+			bound = bound > absBound ? bound : absBound;
+		if(max<err) max = err;
+		if(!(err<=bound)) count++;
+	}
+	*maxErr = max;
+	return count;
+}
+
+void ZC_mergeDiffSums(ZC_DiffSums* s, ZC_DiffSums* tail)
+{
+	s->sum1 += tail->sum1;
+	s->sum2 += tail->sum2;
+	s->sumDiff += tail->sumDiff;
+	s->sumErr += tail->sumErr;
+	s->sumErrSqr += tail->sumErrSqr;
+	if(s->minDiff > tail->minDiff) s->minDiff = tail->minDiff;
+	if(s->maxDiff < tail->maxDiff) s->maxDiff = tail->maxDiff;
+	if(s->minErr > tail->minErr) s->minErr = tail->minErr;
+	if(s->maxErr < tail->maxErr) s->maxErr = tail->maxErr;
+}
+
+void ZC_mergeRelSums(ZC_RelSums* s, ZC_RelSums* tail)
+{
+	s->n_rel += tail->n_rel;
+	if(s->minDiff_rel > tail->minDiff_rel) s->minDiff_rel = tail->minDiff_rel;
+	if(s->maxDiff_rel < tail->maxDiff_rel) s->maxDiff_rel = tail->maxDiff_rel;
+	if(s->minErr_rel > tail->minErr_rel) s->minErr_rel = tail->minErr_rel;
+	if(s->maxErr_rel < tail->maxErr_rel) s->maxErr_rel = tail->maxErr_rel;
+	s->sumErr_rel += tail->sumErr_rel;
+	s->sumErrSqr_rel += tail->sumErrSqr_rel;
+}
+
+ZC_Kernels zc_scalarKernels = {
+	ZC_SIMD_SCALAR, "scalar",
+	ZC_diffSums_float_scalar, ZC_diffSums_double_scalar,
+	ZC_relSums_float_scalar, ZC_relSums_double_scalar,
+	ZC_coMoments_float_scalar, ZC_coMoments_double_scalar,
+	ZC_valueSums_float_scalar, ZC_valueSums_double_scalar,
+	ZC_sqDevSum_float_scalar, ZC_sqDevSum_double_scalar,
+	ZC_boundViolations_float_scalar, ZC_boundViolations_double_scalar
+};
+
+/*****************************validation mode*****************************/
+
+/*the validating kernels run in the worker threads of ZC_runTasks()*/
+static void ZC_countValidationError()
+{
+	__sync_fetch_and_add(&simdValidationErrors, 1);
+}
+
+static int ZC_checkSum(const char* kernel, const char* name, double value, double expected)
+{
+	double tol = ZC_SIMD_VALIDATION_TOL*(fabs(expected) > 1 ? fabs(expected) : 1);
+	if(fabs(value - expected) <= tol || (value != value && expected != expected))
+		return 0;
+	printf("[ZC] Warning: %s kernel %s: %s=%.17g differs from the scalar result %.17g\n", zc_checkedKernels->name, kernel, name, value, expected);
+	return 1;
+}
+
+static int ZC_checkExact(const char* kernel, const char* name, double value, double expected)
+{
+	if(value == expected || (value != value && expected != expected))
+		return 0;
+	printf("[ZC] Warning: %s kernel %s: %s=%.17g differs from the scalar result %.17g\n", zc_checkedKernels->name, kernel, name, value, expected);
+	return 1;
+}
+
+static void ZC_diffSums_float_validate(const float* data1, const float* data2, size_t n, ZC_DiffSums* s)
+{
+	ZC_DiffSums r;
+	int err = 0;
+	zc_checkedKernels->diffSums_float(data1, data2, n, s);
+	ZC_diffSums_float_scalar(data1, data2, n, &r);
+	err += ZC_checkSum("diffSums_float", "sum1", s->sum1, r.sum1);
+	err += ZC_checkSum("diffSums_float", "sum2", s->sum2, r.sum2);
+	err += ZC_checkSum("diffSums_float", "sumDiff", s->sumDiff, r.sumDiff);
+	err += ZC_checkSum("diffSums_float", "sumErr", s->sumErr, r.sumErr);
+	err += ZC_checkSum("diffSums_float", "sumErrSqr", s->sumErrSqr, r.sumErrSqr);
+	err += ZC_checkExact("diffSums_float", "minDiff", s->minDiff, r.minDiff);
+	err += ZC_checkExact("diffSums_float", "maxDiff", s->maxDiff, r.maxDiff);
+	err += ZC_checkExact("diffSums_float", "minErr", s->minErr, r.minErr);
+	err += ZC_checkExact("diffSums_float", "maxErr", s->maxErr, r.maxErr);
+	if(err)
+		ZC_countValidationError();
+}
+
+static void ZC_relSums_float_validate(const float* data1, const float* data2, size_t n, ZC_RelSums* s)
+{
+	ZC_RelSums r;
+	int err = 0;
+	zc_checkedKernels->relSums_float(data1, data2, n, s);
+	ZC_relSums_float_scalar(data1, data2, n, &r);
+	err += ZC_checkExact("relSums_float", "n_rel", s->n_rel, r.n_rel);
+	err += ZC_checkExact("relSums_float", "minDiff_rel", s->minDiff_rel, r.minDiff_rel);
+	err += ZC_checkExact("relSums_float", "maxDiff_rel", s->maxDiff_rel, r.maxDiff_rel);
+	err += ZC_checkExact("relSums_float", "minErr_rel", s->minErr_rel, r.minErr_rel);
+	err += ZC_checkExact("relSums_float", "maxErr_rel", s->maxErr_rel, r.maxErr_rel);
+	err += ZC_checkSum("relSums_float", "sumErr_rel", s->sumErr_rel, r.sumErr_rel);
+	err += ZC_checkSum("relSums_float", "sumErrSqr_rel", s->sumErrSqr_rel, r.sumErrSqr_rel);
+	if(err)
+		ZC_countValidationError();
+}
+
+static void ZC_coMoments_float_validate(const float* data1, const float* data2, size_t n, double mean1, double mean2, double meanDiff, ZC_CoMoments* s)
+{
+	ZC_CoMoments r;
+	int err = 0;
+	zc_checkedKernels->coMoments_float(data1, data2, n, mean1, mean2, meanDiff, s);
+	ZC_coMoments_float_scalar(data1, data2, n, mean1, mean2, meanDiff, &r);
+	err += ZC_checkSum("coMoments_float", "m2_1", s->m2_1, r.m2_1);
+	err += ZC_checkSum("coMoments_float", "m2_2", s->m2_2, r.m2_2);
+	err += ZC_checkSum("coMoments_float", "m2_diff", s->m2_diff, r.m2_diff);
+	err += ZC_checkSum("coMoments_float", "c12", s->c12, r.c12);
+	err += ZC_checkSum("coMoments_float", "c1d", s->c1d, r.c1d);
+	if(err)
+		ZC_countValidationError();
+}
+
+static void ZC_valueSums_float_validate(const float* data, size_t n, double* min, double* max, double* sum)
+{
+	double rmin, rmax, rsum;
+	int err = 0;
+	zc_checkedKernels->valueSums_float(data, n, min, max, sum);
+	ZC_valueSums_float_scalar(data, n, &rmin, &rmax, &rsum);
+	err += ZC_checkExact("valueSums_float", "min", *min, rmin);
+	err += ZC_checkExact("valueSums_float", "max", *max, rmax);
+	err += ZC_checkSum("valueSums_float", "sum", *sum, rsum);
+	if(err)
+		ZC_countValidationError();
+}
+
+static double ZC_sqDevSum_float_validate(const float* data, size_t n, double center)
+{
+	double sum = zc_checkedKernels->sqDevSum_float(data, n, center);
+	if(ZC_checkSum("sqDevSum_float", "sum", sum, ZC_sqDevSum_float_scalar(data, n, center)))
+		ZC_countValidationError();
+	return sum;
+}
+
+static size_t ZC_boundViolations_float_validate(const float* data1, const float* data2, size_t n, double absBound, double pwrBound, int andMode, double* maxErr)
+{
+	double rmaxErr;
+	int err = 0;
+	size_t count = zc_checkedKernels->boundViolations_float(data1, data2, n, absBound, pwrBound, andMode, maxErr);
+	size_t rcount = ZC_boundViolations_float_scalar(data1, data2, n, absBound, pwrBound, andMode, &rmaxErr);
+	err += ZC_checkExact("boundViolations_float", "count", count, rcount);
+	err += ZC_checkExact("boundViolations_float", "maxErr", *maxErr, rmaxErr);
+	if(err)
+		ZC_countValidationError();
+	return count;
+}
+
+static void ZC_diffSums_double_validate(const double* data1, const double* data2, size_t n, ZC_DiffSums* s)
+{
+	ZC_DiffSums r;
+	int err = 0;
+	zc_checkedKernels->diffSums_double(data1, data2, n, s);
+	ZC_diffSums_double_scalar(data1, data2, n, &r);
+	err += ZC_checkSum("diffSums_double", "sum1", s->sum1, r.sum1);
+	err += ZC_checkSum("diffSums_double", "sum2", s->sum2, r.sum2);
+	err += ZC_checkSum("diffSums_double", "sumDiff", s->sumDiff, r.sumDiff);
+	err += ZC_checkSum("diffSums_double", "sumErr", s->sumErr, r.sumErr);
+	err += ZC_checkSum("diffSums_double", "sumErrSqr", s->sumErrSqr, r.sumErrSqr);
+	err += ZC_checkExact("diffSums_double", "minDiff", s->minDiff, r.minDiff);
+	err += ZC_checkExact("diffSums_double", "maxDiff", s->maxDiff, r.maxDiff);
+	err += ZC_checkExact("diffSums_double", "minErr", s->minErr, r.minErr);
+	err += ZC_checkExact("diffSums_double", "maxErr", s->maxErr, r.maxErr);
+	if(err)
+		ZC_countValidationError();
+}
+
+static void ZC_relSums_double_validate(const double* data1, const double* data2, size_t n, ZC_RelSums* s)
+{
+	ZC_RelSums r;
+	int err = 0;
+	zc_checkedKernels->relSums_double(data1, data2, n, s);
+	ZC_relSums_double_scalar(data1, data2, n, &r);
+	err += ZC_checkExact("relSums_double", "n_rel", s->n_rel, r.n_rel);
+	err += ZC_checkExact("relSums_double", "minDiff_rel", s->minDiff_rel, r.minDiff_rel);
+	err += ZC_checkExact("relSums_double", "maxDiff_rel", s->maxDiff_rel, r.maxDiff_rel);
+	err += ZC_checkExact("relSums_double", "minErr_rel", s->minErr_rel, r.minErr_rel);
+	err += ZC_checkExact("relSums_double", "maxErr_rel", s->maxErr_rel, r.maxErr_rel);
+	err += ZC_checkSum("relSums_double", "sumErr_rel", s->sumErr_rel, r.sumErr_rel);
+	err += ZC_checkSum("relSums_double", "sumErrSqr_rel", s->sumErrSqr_rel, r.sumErrSqr_rel);
+	if(err)
+		ZC_countValidationError();
+}
+
+static void ZC_coMoments_double_validate(const double* data1, const double* data2, size_t n, double mean1, double mean2, double meanDiff, ZC_CoMoments* s)
+{
+	ZC_CoMoments r;
+	int err = 0;
+	zc_checkedKernels->coMoments_double(data1, data2, n, mean1, mean2, meanDiff, s);
+	ZC_coMoments_double_scalar(data1, data2, n, mean1, mean2, meanDiff, &r);
+	err += ZC_checkSum("coMoments_double", "m2_1", s->m2_1, r.m2_1);
+	err += ZC_checkSum("coMoments_double", "m2_2", s->m2_2, r.m2_2);
+	err += ZC_checkSum("coMoments_double", "m2_diff", s->m2_diff, r.m2_diff);
+	err += ZC_checkSum("coMoments_double", "c12", s->c12, r.c12);
+	err += ZC_checkSum("coMoments_double", "c1d", s->c1d, r.c1d);
+	if(err)
+		ZC_countValidationError();
+}
+
+static void ZC_valueSums_double_validate(const double* data, size_t n, double* min, double* max, double* sum)
+{
+	double rmin, rmax, rsum;
+	int err = 0;
+	zc_checkedKernels->valueSums_double(data, n, min, max, sum);
+	ZC_valueSums_double_scalar(data, n, &rmin, &rmax, &rsum);
+	err += ZC_checkExact("valueSums_double", "min", *min, rmin);
+	err += ZC_checkExact("valueSums_double", "max", *max, rmax);
+	err += ZC_checkSum("valueSums_double", "sum", *sum, rsum);
+	if(err)
+		ZC_countValidationError();
+}
+
+static double ZC_sqDevSum_double_validate(const double* data, size_t n, double center)
+{
+	double sum = zc_checkedKernels->sqDevSum_double(data, n, center);
+	if(ZC_checkSum("sqDevSum_double", "sum", sum, ZC_sqDevSum_double_scalar(data, n, center)))
+		ZC_countValidationError();
+	return sum;
+}
+
+static size_t ZC_boundViolations_double_validate(const double* data1, const double* data2, size_t n, double absBound, double pwrBound, int andMode, double* maxErr)
+{
+	double rmaxErr;
+	int err = 0;
+	size_t count = zc_checkedKernels->boundViolations_double(data1, data2, n, absBound, pwrBound, andMode, maxErr);
+	size_t rcount = ZC_boundViolations_double_scalar(data1, data2, n, absBound, pwrBound, andMode, &rmaxErr);
+	err += ZC_checkExact("boundViolations_double", "count", count, rcount);
+	err += ZC_checkExact("boundViolations_double", "maxErr", *maxErr, rmaxErr);
+	if(err)
+		ZC_countValidationError();
+	return count;
+}
+
+static ZC_Kernels zc_validationKernels = {
+	0, "validation",
+	ZC_diffSums_float_validate, ZC_diffSums_double_validate,
+	ZC_relSums_float_validate, ZC_relSums_double_validate,
+	ZC_coMoments_float_validate, ZC_coMoments_double_validate,
+	ZC_valueSums_float_validate, ZC_valueSums_double_validate,
+	ZC_sqDevSum_float_validate, ZC_sqDevSum_double_validate,
+	ZC_boundViolations_float_validate, ZC_boundViolations_double_validate
+};
+
+/*****************************dispatch*****************************/
+
+int ZC_parseSimdKernelType(const char* str)
+{
+	if(str == NULL || strcmp(str, "AUTO")==0 || strcmp(str, "auto")==0)
+		return ZC_SIMD_AUTO;
+	else if(strcmp(str, "SCALAR")==0 || strcmp(str, "scalar")==0)
+		return ZC_SIMD_SCALAR;
+	else if(strcmp(str, "AVX2")==0 || strcmp(str, "avx2")==0)
+		return ZC_SIMD_AVX2;
+	else if(strcmp(str, "AVX512")==0 || strcmp(str, "avx512")==0)
+		return ZC_SIMD_AVX512;
+	else if(strcmp(str, "NEON")==0 || strcmp(str, "neon")==0)
+		return ZC_SIMD_NEON;
+	printf("Error: Wrong simdKernel: %s\n", str);
+	printf("Example: simdKernel = AUTO, SCALAR, AVX2, AVX512, NEON\n");
+	exit(0);
+}
+
+/**
+ * The best instruction set supported by the running CPU (cpuid).
+ * */
+int ZC_detectSimdKernelType()
+{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	__builtin_cpu_init();
+	if(__builtin_cpu_supports("avx512f"))
+		return ZC_SIMD_AVX512;
+	if(__builtin_cpu_supports("avx2"))
+		return ZC_SIMD_AVX2;
+#elif defined(__aarch64__)
+	return ZC_SIMD_NEON;
+#endif
+	return ZC_SIMD_SCALAR;
+}
+
+/*whether the kernels of the given type run on a CPU whose best instruction set is best*/
+static int ZC_isSimdKernelSupported(int type, int best)
+{
+	if(type == ZC_SIMD_SCALAR)
+		return 1;
+	if(type == ZC_SIMD_NEON || best == ZC_SIMD_NEON)
+		return type == best;
+	return type <= best;
+}
+
+/**
+ * Select the kernels of the given type (ZC_SIMD_AUTO picks the best available one).
+ * An instruction set that is not supported falls back to the best available one; 
+ * the scalar kernels are always available. In the validation mode, every kernel 
+ * call is checked against the scalar reference.
+ * */
+void ZC_selectKernels(int type, int validation)
+{
+	int best = ZC_detectSimdKernelType();
+	int requested = type;
+	if(type == ZC_SIMD_AUTO || !ZC_isSimdKernelSupported(type, best))
+		type = best;
+	
+	switch(type)
+	{
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+	case ZC_SIMD_AVX512:
+		zc_checkedKernels = &zc_avx512Kernels;
+		break;
+	case ZC_SIMD_AVX2:
+		zc_checkedKernels = &zc_avx2Kernels;
+		break;
+#endif
+#if defined(__aarch64__)
+	case ZC_SIMD_NEON:
+		zc_checkedKernels = &zc_neonKernels;
+		break;
+#endif
+	default:
+		zc_checkedKernels = &zc_scalarKernels;
+	}
+	
+	if(requested != ZC_SIMD_AUTO && requested != type)
+		printf("[ZC] Warning: the requested simdKernel is not supported by this CPU, use the %s kernels instead\n", zc_checkedKernels->name);
+	simdKernelType = zc_checkedKernels->type;
+	simdValidationFlag = validation;
+	simdValidationErrors = 0;
+	zc_kernels = validation ? &zc_validationKernels : zc_checkedKernels;
+}
+
+ZC_Kernels* ZC_getKernels()
+{
+	if(zc_kernels == NULL)
+		ZC_selectKernels(simdKernelType, simdValidationFlag);
+	return zc_kernels;
+}
@@ -0,0 +1,338 @@
+/**
+ *  @file ZC_simd_neon.c
+ *  @brief NEON (AArch64) kernels of the error statistics (selected at runtime by ZC_selectKernels).
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#include "ZC_simd.h"
+
+#if defined(__aarch64__)
+
+#include <arm_neon.h>
+
+/*vminnm/vmaxnm return the number when the other operand is NaN, like the scalar comparisons*/
+static double ZC_hsum_neon(float64x2_t v)
+{
+	return vgetq_lane_f64(v, 0) + vgetq_lane_f64(v, 1);
+}
+
+static void ZC_diffSums_float_neon(const float* data1, const float* data2, size_t n, ZC_DiffSums* s)
+{
+	size_t i = 0;
+	ZC_DiffSums tail;
+	float64x2_t sum1 = vdupq_n_f64(0), sum2 = sum1, sumDiff = sum1, sumErr = sum1, sumErrSqr = sum1;
+	float64x2_t minDiff = vdupq_n_f64(1E100), maxDiff = vdupq_n_f64(-1E100), minErr = minDiff, maxErr = sum1;
+	for (; i + 2 <= n; i += 2)
+	{
+		float64x2_t x1 = vcvt_f64_f32(vld1_f32(data1+i));
+		float64x2_t x2 = vcvt_f64_f32(vld1_f32(data2+i));
+		float64x2_t diff = vcvt_f64_f32(vsub_f32(vld1_f32(data2+i), vld1_f32(data1+i)));
+		float64x2_t err = vabsq_f64(diff);
+		sum1 = vaddq_f64(sum1, x1);
+		sum2 = vaddq_f64(sum2, x2);
+		sumDiff = vaddq_f64(sumDiff, diff);
+		sumErr = vaddq_f64(sumErr, err);
+		sumErrSqr = vaddq_f64(sumErrSqr, vmulq_f64(err, err));
+		minDiff = vminnmq_f64(minDiff, diff);
+		maxDiff = vmaxnmq_f64(maxDiff, diff);
+		minErr = vminnmq_f64(minErr, err);
+		maxErr = vmaxnmq_f64(maxErr, err);
+	}
+	s->sum1 = ZC_hsum_neon(sum1);
+	s->sum2 = ZC_hsum_neon(sum2);
+	s->sumDiff = ZC_hsum_neon(sumDiff);
+	s->sumErr = ZC_hsum_neon(sumErr);
+	s->sumErrSqr = ZC_hsum_neon(sumErrSqr);
+	s->minDiff = vminnmvq_f64(minDiff);
+	s->maxDiff = vmaxnmvq_f64(maxDiff);
+	s->minErr = vminnmvq_f64(minErr);
+	s->maxErr = vmaxnmvq_f64(maxErr);
+	ZC_diffSums_float_scalar(data1+i, data2+i, n-i, &tail);
+	ZC_mergeDiffSums(s, &tail);
+}
+
+static void ZC_relSums_float_neon(const float* data1, const float* data2, size_t n, ZC_RelSums* s)
+{
+	size_t i = 0, n_rel = 0;
+	ZC_RelSums tail;
+	float64x2_t zero = vdupq_n_f64(0), one = vdupq_n_f64(1), big = vdupq_n_f64(1E100), nbig = vdupq_n_f64(-1E100);
+	float64x2_t minDiff_rel = big, maxDiff_rel = nbig, minErr_rel = big, maxErr_rel = zero;
+	float64x2_t sumErr_rel = zero, sumErrSqr_rel = zero;
+	for (; i + 2 <= n; i += 2)
+	{
+		float64x2_t x1 = vcvt_f64_f32(vld1_f32(data1+i));
+		float64x2_t diff = vcvt_f64_f32(vsub_f32(vld1_f32(data2+i), vld1_f32(data1+i)));
+		uint64x2_t isZero = vceqzq_f64(x1);
+		float64x2_t relDiff = vdivq_f64(diff, vbslq_f64(isZero, one, x1));
+		float64x2_t err = vbslq_f64(isZero, zero, vabsq_f64(relDiff));
+		n_rel += 2 - (vgetq_lane_u64(isZero, 0) & 1) - (vgetq_lane_u64(isZero, 1) & 1);
+		minDiff_rel = vminnmq_f64(minDiff_rel, vbslq_f64(isZero, big, relDiff));
+		maxDiff_rel = vmaxnmq_f64(maxDiff_rel, vbslq_f64(isZero, nbig, relDiff));
+		minErr_rel = vminnmq_f64(minErr_rel, vbslq_f64(isZero, big, err));
+		maxErr_rel = vmaxnmq_f64(maxErr_rel, err);
+		sumErr_rel = vaddq_f64(sumErr_rel, err);
+		sumErrSqr_rel = vaddq_f64(sumErrSqr_rel, vmulq_f64(err, err));
+	}
+	s->n_rel = n_rel;
+	s->minDiff_rel = vminnmvq_f64(minDiff_rel);
+	s->maxDiff_rel = vmaxnmvq_f64(maxDiff_rel);
+	s->minErr_rel = vminnmvq_f64(minErr_rel);
+	s->maxErr_rel = vmaxnmvq_f64(maxErr_rel);
+	s->sumErr_rel = ZC_hsum_neon(sumErr_rel);
+	s->sumErrSqr_rel = ZC_hsum_neon(sumErrSqr_rel);
+	ZC_relSums_float_scalar(data1+i, data2+i, n-i, &tail);
+	ZC_mergeRelSums(s, &tail);
+}
+
+static void ZC_coMoments_float_neon(const float* data1, const float* data2, size_t n, double mean1, double mean2, double meanDiff, ZC_CoMoments* s)
+{
+	size_t i = 0;
+	ZC_CoMoments tail;
+	float64x2_t vmean1 = vdupq_n_f64(mean1), vmean2 = vdupq_n_f64(mean2), vmeanDiff = vdupq_n_f64(meanDiff);
+	float64x2_t m2_1 = vdupq_n_f64(0), m2_2 = m2_1, m2_diff = m2_1, c12 = m2_1, c1d = m2_1;
+	for (; i + 2 <= n; i += 2)
+	{
+		float64x2_t d1 = vsubq_f64(vcvt_f64_f32(vld1_f32(data1+i)), vmean1);
+		float64x2_t d2 = vsubq_f64(vcvt_f64_f32(vld1_f32(data2+i)), vmean2);
+		float64x2_t dd = vsubq_f64(vcvt_f64_f32(vsub_f32(vld1_f32(data2+i), vld1_f32(data1+i))), vmeanDiff);
+		m2_1 = vaddq_f64(m2_1, vmulq_f64(d1, d1));
+		m2_2 = vaddq_f64(m2_2, vmulq_f64(d2, d2));
+		m2_diff = vaddq_f64(m2_diff, vmulq_f64(dd, dd));
+		c12 = vaddq_f64(c12, vmulq_f64(d1, d2));
+		c1d = vaddq_f64(c1d, vmulq_f64(d1, dd));
+	}
+	ZC_coMoments_float_scalar(data1+i, data2+i, n-i, mean1, mean2, meanDiff, &tail);
+	s->m2_1 = ZC_hsum_neon(m2_1) + tail.m2_1;
+	s->m2_2 = ZC_hsum_neon(m2_2) + tail.m2_2;
+	s->m2_diff = ZC_hsum_neon(m2_diff) + tail.m2_diff;
+	s->c12 = ZC_hsum_neon(c12) + tail.c12;
+	s->c1d = ZC_hsum_neon(c1d) + tail.c1d;
+}
+
+static void ZC_valueSums_float_neon(const float* data, size_t n, double* min, double* max, double* sum)
+{
+	size_t i = 0;
+	double tmin, tmax, tsum;
+	float64x2_t vmin = vdupq_n_f64(data[0]), vmax = vmin, vsum = vdupq_n_f64(0);
+	for (; i + 2 <= n; i += 2)
+	{
+		float64x2_t x = vcvt_f64_f32(vld1_f32(data+i));
+		vmin = vminnmq_f64(vmin, x);
+		vmax = vmaxnmq_f64(vmax, x);
+		vsum = vaddq_f64(vsum, x);
+	}
+	*min = vminnmvq_f64(vmin);
+	*max = vmaxnmvq_f64(vmax);
+	*sum = ZC_hsum_neon(vsum);
+	if(i < n)
+	{
+		ZC_valueSums_float_scalar(data+i, n-i, &tmin, &tmax, &tsum);
+		if(*min > tmin) *min = tmin;
+		if(*max < tmax) *max = tmax;
+		*sum += tsum;
+	}
+}
+
+static double ZC_sqDevSum_float_neon(const float* data, size_t n, double center)
+{
+	size_t i = 0;
+	float64x2_t vcenter = vdupq_n_f64(center), vsum = vdupq_n_f64(0);
+	for (; i + 2 <= n; i += 2)
+	{
+		float64x2_t d = vsubq_f64(vcvt_f64_f32(vld1_f32(data+i)), vcenter);
+		vsum = vaddq_f64(vsum, vmulq_f64(d, d));
+	}
+	return ZC_hsum_neon(vsum) + ZC_sqDevSum_float_scalar(data+i, n-i, center);
+}
+
+static void ZC_diffSums_double_neon(const double* data1, const double* data2, size_t n, ZC_DiffSums* s)
+{
+	size_t i = 0;
+	ZC_DiffSums tail;
+	float64x2_t sum1 = vdupq_n_f64(0), sum2 = sum1, sumDiff = sum1, sumErr = sum1, sumErrSqr = sum1;
+	float64x2_t minDiff = vdupq_n_f64(1E100), maxDiff = vdupq_n_f64(-1E100), minErr = minDiff, maxErr = sum1;
+	for (; i + 2 <= n; i += 2)
+	{
+		float64x2_t x1 = vld1q_f64(data1+i);
+		float64x2_t x2 = vld1q_f64(data2+i);
+		float64x2_t diff = vsubq_f64(vld1q_f64(data2+i), vld1q_f64(data1+i));
+		float64x2_t err = vabsq_f64(diff);
+		sum1 = vaddq_f64(sum1, x1);
+		sum2 = vaddq_f64(sum2, x2);
+		sumDiff = vaddq_f64(sumDiff, diff);
+		sumErr = vaddq_f64(sumErr, err);
+		sumErrSqr = vaddq_f64(sumErrSqr, vmulq_f64(err, err));
+		minDiff = vminnmq_f64(minDiff, diff);
+		maxDiff = vmaxnmq_f64(maxDiff, diff);
+		minErr = vminnmq_f64(minErr, err);
+		maxErr = vmaxnmq_f64(maxErr, err);
+	}
+	s->sum1 = ZC_hsum_neon(sum1);
+	s->sum2 = ZC_hsum_neon(sum2);
+	s->sumDiff = ZC_hsum_neon(sumDiff);
+	s->sumErr = ZC_hsum_neon(sumErr);
+	s->sumErrSqr = ZC_hsum_neon(sumErrSqr);
+	s->minDiff = vminnmvq_f64(minDiff);
+	s->maxDiff = vmaxnmvq_f64(maxDiff);
+	s->minErr = vminnmvq_f64(minErr);
+	s->maxErr = vmaxnmvq_f64(maxErr);
+	ZC_diffSums_double_scalar(data1+i, data2+i, n-i, &tail);
+	ZC_mergeDiffSums(s, &tail);
+}
+
+static void ZC_relSums_double_neon(const double* data1, const double* data2, size_t n, ZC_RelSums* s)
+{
+	size_t i = 0, n_rel = 0;
+	ZC_RelSums tail;
+	float64x2_t zero = vdupq_n_f64(0), one = vdupq_n_f64(1), big = vdupq_n_f64(1E100), nbig = vdupq_n_f64(-1E100);
+	float64x2_t minDiff_rel = big, maxDiff_rel = nbig, minErr_rel = big, maxErr_rel = zero;
+	float64x2_t sumErr_rel = zero, sumErrSqr_rel = zero;
+	for (; i + 2 <= n; i += 2)
+	{
+		float64x2_t x1 = vld1q_f64(data1+i);
+		float64x2_t diff = vsubq_f64(vld1q_f64(data2+i), vld1q_f64(data1+i));
+		uint64x2_t isZero = vceqzq_f64(x1);
+		float64x2_t relDiff = vdivq_f64(diff, vbslq_f64(isZero, one, x1));
+		float64x2_t err = vbslq_f64(isZero, zero, vabsq_f64(relDiff));
+		n_rel += 2 - (vgetq_lane_u64(isZero, 0) & 1) - (vgetq_lane_u64(isZero, 1) & 1);
+		minDiff_rel = vminnmq_f64(minDiff_rel, vbslq_f64(isZero, big, relDiff));
+		maxDiff_rel = vmaxnmq_f64(maxDiff_rel, vbslq_f64(isZero, nbig, relDiff));
+		minErr_rel = vminnmq_f64(minErr_rel, vbslq_f64(isZero, big, err));
+		maxErr_rel = vmaxnmq_f64(maxErr_rel, err);
+		sumErr_rel = vaddq_f64(sumErr_rel, err);
+		sumErrSqr_rel = vaddq_f64(sumErrSqr_rel, vmulq_f64(err, err));
+	}
+	s->n_rel = n_rel;
+	s->minDiff_rel = vminnmvq_f64(minDiff_rel);
+	s->maxDiff_rel = vmaxnmvq_f64(maxDiff_rel);
+	s->minErr_rel = vminnmvq_f64(minErr_rel);
+	s->maxErr_rel = vmaxnmvq_f64(maxErr_rel);
+	s->sumErr_rel = ZC_hsum_neon(sumErr_rel);
+	s->sumErrSqr_rel = ZC_hsum_neon(sumErrSqr_rel);
+	ZC_relSums_double_scalar(data1+i, data2+i, n-i, &tail);
+	ZC_mergeRelSums(s, &tail);
+}
+
+static void ZC_coMoments_double_neon(const double* data1, const double* data2, size_t n, double mean1, double mean2, double meanDiff, ZC_CoMoments* s)
+{
+	size_t i = 0;
+	ZC_CoMoments tail;
+	float64x2_t vmean1 = vdupq_n_f64(mean1), vmean2 = vdupq_n_f64(mean2), vmeanDiff = vdupq_n_f64(meanDiff);
+	float64x2_t m2_1 = vdupq_n_f64(0), m2_2 = m2_1, m2_diff = m2_1, c12 = m2_1, c1d = m2_1;
+	for (; i + 2 <= n; i += 2)
+	{
+		float64x2_t d1 = vsubq_f64(vld1q_f64(data1+i), vmean1);
+		float64x2_t d2 = vsubq_f64(vld1q_f64(data2+i), vmean2);
+		float64x2_t dd = vsubq_f64(vsubq_f64(vld1q_f64(data2+i), vld1q_f64(data1+i)), vmeanDiff);
+		m2_1 = vaddq_f64(m2_1, vmulq_f64(d1, d1));
+		m2_2 = vaddq_f64(m2_2, vmulq_f64(d2, d2));
+		m2_diff = vaddq_f64(m2_diff, vmulq_f64(dd, dd));
+		c12 = vaddq_f64(c12, vmulq_f64(d1, d2));
+		c1d = vaddq_f64(c1d, vmulq_f64(d1, dd));
+	}
+	ZC_coMoments_double_scalar(data1+i, data2+i, n-i, mean1, mean2, meanDiff, &tail);
+	s->m2_1 = ZC_hsum_neon(m2_1) + tail.m2_1;
+	s->m2_2 = ZC_hsum_neon(m2_2) + tail.m2_2;
+	s->m2_diff = ZC_hsum_neon(m2_diff) + tail.m2_diff;
+	s->c12 = ZC_hsum_neon(c12) + tail.c12;
+	s->c1d = ZC_hsum_neon(c1d) + tail.c1d;
+}
+
+static void ZC_valueSums_double_neon(const double* data, size_t n, double* min, double* max, double* sum)
+{
+	size_t i = 0;
+	double tmin, tmax, tsum;
+	float64x2_t vmin = vdupq_n_f64(data[0]), vmax = vmin, vsum = vdupq_n_f64(0);
+	for (; i + 2 <= n; i += 2)
+	{
+		float64x2_t x = vld1q_f64(data+i);
+		vmin = vminnmq_f64(vmin, x);
+		vmax = vmaxnmq_f64(vmax, x);
+		vsum = vaddq_f64(vsum, x);
+	}
+	*min = vminnmvq_f64(vmin);
+	*max = vmaxnmvq_f64(vmax);
+	*sum = ZC_hsum_neon(vsum);
+	if(i < n)
+	{
+		ZC_valueSums_double_scalar(data+i, n-i, &tmin, &tmax, &tsum);
+		if(*min > tmin) *min = tmin;
+		if(*max < tmax) *max = tmax;
+		*sum += tsum;
+	}
+}
+
+static double ZC_sqDevSum_double_neon(const double* data, size_t n, double center)
+{
+	size_t i = 0;
+	float64x2_t vcenter = vdupq_n_f64(center), vsum = vdupq_n_f64(0);
+	for (; i + 2 <= n; i += 2)
+	{
+		float64x2_t d = vsubq_f64(vld1q_f64(data+i), vcenter);
+		vsum = vaddq_f64(vsum, vmulq_f64(d, d));
+	}
+	return ZC_hsum_neon(vsum) + ZC_sqDevSum_double_scalar(data+i, n-i, center);
+}
+
+static size_t ZC_boundViolations_float_neon(const float* data1, const float* data2, size_t n, double absBound, double pwrBound, int andMode, double* maxErr)
+{
+	size_t i = 0, count;
+	double tmaxErr;
+	float64x2_t vabs = vdupq_n_f64(absBound), vpwr = vdupq_n_f64(pwrBound), vmaxErr = vdupq_n_f64(0);
+	uint64x2_t vok = vdupq_n_u64(0);
+	for (; i + 2 <= n; i += 2)
+	{
+		float32x2_t x1 = vld1_f32(data1+i);
+		float64x2_t err = vabsq_f64(vcvt_f64_f32(vsub_f32(vld1_f32(data2+i), x1)));
+		float64x2_t bound = vmulq_f64(vpwr, vabsq_f64(vcvt_f64_f32(x1)));
+		bound = andMode ? vminnmq_f64(bound, vabs) : vmaxnmq_f64(bound, vabs);
+		vok = vsubq_u64(vok, vcleq_f64(err, bound)); //counts the points with err<=bound (false for NaN)
+		vmaxErr = vmaxnmq_f64(vmaxErr, err);
+	}
+	count = i - (vgetq_lane_u64(vok, 0) + vgetq_lane_u64(vok, 1));
+	*maxErr = vmaxnmvq_f64(vmaxErr);
+	if(i < n)
+	{
+		count += ZC_boundViolations_float_scalar(data1+i, data2+i, n-i, absBound, pwrBound, andMode, &tmaxErr);
+		if(*maxErr < tmaxErr) *maxErr = tmaxErr;
+	}
+	return count;
+}
+
+static size_t ZC_boundViolations_double_neon(const double* data1, const double* data2, size_t n, double absBound, double pwrBound, int andMode, double* maxErr)
+{
+	size_t i = 0, count;
+	double tmaxErr;
+	float64x2_t vabs = vdupq_n_f64(absBound), vpwr = vdupq_n_f64(pwrBound), vmaxErr = vdupq_n_f64(0);
+	uint64x2_t vok = vdupq_n_u64(0);
+	for (; i + 2 <= n; i += 2)
+	{
+		float64x2_t x1 = vld1q_f64(data1+i);
+		float64x2_t err = vabsq_f64(vsubq_f64(vld1q_f64(data2+i), x1));
+		float64x2_t bound = vmulq_f64(vpwr, vabsq_f64(x1));
+		bound = andMode ? vminnmq_f64(bound, vabs) : vmaxnmq_f64(bound, vabs);
+		vok = vsubq_u64(vok, vcleq_f64(err, bound)); //counts the points with err<=bound (false for NaN)
+		vmaxErr = vmaxnmq_f64(vmaxErr, err);
+	}
+	count = i - (vgetq_lane_u64(vok, 0) + vgetq_lane_u64(vok, 1));
+	*maxErr = vmaxnmvq_f64(vmaxErr);
+	if(i < n)
+	{
+		count += ZC_boundViolations_double_scalar(data1+i, data2+i, n-i, absBound, pwrBound, andMode, &tmaxErr);
+		if(*maxErr < tmaxErr) *maxErr = tmaxErr;
+	}
+	return count;
+}
+
+ZC_Kernels zc_neonKernels = {
+	ZC_SIMD_NEON, "neon",
+	ZC_diffSums_float_neon, ZC_diffSums_double_neon,
+	ZC_relSums_float_neon, ZC_relSums_double_neon,
+	ZC_coMoments_float_neon, ZC_coMoments_double_neon,
+	ZC_valueSums_float_neon, ZC_valueSums_double_neon,
+	ZC_sqDevSum_float_neon, ZC_sqDevSum_double_neon,
+	ZC_boundViolations_float_neon, ZC_boundViolations_double_neon
+};
+
+#endif
@@ -0,0 +1,722 @@
+/**
+ *  @file ZC_simd_x86.c
+ *  @brief AVX2 and AVX-512 kernels of the error statistics (selected at runtime by ZC_selectKernels).
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#include "ZC_simd.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+
+#include <immintrin.h>
+
+/*the kernels are compiled for their own instruction set only, so the library still runs on older CPUs.
+ * The min/max operands are ordered (x, acc) so that NaN values are skipped like in the scalar code; 
+ * the sums are accumulated per lane, so they can differ from the scalar ones in the last bits.*/
+#define ZC_TARGET_AVX2 __attribute__((target("avx2")))
+#define ZC_TARGET_AVX512 __attribute__((target("avx512f")))
+
+/*****************************AVX2*****************************/
+
+ZC_TARGET_AVX2 static double ZC_hsum_avx2(__m256d v)
+{
+	double t[4];
+	_mm256_storeu_pd(t, v);
+	return (t[0]+t[1])+(t[2]+t[3]);
+}
+
+ZC_TARGET_AVX2 static double ZC_hmin_avx2(__m256d v)
+{
+	int k;
+	double t[4], m;
+	_mm256_storeu_pd(t, v);
+	m = t[0];
+	for (k = 1; k < 4; k++)
+		if(m > t[k]) m = t[k];
+	return m;
+}
+
+ZC_TARGET_AVX2 static double ZC_hmax_avx2(__m256d v)
+{
+	int k;
+	double t[4], m;
+	_mm256_storeu_pd(t, v);
+	m = t[0];
+	for (k = 1; k < 4; k++)
+		if(m < t[k]) m = t[k];
+	return m;
+}
+
+ZC_TARGET_AVX2 static void ZC_diffSums_float_avx2(const float* data1, const float* data2, size_t n, ZC_DiffSums* s)
+{
+	size_t i = 0;
+	ZC_DiffSums tail;
+	__m256d signMask = _mm256_set1_pd(-0.0);
+	__m256d sum1 = _mm256_set1_pd(0), sum2 = _mm256_set1_pd(0), sumDiff = _mm256_set1_pd(0), sumErr = _mm256_set1_pd(0), sumErrSqr = _mm256_set1_pd(0);
+	__m256d minDiff = _mm256_set1_pd(1E100), maxDiff = _mm256_set1_pd(-1E100), minErr = _mm256_set1_pd(1E100), maxErr = _mm256_set1_pd(0);
+	for (; i + 4 <= n; i += 4)
+	{
+		__m256d x1 = _mm256_cvtps_pd(_mm_loadu_ps(data1+i));
+		__m256d x2 = _mm256_cvtps_pd(_mm_loadu_ps(data2+i));
+		__m256d diff = _mm256_cvtps_pd(_mm_sub_ps(_mm_loadu_ps(data2+i), _mm_loadu_ps(data1+i)));
+		__m256d err = _mm256_andnot_pd(signMask, diff);
+		sum1 = _mm256_add_pd(sum1, x1);
+		sum2 = _mm256_add_pd(sum2, x2);
+		sumDiff = _mm256_add_pd(sumDiff, diff);
+		sumErr = _mm256_add_pd(sumErr, err);
+		sumErrSqr = _mm256_add_pd(sumErrSqr, _mm256_mul_pd(err, err));
+		minDiff = _mm256_min_pd(diff, minDiff);
+		maxDiff = _mm256_max_pd(diff, maxDiff);
+		minErr = _mm256_min_pd(err, minErr);
+		maxErr = _mm256_max_pd(err, maxErr);
+	}
+	s->sum1 = ZC_hsum_avx2(sum1);
+	s->sum2 = ZC_hsum_avx2(sum2);
+	s->sumDiff = ZC_hsum_avx2(sumDiff);
+	s->sumErr = ZC_hsum_avx2(sumErr);
+	s->sumErrSqr = ZC_hsum_avx2(sumErrSqr);
+	s->minDiff = ZC_hmin_avx2(minDiff);
+	s->maxDiff = ZC_hmax_avx2(maxDiff);
+	s->minErr = ZC_hmin_avx2(minErr);
+	s->maxErr = ZC_hmax_avx2(maxErr);
+	ZC_diffSums_float_scalar(data1+i, data2+i, n-i, &tail);
+	ZC_mergeDiffSums(s, &tail);
+}
+
+ZC_TARGET_AVX2 static void ZC_relSums_float_avx2(const float* data1, const float* data2, size_t n, ZC_RelSums* s)
+{
+	size_t i = 0, n_rel = 0;
+	ZC_RelSums tail;
+	__m256d signMask = _mm256_set1_pd(-0.0);
+	__m256d one = _mm256_set1_pd(1), big = _mm256_set1_pd(1E100), nbig = _mm256_set1_pd(-1E100);
+	__m256d minDiff_rel = big, maxDiff_rel = nbig, minErr_rel = big, maxErr_rel = _mm256_set1_pd(0);
+	__m256d sumErr_rel = _mm256_set1_pd(0), sumErrSqr_rel = _mm256_set1_pd(0);
+	for (; i + 4 <= n; i += 4)
+	{
+		__m256d x1 = _mm256_cvtps_pd(_mm_loadu_ps(data1+i));
+		__m256d diff = _mm256_cvtps_pd(_mm_sub_ps(_mm_loadu_ps(data2+i), _mm_loadu_ps(data1+i)));
+		__m256d mask = _mm256_cmp_pd(x1, _mm256_set1_pd(0), _CMP_NEQ_UQ);
+		__m256d relDiff = _mm256_div_pd(diff, _mm256_blendv_pd(one, x1, mask));
+		__m256d err = _mm256_and_pd(_mm256_andnot_pd(signMask, relDiff), mask);
+		n_rel += __builtin_popcount(_mm256_movemask_pd(mask));
+		minDiff_rel = _mm256_min_pd(_mm256_blendv_pd(big, relDiff, mask), minDiff_rel);
+		maxDiff_rel = _mm256_max_pd(_mm256_blendv_pd(nbig, relDiff, mask), maxDiff_rel);
+		minErr_rel = _mm256_min_pd(_mm256_blendv_pd(big, err, mask), minErr_rel);
+		maxErr_rel = _mm256_max_pd(err, maxErr_rel);
+		sumErr_rel = _mm256_add_pd(sumErr_rel, err);
+		sumErrSqr_rel = _mm256_add_pd(sumErrSqr_rel, _mm256_mul_pd(err, err));
+	}
+	s->n_rel = n_rel;
+	s->minDiff_rel = ZC_hmin_avx2(minDiff_rel);
+	s->maxDiff_rel = ZC_hmax_avx2(maxDiff_rel);
+	s->minErr_rel = ZC_hmin_avx2(minErr_rel);
+	s->maxErr_rel = ZC_hmax_avx2(maxErr_rel);
+	s->sumErr_rel = ZC_hsum_avx2(sumErr_rel);
+	s->sumErrSqr_rel = ZC_hsum_avx2(sumErrSqr_rel);
+	ZC_relSums_float_scalar(data1+i, data2+i, n-i, &tail);
+	ZC_mergeRelSums(s, &tail);
+}
+
+ZC_TARGET_AVX2 static void ZC_coMoments_float_avx2(const float* data1, const float* data2, size_t n, double mean1, double mean2, double meanDiff, ZC_CoMoments* s)
+{
+	size_t i = 0;
+	ZC_CoMoments tail;
+	__m256d vmean1 = _mm256_set1_pd(mean1), vmean2 = _mm256_set1_pd(mean2), vmeanDiff = _mm256_set1_pd(meanDiff);
+	__m256d m2_1 = _mm256_set1_pd(0), m2_2 = _mm256_set1_pd(0), m2_diff = _mm256_set1_pd(0), c12 = _mm256_set1_pd(0), c1d = _mm256_set1_pd(0);
+	for (; i + 4 <= n; i += 4)
+	{
+		__m256d d1 = _mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(data1+i)), vmean1);
+		__m256d d2 = _mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(data2+i)), vmean2);
+		__m256d dd = _mm256_sub_pd(_mm256_cvtps_pd(_mm_sub_ps(_mm_loadu_ps(data2+i), _mm_loadu_ps(data1+i))), vmeanDiff);
+		m2_1 = _mm256_add_pd(m2_1, _mm256_mul_pd(d1, d1));
+		m2_2 = _mm256_add_pd(m2_2, _mm256_mul_pd(d2, d2));
+		m2_diff = _mm256_add_pd(m2_diff, _mm256_mul_pd(dd, dd));
+		c12 = _mm256_add_pd(c12, _mm256_mul_pd(d1, d2));
+		c1d = _mm256_add_pd(c1d, _mm256_mul_pd(d1, dd));
+	}
+	ZC_coMoments_float_scalar(data1+i, data2+i, n-i, mean1, mean2, meanDiff, &tail);
+	s->m2_1 = ZC_hsum_avx2(m2_1) + tail.m2_1;
+	s->m2_2 = ZC_hsum_avx2(m2_2) + tail.m2_2;
+	s->m2_diff = ZC_hsum_avx2(m2_diff) + tail.m2_diff;
+	s->c12 = ZC_hsum_avx2(c12) + tail.c12;
+	s->c1d = ZC_hsum_avx2(c1d) + tail.c1d;
+}
+
+ZC_TARGET_AVX2 static void ZC_valueSums_float_avx2(const float* data, size_t n, double* min, double* max, double* sum)
+{
+	size_t i = 0;
+	double tmin, tmax, tsum;
+	__m256d vmin = _mm256_set1_pd(data[0]), vmax = vmin, vsum = _mm256_set1_pd(0);
+	for (; i + 4 <= n; i += 4)
+	{
+		__m256d x = _mm256_cvtps_pd(_mm_loadu_ps(data+i));
+		vmin = _mm256_min_pd(x, vmin);
+		vmax = _mm256_max_pd(x, vmax);
+		vsum = _mm256_add_pd(vsum, x);
+	}
+	*min = ZC_hmin_avx2(vmin);
+	*max = ZC_hmax_avx2(vmax);
+	*sum = ZC_hsum_avx2(vsum);
+	if(i < n)
+	{
+		ZC_valueSums_float_scalar(data+i, n-i, &tmin, &tmax, &tsum);
+		if(*min > tmin) *min = tmin;
+		if(*max < tmax) *max = tmax;
+		*sum += tsum;
+	}
+}
+
+ZC_TARGET_AVX2 static double ZC_sqDevSum_float_avx2(const float* data, size_t n, double center)
+{
+	size_t i = 0;
+	__m256d vcenter = _mm256_set1_pd(center), vsum = _mm256_set1_pd(0);
+	for (; i + 4 <= n; i += 4)
+	{
+		__m256d d = _mm256_sub_pd(_mm256_cvtps_pd(_mm_loadu_ps(data+i)), vcenter);
+		vsum = _mm256_add_pd(vsum, _mm256_mul_pd(d, d));
+	}
+	return ZC_hsum_avx2(vsum) + ZC_sqDevSum_float_scalar(data+i, n-i, center);
+}
+
+ZC_TARGET_AVX2 static void ZC_diffSums_double_avx2(const double* data1, const double* data2, size_t n, ZC_DiffSums* s)
+{
+	size_t i = 0;
+	ZC_DiffSums tail;
+	__m256d signMask = _mm256_set1_pd(-0.0);
+	__m256d sum1 = _mm256_set1_pd(0), sum2 = _mm256_set1_pd(0), sumDiff = _mm256_set1_pd(0), sumErr = _mm256_set1_pd(0), sumErrSqr = _mm256_set1_pd(0);
+	__m256d minDiff = _mm256_set1_pd(1E100), maxDiff = _mm256_set1_pd(-1E100), minErr = _mm256_set1_pd(1E100), maxErr = _mm256_set1_pd(0);
+	for (; i + 4 <= n; i += 4)
+	{
+		__m256d x1 = _mm256_loadu_pd(data1+i);
+		__m256d x2 = _mm256_loadu_pd(data2+i);
+		__m256d diff = _mm256_sub_pd(_mm256_loadu_pd(data2+i), _mm256_loadu_pd(data1+i));
+		__m256d err = _mm256_andnot_pd(signMask, diff);
+		sum1 = _mm256_add_pd(sum1, x1);
+		sum2 = _mm256_add_pd(sum2, x2);
+		sumDiff = _mm256_add_pd(sumDiff, diff);
+		sumErr = _mm256_add_pd(sumErr, err);
+		sumErrSqr = _mm256_add_pd(sumErrSqr, _mm256_mul_pd(err, err));
+		minDiff = _mm256_min_pd(diff, minDiff);
+		maxDiff = _mm256_max_pd(diff, maxDiff);
+		minErr = _mm256_min_pd(err, minErr);
+		maxErr = _mm256_max_pd(err, maxErr);
+	}
+	s->sum1 = ZC_hsum_avx2(sum1);
+	s->sum2 = ZC_hsum_avx2(sum2);
+	s->sumDiff = ZC_hsum_avx2(sumDiff);
+	s->sumErr = ZC_hsum_avx2(sumErr);
+	s->sumErrSqr = ZC_hsum_avx2(sumErrSqr);
+	s->minDiff = ZC_hmin_avx2(minDiff);
+	s->maxDiff = ZC_hmax_avx2(maxDiff);
+	s->minErr = ZC_hmin_avx2(minErr);
+	s->maxErr = ZC_hmax_avx2(maxErr);
+	ZC_diffSums_double_scalar(data1+i, data2+i, n-i, &tail);
+	ZC_mergeDiffSums(s, &tail);
+}
+
+ZC_TARGET_AVX2 static void ZC_relSums_double_avx2(const double* data1, const double* data2, size_t n, ZC_RelSums* s)
+{
+	size_t i = 0, n_rel = 0;
+	ZC_RelSums tail;
+	__m256d signMask = _mm256_set1_pd(-0.0);
+	__m256d one = _mm256_set1_pd(1), big = _mm256_set1_pd(1E100), nbig = _mm256_set1_pd(-1E100);
+	__m256d minDiff_rel = big, maxDiff_rel = nbig, minErr_rel = big, maxErr_rel = _mm256_set1_pd(0);
+	__m256d sumErr_rel = _mm256_set1_pd(0), sumErrSqr_rel = _mm256_set1_pd(0);
+	for (; i + 4 <= n; i += 4)
+	{
+		__m256d x1 = _mm256_loadu_pd(data1+i);
+		__m256d diff = _mm256_sub_pd(_mm256_loadu_pd(data2+i), _mm256_loadu_pd(data1+i));
+		__m256d mask = _mm256_cmp_pd(x1, _mm256_set1_pd(0), _CMP_NEQ_UQ);
+		__m256d relDiff = _mm256_div_pd(diff, _mm256_blendv_pd(one, x1, mask));
+		__m256d err = _mm256_and_pd(_mm256_andnot_pd(signMask, relDiff), mask);
+		n_rel += __builtin_popcount(_mm256_movemask_pd(mask));
+		minDiff_rel = _mm256_min_pd(_mm256_blendv_pd(big, relDiff, mask), minDiff_rel);
+		maxDiff_rel = _mm256_max_pd(_mm256_blendv_pd(nbig, relDiff, mask), maxDiff_rel);
+		minErr_rel = _mm256_min_pd(_mm256_blendv_pd(big, err, mask), minErr_rel);
+		maxErr_rel = _mm256_max_pd(err, maxErr_rel);
+		sumErr_rel = _mm256_add_pd(sumErr_rel, err);
+		sumErrSqr_rel = _mm256_add_pd(sumErrSqr_rel, _mm256_mul_pd(err, err));
+	}
+	s->n_rel = n_rel;
+	s->minDiff_rel = ZC_hmin_avx2(minDiff_rel);
+	s->maxDiff_rel = ZC_hmax_avx2(maxDiff_rel);
+	s->minErr_rel = ZC_hmin_avx2(minErr_rel);
+	s->maxErr_rel = ZC_hmax_avx2(maxErr_rel);
+	s->sumErr_rel = ZC_hsum_avx2(sumErr_rel);
+	s->sumErrSqr_rel = ZC_hsum_avx2(sumErrSqr_rel);
+	ZC_relSums_double_scalar(data1+i, data2+i, n-i, &tail);
+	ZC_mergeRelSums(s, &tail);
+}
+
+ZC_TARGET_AVX2 static void ZC_coMoments_double_avx2(const double* data1, const double* data2, size_t n, double mean1, double mean2, double meanDiff, ZC_CoMoments* s)
+{
+	size_t i = 0;
+	ZC_CoMoments tail;
+	__m256d vmean1 = _mm256_set1_pd(mean1), vmean2 = _mm256_set1_pd(mean2), vmeanDiff = _mm256_set1_pd(meanDiff);
+	__m256d m2_1 = _mm256_set1_pd(0), m2_2 = _mm256_set1_pd(0), m2_diff = _mm256_set1_pd(0), c12 = _mm256_set1_pd(0), c1d = _mm256_set1_pd(0);
+	for (; i + 4 <= n; i += 4)
+	{
+		__m256d d1 = _mm256_sub_pd(_mm256_loadu_pd(data1+i), vmean1);
+		__m256d d2 = _mm256_sub_pd(_mm256_loadu_pd(data2+i), vmean2);
+		__m256d dd = _mm256_sub_pd(_mm256_sub_pd(_mm256_loadu_pd(data2+i), _mm256_loadu_pd(data1+i)), vmeanDiff);
+		m2_1 = _mm256_add_pd(m2_1, _mm256_mul_pd(d1, d1));
+		m2_2 = _mm256_add_pd(m2_2, _mm256_mul_pd(d2, d2));
+		m2_diff = _mm256_add_pd(m2_diff, _mm256_mul_pd(dd, dd));
+		c12 = _mm256_add_pd(c12, _mm256_mul_pd(d1, d2));
+		c1d = _mm256_add_pd(c1d, _mm256_mul_pd(d1, dd));
+	}
+	ZC_coMoments_double_scalar(data1+i, data2+i, n-i, mean1, mean2, meanDiff, &tail);
+	s->m2_1 = ZC_hsum_avx2(m2_1) + tail.m2_1;
+	s->m2_2 = ZC_hsum_avx2(m2_2) + tail.m2_2;
+	s->m2_diff = ZC_hsum_avx2(m2_diff) + tail.m2_diff;
+	s->c12 = ZC_hsum_avx2(c12) + tail.c12;
+	s->c1d = ZC_hsum_avx2(c1d) + tail.c1d;
+}
+
+ZC_TARGET_AVX2 static void ZC_valueSums_double_avx2(const double* data, size_t n, double* min, double* max, double* sum)
+{
+	size_t i = 0;
+	double tmin, tmax, tsum;
+	__m256d vmin = _mm256_set1_pd(data[0]), vmax = vmin, vsum = _mm256_set1_pd(0);
+	for (; i + 4 <= n; i += 4)
+	{
+		__m256d x = _mm256_loadu_pd(data+i);
+		vmin = _mm256_min_pd(x, vmin);
+		vmax = _mm256_max_pd(x, vmax);
+		vsum = _mm256_add_pd(vsum, x);
+	}
+	*min = ZC_hmin_avx2(vmin);
+	*max = ZC_hmax_avx2(vmax);
+	*sum = ZC_hsum_avx2(vsum);
+	if(i < n)
+	{
+		ZC_valueSums_double_scalar(data+i, n-i, &tmin, &tmax, &tsum);
+		if(*min > tmin) *min = tmin;
+		if(*max < tmax) *max = tmax;
+		*sum += tsum;
+	}
+}
+
+ZC_TARGET_AVX2 static double ZC_sqDevSum_double_avx2(const double* data, size_t n, double center)
+{
+	size_t i = 0;
+	__m256d vcenter = _mm256_set1_pd(center), vsum = _mm256_set1_pd(0);
+	for (; i + 4 <= n; i += 4)
+	{
+		__m256d d = _mm256_sub_pd(_mm256_loadu_pd(data+i), vcenter);
+		vsum = _mm256_add_pd(vsum, _mm256_mul_pd(d, d));
+	}
+	return ZC_hsum_avx2(vsum) + ZC_sqDevSum_double_scalar(data+i, n-i, center);
+}
+
+ZC_TARGET_AVX2 static size_t ZC_boundViolations_float_avx2(const float* data1, const float* data2, size_t n, double absBound, double pwrBound, int andMode, double* maxErr)
+{
+	size_t i = 0, count;
+	double tmaxErr;
+	__m256d signMask = _mm256_set1_pd(-0.0), one = _mm256_set1_pd(1);
+	__m256d vabs = _mm256_set1_pd(absBound), vpwr = _mm256_set1_pd(pwrBound);
+	__m256d vcount = _mm256_set1_pd(0), vmaxErr = _mm256_set1_pd(0);
+	for (; i + 4 <= n; i += 4)
+	{
+		__m128 x1 = _mm_loadu_ps(data1+i);
+		__m256d err = _mm256_andnot_pd(signMask, _mm256_cvtps_pd(_mm_sub_ps(_mm_loadu_ps(data2+i), x1)));
+		__m256d bound = _mm256_mul_pd(vpwr, _mm256_andnot_pd(signMask, _mm256_cvtps_pd(x1)));
+		bound = andMode ? _mm256_min_pd(bound, vabs) : _mm256_max_pd(bound, vabs);
+		//NLE_UQ: the NaN errors are violations
+		vcount = _mm256_add_pd(vcount, _mm256_and_pd(_mm256_cmp_pd(err, bound, _CMP_NLE_UQ), one));
+		vmaxErr = _mm256_max_pd(err, vmaxErr);
+	}
+	count = (size_t)ZC_hsum_avx2(vcount);
+	*maxErr = ZC_hmax_avx2(vmaxErr);
+	if(i < n)
+	{
+		count += ZC_boundViolations_float_scalar(data1+i, data2+i, n-i, absBound, pwrBound, andMode, &tmaxErr);
+		if(*maxErr < tmaxErr) *maxErr = tmaxErr;
+	}
+	return count;
+}
+
+ZC_TARGET_AVX2 static size_t ZC_boundViolations_double_avx2(const double* data1, const double* data2, size_t n, double absBound, double pwrBound, int andMode, double* maxErr)
+{
+	size_t i = 0, count;
+	double tmaxErr;
+	__m256d signMask = _mm256_set1_pd(-0.0), one = _mm256_set1_pd(1);
+	__m256d vabs = _mm256_set1_pd(absBound), vpwr = _mm256_set1_pd(pwrBound);
+	__m256d vcount = _mm256_set1_pd(0), vmaxErr = _mm256_set1_pd(0);
+	for (; i + 4 <= n; i += 4)
+	{
+		__m256d x1 = _mm256_loadu_pd(data1+i);
+		__m256d err = _mm256_andnot_pd(signMask, _mm256_sub_pd(_mm256_loadu_pd(data2+i), x1));
+		__m256d bound = _mm256_mul_pd(vpwr, _mm256_andnot_pd(signMask, x1));
+		bound = andMode ? _mm256_min_pd(bound, vabs) : _mm256_max_pd(bound, vabs);
+		//NLE_UQ: the NaN errors are violations
+		vcount = _mm256_add_pd(vcount, _mm256_and_pd(_mm256_cmp_pd(err, bound, _CMP_NLE_UQ), one));
+		vmaxErr = _mm256_max_pd(err, vmaxErr);
+	}
+	count = (size_t)ZC_hsum_avx2(vcount);
+	*maxErr = ZC_hmax_avx2(vmaxErr);
+	if(i < n)
+	{
+		count += ZC_boundViolations_double_scalar(data1+i, data2+i, n-i, absBound, pwrBound, andMode, &tmaxErr);
+		if(*maxErr < tmaxErr) *maxErr = tmaxErr;
+	}
+	return count;
+}
+
+ZC_Kernels zc_avx2Kernels = {
+	ZC_SIMD_AVX2, "avx2",
+	ZC_diffSums_float_avx2, ZC_diffSums_double_avx2,
+	ZC_relSums_float_avx2, ZC_relSums_double_avx2,
+	ZC_coMoments_float_avx2, ZC_coMoments_double_avx2,
+	ZC_valueSums_float_avx2, ZC_valueSums_double_avx2,
+	ZC_sqDevSum_float_avx2, ZC_sqDevSum_double_avx2,
+	ZC_boundViolations_float_avx2, ZC_boundViolations_double_avx2
+};
+
+/*****************************AVX-512*****************************/
+
+ZC_TARGET_AVX512 static double ZC_hsum_avx512(__m512d v)
+{
+	double t[8];
+	_mm512_storeu_pd(t, v);
+	return ((t[0]+t[1])+(t[2]+t[3]))+((t[4]+t[5])+(t[6]+t[7]));
+}
+
+ZC_TARGET_AVX512 static double ZC_hmin_avx512(__m512d v)
+{
+	int k;
+	double t[8], m;
+	_mm512_storeu_pd(t, v);
+	m = t[0];
+	for (k = 1; k < 8; k++)
+		if(m > t[k]) m = t[k];
+	return m;
+}
+
+ZC_TARGET_AVX512 static double ZC_hmax_avx512(__m512d v)
+{
+	int k;
+	double t[8], m;
+	_mm512_storeu_pd(t, v);
+	m = t[0];
+	for (k = 1; k < 8; k++)
+		if(m < t[k]) m = t[k];
+	return m;
+}
+
+ZC_TARGET_AVX512 static void ZC_diffSums_float_avx512(const float* data1, const float* data2, size_t n, ZC_DiffSums* s)
+{
+	size_t i = 0;
+	ZC_DiffSums tail;
+	__m512d sum1 = _mm512_set1_pd(0), sum2 = _mm512_set1_pd(0), sumDiff = _mm512_set1_pd(0), sumErr = _mm512_set1_pd(0), sumErrSqr = _mm512_set1_pd(0);
+	__m512d minDiff = _mm512_set1_pd(1E100), maxDiff = _mm512_set1_pd(-1E100), minErr = _mm512_set1_pd(1E100), maxErr = _mm512_set1_pd(0);
+	for (; i + 8 <= n; i += 8)
+	{
+		__m512d x1 = _mm512_cvtps_pd(_mm256_loadu_ps(data1+i));
+		__m512d x2 = _mm512_cvtps_pd(_mm256_loadu_ps(data2+i));
+		__m512d diff = _mm512_cvtps_pd(_mm256_sub_ps(_mm256_loadu_ps(data2+i), _mm256_loadu_ps(data1+i)));
+		__m512d err = _mm512_abs_pd(diff);
+		sum1 = _mm512_add_pd(sum1, x1);
+		sum2 = _mm512_add_pd(sum2, x2);
+		sumDiff = _mm512_add_pd(sumDiff, diff);
+		sumErr = _mm512_add_pd(sumErr, err);
+		sumErrSqr = _mm512_add_pd(sumErrSqr, _mm512_mul_pd(err, err));
+		minDiff = _mm512_min_pd(diff, minDiff);
+		maxDiff = _mm512_max_pd(diff, maxDiff);
+		minErr = _mm512_min_pd(err, minErr);
+		maxErr = _mm512_max_pd(err, maxErr);
+	}
+	s->sum1 = ZC_hsum_avx512(sum1);
+	s->sum2 = ZC_hsum_avx512(sum2);
+	s->sumDiff = ZC_hsum_avx512(sumDiff);
+	s->sumErr = ZC_hsum_avx512(sumErr);
+	s->sumErrSqr = ZC_hsum_avx512(sumErrSqr);
+	s->minDiff = ZC_hmin_avx512(minDiff);
+	s->maxDiff = ZC_hmax_avx512(maxDiff);
+	s->minErr = ZC_hmin_avx512(minErr);
+	s->maxErr = ZC_hmax_avx512(maxErr);
+	ZC_diffSums_float_scalar(data1+i, data2+i, n-i, &tail);
+	ZC_mergeDiffSums(s, &tail);
+}
+
+ZC_TARGET_AVX512 static void ZC_relSums_float_avx512(const float* data1, const float* data2, size_t n, ZC_RelSums* s)
+{
+	size_t i = 0, n_rel = 0;
+	ZC_RelSums tail;
+	__m512d one = _mm512_set1_pd(1), big = _mm512_set1_pd(1E100), nbig = _mm512_set1_pd(-1E100);
+	__m512d minDiff_rel = big, maxDiff_rel = nbig, minErr_rel = big, maxErr_rel = _mm512_set1_pd(0);
+	__m512d sumErr_rel = _mm512_set1_pd(0), sumErrSqr_rel = _mm512_set1_pd(0);
+	for (; i + 8 <= n; i += 8)
+	{
+		__m512d x1 = _mm512_cvtps_pd(_mm256_loadu_ps(data1+i));
+		__m512d diff = _mm512_cvtps_pd(_mm256_sub_ps(_mm256_loadu_ps(data2+i), _mm256_loadu_ps(data1+i)));
+		__mmask8 mask = _mm512_cmp_pd_mask(x1, _mm512_set1_pd(0), _CMP_NEQ_UQ);
+		__m512d relDiff = _mm512_div_pd(diff, _mm512_mask_blend_pd(mask, one, x1));
+		__m512d err = _mm512_abs_pd(relDiff);
+		n_rel += __builtin_popcount((unsigned int)mask);
+		minDiff_rel = _mm512_min_pd(_mm512_mask_blend_pd(mask, big, relDiff), minDiff_rel);
+		maxDiff_rel = _mm512_max_pd(_mm512_mask_blend_pd(mask, nbig, relDiff), maxDiff_rel);
+		minErr_rel = _mm512_min_pd(_mm512_mask_blend_pd(mask, big, err), minErr_rel);
+		maxErr_rel = _mm512_mask_max_pd(maxErr_rel, mask, err, maxErr_rel);
+		sumErr_rel = _mm512_mask_add_pd(sumErr_rel, mask, sumErr_rel, err);
+		sumErrSqr_rel = _mm512_mask_add_pd(sumErrSqr_rel, mask, sumErrSqr_rel, _mm512_mul_pd(err, err));
+	}
+	s->n_rel = n_rel;
+	s->minDiff_rel = ZC_hmin_avx512(minDiff_rel);
+	s->maxDiff_rel = ZC_hmax_avx512(maxDiff_rel);
+	s->minErr_rel = ZC_hmin_avx512(minErr_rel);
+	s->maxErr_rel = ZC_hmax_avx512(maxErr_rel);
+	s->sumErr_rel = ZC_hsum_avx512(sumErr_rel);
+	s->sumErrSqr_rel = ZC_hsum_avx512(sumErrSqr_rel);
+	ZC_relSums_float_scalar(data1+i, data2+i, n-i, &tail);
+	ZC_mergeRelSums(s, &tail);
+}
+
+ZC_TARGET_AVX512 static void ZC_coMoments_float_avx512(const float* data1, const float* data2, size_t n, double mean1, double mean2, double meanDiff, ZC_CoMoments* s)
+{
+	size_t i = 0;
+	ZC_CoMoments tail;
+	__m512d vmean1 = _mm512_set1_pd(mean1), vmean2 = _mm512_set1_pd(mean2), vmeanDiff = _mm512_set1_pd(meanDiff);
+	__m512d m2_1 = _mm512_set1_pd(0), m2_2 = _mm512_set1_pd(0), m2_diff = _mm512_set1_pd(0), c12 = _mm512_set1_pd(0), c1d = _mm512_set1_pd(0);
+	for (; i + 8 <= n; i += 8)
+	{
+		__m512d d1 = _mm512_sub_pd(_mm512_cvtps_pd(_mm256_loadu_ps(data1+i)), vmean1);
+		__m512d d2 = _mm512_sub_pd(_mm512_cvtps_pd(_mm256_loadu_ps(data2+i)), vmean2);
+		__m512d dd = _mm512_sub_pd(_mm512_cvtps_pd(_mm256_sub_ps(_mm256_loadu_ps(data2+i), _mm256_loadu_ps(data1+i))), vmeanDiff);
+		m2_1 = _mm512_add_pd(m2_1, _mm512_mul_pd(d1, d1));
+		m2_2 = _mm512_add_pd(m2_2, _mm512_mul_pd(d2, d2));
+		m2_diff = _mm512_add_pd(m2_diff, _mm512_mul_pd(dd, dd));
+		c12 = _mm512_add_pd(c12, _mm512_mul_pd(d1, d2));
+		c1d = _mm512_add_pd(c1d, _mm512_mul_pd(d1, dd));
+	}
+	ZC_coMoments_float_scalar(data1+i, data2+i, n-i, mean1, mean2, meanDiff, &tail);
+	s->m2_1 = ZC_hsum_avx512(m2_1) + tail.m2_1;
+	s->m2_2 = ZC_hsum_avx512(m2_2) + tail.m2_2;
+	s->m2_diff = ZC_hsum_avx512(m2_diff) + tail.m2_diff;
+	s->c12 = ZC_hsum_avx512(c12) + tail.c12;
+	s->c1d = ZC_hsum_avx512(c1d) + tail.c1d;
+}
+
+ZC_TARGET_AVX512 static void ZC_valueSums_float_avx512(const float* data, size_t n, double* min, double* max, double* sum)
+{
+	size_t i = 0;
+	double tmin, tmax, tsum;
+	__m512d vmin = _mm512_set1_pd(data[0]), vmax = vmin, vsum = _mm512_set1_pd(0);
+	for (; i + 8 <= n; i += 8)
+	{
+		__m512d x = _mm512_cvtps_pd(_mm256_loadu_ps(data+i));
+		vmin = _mm512_min_pd(x, vmin);
+		vmax = _mm512_max_pd(x, vmax);
+		vsum = _mm512_add_pd(vsum, x);
+	}
+	*min = ZC_hmin_avx512(vmin);
+	*max = ZC_hmax_avx512(vmax);
+	*sum = ZC_hsum_avx512(vsum);
+	if(i < n)
+	{
+		ZC_valueSums_float_scalar(data+i, n-i, &tmin, &tmax, &tsum);
+		if(*min > tmin) *min = tmin;
+		if(*max < tmax) *max = tmax;
+		*sum += tsum;
+	}
+}
+
+ZC_TARGET_AVX512 static double ZC_sqDevSum_float_avx512(const float* data, size_t n, double center)
+{
+	size_t i = 0;
+	__m512d vcenter = _mm512_set1_pd(center), vsum = _mm512_set1_pd(0);
+	for (; i + 8 <= n; i += 8)
+	{
+		__m512d d = _mm512_sub_pd(_mm512_cvtps_pd(_mm256_loadu_ps(data+i)), vcenter);
+		vsum = _mm512_add_pd(vsum, _mm512_mul_pd(d, d));
+	}
+	return ZC_hsum_avx512(vsum) + ZC_sqDevSum_float_scalar(data+i, n-i, center);
+}
+
+ZC_TARGET_AVX512 static void ZC_diffSums_double_avx512(const double* data1, const double* data2, size_t n, ZC_DiffSums* s)
+{
+	size_t i = 0;
+	ZC_DiffSums tail;
+	__m512d sum1 = _mm512_set1_pd(0), sum2 = _mm512_set1_pd(0), sumDiff = _mm512_set1_pd(0), sumErr = _mm512_set1_pd(0), sumErrSqr = _mm512_set1_pd(0);
+	__m512d minDiff = _mm512_set1_pd(1E100), maxDiff = _mm512_set1_pd(-1E100), minErr = _mm512_set1_pd(1E100), maxErr = _mm512_set1_pd(0);
+	for (; i + 8 <= n; i += 8)
+	{
+		__m512d x1 = _mm512_loadu_pd(data1+i);
+		__m512d x2 = _mm512_loadu_pd(data2+i);
+		__m512d diff = _mm512_sub_pd(_mm512_loadu_pd(data2+i), _mm512_loadu_pd(data1+i));
+		__m512d err = _mm512_abs_pd(diff);
+		sum1 = _mm512_add_pd(sum1, x1);
+		sum2 = _mm512_add_pd(sum2, x2);
+		sumDiff = _mm512_add_pd(sumDiff, diff);
+		sumErr = _mm512_add_pd(sumErr, err);
+		sumErrSqr = _mm512_add_pd(sumErrSqr, _mm512_mul_pd(err, err));
+		minDiff = _mm512_min_pd(diff, minDiff);
+		maxDiff = _mm512_max_pd(diff, maxDiff);
+		minErr = _mm512_min_pd(err, minErr);
+		maxErr = _mm512_max_pd(err, maxErr);
+	}
+	s->sum1 = ZC_hsum_avx512(sum1);
+	s->sum2 = ZC_hsum_avx512(sum2);
+	s->sumDiff = ZC_hsum_avx512(sumDiff);
+	s->sumErr = ZC_hsum_avx512(sumErr);
+	s->sumErrSqr = ZC_hsum_avx512(sumErrSqr);
+	s->minDiff = ZC_hmin_avx512(minDiff);
+	s->maxDiff = ZC_hmax_avx512(maxDiff);
+	s->minErr = ZC_hmin_avx512(minErr);
+	s->maxErr = ZC_hmax_avx512(maxErr);
+	ZC_diffSums_double_scalar(data1+i, data2+i, n-i, &tail);
+	ZC_mergeDiffSums(s, &tail);
+}
+
+ZC_TARGET_AVX512 static void ZC_relSums_double_avx512(const double* data1, const double* data2, size_t n, ZC_RelSums* s)
+{
+	size_t i = 0, n_rel = 0;
+	ZC_RelSums tail;
+	__m512d one = _mm512_set1_pd(1), big = _mm512_set1_pd(1E100), nbig = _mm512_set1_pd(-1E100);
+	__m512d minDiff_rel = big, maxDiff_rel = nbig, minErr_rel = big, maxErr_rel = _mm512_set1_pd(0);
+	__m512d sumErr_rel = _mm512_set1_pd(0), sumErrSqr_rel = _mm512_set1_pd(0);
+	for (; i + 8 <= n; i += 8)
+	{
+		__m512d x1 = _mm512_loadu_pd(data1+i);
+		__m512d diff = _mm512_sub_pd(_mm512_loadu_pd(data2+i), _mm512_loadu_pd(data1+i));
+		__mmask8 mask = _mm512_cmp_pd_mask(x1, _mm512_set1_pd(0), _CMP_NEQ_UQ);
+		__m512d relDiff = _mm512_div_pd(diff, _mm512_mask_blend_pd(mask, one, x1));
+		__m512d err = _mm512_abs_pd(relDiff);
+		n_rel += __builtin_popcount((unsigned int)mask);
+		minDiff_rel = _mm512_min_pd(_mm512_mask_blend_pd(mask, big, relDiff), minDiff_rel);
+		maxDiff_rel = _mm512_max_pd(_mm512_mask_blend_pd(mask, nbig, relDiff), maxDiff_rel);
+		minErr_rel = _mm512_min_pd(_mm512_mask_blend_pd(mask, big, err), minErr_rel);
+		maxErr_rel = _mm512_mask_max_pd(maxErr_rel, mask, err, maxErr_rel);
+		sumErr_rel = _mm512_mask_add_pd(sumErr_rel, mask, sumErr_rel, err);
+		sumErrSqr_rel = _mm512_mask_add_pd(sumErrSqr_rel, mask, sumErrSqr_rel, _mm512_mul_pd(err, err));
+	}
+	s->n_rel = n_rel;
+	s->minDiff_rel = ZC_hmin_avx512(minDiff_rel);
+	s->maxDiff_rel = ZC_hmax_avx512(maxDiff_rel);
+	s->minErr_rel = ZC_hmin_avx512(minErr_rel);
+	s->maxErr_rel = ZC_hmax_avx512(maxErr_rel);
+	s->sumErr_rel = ZC_hsum_avx512(sumErr_rel);
+	s->sumErrSqr_rel = ZC_hsum_avx512(sumErrSqr_rel);
+	ZC_relSums_double_scalar(data1+i, data2+i, n-i, &tail);
+	ZC_mergeRelSums(s, &tail);
+}
+
+ZC_TARGET_AVX512 static void ZC_coMoments_double_avx512(const double* data1, const double* data2, size_t n, double mean1, double mean2, double meanDiff, ZC_CoMoments* s)
+{
+	size_t i = 0;
+	ZC_CoMoments tail;
+	__m512d vmean1 = _mm512_set1_pd(mean1), vmean2 = _mm512_set1_pd(mean2), vmeanDiff = _mm512_set1_pd(meanDiff);
+	__m512d m2_1 = _mm512_set1_pd(0), m2_2 = _mm512_set1_pd(0), m2_diff = _mm512_set1_pd(0), c12 = _mm512_set1_pd(0), c1d = _mm512_set1_pd(0);
+	for (; i + 8 <= n; i += 8)
+	{
+		__m512d d1 = _mm512_sub_pd(_mm512_loadu_pd(data1+i), vmean1);
+		__m512d d2 = _mm512_sub_pd(_mm512_loadu_pd(data2+i), vmean2);
+		__m512d dd = _mm512_sub_pd(_mm512_sub_pd(_mm512_loadu_pd(data2+i), _mm512_loadu_pd(data1+i)), vmeanDiff);
+		m2_1 = _mm512_add_pd(m2_1, _mm512_mul_pd(d1, d1));
+		m2_2 = _mm512_add_pd(m2_2, _mm512_mul_pd(d2, d2));
+		m2_diff = _mm512_add_pd(m2_diff, _mm512_mul_pd(dd, dd));
+		c12 = _mm512_add_pd(c12, _mm512_mul_pd(d1, d2));
+		c1d = _mm512_add_pd(c1d, _mm512_mul_pd(d1, dd));
+	}
+	ZC_coMoments_double_scalar(data1+i, data2+i, n-i, mean1, mean2, meanDiff, &tail);
+	s->m2_1 = ZC_hsum_avx512(m2_1) + tail.m2_1;
+	s->m2_2 = ZC_hsum_avx512(m2_2) + tail.m2_2;
+	s->m2_diff = ZC_hsum_avx512(m2_diff) + tail.m2_diff;
+	s->c12 = ZC_hsum_avx512(c12) + tail.c12;
+	s->c1d = ZC_hsum_avx512(c1d) + tail.c1d;
+}
+
+ZC_TARGET_AVX512 static void ZC_valueSums_double_avx512(const double* data, size_t n, double* min, double* max, double* sum)
+{
+	size_t i = 0;
+	double tmin, tmax, tsum;
+	__m512d vmin = _mm512_set1_pd(data[0]), vmax = vmin, vsum = _mm512_set1_pd(0);
+	for (; i + 8 <= n; i += 8)
+	{
+		__m512d x = _mm512_loadu_pd(data+i);
+		vmin = _mm512_min_pd(x, vmin);
+		vmax = _mm512_max_pd(x, vmax);
+		vsum = _mm512_add_pd(vsum, x);
+	}
+	*min = ZC_hmin_avx512(vmin);
+	*max = ZC_hmax_avx512(vmax);
+	*sum = ZC_hsum_avx512(vsum);
+	if(i < n)
+	{
+		ZC_valueSums_double_scalar(data+i, n-i, &tmin, &tmax, &tsum);
+		if(*min > tmin) *min = tmin;
+		if(*max < tmax) *max = tmax;
+		*sum += tsum;
+	}
+}
+
+ZC_TARGET_AVX512 static double ZC_sqDevSum_double_avx512(const double* data, size_t n, double center)
+{
+	size_t i = 0;
+	__m512d vcenter = _mm512_set1_pd(center), vsum = _mm512_set1_pd(0);
+	for (; i + 8 <= n; i += 8)
+	{
+		__m512d d = _mm512_sub_pd(_mm512_loadu_pd(data+i), vcenter);
+		vsum = _mm512_add_pd(vsum, _mm512_mul_pd(d, d));
+	}
+	return ZC_hsum_avx512(vsum) + ZC_sqDevSum_double_scalar(data+i, n-i, center);
+}
+
+ZC_TARGET_AVX512 static size_t ZC_boundViolations_float_avx512(const float* data1, const float* data2, size_t n, double absBound, double pwrBound, int andMode, double* maxErr)
+{
+	size_t i = 0, count = 0;
+	double tmaxErr;
+	__m512d vabs = _mm512_set1_pd(absBound), vpwr = _mm512_set1_pd(pwrBound), vmaxErr = _mm512_set1_pd(0);
+	for (; i + 8 <= n; i += 8)
+	{
+		__m256 x1 = _mm256_loadu_ps(data1+i);
+		__m512d err = _mm512_abs_pd(_mm512_cvtps_pd(_mm256_sub_ps(_mm256_loadu_ps(data2+i), x1)));
+		__m512d bound = _mm512_mul_pd(vpwr, _mm512_abs_pd(_mm512_cvtps_pd(x1)));
+		bound = andMode ? _mm512_min_pd(bound, vabs) : _mm512_max_pd(bound, vabs);
+		count += __builtin_popcount((unsigned int)_mm512_cmp_pd_mask(err, bound, _CMP_NLE_UQ));
+		vmaxErr = _mm512_max_pd(err, vmaxErr);
+	}
+	*maxErr = ZC_hmax_avx512(vmaxErr);
+	if(i < n)
+	{
+		count += ZC_boundViolations_float_scalar(data1+i, data2+i, n-i, absBound, pwrBound, andMode, &tmaxErr);
+		if(*maxErr < tmaxErr) *maxErr = tmaxErr;
+	}
+	return count;
+}
+
+ZC_TARGET_AVX512 static size_t ZC_boundViolations_double_avx512(const double* data1, const double* data2, size_t n, double absBound, double pwrBound, int andMode, double* maxErr)
+{
+	size_t i = 0, count = 0;
+	double tmaxErr;
+	__m512d vabs = _mm512_set1_pd(absBound), vpwr = _mm512_set1_pd(pwrBound), vmaxErr = _mm512_set1_pd(0);
+	for (; i + 8 <= n; i += 8)
+	{
+		__m512d x1 = _mm512_loadu_pd(data1+i);
+		__m512d err = _mm512_abs_pd(_mm512_sub_pd(_mm512_loadu_pd(data2+i), x1));
+		__m512d bound = _mm512_mul_pd(vpwr, _mm512_abs_pd(x1));
+		bound = andMode ? _mm512_min_pd(bound, vabs) : _mm512_max_pd(bound, vabs);
+		count += __builtin_popcount((unsigned int)_mm512_cmp_pd_mask(err, bound, _CMP_NLE_UQ));
+		vmaxErr = _mm512_max_pd(err, vmaxErr);
+	}
+	*maxErr = ZC_hmax_avx512(vmaxErr);
+	if(i < n)
+	{
+		count += ZC_boundViolations_double_scalar(data1+i, data2+i, n-i, absBound, pwrBound, andMode, &tmaxErr);
+		if(*maxErr < tmaxErr) *maxErr = tmaxErr;
+	}
+	return count;
+}
+
+ZC_Kernels zc_avx512Kernels = {
+	ZC_SIMD_AVX512, "avx512",
+	ZC_diffSums_float_avx512, ZC_diffSums_double_avx512,
+	ZC_relSums_float_avx512, ZC_relSums_double_avx512,
+	ZC_coMoments_float_avx512, ZC_coMoments_double_avx512,
+	ZC_valueSums_float_avx512, ZC_valueSums_double_avx512,
+	ZC_sqDevSum_float_avx512, ZC_sqDevSum_double_avx512,
+	ZC_boundViolations_float_avx512, ZC_boundViolations_double_avx512
+};
+
+#endif
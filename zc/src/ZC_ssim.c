@@ -15,9 +15,12 @@
  */
 
 #include <math.h>
+#include <float.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 #include "zc.h"
+#include "ZC_ssim.h"
 
 // Google version of SSIM
 // SSIM
@@ -28,7 +31,11 @@ static const int K[KERNEL_SIZE] =
 {
     1, 4, 11, 16, 11, 4, 1    // 16 * exp(-0.3 * i * i)
 };
-static const double ki_w = 1. / 2304.;  // 1 / sum(i:0..6, j..6) K[i]*K[j]
+
+/**
+ * SSIM of the window centered at (xo, yo), clipped at the borders: the per-pixel 
+ * reference of zc_calc_ssim_2d_float() (it is not used by it).
+ * */
 double zc_get_ssim_float(const float *org, const float *rec,
                  int xo, int yo, size_t W, size_t H, const double valueRange)
 {
@@ -94,123 +101,7 @@ double zc_get_ssim_float(const float *org, const float *rec,
 
 }
 
-double zc_get_ssimfull_kernel_float(const float *org, const float *rec,
-                            int xo, int yo, size_t W, size_t H, const double valueRange)
-{
-	size_t stride = W;
-    int y_, x_;
-    double xm = 0, ym = 0, xxm = 0, xym = 0, yym = 0;
-    org += (yo - KERNEL) * stride;
-    org += (xo - KERNEL);
-    rec += (yo - KERNEL) * stride;
-    rec += (xo - KERNEL);
-
-    for (y_ = 0; y_ < KERNEL_SIZE; ++y_, org += stride, rec += stride)
-    {
-        const int Wy = K[y_];
-
-        for (x_ = 0; x_ < KERNEL_SIZE; ++x_)
-        {
-            const int Wxy = Wy * K[x_];
-            // TODO(skal): inlined assembly
-            const double org_x = org[x_];
-            const double rec_x = rec[x_];
-            xm  += Wxy * org_x;
-            ym  += Wxy * rec_x;
-            xxm += Wxy * org_x * org_x;
-            xym += Wxy * org_x * rec_x;
-            yym += Wxy * rec_x * rec_x;
-        }
-    }
-    
-    double range2 = valueRange*valueRange;
-
-    {
-        const double iw = ki_w;
-        const double iwx = xm * iw;
-        const double iwy = ym * iw;
-        double sxx = xxm * iw - iwx * iwx;
-        double syy = yym * iw - iwy * iwy;
-
-        // small errors are possible, due to rounding. Clamp to zero.
-        if (sxx < 0.) sxx = 0.;
-
-        if (syy < 0.) syy = 0.;
-
-        {
-            const double sxsy = sqrt(sxx * syy);
-            const double sxy = xym * iw - iwx * iwy;
-            double C11 = (0.01 * 0.01) * range2;
-            double C22 = (0.03 * 0.03) * range2;
-            double C33 = (0.015 * 0.015) * range2;
-            double l = (2. * iwx * iwy + C11) / (iwx * iwx + iwy * iwy + C11);
-            double c = (2. * sxsy      + C22) / (sxx + syy + C22);
-            double s = (sxy + C33) / (sxsy + C33);
-            return l * c * s;
-        }
-    }
-}
-
-double zc_calc_ssim_2d_float(const float *org, const float *rec,
-                  const size_t r2, const size_t r1)
-{
-	size_t totalSize = r2*r1;
-	size_t image_width = r1;
-	size_t image_height = r2;
-	
-    size_t j, i;
-    double SSIM = 0.;
-    double min = org[0], max = org[0];
-    
-    for(i=0;i<image_height;i++)
-		for(j=0;j<image_width;j++)
-		{
-			double v = org[i*image_width+j];
-			if(min>v) min = v;
-			if(max<v) max = v;
-		}
-		
-	double range = max - min;
-
-    for (j = 0; j < KERNEL; ++j)
-    {
-        for (i = 0; i < image_width; ++i)
-        {
-            SSIM += zc_get_ssim_float(org, rec, i, j, image_width, image_height, range);
-        }
-    }
-
-    for (j = KERNEL; j < image_height - KERNEL; ++j)
-    {
-        for (i = 0; i < KERNEL; ++i)
-        {
-            SSIM += zc_get_ssim_float(org, rec, i, j, image_width, image_height, range);
-        }
-
-        for (i = KERNEL; i < image_width - KERNEL; ++i)
-        {
-            SSIM += zc_get_ssimfull_kernel_float(org, rec, i, j,
-                                         image_width, image_height, range);
-        }
-
-        for (i = image_width - KERNEL; i < image_width; ++i)
-        {
-            SSIM += zc_get_ssim_float(org, rec, i, j, image_width, image_height, range);
-        }
-    }
-
-    for (j = image_height - KERNEL; j < image_height; ++j)
-    {
-        for (i = 0; i < image_width; ++i)
-        {
-            SSIM += zc_get_ssim_float(org, rec, i, j, image_width, image_height, range);
-        }
-    }
-
-    return SSIM/totalSize;
-}
-
-
+/*per-pixel reference of zc_calc_ssim_2d_double(), see zc_get_ssim_float()*/
 double zc_get_ssim_double(const double *org, const double *rec,
                  int xo, int yo, size_t W, size_t H, const double valueRange)
 {
@@ -276,247 +167,1381 @@ double zc_get_ssim_double(const double *org, const double *rec,
 
 }
 
-double zc_get_ssimfull_kernel_double(const double *org, const double *rec,
-                            int xo, int yo, size_t W, size_t H, const double valueRange)
+/*the five local moments filtered by the kernel: x, y, x*x, x*y, y*y*/
+#define ZC_SSIM_MOMENTS 5
+/*SSIM of the constant slices, which are skipped (the SSIM is in [-1, 1])*/
+#define ZC_SSIM_CONSTANT_SLICE -2
+
+typedef struct ZC_SsimTask
 {
-	size_t stride = W;
-    int y_, x_;
-    double xm = 0, ym = 0, xxm = 0, xym = 0, yym = 0;
-    org += (yo - KERNEL) * stride;
-    org += (xo - KERNEL);
-    rec += (yo - KERNEL) * stride;
-    rec += (xo - KERNEL);
-
-    for (y_ = 0; y_ < KERNEL_SIZE; ++y_, org += stride, rec += stride)
-    {
-        const int Wy = K[y_];
+	const void* org; /*the data in memory, or NULL: read from fd1 and fd2*/
+	const void* rec;
+	int fd1, fd2;
+	int dataType; /*ZC_FLOAT or ZC_DOUBLE*/
+	size_t W, H, D; /*r1, r2 and the planes of the 3D window (1: 2D window)*/
+	size_t nbBands; /*bands of ZC_SSIM_BAND_ROWS rows of the centers of each plane*/
+	size_t cz0, cz1, cy0, cy1, cx0, cx1; /*the windows summed: centers [cz0, cz1) x [cy0, cy1) x [cx0, cx1)*/
+	size_t sliceInterval; /*1 plane out of sliceInterval (ZC_computeSsimSlices())*/
+	double C1, C2, C3;
+	double* colWeights; /*W inverse sums of the kernel weights of the (clipped) columns*/
+	double* rowWeights; /*H, idem for the rows*/
+	double* planeWeights; /*D, idem for the planes*/
+	double* buffers; /*scratch of each thread*/
+	size_t bufferSize;
+	double* partials; /*result of each task*/
+	const double* halo; /*1D: the points of the neighbors (ZC_computeSsim1D())*/
+	int haloL, haloR;
+} ZC_SsimTask;
+
+/*inverse sums of the kernel weights of the windows clipped to [0, n)*/
+static double* ZC_computeSsimWeights(size_t n)
+{
+	size_t i;
+	int k;
+	double* weights = (double*)malloc(sizeof(double)*n);
+	for(i=0;i<n;i++)
+	{
+		double w = 0;
+		for(k=-KERNEL;k<=KERNEL;k++)
+			if((long)i+k >= 0 && (long)i+k < (long)n)
+				w += K[KERNEL+k];
+		weights[i] = 1./w;
+	}
+	return weights;
+}
 
-        for (x_ = 0; x_ < KERNEL_SIZE; ++x_)
-        {
-            const int Wxy = Wy * K[x_];
-            // TODO(skal): inlined assembly
-            const double org_x = org[x_];
-            const double rec_x = rec[x_];
-            xm  += Wxy * org_x;
-            ym  += Wxy * rec_x;
-            xxm += Wxy * org_x * org_x;
-            xym += Wxy * org_x * rec_x;
-            yym += Wxy * rec_x * rec_x;
-        }
-    }
-    
-    double range2 = valueRange*valueRange;
+static void ZC_setSsimConstants(ZC_SsimTask* t, double valueRange)
+{
+	double range2 = valueRange*valueRange;
+	t->C1 = (0.01 * 0.01) * range2;
+	t->C2 = (0.03 * 0.03) * range2;
+	t->C3 = (0.015 * 0.015) * range2;
+}
 
-    {
-        const double iw = ki_w;
-        const double iwx = xm * iw;
-        const double iwy = ym * iw;
-        double sxx = xxm * iw - iwx * iwx;
-        double syy = yym * iw - iwy * iwy;
+static size_t ZC_getSsimElemSize(ZC_SsimTask* t)
+{
+	return t->dataType==ZC_FLOAT ? sizeof(float) : sizeof(double);
+}
 
-        // small errors are possible, due to rounding. Clamp to zero.
-        if (sxx < 0.) sxx = 0.;
+static size_t ZC_getSsimBandRows(ZC_SsimTask* t)
+{
+	return t->H < ZC_SSIM_BAND_ROWS ? t->H : ZC_SSIM_BAND_ROWS;
+}
 
-        if (syy < 0.) syy = 0.;
+/*scratch of ZC_filterSsimBand(): the padded moment rows, the ring of KERNEL_SIZE filtered rows and the rows read from the files*/
+static size_t ZC_getSsimScratchSize(ZC_SsimTask* t)
+{
+	size_t W = t->W;
+	return ZC_SSIM_MOMENTS*(W+2*KERNEL) + KERNEL_SIZE*ZC_SSIM_MOMENTS*W + 2*(ZC_getSsimBandRows(t)+2*KERNEL)*W;
+}
 
-        {
-            const double sxsy = sqrt(sxx * syy);
-            const double sxy = xym * iw - iwx * iwy;
-            double C11 = (0.01 * 0.01) * range2;
-            double C22 = (0.03 * 0.03) * range2;
-            double C33 = (0.015 * 0.015) * range2;
-            double l = (2. * iwx * iwy + C11) / (iwx * iwx + iwy * iwy + C11);
-            double c = (2. * sxsy      + C22) / (sxx + syy + C22);
-            double s = (sxy + C33) / (sxsy + C33);
-            return l * c * s;
-        }
-    }
+/*sum only the windows centered in [z0, z1) x [y0, y1) x [x0, x1); they still read the points around them*/
+static void ZC_setSsimCenters(ZC_SsimTask* t, size_t z0, size_t z1, size_t y0, size_t y1, size_t x0, size_t x1)
+{
+	t->cz0 = z0;
+	t->cz1 = z1;
+	t->cy0 = y0;
+	t->cy1 = y1;
+	t->cx0 = x0;
+	t->cx1 = x1;
+	t->nbBands = y1 > y0 ? (y1-y0-1)/ZC_SSIM_BAND_ROWS+1 : 0;
 }
 
-double zc_calc_ssim_2d_double(const double *org, const double *rec,
-                  const size_t r2, const size_t r1)
+/*the data (in memory) of the windows of D planes of r2 x r1 points, clipped to the data, all centers summed*/
+static void ZC_setSsimShape(ZC_SsimTask* t, const void* org, const void* rec, int dataType, size_t D, size_t r2, size_t r1)
+{
+	t->org = org;
+	t->rec = rec;
+	t->fd1 = t->fd2 = -1;
+	t->dataType = dataType;
+	t->W = r1;
+	t->H = r2;
+	t->D = D;
+	t->sliceInterval = 1;
+	t->colWeights = ZC_computeSsimWeights(r1);
+	t->rowWeights = ZC_computeSsimWeights(r2);
+	t->planeWeights = ZC_computeSsimWeights(D);
+	ZC_setSsimCenters(t, 0, D, 0, r2, 0, r1);
+}
+
+/**
+ * Initialize the task for the windows of D planes of r2 x r1 points; each thread gets the scratch
+ * of ZC_filterSsimBand() followed by extraSize values.
+ * */
+static void ZC_initSsimTask(ZC_SsimTask* t, const void* org, const void* rec, int dataType, size_t D, size_t r2, size_t r1, size_t extraSize, size_t nbTasks)
+{
+	ZC_setSsimShape(t, org, rec, dataType, D, r2, r1);
+	t->bufferSize = ZC_getSsimScratchSize(t) + extraSize;
+	t->buffers = (double*)malloc(sizeof(double)*t->bufferSize*ZC_computeThreadCount(nbTasks));
+	t->partials = (double*)malloc(sizeof(double)*nbTasks);
+}
+
+static void ZC_freeSsimShape(ZC_SsimTask* t)
+{
+	free(t->colWeights);
+	free(t->rowWeights);
+	free(t->planeWeights);
+}
+
+static void ZC_freeSsimTask(ZC_SsimTask* t)
+{
+	ZC_freeSsimShape(t);
+	free(t->buffers);
+	free(t->partials);
+}
+
+/*count rows from the row (counted over all the planes): in memory, or read into staging*/
+static void ZC_getSsimRows(ZC_SsimTask* t, size_t row, size_t count, void* staging, const void** o, const void** r)
+{
+	size_t elemSize = ZC_getSsimElemSize(t), offset = row*t->W;
+	if(t->org!=NULL)
+	{
+		*o = (const char*)t->org + offset*elemSize;
+		*r = (const char*)t->rec + offset*elemSize;
+	}
+	else
+	{
+		char* s = (char*)staging;
+		ZC_readDataChunk(t->fd1, elemSize, offset, count*t->W, s);
+		ZC_readDataChunk(t->fd2, elemSize, offset, count*t->W, s+count*t->W*elemSize);
+		*o = s;
+		*r = s+count*t->W*elemSize;
+	}
+}
+
+/*horizontal pass: the five moments of the row (o, r), filtered along x (zeros beyond the borders)*/
+static void ZC_filterSsimRow(ZC_SsimTask* t, const void* org, const void* rec, double* padded, double* out)
 {
-	size_t totalSize = r1*r2;
-	size_t image_width = r1;
-	size_t image_height = r2;
-	
-    size_t j, i;
-    double SSIM = 0.;
-    double min = org[0], max = org[0];
-    
-    for(i=0;i<image_height;i++)
-		for(j=0;j<image_width;j++)
+	size_t x, W = t->W, P = W+2*KERNEL;
+	int m;
+	double* po = padded + KERNEL;
+	if(t->dataType==ZC_FLOAT)
+	{
+		const float* o = (const float*)org;
+		const float* r = (const float*)rec;
+		for(x=0;x<W;x++)
+		{
+			po[x] = o[x];
+			po[P+x] = r[x];
+		}
+	}
+	else
+	{
+		const double* o = (const double*)org;
+		const double* r = (const double*)rec;
+		for(x=0;x<W;x++)
 		{
-			double v = org[i*image_width+j];
-			if(min>v) min = v;
-			if(max<v) max = v;
+			po[x] = o[x];
+			po[P+x] = r[x];
 		}
-		
-	double range = max - min;
+	}
+	for(x=0;x<W;x++)
+	{
+		po[2*P+x] = po[x]*po[x];
+		po[3*P+x] = po[x]*po[P+x];
+		po[4*P+x] = po[P+x]*po[P+x];
+	}
+	for(m=0;m<ZC_SSIM_MOMENTS;m++)
+	{
+		const double* v = padded + m*P + KERNEL;
+		double* h = out + m*W;
+		//symmetric kernel: K[KERNEL-k] == K[KERNEL+k]
+		for(x=0;x<W;x++)
+			h[x] = K[3]*v[x] + K[2]*(v[x-1]+v[x+1]) + K[1]*(v[x-2]+v[x+2]) + K[0]*(v[x-3]+v[x+3]);
+	}
+}
 
-    for (j = 0; j < KERNEL; ++j)
-    {
-        for (i = 0; i < image_width; ++i)
-        {
-            SSIM += zc_get_ssim_double(org, rec, i, j, image_width, image_height, range);
-        }
-    }
+/**
+ * xy pass over the rows [y0, y1) of the plane: each input row is filtered once along x into 
+ * a ring of KERNEL_SIZE rows, then each output row combines the ring along y, so every moment 
+ * costs 2*KERNEL_SIZE multiply-adds per point instead of KERNEL_SIZE^2. The band only reads its 
+ * rows and KERNEL rows of halo on each side; out gets the ZC_SSIM_MOMENTS*W sums (not normalized) 
+ * of each row.
+ * */
+static void ZC_filterSsimBand(ZC_SsimTask* t, size_t plane, size_t y0, size_t y1, double* scratch, double* out)
+{
+	size_t W = t->W, H = t->H, y, m, next, elemSize = ZC_getSsimElemSize(t);
+	size_t first = y0 > KERNEL ? y0-KERNEL : 0, end = y1+KERNEL < H ? y1+KERNEL : H;
+	int k;
+	double* padded = scratch;
+	double* ring = padded + ZC_SSIM_MOMENTS*(W+2*KERNEL);
+	const void *o, *r;
+	ZC_getSsimRows(t, plane*H+first, end-first, ring + KERNEL_SIZE*ZC_SSIM_MOMENTS*W, &o, &r);
+	memset(padded, 0, sizeof(double)*ZC_SSIM_MOMENTS*(W+2*KERNEL));
+
+	for(y=y0, next=first;y<y1;y++)
+	{
+		size_t last = y+KERNEL < H ? y+KERNEL : H-1;
+		size_t wFirst = y > KERNEL ? y-KERNEL : 0;
+		double* v = out + (y-y0)*ZC_SSIM_MOMENTS*W;
+		for(;next<=last;next++)
+			ZC_filterSsimRow(t, (const char*)o + (next-first)*W*elemSize, (const char*)r + (next-first)*W*elemSize,
+			padded, ring + (next%KERNEL_SIZE)*ZC_SSIM_MOMENTS*W);
+
+		//vertical pass over the rows [wFirst, last] of the window
+		memset(v, 0, sizeof(double)*ZC_SSIM_MOMENTS*W);
+		for(k=(int)(wFirst+KERNEL-y);k<=(int)(last+KERNEL-y);k++)
+		{
+			const double Ky = K[k];
+			const double* h = ring + ((y+k-KERNEL)%KERNEL_SIZE)*ZC_SSIM_MOMENTS*W;
+			for(m=0;m<ZC_SSIM_MOMENTS*W;m++)
+				v[m] += Ky*h[m];
+		}
+	}
+}
 
-    for (j = KERNEL; j < image_height - KERNEL; ++j)
-    {
-        for (i = 0; i < KERNEL; ++i)
-        {
-            SSIM += zc_get_ssim_double(org, rec, i, j, image_width, image_height, range);
-        }
+/*SSIM of the window of the moments v[0], v[stride], ..., v[4*stride] (weighted sums) and of the inverse weight iw*/
+static inline double ZC_computeSsimWindow(ZC_SsimTask* t, const double* v, size_t stride, double iw)
+{
+	const double iwx = v[0] * iw;
+	const double iwy = v[stride] * iw;
+	double sxx = v[2*stride] * iw - iwx * iwx;
+	double syy = v[4*stride] * iw - iwy * iwy;
+	// small errors are possible, due to rounding. Clamp to zero.
+	if (sxx < 0.) sxx = 0.;
+	if (syy < 0.) syy = 0.;
+	const double sxsy = sqrt(sxx * syy);
+	const double sxy = v[3*stride] * iw - iwx * iwy;
+	double l = (2. * iwx * iwy + t->C1) / (iwx * iwx + iwy * iwy + t->C1);
+	double c = (2. * sxsy      + t->C2) / (sxx + syy + t->C2);
+	double s = (sxy + t->C3) / (sxsy + t->C3);
+	return l * c * s;
+}
 
-        for (i = KERNEL; i < image_width - KERNEL; ++i)
-        {
-            SSIM += zc_get_ssimfull_kernel_double(org, rec, i, j,
-                                         image_width, image_height, range);
-        }
+/*sum of the 2D SSIM of the band of the plane*/
+static double ZC_sumSsimBand(ZC_SsimTask* t, size_t plane, size_t band, double* buffer)
+{
+	size_t W = t->W, x, y;
+	size_t y0 = t->cy0+band*ZC_SSIM_BAND_ROWS, y1 = y0+ZC_SSIM_BAND_ROWS < t->cy1 ? y0+ZC_SSIM_BAND_ROWS : t->cy1;
+	double* out = buffer + ZC_getSsimScratchSize(t);
+	double bandSum = 0;
+	ZC_filterSsimBand(t, plane, y0, y1, buffer, out);
+	for(y=y0;y<y1;y++)
+	{
+		const double* v = out + (y-y0)*ZC_SSIM_MOMENTS*W;
+		double rowSum = 0;
+		for(x=t->cx0;x<t->cx1;x++)
+			rowSum += ZC_computeSsimWindow(t, v+x, W, t->rowWeights[y]*t->colWeights[x]);
+		bandSum += rowSum;
+	}
+	return bandSum;
+}
 
-        for (i = image_width - KERNEL; i < image_width; ++i)
-        {
-            SSIM += zc_get_ssim_double(org, rec, i, j, image_width, image_height, range);
-        }
-    }
+static void ZC_computeSsimBand(void* arg, int threadID, size_t taskID)
+{
+	ZC_SsimTask* t = (ZC_SsimTask*)arg;
+	t->partials[taskID] = ZC_sumSsimBand(t, 0, taskID, t->buffers + threadID*t->bufferSize);
+}
 
-    for (j = image_height - KERNEL; j < image_height; ++j)
-    {
-        for (i = 0; i < image_width; ++i)
-        {
-            SSIM += zc_get_ssim_double(org, rec, i, j, image_width, image_height, range);
-        }
-    }
+/**
+ * Mean SSIM of the r2 x r1 image (ZC_FLOAT or ZC_DOUBLE, in memory or in the files fd1 and fd2), 
+ * with the 7x7 Gaussian window of the Google version (clipped and renormalized at the borders, 
+ * as zc_get_ssim_float()) and the constants of valueRange (the value range of org). The separable 
+ * window is applied by a horizontal and a vertical pass, by bands of ZC_SSIM_BAND_ROWS rows run in 
+ * parallel (from the files, each band only reads its rows and their halo); the bands are summed in 
+ * their order, so the result does not depend on the number of threads. It equals the per-pixel
+ * windows up to the rounding of the sums (relative differences of 1E-12 on the local SSIM for
+ * smooth data, more where the local variance is far below the squared mean).
+ * */
+static double ZC_computeSsim2D(const void* org, const void* rec, int fd1, int fd2, int dataType, size_t r2, size_t r1, double valueRange)
+{
+	size_t i, n = r2*r1;
+	double ssim = 0;
+	ZC_SsimTask task;
+	if(n==0)
+		return 0;
+	ZC_initSsimTask(&task, org, rec, dataType, 1, r2, r1, (r2 < ZC_SSIM_BAND_ROWS ? r2 : ZC_SSIM_BAND_ROWS)*ZC_SSIM_MOMENTS*r1, (r2-1)/ZC_SSIM_BAND_ROWS+1);
+	task.fd1 = fd1;
+	task.fd2 = fd2;
+	ZC_setSsimConstants(&task, valueRange);
+	ZC_runTasks(ZC_computeSsimBand, &task, task.nbBands);
+	for(i=0;i<task.nbBands;i++)
+		ssim += task.partials[i];
+	ZC_freeSsimTask(&task);
+	return ssim/n;
+}
 
-    return SSIM/totalSize;
+double zc_calc_ssim_2d_float(const float *org, const float *rec,
+                  const size_t r2, const size_t r1)
+{
+	return ZC_computeSsim2D(org, rec, -1, -1, ZC_FLOAT, r2, r1, ZC_computeValueRange_float((float*)org, r2*r1));
 }
 
+double zc_calc_ssim_2d_double(const double *org, const double *rec,
+                  const size_t r2, const size_t r1)
+{
+	return ZC_computeSsim2D(org, rec, -1, -1, ZC_DOUBLE, r2, r1, ZC_computeValueRange_double((double*)org, r2*r1));
+}
 
-void zc_calc_ssim_3d_float(float *org, float *rec, size_t r3, size_t r2, size_t r1, double *min_ssim, double* avg_ssim, double* max_ssim)
+/*zc_calc_ssim_2d_float() on the data of the files fd1 and fd2 (ZC_FLOAT or ZC_DOUBLE), read by bands of rows; valueRange: the value range of the data of fd1*/
+double zc_calc_ssim_2d_file(int fd1, int fd2, int dataType, size_t r2, size_t r1, double valueRange)
+{
+	return ZC_computeSsim2D(NULL, NULL, fd1, fd2, dataType, r2, r1, valueRange);
+}
+
+static void ZC_computeSsimExtrema(const void* data, int dataType, size_t n, double* minValue, double* maxValue)
+{
+	size_t i;
+	double min, max;
+	if(dataType==ZC_FLOAT)
+	{
+		const float* p = (const float*)data;
+		min = max = p[0];
+		for(i=1;i<n;i++)
+		{
+			if(min>p[i]) min = p[i];
+			if(max<p[i]) max = p[i];
+		}
+	}
+	else
+	{
+		const double* p = (const double*)data;
+		min = max = p[0];
+		for(i=1;i<n;i++)
+		{
+			if(min>p[i]) min = p[i];
+			if(max<p[i]) max = p[i];
+		}
+	}
+	*minValue = min;
+	*maxValue = max;
+}
+
+/*2D SSIM of the slice taskID*sliceInterval, with the constants of its own value range; its bands are run by this thread*/
+static void ZC_computeSsimSlice(void* arg, int threadID, size_t taskID)
 {
-	size_t i = 0, j = 0, counter = 0;
-	size_t intv = 1, offset = 0;
+	ZC_SsimTask* t = (ZC_SsimTask*)arg;
+	ZC_SsimTask slice = *t;
+	size_t b, n = t->W*t->H, plane = taskID*t->sliceInterval, elemSize = ZC_getSsimElemSize(t);
+	double* buffer = t->buffers + threadID*t->bufferSize;
+	double min, max, valueRange, ssim = 0;
+	if(t->org==NULL)
+	{
+		//read the whole slice (after the scratch and the output band), to get its value range first
+		char* s = (char*)(buffer + ZC_getSsimScratchSize(t) + ZC_getSsimBandRows(t)*ZC_SSIM_MOMENTS*t->W);
+		ZC_readDataChunk(t->fd1, elemSize, plane*n, n, s);
+		slice.org = s;
+		slice.rec = NULL;
+		ZC_computeSsimExtrema(s, t->dataType, n, &min, &max);
+		valueRange = max - min;
+		if(valueRange!=0)
+		{
+			ZC_readDataChunk(t->fd2, elemSize, plane*n, n, s+n*elemSize);
+			slice.rec = s+n*elemSize;
+		}
+	}
+	else
+	{
+		slice.org = (const char*)t->org + plane*n*elemSize;
+		slice.rec = (const char*)t->rec + plane*n*elemSize;
+		ZC_computeSsimExtrema(slice.org, t->dataType, n, &min, &max);
+		valueRange = max - min;
+	}
+	if(valueRange==0) //skip the constant slices
+	{
+		t->partials[taskID] = ZC_SSIM_CONSTANT_SLICE;
+		return;
+	}
+	ZC_setSsimConstants(&slice, valueRange);
+	for(b=0;b<t->nbBands;b++)
+		ssim += ZC_sumSsimBand(&slice, 0, b, buffer);
+	t->partials[taskID] = ssim/n;
+}
+
+/**
+ * Min, average and max of the 2D SSIM of the slices of the r3 x r2 x r1 data (in memory or 
+ * in the files of the task), the constant slices being skipped. ssimImage2DSlices of them
+ * are sampled uniformly (0: all the slices); the slices are run in parallel, each one by a
+ * single thread with the moment pipeline of zc_calc_ssim_2d_float(), so the results are those 
+ * of zc_calc_ssim_2d_float() on the slices, whatever the number of threads.
+ * */
+static void ZC_computeSsimSlices(const void* org, const void* rec, int fd1, int fd2, int dataType, 
+size_t r3, size_t r2, size_t r1, double *min_ssim, double* avg_ssim, double* max_ssim)
+{
+	size_t i, counter = 0, nbSlices, extraSize;
+	ZC_SsimTask task;
 	*min_ssim = 1;
 	*max_ssim = 0;
 	*avg_ssim = 0;
-	//just work on 10 uniformly sampled layers if r3 is a large number
-	if(r3>20)
-		intv = r3/20;
-	size_t nbEle = r2*r1;
-	float *p, *q;
-	//perform calculation of ssim for each layer
-	for(i=0;i<r3;i+=intv)
-	{
-		offset = i*nbEle;
-		p = org+offset;
-		q = rec+offset;
-		double min = p[0], max = min;
-		for(j=0;j<nbEle;j++)
-		{
-			if(min>p[j])min = p[j];
-			if(max<p[j])max = p[j];
-		}	
-		if(min==max) //skip the constant dataset
+	size_t intv = ssimImage2DSlices > 0 && r3 > (size_t)ssimImage2DSlices ? r3/ssimImage2DSlices : 1;
+	nbSlices = (r3-1)/intv+1;
+	extraSize = (r2 < ZC_SSIM_BAND_ROWS ? r2 : ZC_SSIM_BAND_ROWS)*ZC_SSIM_MOMENTS*r1;
+	if(org==NULL) //two slices of floats or doubles
+		extraSize += 2*r2*r1;
+	ZC_initSsimTask(&task, org, rec, dataType, 1, r2, r1, extraSize, nbSlices);
+	task.fd1 = fd1;
+	task.fd2 = fd2;
+	task.sliceInterval = intv;
+	ZC_runTasks(ZC_computeSsimSlice, &task, nbSlices);
+	for(i=0;i<nbSlices;i++)
+	{
+		double ssim = task.partials[i];
+		if(ssim==ZC_SSIM_CONSTANT_SLICE)
 			continue;
 		counter++;
-		double ssim = zc_calc_ssim_2d_float(p, q, r2, r1);
 		if(*min_ssim>ssim) *min_ssim=ssim;
 		if(*max_ssim<ssim) *max_ssim=ssim;
 		*avg_ssim += ssim;
 	}
 	*avg_ssim=*avg_ssim/counter;
+	ZC_freeSsimTask(&task);
+}
+
+void zc_calc_ssim_3d_float(float *org, float *rec, size_t r3, size_t r2, size_t r1, double *min_ssim, double* avg_ssim, double* max_ssim)
+{
+	ZC_computeSsimSlices(org, rec, -1, -1, ZC_FLOAT, r3, r2, r1, min_ssim, avg_ssim, max_ssim);
 }
 
 void zc_calc_ssim_3d_double(double *org, double *rec, size_t r3, size_t r2, size_t r1, double *min_ssim, double* avg_ssim, double* max_ssim)
 {
-	size_t i = 0, j = 0, counter = 0;
-	size_t intv = 1, offset = 0;
-	*min_ssim = 1;
-	*avg_ssim = 0;
-	*max_ssim = 0;
-	//just work on 10 uniformly sampled layers if r3 is a large number
-	if(r3>20)
-		intv = r3/20;
-	size_t nbEle = r2*r1;
-	double *p, *q;		
-	//perform calculation of ssim for each layer
-	for(i=0;i<r3;i+=intv)
-	{
-		offset = i*nbEle;
-		p = org+offset;
-		q = rec+offset;
-		double min = p[0], max = min;
-		for(j=0;j<nbEle;j++)
+	ZC_computeSsimSlices(org, rec, -1, -1, ZC_DOUBLE, r3, r2, r1, min_ssim, avg_ssim, max_ssim);
+}
+
+/*zc_calc_ssim_3d_float() on the data of the files fd1 and fd2 (ZC_FLOAT or ZC_DOUBLE), read slice by slice*/
+void zc_calc_ssim_3d_file(int fd1, int fd2, int dataType, size_t r3, size_t r2, size_t r1, double *min_ssim, double* avg_ssim, double* max_ssim)
+{
+	ZC_computeSsimSlices(NULL, NULL, fd1, fd2, dataType, r3, r2, r1, min_ssim, avg_ssim, max_ssim);
+}
+
+/**
+ * Sum of the 3D SSIM of the band of all the planes of the volume: the band of each plane is 
+ * filtered along x and y once (ZC_filterSsimBand()) into a ring of KERNEL_SIZE planes, then each 
+ * output plane combines the ring along z. Only the band and its halo rows of each plane are read, 
+ * one plane after another.
+ * */
+static double ZC_sumSsimVolumeBand(ZC_SsimTask* t, size_t volume, size_t band, double* buffer)
+{
+	size_t W = t->W, D = t->D;
+	size_t y0 = t->cy0+band*ZC_SSIM_BAND_ROWS, y1 = y0+ZC_SSIM_BAND_ROWS < t->cy1 ? y0+ZC_SSIM_BAND_ROWS : t->cy1;
+	size_t x, y, z, m, bandSize = ZC_getSsimBandRows(t)*ZC_SSIM_MOMENTS*W;
+	size_t next = t->cz0 > KERNEL ? t->cz0-KERNEL : 0;
+	int k;
+	double* ring = buffer + ZC_getSsimScratchSize(t);
+	double* v = ring + KERNEL_SIZE*bandSize;
+	double sum = 0;
+	for(z=t->cz0;z<t->cz1;z++)
+	{
+		size_t last = z+KERNEL < D ? z+KERNEL : D-1;
+		size_t first = z > KERNEL ? z-KERNEL : 0;
+		for(;next<=last;next++)
+			ZC_filterSsimBand(t, volume*D+next, y0, y1, buffer, ring + (next%KERNEL_SIZE)*bandSize);
+
+		//z pass over the planes [first, last] of the window
+		memset(v, 0, sizeof(double)*(y1-y0)*ZC_SSIM_MOMENTS*W);
+		for(k=(int)(first+KERNEL-z);k<=(int)(last+KERNEL-z);k++)
 		{
-			if(min>p[j])min = p[j];
-			if(max<p[j])max = p[j];
-		}	
-		if(min==max) //skip the constant dataset
-			continue;
-		counter++;		
-		double ssim = zc_calc_ssim_2d_double(p, q, r2, r1);
-		if(*min_ssim>ssim) *min_ssim=ssim;
-		if(*max_ssim<ssim) *max_ssim=ssim;
-		*avg_ssim += ssim;
+			const double Kz = K[k];
+			const double* h = ring + ((z+k-KERNEL)%KERNEL_SIZE)*bandSize;
+			for(m=0;m<(y1-y0)*ZC_SSIM_MOMENTS*W;m++)
+				v[m] += Kz*h[m];
+		}
+
+		double planeSum = 0;
+		for(y=y0;y<y1;y++)
+		{
+			const double* row = v + (y-y0)*ZC_SSIM_MOMENTS*W;
+			const double iw = t->planeWeights[z]*t->rowWeights[y];
+			for(x=t->cx0;x<t->cx1;x++)
+				planeSum += ZC_computeSsimWindow(t, row+x, W, iw*t->colWeights[x]);
+		}
+		sum += planeSum;
 	}
-	*avg_ssim=*avg_ssim/counter;
+	return sum;
+}
+
+/*the band taskID%nbBands of the volume taskID/nbBands*/
+static void ZC_computeSsimVolumeBand(void* arg, int threadID, size_t taskID)
+{
+	ZC_SsimTask* t = (ZC_SsimTask*)arg;
+	t->partials[taskID] = ZC_sumSsimVolumeBand(t, taskID/t->nbBands, taskID%t->nbBands, t->buffers + threadID*t->bufferSize);
+}
+
+/**
+ * Mean SSIM of the 7x7x7 Gaussian windows (the separable product of the 2D kernel and of the same
+ * kernel along z, clipped and renormalized at the borders) of the r4 volumes of r3 x r2 x r1 points
+ * (the windows do not cross the volumes), with the constants of valueRange (the value range of org). 
+ * The tasks are the bands of ZC_SSIM_BAND_ROWS rows of each volume, summed in their order, so the 
+ * result does not depend on the number of threads.
+ * */
+static double ZC_computeSsimVolume(const void* org, const void* rec, int fd1, int fd2, int dataType, 
+size_t r4, size_t r3, size_t r2, size_t r1, double valueRange)
+{
+	size_t i, nbTasks, n = r4*r3*r2*r1;
+	double ssim = 0;
+	ZC_SsimTask task;
+	if(n==0)
+		return 0;
+	nbTasks = r4*((r2-1)/ZC_SSIM_BAND_ROWS+1);
+	//the ring of KERNEL_SIZE bands, then the output band
+	ZC_initSsimTask(&task, org, rec, dataType, r3, r2, r1, (KERNEL_SIZE+1)*(r2 < ZC_SSIM_BAND_ROWS ? r2 : ZC_SSIM_BAND_ROWS)*ZC_SSIM_MOMENTS*r1, nbTasks);
+	task.fd1 = fd1;
+	task.fd2 = fd2;
+	ZC_setSsimConstants(&task, valueRange);
+	ZC_runTasks(ZC_computeSsimVolumeBand, &task, nbTasks);
+	for(i=0;i<nbTasks;i++)
+		ssim += task.partials[i];
+	ZC_freeSsimTask(&task);
+	return ssim/n;
+}
+
+double zc_calc_ssim_volume_float(const float *org, const float *rec, size_t r4, size_t r3, size_t r2, size_t r1, double valueRange)
+{
+	return ZC_computeSsimVolume(org, rec, -1, -1, ZC_FLOAT, r4, r3, r2, r1, valueRange);
+}
+
+double zc_calc_ssim_volume_double(const double *org, const double *rec, size_t r4, size_t r3, size_t r2, size_t r1, double valueRange)
+{
+	return ZC_computeSsimVolume(org, rec, -1, -1, ZC_DOUBLE, r4, r3, r2, r1, valueRange);
+}
+
+/*zc_calc_ssim_volume_float() on the data of the files fd1 and fd2 (ZC_FLOAT or ZC_DOUBLE), read by bands of rows*/
+double zc_calc_ssim_volume_file(int fd1, int fd2, int dataType, size_t r4, size_t r3, size_t r2, size_t r1, double valueRange)
+{
+	return ZC_computeSsimVolume(NULL, NULL, fd1, fd2, dataType, r4, r3, r2, r1, valueRange);
+}
+
+//1D SSIM
+
+/*inverse sum of the kernel weights of the 1D window of x, clipped to [lo, hi)*/
+static double ZC_computeSsimWeight(long x, long lo, long hi)
+{
+	int k;
+	double w = 0;
+	for(k=-KERNEL;k<=KERNEL;k++)
+		if(x+k >= lo && x+k < hi)
+			w += K[KERNEL+k];
+	return 1./w;
+}
+
+/**
+ * Values of the positions [start, start+count) of the 1D data in o and r: the data (in memory
+ * or read from the files into staging), the haloL and haloR points of the neighbors on each 
+ * side (see ZC_computeSsim1D()), and zeros beyond them.
+ * */
+static void ZC_fillSsimSegment(ZC_SsimTask* t, long start, size_t count, double* o, double* r, void* staging)
+{
+	long p, n = (long)t->W, end = start+(long)count;
+	long first = start > 0 ? start : 0, last = end < n ? end : n; //the data positions [first, last)
+	size_t i, elemSize = ZC_getSsimElemSize(t);
+	const char *ob, *rb;
+	for(p=start;p<end;p++)
+	{
+		double a = 0, b = 0;
+		if(p < 0 && p >= -t->haloL)
+		{
+			a = t->halo[KERNEL+p];
+			b = t->halo[2*KERNEL+p];
+		}
+		else if(p >= n && p < n+t->haloR)
+		{
+			a = t->halo[2*KERNEL+p-n];
+			b = t->halo[3*KERNEL+p-n];
+		}
+		o[p-start] = a;
+		r[p-start] = b;
+	}
+	if(first >= last)
+		return;
+	if(t->org!=NULL)
+	{
+		ob = (const char*)t->org + first*elemSize;
+		rb = (const char*)t->rec + first*elemSize;
+	}
+	else
+	{
+		ob = (const char*)staging;
+		rb = ob + (last-first)*elemSize;
+		ZC_readDataChunk(t->fd1, elemSize, first, last-first, (void*)ob);
+		ZC_readDataChunk(t->fd2, elemSize, first, last-first, (void*)rb);
+	}
+	o += first-start;
+	r += first-start;
+	if(t->dataType==ZC_FLOAT)
+		for(i=0;i<(size_t)(last-first);i++)
+		{
+			o[i] = ((const float*)ob)[i];
+			r[i] = ((const float*)rb)[i];
+		}
+	else
+		for(i=0;i<(size_t)(last-first);i++)
+		{
+			o[i] = ((const double*)ob)[i];
+			r[i] = ((const double*)rb)[i];
+		}
+}
+
+/**
+ * Sum of the SSIM of the points of the chunk taskID: the five moments of the chunk and of its 
+ * KERNEL points on each side are filtered by the 7-point kernel (contiguous arrays and a fixed 
+ * number of taps, so the loops vectorize); the windows clipped at the borders are renormalized.
+ * */
+static void ZC_computeSsimChunk(void* arg, int threadID, size_t taskID)
+{
+	ZC_SsimTask* t = (ZC_SsimTask*)arg;
+	size_t x, n = t->W, x0 = taskID*ZC_SSIM_CHUNK_POINTS, x1 = x0+ZC_SSIM_CHUNK_POINTS < n ? x0+ZC_SSIM_CHUNK_POINTS : n;
+	size_t len = x1-x0, P = len+2*KERNEL;
+	long lo = -t->haloL, hi = (long)n+t->haloR;
+	int m;
+	double* padded = t->buffers + threadID*t->bufferSize;
+	double* v = padded + ZC_SSIM_MOMENTS*P;
+	const double innerWeight = ZC_computeSsimWeight(0, -KERNEL, KERNEL+1);
+	double sum = 0;
+	ZC_fillSsimSegment(t, (long)x0-KERNEL, P, padded, padded+P, v + ZC_SSIM_MOMENTS*len);
+	for(x=0;x<P;x++)
+	{
+		padded[2*P+x] = padded[x]*padded[x];
+		padded[3*P+x] = padded[x]*padded[P+x];
+		padded[4*P+x] = padded[P+x]*padded[P+x];
+	}
+	for(m=0;m<ZC_SSIM_MOMENTS;m++)
+	{
+		const double* u = padded + m*P + KERNEL;
+		double* h = v + m*len;
+		for(x=0;x<len;x++)
+			h[x] = K[3]*u[x] + K[2]*(u[x-1]+u[x+1]) + K[1]*(u[x-2]+u[x+2]) + K[0]*(u[x-3]+u[x+3]);
+	}
+	for(x=0;x<len;x++)
+	{
+		long p = (long)(x0+x);
+		double iw = p-KERNEL >= lo && p+KERNEL < hi ? innerWeight : ZC_computeSsimWeight(p, lo, hi);
+		sum += ZC_computeSsimWindow(t, v+x, len, iw);
+	}
+	t->partials[taskID] = sum;
+}
+
+/**
+ * Sum of the SSIM of the windows of 7 points of the n points of the 1D data (in memory or in 
+ * the files), with the constants of valueRange. halo (or NULL) holds the KERNEL points on 
+ * each side of the data on another rank: org then rec on the left (right-aligned, haloL of 
+ * them are valid), org then rec on the right (haloR of them); the windows reach into them. 
+ * The chunks of ZC_SSIM_CHUNK_POINTS points are summed in their order, so the result does not 
+ * depend on the number of threads.
+ * */
+static double ZC_computeSsim1D(const void* org, const void* rec, int fd1, int fd2, int dataType, size_t n, 
+const double* halo, int haloL, int haloR, double valueRange)
+{
+	size_t i, nbChunks, P;
+	double sum = 0;
+	ZC_SsimTask task;
+	if(n==0)
+		return 0;
+	nbChunks = (n-1)/ZC_SSIM_CHUNK_POINTS+1;
+	P = (n < ZC_SSIM_CHUNK_POINTS ? n : ZC_SSIM_CHUNK_POINTS) + 2*KERNEL;
+	task.org = org;
+	task.rec = rec;
+	task.fd1 = fd1;
+	task.fd2 = fd2;
+	task.dataType = dataType;
+	task.W = n;
+	task.halo = halo;
+	task.haloL = halo==NULL ? 0 : haloL;
+	task.haloR = halo==NULL ? 0 : haloR;
+	ZC_setSsimConstants(&task, valueRange);
+	//the padded moments, the filtered moments and the staging of the two files
+	task.bufferSize = ZC_SSIM_MOMENTS*P + ZC_SSIM_MOMENTS*(P-2*KERNEL) + 2*P;
+	task.buffers = (double*)malloc(sizeof(double)*task.bufferSize*ZC_computeThreadCount(nbChunks));
+	task.partials = (double*)malloc(sizeof(double)*nbChunks);
+	ZC_runTasks(ZC_computeSsimChunk, &task, nbChunks);
+	for(i=0;i<nbChunks;i++)
+		sum += task.partials[i];
+	free(task.buffers);
+	free(task.partials);
+	return sum;
 }
 
-//TODO: 1d SSIM
+/*mean SSIM of the windows of 7 points (the 1D Gaussian kernel of the 2D SSIM), with the constants of the value range of org*/
 double zc_calc_ssim_1d_float(const float *org, const float *rec, const size_t r1)
-{}
+{
+	if(r1==0)
+		return 0;
+	return ZC_computeSsim1D(org, rec, -1, -1, ZC_FLOAT, r1, NULL, 0, 0, ZC_computeValueRange_float((float*)org, r1))/r1;
+}
 
 double zc_calc_ssim_1d_double(const double *org, const double *rec, const size_t r1)
-{}
+{
+	if(r1==0)
+		return 0;
+	return ZC_computeSsim1D(org, rec, -1, -1, ZC_DOUBLE, r1, NULL, 0, 0, ZC_computeValueRange_double((double*)org, r1))/r1;
+}
+
+/*zc_calc_ssim_1d_float() on the data of the files fd1 and fd2 (ZC_FLOAT or ZC_DOUBLE), read by chunks; valueRange: the value range of the data of fd1*/
+double zc_calc_ssim_1d_file(int fd1, int fd2, int dataType, size_t r1, double valueRange)
+{
+	if(r1==0)
+		return 0;
+	return ZC_computeSsim1D(NULL, NULL, fd1, fd2, dataType, r1, NULL, 0, 0, valueRange)/r1;
+}
 
+/*ssimProcGrid of the configuration: the ranks along r1, r2 and r3 (1 if omitted), or all 0 (NULL or empty string)*/
+void ZC_parseSsimProcGrid(char* s, int* grid)
+{
+	int k;
+	char* end;
+	memset(grid, 0, 3*sizeof(int));
+	if(s==NULL)
+		return;
+	for(k=0;k<3;k++)
+	{
+		long p = strtol(s, &end, 10);
+		if(end==s)
+			break;
+		if(p<=0)
+		{
+			printf("Error: wrong ssimProcGrid: %s\n", s);
+			exit(0);
+		}
+		grid[k] = (int)p;
+		s = end;
+	}
+	if(k>0)
+		for(;k<3;k++)
+			grid[k] = 1;
+}
 
 //MPI
 #ifdef HAVE_MPI
+/*the blocks around the block of a rank (offsets -1, 0 and 1 along each axis), the block itself being ZC_SSIM_SELF*/
+#define ZC_SSIM_NEIGHBORS 27
+#define ZC_SSIM_SELF 13
+
+/**
+ * Blocks of the online SSIM: the ranks form a grid along r3, r2 and r1 (axes 0, 1 and 2), each one 
+ * holding a block of n[0] x n[1] x n[2] points of each of the nbVolumes volumes. The windows of the 
+ * points near the borders of the block read the halo, the points of the neighbors within KERNEL of 
+ * them: the extended block is the block with lo[a] and hi[a] points of halo on each side.
+ * */
+typedef struct ZC_SsimGrid
+{
+	int dims[3]; /*ranks along each axis*/
+	int coords[3]; /*block of this rank*/
+	int cartesian; /*the ranks are those of the Cartesian communicator ZC_COMM_WORLD*/
+	int firstAxis; /*first axis of the data: 0 (3D data) or 1 (2D data)*/
+	int window3D; /*3D windows (else 2D windows in each slice)*/
+	size_t n[3], offset[3], global[3]; /*points of the block, global index of its first point, global points*/
+	size_t lo[3], hi[3], ext[3]; /*halo on each side (0 at the global borders), points of the extended block*/
+	size_t nbVolumes;
+	int dataType;
+	size_t elemSize;
+	const void* org;
+	const void* rec;
+	size_t boxPoints[ZC_SSIM_NEIGHBORS]; /*points of the halo from each neighbor (per volume and array)*/
+	char* sendBuffers[ZC_SSIM_NEIGHBORS];
+	char* recvBuffers[ZC_SSIM_NEIGHBORS]; /*org then rec of each neighbor, volume after volume*/
+	MPI_Request requests[2*ZC_SSIM_NEIGHBORS];
+	int nbRequests;
+} ZC_SsimGrid;
+
+/*rank of the block of coordinates coords, or MPI_PROC_NULL beyond the borders*/
+static int ZC_getSsimRank(ZC_SsimGrid* g, int* coords)
+{
+	int a, rank;
+	for(a=0;a<3;a++)
+		if(coords[a] < 0 || coords[a] >= g->dims[a])
+			return MPI_PROC_NULL;
+	if(g->cartesian)
+	{
+		MPI_Cart_rank(ZC_COMM_WORLD, coords+g->firstAxis, &rank);
+		return rank;
+	}
+	return (coords[0]*g->dims[1] + coords[1])*g->dims[2] + coords[2];
+}
+
+/**
+ * The grid of the ranks: ssimProcGrid of the configuration (the blocks in the order of the ranks, 
+ * r1 first), else the Cartesian communicator ZC_COMM_WORLD (its dimensions along the slowest
+ * dimensions of the data), else the blocks stacked along the slowest dimension in the order of
+ * the ranks, as for the 1D SSIM. The sizes of the blocks are shared to get their global positions.
+ * */
+static void ZC_initSsimGrid(ZC_SsimGrid* g, const void* org, const void* rec, int dataType, int dataDims, 
+int window3D, size_t nbVolumes, size_t r3, size_t r2, size_t r1)
+{
+	int a, i, status, ndims, nbSizes, base;
+	long* sizes;
+	g->firstAxis = 3-dataDims;
+	g->window3D = window3D;
+	g->cartesian = 0;
+	for(a=0;a<3;a++)
+	{
+		g->dims[a] = 1;
+		g->coords[a] = 0;
+	}
+	MPI_Topo_test(ZC_COMM_WORLD, &status);
+	if(ssimProcGrid[0] > 0)
+	{
+		for(a=0;a<3;a++)
+			g->dims[a] = ssimProcGrid[2-a];
+		if(g->dims[0]*g->dims[1]*g->dims[2] != nbProc || (dataDims==2 && g->dims[0] > 1))
+		{
+			printf("Error: ssimProcGrid (%d %d %d) does not match the %d ranks and the %d dimensions of the data\n", 
+			ssimProcGrid[0], ssimProcGrid[1], ssimProcGrid[2], nbProc, dataDims);
+			exit(0);
+		}
+		g->coords[2] = myRank%g->dims[2];
+		g->coords[1] = myRank/g->dims[2]%g->dims[1];
+		g->coords[0] = myRank/(g->dims[2]*g->dims[1]);
+	}
+	else if(status==MPI_CART)
+	{
+		int cartDims[3], periods[3], cartCoords[3];
+		MPI_Cartdim_get(ZC_COMM_WORLD, &ndims);
+		if(ndims > dataDims)
+		{
+			printf("Error: the Cartesian communicator has %d dimensions, the data %d\n", ndims, dataDims);
+			exit(0);
+		}
+		MPI_Cart_get(ZC_COMM_WORLD, ndims, cartDims, periods, cartCoords);
+		for(a=0;a<ndims;a++)
+		{
+			g->dims[g->firstAxis+a] = cartDims[a];
+			g->coords[g->firstAxis+a] = cartCoords[a];
+		}
+		g->cartesian = 1;
+	}
+	else
+	{
+		g->dims[g->firstAxis] = nbProc;
+		g->coords[g->firstAxis] = myRank;
+	}
+
+	g->n[0] = r3;
+	g->n[1] = r2;
+	g->n[2] = r1;
+	nbSizes = g->dims[0]+g->dims[1]+g->dims[2];
+	sizes = (long*)calloc(nbSizes, sizeof(long));
+	for(a=0, base=0;a<3;base+=g->dims[a], a++)
+		sizes[base+g->coords[a]] = (long)g->n[a];
+	MPI_Allreduce(MPI_IN_PLACE, sizes, nbSizes, MPI_LONG, MPI_MAX, ZC_COMM_WORLD);
+	for(a=0, base=0;a<3;base+=g->dims[a], a++)
+	{
+		int split = g->dims[a] > 1 && (a > 0 || window3D);
+		if(sizes[base+g->coords[a]] != (long)g->n[a] || (split && g->n[a] < KERNEL))
+		{
+			printf("Error: the blocks of the online SSIM do not form a grid of blocks of at least %d points along the split dimensions\n", KERNEL);
+			exit(0);
+		}
+		g->offset[a] = g->global[a] = 0;
+		for(i=0;i<g->dims[a];i++)
+		{
+			if(i < g->coords[a])
+				g->offset[a] += sizes[base+i];
+			g->global[a] += sizes[base+i];
+		}
+		g->lo[a] = split && g->coords[a] > 0 ? KERNEL : 0;
+		g->hi[a] = split && g->coords[a] < g->dims[a]-1 ? KERNEL : 0;
+		g->ext[a] = g->lo[a]+g->n[a]+g->hi[a];
+	}
+	free(sizes);
+	g->nbVolumes = nbVolumes;
+	g->dataType = dataType;
+	g->elemSize = dataType==ZC_FLOAT ? sizeof(float) : sizeof(double);
+	g->org = org;
+	g->rec = rec;
+	g->nbRequests = 0;
+	for(i=0;i<ZC_SSIM_NEIGHBORS;i++)
+		g->sendBuffers[i] = g->recvBuffers[i] = NULL;
+}
+
+/*copy the box [b0, b1) of the volume of the block of data (org or rec) to out; returns the end of the copy*/
+static char* ZC_copySsimBox(ZC_SsimGrid* g, const void* data, size_t volume, const size_t* b0, const size_t* b1, char* out)
+{
+	size_t z, y, rowSize = (b1[2]-b0[2])*g->elemSize;
+	const char* p = (const char*)data + volume*g->n[0]*g->n[1]*g->n[2]*g->elemSize;
+	for(z=b0[0];z<b1[0];z++)
+		for(y=b0[1];y<b1[1];y++)
+		{
+			memcpy(out, p + ((z*g->n[1]+y)*g->n[2]+b0[2])*g->elemSize, rowSize);
+			out += rowSize;
+		}
+	return out;
+}
+
+/**
+ * Start the exchange of the halo with the (up to 26) neighbors: the KERNEL points at the borders 
+ * of the block facing each neighbor (faces, edges and corners) are sent, and the same ones of the 
+ * neighbors are received, without waiting for them (ZC_finishSsimExchange()).
+ * */
+static void ZC_startSsimExchange(ZC_SsimGrid* g)
+{
+	int i, a, c[3], coords[3], rank;
+	size_t v, b0[3], b1[3], bytes;
+	for(i=0;i<ZC_SSIM_NEIGHBORS;i++)
+	{
+		if(i==ZC_SSIM_SELF)
+			continue;
+		c[0] = i/9-1;
+		c[1] = i/3%3-1;
+		c[2] = i%3-1;
+		for(a=0;a<3;a++)
+		{
+			if(c[a]!=0 && g->lo[a]+g->hi[a]==0) //no halo along this axis
+				break;
+			coords[a] = g->coords[a]+c[a];
+		}
+		if(a < 3 || (rank = ZC_getSsimRank(g, coords))==MPI_PROC_NULL)
+			continue;
+		g->boxPoints[i] = 1;
+		for(a=0;a<3;a++)
+		{
+			b0[a] = c[a] > 0 ? g->n[a]-KERNEL : 0;
+			b1[a] = c[a] < 0 ? KERNEL : g->n[a];
+			g->boxPoints[i] *= b1[a]-b0[a];
+		}
+		bytes = 2*g->nbVolumes*g->boxPoints[i]*g->elemSize;
+		g->sendBuffers[i] = (char*)malloc(bytes);
+		g->recvBuffers[i] = (char*)malloc(bytes);
+		char* s = g->sendBuffers[i];
+		for(v=0;v<g->nbVolumes;v++)
+			s = ZC_copySsimBox(g, g->org, v, b0, b1, s);
+		for(v=0;v<g->nbVolumes;v++)
+			s = ZC_copySsimBox(g, g->rec, v, b0, b1, s);
+		//the tag is the offset of the receiver seen from the sender
+		MPI_Irecv(g->recvBuffers[i], (int)bytes, MPI_BYTE, rank, ZC_SSIM_NEIGHBORS-1-i, ZC_COMM_WORLD, &g->requests[g->nbRequests++]);
+		MPI_Isend(g->sendBuffers[i], (int)bytes, MPI_BYTE, rank, i, ZC_COMM_WORLD, &g->requests[g->nbRequests++]);
+	}
+}
+
+static void ZC_finishSsimExchange(ZC_SsimGrid* g)
+{
+	int i;
+	MPI_Waitall(g->nbRequests, g->requests, MPI_STATUSES_IGNORE);
+	for(i=0;i<ZC_SSIM_NEIGHBORS;i++)
+	{
+		free(g->sendBuffers[i]);
+		g->sendBuffers[i] = NULL;
+	}
+}
+
+static void ZC_freeSsimGrid(ZC_SsimGrid* g)
+{
+	int i;
+	for(i=0;i<ZC_SSIM_NEIGHBORS;i++)
+	{
+		free(g->sendBuffers[i]);
+		free(g->recvBuffers[i]);
+	}
+}
+
+/*copy the box [e0, e1) of the extended block of the volume, org (array 0) or rec (1), to out: each row is read from the block and the halo*/
+static void ZC_gatherSsimBox(ZC_SsimGrid* g, int array, size_t volume, const size_t* e0, const size_t* e1, char* out)
+{
+	size_t e[3], idx[3], dims[3], end;
+	int a, c[3], i;
+	const char* p;
+	for(e[0]=e0[0];e[0]<e1[0];e[0]++)
+		for(e[1]=e0[1];e[1]<e1[1];e[1]++)
+			for(e[2]=e0[2];e[2]<e1[2];e[2]=end)
+			{
+				for(a=0;a<3;a++)
+				{
+					c[a] = e[a] < g->lo[a] ? -1 : (e[a] < g->lo[a]+g->n[a] ? 0 : 1);
+					idx[a] = c[a] < 0 ? e[a] : (c[a]==0 ? e[a]-g->lo[a] : e[a]-g->lo[a]-g->n[a]);
+					dims[a] = c[a]==0 ? g->n[a] : KERNEL;
+				}
+				end = c[2] < 0 ? g->lo[2] : (c[2]==0 ? g->lo[2]+g->n[2] : g->ext[2]);
+				if(end > e1[2])
+					end = e1[2];
+				i = (c[0]+1)*9 + (c[1]+1)*3 + c[2]+1;
+				if(i==ZC_SSIM_SELF)
+					p = (const char*)(array==0 ? g->org : g->rec) + volume*g->n[0]*g->n[1]*g->n[2]*g->elemSize;
+				else
+					p = g->recvBuffers[i] + (array*g->nbVolumes+volume)*g->boxPoints[i]*g->elemSize;
+				memcpy(out, p + ((idx[0]*dims[1]+idx[1])*dims[2]+idx[2])*g->elemSize, (end-e[2])*g->elemSize);
+				out += (end-e[2])*g->elemSize;
+			}
+}
+
+/**
+ * Windows computed together by ZC_runTasks(): each job is a slice or a volume of the block, or a 
+ * box of points near its borders gathered with the halo; its bands are the tasks.
+ * */
+typedef struct ZC_SsimJobs
+{
+	ZC_SsimTask* tasks; /*one per job*/
+	size_t* firstTask; /*first band of each job*/
+	size_t* keys; /*the sum of each job goes to sums[key]*/
+	char** boxes; /*data gathered for the job (or NULL)*/
+	size_t count, capacity, nbTasks;
+	int window3D;
+	double* buffers;
+	size_t bufferSize;
+	double* partials;
+} ZC_SsimJobs;
+
+static void ZC_initSsimJobs(ZC_SsimJobs* jobs, int window3D)
+{
+	memset(jobs, 0, sizeof(ZC_SsimJobs));
+	jobs->window3D = window3D;
+}
+
+/*add the job of the windows centered in [c0, c1) of the D x H x W data (in memory or in box, freed with the jobs)*/
+static void ZC_addSsimJob(ZC_SsimJobs* jobs, const void* org, const void* rec, char* box, int dataType, 
+size_t D, size_t H, size_t W, const size_t* c0, const size_t* c1, double valueRange, size_t key)
+{
+	ZC_SsimTask* t;
+	size_t size;
+	if(c0[0]>=c1[0] || c0[1]>=c1[1] || c0[2]>=c1[2])
+	{
+		free(box);
+		return;
+	}
+	if(jobs->count==jobs->capacity)
+	{
+		jobs->capacity = jobs->capacity==0 ? 16 : 2*jobs->capacity;
+		jobs->tasks = (ZC_SsimTask*)realloc(jobs->tasks, sizeof(ZC_SsimTask)*jobs->capacity);
+		jobs->firstTask = (size_t*)realloc(jobs->firstTask, sizeof(size_t)*jobs->capacity);
+		jobs->keys = (size_t*)realloc(jobs->keys, sizeof(size_t)*jobs->capacity);
+		jobs->boxes = (char**)realloc(jobs->boxes, sizeof(char*)*jobs->capacity);
+	}
+	t = &jobs->tasks[jobs->count];
+	ZC_setSsimShape(t, org, rec, dataType, D, H, W);
+	ZC_setSsimCenters(t, c0[0], c1[0], c0[1], c1[1], c0[2], c1[2]);
+	ZC_setSsimConstants(t, valueRange);
+	//the scratch, then the ring of KERNEL_SIZE bands of the 3D windows and the output band
+	size = ZC_getSsimScratchSize(t) + (jobs->window3D ? KERNEL_SIZE+1 : 1)*ZC_getSsimBandRows(t)*ZC_SSIM_MOMENTS*W;
+	if(jobs->bufferSize < size)
+		jobs->bufferSize = size;
+	jobs->firstTask[jobs->count] = jobs->nbTasks;
+	jobs->keys[jobs->count] = key;
+	jobs->boxes[jobs->count] = box;
+	jobs->nbTasks += t->nbBands;
+	jobs->count++;
+}
+
+static void ZC_computeSsimJob(void* arg, int threadID, size_t taskID)
+{
+	ZC_SsimJobs* jobs = (ZC_SsimJobs*)arg;
+	size_t lo = 0, hi = jobs->count, mid;
+	double* buffer = jobs->buffers + threadID*jobs->bufferSize;
+	while(hi-lo > 1) //the last job starting at or before taskID
+	{
+		mid = (lo+hi)/2;
+		if(jobs->firstTask[mid] <= taskID)
+			lo = mid;
+		else
+			hi = mid;
+	}
+	if(jobs->window3D)
+		jobs->partials[taskID] = ZC_sumSsimVolumeBand(&jobs->tasks[lo], 0, taskID-jobs->firstTask[lo], buffer);
+	else
+		jobs->partials[taskID] = ZC_sumSsimBand(&jobs->tasks[lo], 0, taskID-jobs->firstTask[lo], buffer);
+}
+
+/*run the jobs in parallel, add the sum of each one to sums[key] (in the order of the jobs) and remove them*/
+static void ZC_runSsimJobs(ZC_SsimJobs* jobs, double* sums)
+{
+	size_t j, i;
+	jobs->buffers = (double*)malloc(sizeof(double)*jobs->bufferSize*ZC_computeThreadCount(jobs->nbTasks));
+	jobs->partials = (double*)malloc(sizeof(double)*jobs->nbTasks);
+	ZC_runTasks(ZC_computeSsimJob, jobs, jobs->nbTasks);
+	for(j=0;j<jobs->count;j++)
+	{
+		double sum = 0;
+		for(i=0;i<jobs->tasks[j].nbBands;i++)
+			sum += jobs->partials[jobs->firstTask[j]+i];
+		sums[jobs->keys[j]] += sum;
+		ZC_freeSsimShape(&jobs->tasks[j]);
+		free(jobs->boxes[j]);
+	}
+	free(jobs->buffers);
+	free(jobs->partials);
+	free(jobs->tasks);
+	free(jobs->firstTask);
+	free(jobs->keys);
+	free(jobs->boxes);
+	ZC_initSsimJobs(jobs, jobs->window3D);
+}
+
+/**
+ * Add the jobs of the windows centered in the box [b0, b1) of the block (the plane b0[0] for 
+ * the 2D windows): the box and the points within KERNEL of it along the axes of the windows 
+ * (clipped to the extended block) are gathered, so the windows are clipped only at the global 
+ * borders, as in the serial SSIM.
+ * */
+static void ZC_addSsimBoxJob(ZC_SsimGrid* g, ZC_SsimJobs* jobs, size_t volume, const size_t* b0, const size_t* b1, double valueRange, size_t key)
+{
+	int a;
+	size_t e0[3], e1[3], c0[3], c1[3], points = 1;
+	char* box;
+	if(b0[0]>=b1[0] || b0[1]>=b1[1] || b0[2]>=b1[2])
+		return;
+	for(a=0;a<3;a++)
+	{
+		size_t reach = a > 0 || g->window3D ? KERNEL : 0;
+		e0[a] = b0[a]+g->lo[a] > reach ? b0[a]+g->lo[a]-reach : 0;
+		e1[a] = b1[a]+g->lo[a]+reach < g->ext[a] ? b1[a]+g->lo[a]+reach : g->ext[a];
+		c0[a] = b0[a]+g->lo[a]-e0[a];
+		c1[a] = b1[a]+g->lo[a]-e0[a];
+		points *= e1[a]-e0[a];
+	}
+	box = (char*)malloc(2*points*g->elemSize);
+	ZC_gatherSsimBox(g, 0, volume, e0, e1, box);
+	ZC_gatherSsimBox(g, 1, volume, e0, e1, box+points*g->elemSize);
+	ZC_addSsimJob(jobs, box, box+points*g->elemSize, box, g->dataType, e1[0]-e0[0], e1[1]-e0[1], e1[2]-e0[2], c0, c1, valueRange, key);
+}
+
+/**
+ * Add the jobs of the windows of the volume (or of the slice z0, if z1==z0+1 and the windows are 2D): 
+ * those of the interior of the block (interior!=0), which do not read the halo, or those of the 
+ * boxes around it, which do, once it is received.
+ * */
+static void ZC_addSsimBlockJobs(ZC_SsimGrid* g, ZC_SsimJobs* jobs, int interior, size_t volume, size_t z0, size_t z1, double valueRange, size_t key)
+{
+	int a;
+	size_t i0[3], i1[3], b0[3], b1[3], c0[3], c1[3];
+	for(a=0;a<3;a++)
+	{
+		//the windows centered in [i0, i1) do not reach the halo
+		i0[a] = g->lo[a];
+		i1[a] = g->n[a] > g->lo[a]+g->hi[a] ? g->n[a]-g->hi[a] : i0[a];
+		b0[a] = 0;
+		b1[a] = g->n[a];
+	}
+	if(!g->window3D)
+	{
+		i0[0] = b0[0] = z0;
+		i1[0] = b1[0] = z1;
+	}
+	if(interior)
+	{
+		size_t planeSize = g->n[1]*g->n[2]*g->elemSize;
+		const char* o = (const char*)g->org + (volume*g->n[0]+z0)*planeSize;
+		const char* r = (const char*)g->rec + (volume*g->n[0]+z0)*planeSize;
+		for(a=0;a<3;a++)
+		{
+			c0[a] = i0[a]-z0*(a==0);
+			c1[a] = i1[a]-z0*(a==0);
+		}
+		ZC_addSsimJob(jobs, o, r, NULL, g->dataType, z1-z0, g->n[1], g->n[2], c0, c1, valueRange, key);
+		return;
+	}
+	//the slabs before and after the interior along each axis, then the rest of the block
+	for(a=g->window3D ? 0 : 1;a<3;a++)
+	{
+		memcpy(c0, b0, sizeof(b0));
+		memcpy(c1, b1, sizeof(b1));
+		c1[a] = i0[a];
+		ZC_addSsimBoxJob(g, jobs, volume, c0, c1, valueRange, key);
+		c0[a] = i1[a];
+		c1[a] = b1[a];
+		ZC_addSsimBoxJob(g, jobs, volume, c0, c1, valueRange, key);
+		b0[a] = i0[a];
+		b1[a] = i1[a];
+	}
+}
+
+/**
+ * Sums of the 2D SSIM of the slices of the blocks of all the ranks (on rank 0): the slices 
+ * k*interval of the global data, each one with the constants of its global value range, the 
+ * constant slices being skipped if skipConstant; ranges and sums get the nbSlices values. The 
+ * halo of each slice is exchanged with the neighbors along r2 and r1 while the interior of the
+ * block is computed.
+ * */
+static void ZC_computeSsimSlices_online(ZC_SsimGrid* g, size_t interval, size_t nbSlices, int skipConstant, double* ranges, double* sums)
+{
+	size_t z, k, planePoints = g->n[1]*g->n[2];
+	int interior;
+	double* extrema = (double*)malloc(sizeof(double)*2*nbSlices);
+	double* localSums = (double*)calloc(nbSlices, sizeof(double));
+	ZC_SsimJobs jobs;
+	for(k=0;k<2*nbSlices;k++)
+		extrema[k] = -DBL_MAX;
+	for(z=0;z<g->n[0];z++)
+		if((g->offset[0]+z)%interval==0 && planePoints > 0)
+		{
+			k = (g->offset[0]+z)/interval;
+			ZC_computeSsimExtrema((const char*)g->org + z*planePoints*g->elemSize, g->dataType, planePoints, &extrema[2*k], &extrema[2*k+1]);
+			extrema[2*k] = -extrema[2*k];
+		}
+	MPI_Allreduce(MPI_IN_PLACE, extrema, 2*nbSlices, MPI_DOUBLE, MPI_MAX, ZC_COMM_WORLD);
+	for(k=0;k<nbSlices;k++)
+		ranges[k] = extrema[2*k+1]+extrema[2*k];
+
+	ZC_startSsimExchange(g);
+	ZC_initSsimJobs(&jobs, 0);
+	for(interior=1;interior>=0;interior--)
+	{
+		if(!interior)
+			ZC_finishSsimExchange(g);
+		for(z=0;z<g->n[0];z++)
+		{
+			k = (g->offset[0]+z)/interval;
+			if((g->offset[0]+z)%interval==0 && !(skipConstant && ranges[k]==0))
+				ZC_addSsimBlockJobs(g, &jobs, interior, 0, z, z+1, ranges[k], k);
+		}
+		ZC_runSsimJobs(&jobs, localSums);
+	}
+	MPI_Reduce(localSums, sums, nbSlices, MPI_DOUBLE, MPI_SUM, 0, ZC_COMM_WORLD);
+	free(extrema);
+	free(localSums);
+}
+
+/**
+ * Mean SSIM (on rank 0) of the image distributed over the ranks as a grid of blocks of r2 x r1 
+ * points (see ZC_initSsimGrid()): the windows crossing the blocks read the halo received from the
+ * neighbors and each point is counted once, so the result is the SSIM of the whole image (that of
+ * zc_calc_ssim_2d_float() up to the rounding of the sums), with the constants of its value range.
+ * */
+static double ZC_computeSsim2D_online(const void* org, const void* rec, int dataType, size_t r2, size_t r1)
+{
+	double range, sum = 0;
+	ZC_SsimGrid g;
+	ZC_initSsimGrid(&g, org, rec, dataType, 2, 0, 1, 1, r2, r1);
+	ZC_computeSsimSlices_online(&g, 1, 1, 0, &range, &sum);
+	ZC_freeSsimGrid(&g);
+	return myRank==0 && g.global[1]*g.global[2] > 0 ? sum/(g.global[1]*g.global[2]) : 0;
+}
+
 double zc_calc_ssim_2d_double_online(const double *org, const double *rec, const size_t r2, const size_t r1)
 {
-	double global_ssim = 0;
-	double local_ssim = zc_calc_ssim_2d_double(org, rec, r2, r1);
-	MPI_Reduce(&local_ssim, &global_ssim, 1, MPI_DOUBLE, MPI_SUM, 0, ZC_COMM_WORLD);
-	if(myRank==0)
-		global_ssim /= nbProc;
-	
-	return global_ssim;
+	return ZC_computeSsim2D_online(org, rec, ZC_DOUBLE, r2, r1);
 }
 
 double zc_calc_ssim_2d_float_online(const float *org, const float *rec, const size_t r2, const size_t r1)
 {
-	double global_ssim = 0;
-	double local_ssim = zc_calc_ssim_2d_float(org, rec, r2, r1);
-	MPI_Reduce(&local_ssim, &global_ssim, 1, MPI_DOUBLE, MPI_SUM, 0, ZC_COMM_WORLD);
-	if(myRank==0)
-		global_ssim /= nbProc;
-	
-	return global_ssim;
+	return ZC_computeSsim2D_online(org, rec, ZC_FLOAT, r2, r1);
+}
+
+/**
+ * Min, average and max (on rank 0) of the 2D SSIM of the slices of the 3D data distributed over the 
+ * ranks as a grid of blocks of r3 x r2 x r1 points: the slices sampled and skipped as in 
+ * zc_calc_ssim_3d_float() on the whole data, each one computed from the blocks of all the ranks.
+ * */
+static void ZC_computeSsim3D_online(const void* org, const void* rec, int dataType, size_t r3, size_t r2, size_t r1, 
+double *min_ssim, double* avg_ssim, double* max_ssim)
+{
+	size_t k, counter = 0, interval, nbSlices, n;
+	double *ranges, *sums;
+	ZC_SsimGrid g;
+	ZC_initSsimGrid(&g, org, rec, dataType, 3, 0, 1, r3, r2, r1);
+	interval = ssimImage2DSlices > 0 && g.global[0] > (size_t)ssimImage2DSlices ? g.global[0]/ssimImage2DSlices : 1;
+	nbSlices = (g.global[0]-1)/interval+1;
+	n = g.global[1]*g.global[2];
+	ranges = (double*)malloc(sizeof(double)*nbSlices);
+	sums = (double*)calloc(nbSlices, sizeof(double));
+	ZC_computeSsimSlices_online(&g, interval, nbSlices, 1, ranges, sums);
+	*min_ssim = 1;
+	*max_ssim = 0;
+	*avg_ssim = 0;
+	for(k=0;k<nbSlices;k++)
+	{
+		double ssim = sums[k]/n;
+		if(ranges[k]==0)
+			continue;
+		counter++;
+		if(*min_ssim>ssim) *min_ssim=ssim;
+		if(*max_ssim<ssim) *max_ssim=ssim;
+		*avg_ssim += ssim;
+	}
+	*avg_ssim=*avg_ssim/counter;
+	ZC_freeSsimGrid(&g);
+	free(ranges);
+	free(sums);
 }
 
 void zc_calc_ssim_3d_float_online(float *org, float *rec, size_t r3, size_t r2, size_t r1, double *global_min_ssim, double* global_avg_ssim, double* global_max_ssim)
 {
-	double local_min_ssim = 0, local_max_ssim = 0, local_avg_ssim = 0;
-	zc_calc_ssim_3d_float(org, rec, r3, r2, r1, &local_min_ssim, &local_avg_ssim, &local_max_ssim);
-	MPI_Reduce(&local_min_ssim, global_min_ssim, 1, MPI_DOUBLE, MPI_MIN, 0, ZC_COMM_WORLD);
-	MPI_Reduce(&local_avg_ssim, global_avg_ssim, 1, MPI_DOUBLE, MPI_SUM, 0, ZC_COMM_WORLD);
-	MPI_Reduce(&local_max_ssim, global_max_ssim, 1, MPI_DOUBLE, MPI_MAX, 0, ZC_COMM_WORLD);
-	
-	if(myRank==0)
-		*global_avg_ssim = *global_avg_ssim/nbProc;
+	ZC_computeSsim3D_online(org, rec, ZC_FLOAT, r3, r2, r1, global_min_ssim, global_avg_ssim, global_max_ssim);
 }
 
 void zc_calc_ssim_3d_double_online(double *org, double *rec, size_t r3, size_t r2, size_t r1, double *global_min_ssim, double* global_avg_ssim, double* global_max_ssim)
 {
-	double local_min_ssim = 0, local_max_ssim = 0, local_avg_ssim = 0;
-	zc_calc_ssim_3d_double(org, rec, r3, r2, r1, &local_min_ssim, &local_avg_ssim, &local_max_ssim);
-	MPI_Reduce(&local_min_ssim, global_min_ssim, 1, MPI_DOUBLE, MPI_MIN, 0, ZC_COMM_WORLD);
-	MPI_Reduce(&local_avg_ssim, global_avg_ssim, 1, MPI_DOUBLE, MPI_SUM, 0, ZC_COMM_WORLD);
-	MPI_Reduce(&local_max_ssim, global_max_ssim, 1, MPI_DOUBLE, MPI_MAX, 0, ZC_COMM_WORLD);
-	
-	if(myRank==0)
-		*global_avg_ssim = *global_avg_ssim/nbProc;	
+	ZC_computeSsim3D_online(org, rec, ZC_DOUBLE, r3, r2, r1, global_min_ssim, global_avg_ssim, global_max_ssim);
+}
+
+/**
+ * zc_calc_ssim_volume_float() (on rank 0) of the r4 volumes distributed over the ranks as a grid 
+ * of blocks of r3 x r2 x r1 points (valueRange: the global one): the halo of KERNEL planes, rows 
+ * and columns is exchanged with the neighbors while the interior of the blocks is computed.
+ * */
+static double ZC_computeSsimVolume_online(const void* org, const void* rec, int dataType, size_t r4, size_t r3, size_t r2, size_t r1, double valueRange)
+{
+	size_t v, n;
+	int interior;
+	double sum = 0, localSum = 0;
+	ZC_SsimGrid g;
+	ZC_SsimJobs jobs;
+	ZC_initSsimGrid(&g, org, rec, dataType, 3, 1, r4, r3, r2, r1);
+	ZC_startSsimExchange(&g);
+	ZC_initSsimJobs(&jobs, 1);
+	for(interior=1;interior>=0;interior--)
+	{
+		if(!interior)
+			ZC_finishSsimExchange(&g);
+		for(v=0;v<r4;v++)
+			ZC_addSsimBlockJobs(&g, &jobs, interior, v, 0, r3, valueRange, 0);
+		ZC_runSsimJobs(&jobs, &localSum);
+	}
+	MPI_Reduce(&localSum, &sum, 1, MPI_DOUBLE, MPI_SUM, 0, ZC_COMM_WORLD);
+	n = r4*g.global[0]*g.global[1]*g.global[2];
+	ZC_freeSsimGrid(&g);
+	return myRank==0 && n > 0 ? sum/n : 0;
+}
+
+double zc_calc_ssim_volume_float_online(const float *org, const float *rec, size_t r4, size_t r3, size_t r2, size_t r1, double valueRange)
+{
+	return ZC_computeSsimVolume_online(org, rec, ZC_FLOAT, r4, r3, r2, r1, valueRange);
+}
+
+double zc_calc_ssim_volume_double_online(const double *org, const double *rec, size_t r4, size_t r3, size_t r2, size_t r1, double valueRange)
+{
+	return ZC_computeSsimVolume_online(org, rec, ZC_DOUBLE, r4, r3, r2, r1, valueRange);
+}
+
+static double ZC_getSsimValue(const void* data, int dataType, size_t i)
+{
+	return dataType==ZC_FLOAT ? ((const float*)data)[i] : ((const double*)data)[i];
+}
+
+/**
+ * Mean SSIM (on rank 0) of the 1D data distributed over the ranks in their order (r1 local points,
+ * at least KERNEL on each rank): the KERNEL points at both ends are exchanged with the neighbors, so
+ * the windows crossing the ranks are complete, and the sums of the ranks are weighted by their points,
+ * so the result is the SSIM of the whole array, with the constants of its global value range.
+ * */
+static double ZC_computeSsim1D_online(const void* org, const void* rec, int dataType, size_t r1)
+{
+	size_t i, c = r1 < KERNEL ? r1 : KERNEL;
+	int left = myRank > 0 ? myRank-1 : MPI_PROC_NULL, right = myRank < nbProc-1 ? myRank+1 : MPI_PROC_NULL;
+	double min = DBL_MAX, max = -DBL_MAX, extrema[2], sums[2], global_sums[2] = {0, 0};
+	//org then rec (KERNEL points each), then the number of valid points
+	double toLeft[2*KERNEL+1], toRight[2*KERNEL+1], fromLeft[2*KERNEL+1], fromRight[2*KERNEL+1], halo[4*KERNEL];
+	memset(toLeft, 0, sizeof(toLeft));
+	memset(toRight, 0, sizeof(toRight));
+	memset(fromLeft, 0, sizeof(fromLeft));
+	memset(fromRight, 0, sizeof(fromRight));
+	for(i=0;i<c;i++)
+	{
+		toLeft[i] = ZC_getSsimValue(org, dataType, i);
+		toLeft[KERNEL+i] = ZC_getSsimValue(rec, dataType, i);
+		toRight[KERNEL-c+i] = ZC_getSsimValue(org, dataType, r1-c+i);
+		toRight[2*KERNEL-c+i] = ZC_getSsimValue(rec, dataType, r1-c+i);
+	}
+	toLeft[2*KERNEL] = toRight[2*KERNEL] = c;
+	MPI_Sendrecv(toRight, 2*KERNEL+1, MPI_DOUBLE, right, 0, fromLeft, 2*KERNEL+1, MPI_DOUBLE, left, 0, ZC_COMM_WORLD, MPI_STATUS_IGNORE);
+	MPI_Sendrecv(toLeft, 2*KERNEL+1, MPI_DOUBLE, left, 1, fromRight, 2*KERNEL+1, MPI_DOUBLE, right, 1, ZC_COMM_WORLD, MPI_STATUS_IGNORE);
+	memcpy(halo, fromLeft, sizeof(double)*2*KERNEL);
+	memcpy(halo+2*KERNEL, fromRight, sizeof(double)*2*KERNEL);
+
+	if(r1 > 0)
+		ZC_computeSsimExtrema(org, dataType, r1, &min, &max);
+	extrema[0] = -min;
+	extrema[1] = max;
+	MPI_Allreduce(MPI_IN_PLACE, extrema, 2, MPI_DOUBLE, MPI_MAX, ZC_COMM_WORLD);
+
+	sums[0] = ZC_computeSsim1D(org, rec, -1, -1, dataType, r1, halo, (int)fromLeft[2*KERNEL], (int)fromRight[2*KERNEL], extrema[1]+extrema[0]);
+	sums[1] = r1;
+	MPI_Reduce(sums, global_sums, 2, MPI_DOUBLE, MPI_SUM, 0, ZC_COMM_WORLD);
+	return myRank==0 && global_sums[1] > 0 ? global_sums[0]/global_sums[1] : 0;
+}
+
+double zc_calc_ssim_1d_float_online(const float *org, const float *rec, const size_t r1)
+{
+	return ZC_computeSsim1D_online(org, rec, ZC_FLOAT, r1);
+}
+
+double zc_calc_ssim_1d_double_online(const double *org, const double *rec, const size_t r1)
+{
+	return ZC_computeSsim1D_online(org, rec, ZC_DOUBLE, r1);
 }
 
 #endif
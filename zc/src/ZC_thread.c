@@ -0,0 +1,247 @@
+/**
+ *  @file ZC_thread.c
+ *  @brief Thread pool helpers used by the compare and property functions.
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include <pthread.h>
+#include "ZC_thread.h"
+
+typedef struct ZC_ThreadArg
+{
+	ZC_TaskFunc func;
+	void* arg;
+	int threadID;
+	int threadCount;
+	size_t nbTasks;
+} ZC_ThreadArg;
+
+/**
+ * Persistent workers 1..nbWorkers of ZC_runTasks() (the calling thread is thread 0), started on 
+ * first use and kept waiting for the next job (generation) until ZC_freeThreadPool(). 
+ * zc_poolUse is held by the caller whose job the workers run.
+ * */
+typedef struct ZC_ThreadPool
+{
+	pthread_t* workers;
+	int nbWorkers;
+	pthread_mutex_t lock;
+	pthread_cond_t start; /*a new job or the shutdown*/
+	pthread_cond_t done; /*the last worker of the job finished*/
+	unsigned long generation;
+	int remaining; /*workers of the current job still running*/
+	int shutdown;
+	ZC_ThreadArg job; /*threadID is set by each worker*/
+} ZC_ThreadPool;
+
+static ZC_ThreadPool zc_pool = {NULL, 0, PTHREAD_MUTEX_INITIALIZER, PTHREAD_COND_INITIALIZER, PTHREAD_COND_INITIALIZER, 0, 0, 0};
+static pthread_mutex_t zc_poolUse = PTHREAD_MUTEX_INITIALIZER;
+
+/**
+ * Set the number of threads used by the analysis (n<=0 means all the online cores).
+ * */
+void ZC_setNbThreads(int n)
+{
+	if(n <= 0)
+	{
+		long cores = sysconf(_SC_NPROCESSORS_ONLN);
+		n = cores > 0 ? (int)cores : 1;
+	}
+	nbThreads = n;
+}
+
+int ZC_getNbThreads()
+{
+	return nbThreads;
+}
+
+int ZC_computeThreadCount(size_t nbTasks)
+{
+	if(nbThreads <= 1 || nbTasks <= 1)
+		return 1;
+	return nbTasks < (size_t)nbThreads ? (int)nbTasks : nbThreads;
+}
+
+size_t ZC_computeChunkCount(size_t numOfElem)
+{
+	return (numOfElem + ZC_CHUNK_SIZE - 1)/ZC_CHUNK_SIZE;
+}
+
+static void* ZC_runThread(void* p)
+{
+	ZC_ThreadArg* t = (ZC_ThreadArg*)p;
+	size_t i;
+	for(i = t->threadID; i < t->nbTasks; i += t->threadCount)
+		t->func(t->arg, t->threadID, i);
+	return NULL;
+}
+
+static void* ZC_runWorker(void* p)
+{
+	int threadID = (int)(size_t)p;
+	unsigned long seen = 0;
+	ZC_ThreadArg t;
+	pthread_mutex_lock(&zc_pool.lock);
+	seen = zc_pool.generation - 1; /*created for the current job (see ZC_runTasks)*/
+	while(1)
+	{
+		while(zc_pool.generation == seen && !zc_pool.shutdown)
+			pthread_cond_wait(&zc_pool.start, &zc_pool.lock);
+		if(zc_pool.shutdown)
+			break;
+		seen = zc_pool.generation;
+		if(threadID >= zc_pool.job.threadCount)
+			continue;
+		t = zc_pool.job;
+		t.threadID = threadID;
+		pthread_mutex_unlock(&zc_pool.lock);
+		ZC_runThread(&t);
+		pthread_mutex_lock(&zc_pool.lock);
+		if(--zc_pool.remaining == 0)
+			pthread_cond_signal(&zc_pool.done);
+	}
+	pthread_mutex_unlock(&zc_pool.lock);
+	return NULL;
+}
+
+/*start the workers up to threadID count-1 (called with zc_pool.lock held)*/
+static void ZC_growThreadPool(int count)
+{
+	int i;
+	if(count-1 <= zc_pool.nbWorkers)
+		return;
+	zc_pool.workers = (pthread_t*)realloc(zc_pool.workers, sizeof(pthread_t)*count);
+	for(i = zc_pool.nbWorkers+1; i < count; i++)
+	{
+		if(pthread_create(&zc_pool.workers[i], NULL, ZC_runWorker, (void*)(size_t)i) != 0)
+		{
+			printf("Error: failed to create thread %d\n", i);
+			exit(0);
+		}
+	}
+	zc_pool.nbWorkers = count-1;
+}
+
+/*the workers are created and joined for this call only (nested or concurrent calls)*/
+static void ZC_runTasksSpawned(ZC_TaskFunc func, void* arg, size_t nbTasks, int threadCount)
+{
+	int i;
+	ZC_ThreadArg* targs = (ZC_ThreadArg*)malloc(sizeof(ZC_ThreadArg)*threadCount);
+	pthread_t* threads = (pthread_t*)malloc(sizeof(pthread_t)*threadCount);
+	
+	for(i = 0; i < threadCount; i++)
+	{
+		targs[i].func = func;
+		targs[i].arg = arg;
+		targs[i].threadID = i;
+		targs[i].threadCount = threadCount;
+		targs[i].nbTasks = nbTasks;
+	}
+	for(i = 1; i < threadCount; i++)
+	{
+		if(pthread_create(&threads[i], NULL, ZC_runThread, &targs[i]) != 0)
+		{
+			printf("Error: failed to create thread %d\n", i);
+			exit(0);
+		}
+	}
+	ZC_runThread(&targs[0]);
+	for(i = 1; i < threadCount; i++)
+		pthread_join(threads[i], NULL);
+	
+	free(threads);
+	free(targs);
+}
+
+/**
+ * Run func(arg, threadID, taskID) for every taskID in [0, nbTasks), with
+ * ZC_computeThreadCount(nbTasks) threads (the calling thread is thread 0): thread k 
+ * runs the tasks k, k+threadCount, ..., so the tasks of each threadID do not depend on 
+ * the scheduling. The other threads are the persistent workers of the pool; a call made 
+ * while the pool runs another job (from a task, or from another thread of the program) 
+ * creates and joins its own threads instead.
+ * */
+void ZC_runTasks(ZC_TaskFunc func, void* arg, size_t nbTasks)
+{
+	ZC_ThreadArg t;
+	int threadCount = ZC_computeThreadCount(nbTasks);
+	if(threadCount == 1)
+	{
+		t.func = func;
+		t.arg = arg;
+		t.threadID = 0;
+		t.threadCount = 1;
+		t.nbTasks = nbTasks;
+		ZC_runThread(&t);
+		return;
+	}
+	if(pthread_mutex_trylock(&zc_poolUse) != 0)
+	{
+		ZC_runTasksSpawned(func, arg, nbTasks, threadCount);
+		return;
+	}
+	
+	pthread_mutex_lock(&zc_pool.lock);
+	zc_pool.job.func = func;
+	zc_pool.job.arg = arg;
+	zc_pool.job.threadCount = threadCount;
+	zc_pool.job.nbTasks = nbTasks;
+	zc_pool.remaining = threadCount-1;
+	zc_pool.generation++;
+	ZC_growThreadPool(threadCount);
+	t = zc_pool.job;
+	pthread_cond_broadcast(&zc_pool.start);
+	pthread_mutex_unlock(&zc_pool.lock);
+	
+	t.threadID = 0;
+	ZC_runThread(&t);
+	
+	pthread_mutex_lock(&zc_pool.lock);
+	while(zc_pool.remaining > 0)
+		pthread_cond_wait(&zc_pool.done, &zc_pool.lock);
+	pthread_mutex_unlock(&zc_pool.lock);
+	pthread_mutex_unlock(&zc_poolUse);
+}
+
+/*stop and join the workers of ZC_runTasks() (called by ZC_Finalize(); they are started again on demand)*/
+void ZC_freeThreadPool()
+{
+	int i;
+	pthread_mutex_lock(&zc_poolUse);
+	pthread_mutex_lock(&zc_pool.lock);
+	zc_pool.shutdown = 1;
+	pthread_cond_broadcast(&zc_pool.start);
+	pthread_mutex_unlock(&zc_pool.lock);
+	for(i = 1; i <= zc_pool.nbWorkers; i++)
+		pthread_join(zc_pool.workers[i], NULL);
+	free(zc_pool.workers);
+	zc_pool.workers = NULL;
+	zc_pool.nbWorkers = 0;
+	zc_pool.shutdown = 0;
+	pthread_mutex_unlock(&zc_poolUse);
+}
+
+/*shared *p = min(*p, value), e.g., the first task that makes the following ones useless*/
+void ZC_atomicMin(volatile size_t* p, size_t value)
+{
+	size_t old = *p;
+	while(value < old && !__sync_bool_compare_and_swap(p, old, value))
+		old = *p;
+}
+
+/**
+ * Sum count partial vectors of length width (stored one after another) with a 
+ * fixed-shape pairwise tree; the result is left in partials[0..width-1].
+ * */
+void ZC_reduceSumTree(double* partials, size_t count, size_t width)
+{
+	size_t stride, i, j;
+	for(stride = 1; stride < count; stride *= 2)
+		for(i = 0; i + stride < count; i += 2*stride)
+			for(j = 0; j < width; j++)
+				partials[i*width+j] += partials[(i+stride)*width+j];
+}
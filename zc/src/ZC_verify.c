@@ -0,0 +1,182 @@
+/**
+ *  @file ZC_verify.c
+ *  @brief Verification of the error bound of the decompressed data.
+ *  (C) 2016 by Mathematics and Computer Science (MCS), Argonne National Laboratory.
+ *      See COPYRIGHT in top-level directory.
+ */
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "zc.h"
+#include "ZC_verify.h"
+
+static const char* zc_errorBoundModeNames[] = {"ABS", "REL", "ABS_AND_REL", "ABS_OR_REL",
+"PW_REL", "ABS_AND_PW_REL", "ABS_OR_PW_REL", "REL_AND_PW_REL", "REL_OR_PW_REL"};
+static const int zc_errorBoundModes[] = {ABS, REL, ABS_AND_REL, ABS_OR_REL,
+PW_REL, ABS_AND_PW_REL, ABS_OR_PW_REL, REL_AND_PW_REL, REL_OR_PW_REL};
+#define ZC_ERROR_BOUND_MODE_COUNT 9
+
+/*the error bound modes of the configuration file (e.g., ABS_OR_PW_REL), or -1*/
+int ZC_parseErrorBoundMode(const char* s)
+{
+	int i;
+	for(i=0;i<ZC_ERROR_BOUND_MODE_COUNT;i++)
+		if(strcmp(s, zc_errorBoundModeNames[i])==0)
+			return zc_errorBoundModes[i];
+	return -1;
+}
+
+const char* ZC_getErrorBoundModeName(int errBoundMode)
+{
+	int i;
+	for(i=0;i<ZC_ERROR_BOUND_MODE_COUNT;i++)
+		if(zc_errorBoundModes[i]==errBoundMode)
+			return zc_errorBoundModeNames[i];
+	return "UNKNOWN";
+}
+
+/*whether the bound depends on the value range of the original data*/
+int ZC_errorBoundNeedsRange(int errBoundMode)
+{
+	return errBoundMode==REL || errBoundMode==ABS_AND_REL || errBoundMode==ABS_OR_REL
+	|| errBoundMode==REL_AND_PW_REL || errBoundMode==REL_OR_PW_REL;
+}
+
+/**
+ * Turn the error bound mode into the per-point test of the kernels:
+ * |data2[i]-data1[i]| <= absBound (AND/OR) pwrBound*|data1[i]|.
+ * */
+void ZC_resolveErrorBound(ZC_VerifyResult* result, int errBoundMode, double absErrBound, double relBoundRatio,
+double pwrBoundRatio, double valueRange)
+{
+	double relBound = relBoundRatio*valueRange;
+	result->errBoundMode = errBoundMode;
+	result->pwrBound = 0;
+	result->andMode = 0;
+	switch(errBoundMode)
+	{
+	case ABS:
+		result->absBound = absErrBound;
+		break;
+	case REL:
+		result->absBound = relBound;
+		break;
+	case ABS_AND_REL:
+		result->absBound = absErrBound < relBound ? absErrBound : relBound;
+		break;
+	case ABS_OR_REL:
+		result->absBound = absErrBound > relBound ? absErrBound : relBound;
+		break;
+	case PW_REL:
+		result->absBound = 0;
+		result->pwrBound = pwrBoundRatio;
+		break;
+	case ABS_AND_PW_REL:
+	case ABS_OR_PW_REL:
+		result->absBound = absErrBound;
+		result->pwrBound = pwrBoundRatio;
+		result->andMode = errBoundMode==ABS_AND_PW_REL;
+		break;
+	case REL_AND_PW_REL:
+	case REL_OR_PW_REL:
+		result->absBound = relBound;
+		result->pwrBound = pwrBoundRatio;
+		result->andMode = errBoundMode==REL_AND_PW_REL;
+		break;
+	default:
+		printf("Error: wrong errorBoundMode: %d\n", errBoundMode);
+		exit(0);
+	}
+}
+
+/*coordinates (in the order r5, r4, r3, r2, r1) of the point at index in the data*/
+void ZC_computeCoordinates(size_t index, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1, size_t* coords)
+{
+	int k;
+	size_t r[5] = {r5, r4, r3, r2, r1};
+	for(k=4;k>=0;k--)
+	{
+		size_t d = r[k]==0 ? 1 : r[k];
+		coords[k] = index%d;
+		index /= d;
+	}
+}
+
+/**
+ * Combine the results of the chunks in the order of the data: the chunks after the first
+ * one that found maxViolations violations (or any violation, if maxViolations is 1) are
+ * ignored, so the result does not depend on the number of threads.
+ * */
+void ZC_mergeVerifyChunks(ZC_VerifyResult* result, ZC_VerifyChunk* chunks, size_t nbChunks, size_t maxViolations)
+{
+	size_t i, j, count = 0;
+	result->maxAbsErr = 0;
+	result->nbChecked = 0;
+	result->nbViolations = 0;
+	result->violations = maxViolations > 0 ? (size_t*)malloc(sizeof(size_t)*maxViolations) : NULL;
+	for(i=0;i<nbChunks;i++)
+	{
+		ZC_VerifyChunk* c = &chunks[i];
+		if(result->maxAbsErr < c->maxErr)
+			result->maxAbsErr = c->maxErr;
+		result->nbChecked += c->nbChecked;
+		result->nbViolations += c->nbViolations;
+		for(j=0;j<c->nbViolations && count<maxViolations;j++)
+			result->violations[count++] = c->violations[j];
+		if(maxViolations > 0 && count==maxViolations)
+			break;
+	}
+	if(maxViolations > 0 && result->nbViolations > maxViolations)
+		result->nbViolations = maxViolations;
+	result->pass = result->nbViolations==0;
+}
+
+/**
+ * Check the error bound of the configuration (errorBoundMode, absErrBound, relBoundRatio,
+ * pwrBoundRatio and maxViolations), stopping early once maxViolations violations are found.
+ * */
+ZC_VerifyResult* ZC_verifyErrorBound(int dataType, void* data1, void* data2, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
+{
+	if(dataType==ZC_FLOAT)
+		return ZC_verifyErrorBound_float((float*)data1, (float*)data2, errorBoundMode, absErrBound, relBoundRatio,
+		pwrBoundRatio, verifyMaxViolations, r5, r4, r3, r2, r1);
+	else if(dataType==ZC_DOUBLE)
+		return ZC_verifyErrorBound_double((double*)data1, (double*)data2, errorBoundMode, absErrBound, relBoundRatio,
+		pwrBoundRatio, verifyMaxViolations, r5, r4, r3, r2, r1);
+	printf("Error: dataType is wrong in ZC_verifyErrorBound().\n");
+	exit(0);
+}
+
+void ZC_printVerifyResult(ZC_VerifyResult* result, void* data1, void* data2, int dataType)
+{
+	size_t i, coords[5];
+	int k, dim = ZC_computeDimension(result->r5, result->r4, result->r3, result->r2, result->r1);
+	printf("errorBoundMode = %s\n", ZC_getErrorBoundModeName(result->errBoundMode));
+	printf("absBound = %.10G\n", result->absBound);
+	if(result->pwrBound > 0)
+		printf("pwrBound = %.10G (%s)\n", result->pwrBound, result->andMode ? "AND" : "OR");
+	printf("checkedPoints = %zu\n", result->nbChecked);
+	printf("maxAbsErr = %.10G\n", result->maxAbsErr);
+	printf("violations = %zu\n", result->nbViolations);
+	for(i=0;i<result->nbViolations && result->violations!=NULL;i++)
+	{
+		size_t index = result->violations[i];
+		double v1 = dataType==ZC_FLOAT ? ((float*)data1)[index] : ((double*)data1)[index];
+		double v2 = dataType==ZC_FLOAT ? ((float*)data2)[index] : ((double*)data2)[index];
+		ZC_computeCoordinates(index, result->r5, result->r4, result->r3, result->r2, result->r1, coords);
+		printf("violation %zu: index = %zu, (", i, index);
+		for(k=5-dim;k<5;k++)
+			printf(k<4 ? "%zu, " : "%zu", coords[k]);
+		printf("), original = %.10G, decompressed = %.10G\n", v1, v2);
+	}
+	printf("verification = %s\n", result->pass ? "PASS" : "FAIL");
+}
+
+void ZC_freeVerifyResult(ZC_VerifyResult* result)
+{
+	if(result==NULL)
+		return;
+	free(result->violations);
+	free(result);
+}
@@ -28,6 +28,9 @@
 #ifdef HAVE_ONLINEVIS
 #include "zserver.h"
 #endif
+#ifdef HAVE_FFTW3
+#include "ZC_FFTW3_math.h"
+#endif
 
 char *rscriptPath = NULL;
 
@@ -38,21 +41,29 @@ int checkingStatus; //0 refers to probe_compressor, 1 refers to analyze_data, an
 int executionMode = 0;
 //char *ZC_workspaceDir;
 
-int errorBoundMode; //ABS, REL, ABS_AND_REL, or ABS_OR_REL
+int errorBoundMode; //ABS, REL, ABS_AND_REL, ABS_OR_REL, PW_REL, ABS_AND_PW_REL, ...
 
 char *zc_cfgFile;
 
 double absErrBound;
 double relBoundRatio;
+double pwrBoundRatio;
 
 int minValueFlag = 1;
 int maxValueFlag = 1;
 int valueRangeFlag = 1;
 int avgValueFlag = 1;
 int entropyFlag = 1;
+int quantEntropyFlag = 0;
+double quantEntropyBoundRatio = 1E-4; //error bound of the quantized entropy, relative to the value range
+int valueQuantilesFlag = 0;
 int autocorrFlag = 1;
 int autocorr3DFlag = 1;
+int autocorr3DMaxLag = 0; //0: 3D autocorrelation of the whole volume, otherwise only of the lags -autocorr3DMaxLag..autocorr3DMaxLag
 int fftFlag = 1;
+int fftMode = ZC_FFT_PARTIAL;
+int fftwPlanner = ZC_FFTW_ESTIMATE;
+char* fftwWisdomFile = NULL; //NULL: the wisdom of the FFTW_MEASURE plans is not saved
 int lapFlag = 0;
 
 int compressTimeFlag = 1;
@@ -66,6 +77,7 @@ int errAutoCorrFlag = 1;
 int errAutoCorr3DFlag = 1;
 int absErrPDFFlag = 1;
 int pwrErrPDFFlag = 1;
+int pwrErrFlag = 1;
 
 int minRelErrFlag = 1;
 int avgRelErrFlag = 1;
@@ -81,6 +93,15 @@ int pearsonCorrFlag = 1;
 int KS_testFlag = 1;
 int SSIMFlag = 1;
 int SSIMIMAGE2DFlag = 1;
+int ssimImage2DSlices = 20; //slices sampled by ssimImage2D (0: all the slices)
+int SSIMVOLUME3DFlag = 0;
+int ssimProcGrid[3] = {0, 0, 0}; //ranks of the online SSIM along r1, r2 and r3 (0: see ZC_ssim.c)
+
+int errMapFlag = 1;
+size_t errMapTile[5] = {0, 0, 0, 0, 0}; //0: default tile shape
+int errQuantilesFlag = 0;
+
+size_t verifyMaxViolations = 1; //error-bound verification: stop at the first violation
 
 int plotAutoCorrFlag = 1;
 int plotAbsErrPDFFlag = 1;
@@ -95,6 +116,11 @@ char *reportTemplateDir;
 
 int ZC_versionNumber[3];
 
+int nbThreads = 1; //number of threads used by the analysis functions
+
+double sampleRatio = 1; //approximate mode: fraction of the data points analyzed
+unsigned int sampleSeed = 1;
+
 struct timeval startCmprTime;
 struct timeval endCmprTime;  /* Start and end times */
 struct timeval startDecTime;
@@ -277,65 +303,11 @@ long ZC_computeDataLength(size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
 	return dataLength;
 }
 
+/*the basic properties (min, max, range, avg, zeromean_variance) are computed, the others on first use*/
 ZC_DataProperty* ZC_startCmpr_offline(char* varName, int dataType, void *oriData, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
 {
-	size_t i;
-	double min,max,valueRange,sum = 0,avg;
-	ZC_DataProperty* property = (ZC_DataProperty*)malloc(sizeof(ZC_DataProperty));
-	memset(property, 0, sizeof(ZC_DataProperty));
-	
-	property->varName = (char*)malloc(sizeof(char)*100);
-	char* varN = rmFileExtension(varName); //remove the final "." if any
-	strcpy(property->varName, varN);
-	free(varN);
-	property->numOfElem = ZC_computeDataLength(r5,r4,r3,r2,r1);
-	property->dataType = dataType;
-	property->data = oriData;
-	property->r5 = r5;
-	property->r4 = r4;
-	property->r3 = r3;
-	property->r2 = r2;
-	property->r1 = r1;
-	
-	if(dataType == ZC_FLOAT)
-	{
-		float* data = (float*)oriData;
-		min = data[0];
-		max = data[0];
-		for(i=0;i<property->numOfElem;i++)
-		{
-			if(min>data[i]) min = data[i];
-			if(max<data[i]) max = data[i];
-			sum += data[i];
-		}
-		double med = min+(max-min)/2;
-		double sum_of_square = 0;
-		for(i=0;i<property->numOfElem;i++)
-			sum_of_square += (data[i] - med)*(data[i] - med);
-		property->zeromean_variance = sum_of_square/property->numOfElem;		
-	}
-	else
-	{
-		double* data = (double*)oriData;
-		min = data[0];
-		max = data[0];
-		for(i=0;i<property->numOfElem;i++)
-		{
-			if(min>data[i]) min = data[i];
-			if(max<data[i]) max = data[i];
-			sum += data[i];
-		}			
-		double med = min+(max-min)/2;
-		double sum_of_square = 0;
-		for(i=0;i<property->numOfElem;i++)
-			sum_of_square += (data[i] - med)*(data[i] - med);
-		property->zeromean_variance = sum_of_square/property->numOfElem;			
-	}
-	property->minValue = min;
-	property->maxValue = max;
-	property->valueRange = max - min;
-	property->avgValue = sum/property->numOfElem;
-//	printf("property->avgValue=%f, sum=%f, property->numOfElem=%zu\n", property->avgValue, sum, property->numOfElem);
+	ZC_DataProperty* property = ZC_createDataProperty(varName, dataType, oriData, r5, r4, r3, r2, r1);
+	ZC_requireProperties(property, ZC_PROP_BASIC);
 	
 	if(compressTimeFlag)
 		cost_startCmpr();
@@ -1238,6 +1210,19 @@ int ZC_Finalize()
 	}
 	if(reportTemplateDir!=NULL)
 		free(reportTemplateDir);
+	ZC_freeFFTTwiddles();
+	ZC_freeThreadPool();
+#ifdef HAVE_FFTW3
+	ZC_freeFFTWPlans();
+#endif
+#ifdef HAVE_MPI
+	ZC_freeOnlineStatOp();
+#endif
+	if(fftwWisdomFile!=NULL)
+	{
+		free(fftwWisdomFile);
+		fftwWisdomFile = NULL;
+	}
 	//free compressor_errBounds_elements
 	size_t i =0, j=0;
 	for(i=0;i<allCompressorCount;i++)
@@ -1392,13 +1377,15 @@ long ZC_computeDataLength_online(size_t r5, size_t r4, size_t r3, size_t r2, siz
 	return globalDataLength;
 }
 
-ZC_DataProperty* ZC_startCmpr_online(char* varName, int dataType, void *oriData, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
+/**
+ * The property of the local part of the data, whose basic properties are left pending 
+ * (ZC_PROP_BASIC): they are reduced over the ranks by ZC_genBasicProperties_*_online(), or 
+ * together with the first comparison by ZC_compareData_*_online(). Not collective.
+ * */
+ZC_DataProperty* ZC_createProperty_online(char* varName, int dataType, void *oriData, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
 {
-	size_t i;
-	double sum = 0,avg;
 	ZC_DataProperty* property = (ZC_DataProperty*)malloc(sizeof(ZC_DataProperty));
 	memset(property, 0, sizeof(ZC_DataProperty));
-	size_t numOfElem = ZC_computeDataLength(r5,r4,r3,r2,r1);	
 	
 	property->varName = (char*)malloc(sizeof(char)*100);
 	char* varN = rmFileExtension(varName); //remove the final "." if any
@@ -1412,6 +1399,14 @@ ZC_DataProperty* ZC_startCmpr_online(char* varName, int dataType, void *oriData,
 	property->r3 = r3;
 	property->r2 = r2;
 	property->r1 = r1;
+	property->pendingMask = ZC_PROP_BASIC;
+	return property;
+}
+
+ZC_DataProperty* ZC_startCmpr_online(char* varName, int dataType, void *oriData, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
+{
+	ZC_DataProperty* property = ZC_createProperty_online(varName, dataType, oriData, r5, r4, r3, r2, r1);
+	size_t numOfElem = ZC_computeDataLength(r5,r4,r3,r2,r1);	
 	
 	if(dataType == ZC_FLOAT)
 	{
@@ -1506,6 +1501,10 @@ void ZC_endDec_online(ZC_CompareData* compareResult, void *decData)
 
 //overall interfaces for checkingStatus==PROBE_COMPRESSOR
 
+/**
+ * The returned property borrows oriData (see ZC_createDataProperty()): the buffer must stay 
+ * alive while the property is used, or be given up by ZC_releasePropertyData() before it is freed.
+ * */
 ZC_DataProperty* ZC_startCmpr(char* varName, int dataType, void *oriData, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
 {
 	ZC_DataProperty* result = (ZC_DataProperty*)ht_get(ecPropertyTable, varName); //note that result->varName is the cleared string of varName.
@@ -1526,6 +1525,45 @@ ZC_DataProperty* ZC_startCmpr(char* varName, int dataType, void *oriData, size_t
 	return result;	
 }
 
+/**
+ * Same as ZC_startCmpr(), but keeps the property registered for varName (and the 
+ * quantities it caches for the comparisons, e.g., the fft coefficients) if it was 
+ * generated on the same data buffer with the same data type and dimensions, 
+ * which avoids analyzing the original data again in an error-bound sweep. 
+ * The original data must not be modified in between: the property is matched by 
+ * its buffer, not by its content, so this is only used when the caller asks for it 
+ * (ZC_compareData() always analyzes the original data again). The property may also 
+ * come from ZC_genProperties(), which registers it under varName.
+ * */
+ZC_DataProperty* ZC_startCmpr_reuse(char* varName, int dataType, void *oriData, size_t r5, size_t r4, size_t r3, size_t r2, size_t r1)
+{
+	ZC_DataProperty* result = (ZC_DataProperty*)ht_get(ecPropertyTable, varName);
+	if(result==NULL)
+	{
+		char* varN = rmFileExtension(varName);
+		result = (ZC_DataProperty*)ht_get(ecPropertyTable, varN);
+		free(varN);
+	}
+	
+	if(result==NULL || result->data!=oriData || result->dataType!=dataType || result->r5!=r5 || result->r4!=r4 
+	|| result->r3!=r3 || result->r2!=r2 || result->r1!=r1)
+		return ZC_startCmpr(varName, dataType, oriData, r5, r4, r3, r2, r1);
+
+#ifdef HAVE_MPI
+	if(compressTimeFlag)
+	{
+		if(executionMode == ZC_ONLINE)
+			initTime = MPI_Wtime();
+		else
+			cost_startCmpr();
+	}
+#else
+	if(compressTimeFlag)
+		cost_startCmpr();
+#endif
+	return result;
+}
+
 ZC_CompareData* ZC_endCmpr(ZC_DataProperty* dataProperty, char* solution, long cmprSize)
 {
 	ZC_CompareData* result = NULL;